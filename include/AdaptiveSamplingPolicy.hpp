@@ -0,0 +1,77 @@
+#ifndef ADAPTIVE_SAMPLING_POLICY_HPP
+#define ADAPTIVE_SAMPLING_POLICY_HPP
+
+#include <Arduino.h>
+#include <atomic>
+
+// Channels the policy can watch (matches SENSOR_PIPELINE_MAX_CHANNELS)
+#define ADAPTIVE_POLICY_MAX_CHANNELS 4
+
+// Defaults
+#define ADAPTIVE_POLICY_MIN_PERIOD_MS 250
+#define ADAPTIVE_POLICY_MAX_PERIOD_MS 8000
+#define ADAPTIVE_POLICY_STABLE_SAMPLES 8
+
+// How much work each sample should cost. Sensors map this onto their own
+// settings, e.g. SHT45 HIGH/MED/LOW precision (8.3 / 4.5 / 1.7 ms conversions).
+enum class SamplingEffort : uint8_t {
+    PRECISE = 0,   // Full precision
+    BALANCED = 1,  // Medium precision
+    ECONOMY = 2    // Lowest precision, shortest conversion
+};
+
+// Backs the sampling rate and effort off while readings are stable and
+// escalates back to the fastest, most precise setting as soon as any watched
+// channel changes faster than its threshold.
+//
+// After every stable_samples consecutive quiet samples the period doubles (up
+// to max_period) and the effort drops one level. One sample whose rate
+// exceeds a channel's escalate threshold returns to min_period and PRECISE effort.
+// observe() runs on the consumer side; getPeriod()/getEffort() are safe to
+// read from the sampler task.
+class AdaptiveSamplingPolicy {
+private:
+    uint32_t min_period_ms;
+    uint32_t max_period_ms;
+    uint16_t stable_samples;
+    bool enabled;
+
+    // Per-channel thresholds in units per second (0 = channel not watched)
+    float escalate_rate[ADAPTIVE_POLICY_MAX_CHANNELS];
+    float stable_rate[ADAPTIVE_POLICY_MAX_CHANNELS];
+
+    // Rate tracking
+    float last_value[ADAPTIVE_POLICY_MAX_CHANNELS];
+    uint32_t last_timestamp;
+    bool primed;
+    uint16_t stable_count;
+
+    std::atomic<uint32_t> period_ms;
+    std::atomic<uint8_t> effort;
+
+public:
+    AdaptiveSamplingPolicy(uint32_t min_period = ADAPTIVE_POLICY_MIN_PERIOD_MS,
+                           uint32_t max_period = ADAPTIVE_POLICY_MAX_PERIOD_MS,
+                           uint16_t stable_samples = ADAPTIVE_POLICY_STABLE_SAMPLES);
+
+    // Watch a channel: escalate above escalate_per_second, count as stable
+    // below stable_per_second (in between neither escalates nor backs off)
+    bool setChannelThresholds(uint8_t channel, float escalate_per_second, float stable_per_second);
+
+    // Feed one filtered sample
+    void observe(const float* values, uint8_t channel_count, uint32_t timestamp_ms);
+
+    // Disabled: always min_period and PRECISE effort
+    void setEnabled(bool enable);
+    bool isEnabled() const;
+
+    // Jump back to the fastest setting (e.g. after a user request)
+    void escalate();
+
+    uint32_t getPeriod() const;
+    SamplingEffort getEffort() const;
+    uint32_t getMinPeriod() const;
+    uint32_t getMaxPeriod() const;
+};
+
+#endif // ADAPTIVE_SAMPLING_POLICY_HPP
@@ -0,0 +1,181 @@
+#ifndef ASSET_ARENA_HPP
+#define ASSET_ARENA_HPP
+
+#include <Arduino.h>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "AssetBuffer.hpp"
+#include "GraphicsAsset.hpp"
+#include "TextBox.hpp"
+#include "FunctionPlot.hpp"
+#include "DataPlot.hpp"
+#include "Table.hpp"
+#include "Geometry.hpp"
+#include "Bitmap.hpp"
+
+// Defaults
+#define ASSET_ARENA_DEFAULT_SLOTS 64
+#define ASSET_ARENA_DEFAULT_POOL_BYTES (16 * 1024)
+
+// Buffer pool: power-of-two blocks from 16 B to 4 KiB, each with a header
+// recording its size class; larger requests go to the general heap
+#define ASSET_ARENA_SIZE_CLASSES 9
+#define ASSET_ARENA_MIN_BLOCK 16
+#define ASSET_ARENA_BLOCK_HEADER 8
+
+// Slot index in the low 16 bits, slot generation in the high 16 bits.
+// Generations start at 1, so 0 is never a valid handle.
+typedef uint32_t AssetHandle;
+#define ASSET_HANDLE_INVALID 0
+
+// Where the arena places its slots and buffer pool
+enum class ArenaMemory : uint8_t {
+    INTERNAL = 0,
+    PSRAM = 1  // ESP32-S3 external RAM; falls back to internal RAM when absent
+};
+
+constexpr size_t assetSlotMax(size_t a, size_t b) {
+    return a > b ? a : b;
+}
+
+// Every slot can hold any of the built-in asset types
+constexpr size_t ASSET_ARENA_SLOT_SIZE =
+    assetSlotMax(sizeof(TextBox), assetSlotMax(sizeof(FunctionPlot), assetSlotMax(sizeof(DataPlot),
+    assetSlotMax(sizeof(Table), assetSlotMax(sizeof(Geometry), sizeof(Bitmap))))));
+
+// Fixed pool of asset slots plus a size-class pool for the assets' buffers,
+// both allocated once. Assets are addressed by generation-checked handles:
+// a handle to a destroyed asset stays invalid even after its slot is reused
+// from the free list. Not thread safe; use from the task that draws.
+class AssetArena {
+private:
+    struct SlotInfo {
+        GraphicsAsset* asset;  // nullptr while the slot is free
+        uint16_t generation;
+        uint16_t next_free;
+    };
+
+    // Asset slots
+    uint8_t* slot_memory;  // Raw allocation; slots starts at the first aligned byte
+    uint8_t* slots;
+    size_t slot_stride;
+    uint16_t slot_count;
+    SlotInfo* slot_info;
+    uint16_t free_head;
+    uint16_t live_count;
+
+    // Buffer pool: bump-allocated, freed blocks go to per-class free lists
+    uint8_t* pool_memory;
+    uint8_t* pool;
+    size_t pool_size;
+    size_t pool_used;
+    size_t pool_in_use;  // Bytes in blocks currently handed out
+    void* free_blocks[ASSET_ARENA_SIZE_CLASSES];
+
+    // Every live arena, so a buffer can be returned to its owner
+    AssetArena* next_arena;
+    static AssetArena* arenas;
+    static AssetArena* active;
+
+    static uint8_t* allocateRegion(size_t bytes, ArenaMemory memory);
+    static void freeRegion(uint8_t* region);
+
+    bool claimSlot(uint16_t& index);
+    AssetHandle commitSlot(uint16_t index, GraphicsAsset* asset);
+    void releaseSlot(uint16_t index);
+    bool decode(AssetHandle handle, uint16_t& index) const;
+
+    friend void* assetBufferAlloc(size_t bytes);
+    friend void assetBufferFree(void* buffer);
+
+public:
+    // Constructor - check isValid() afterwards
+    AssetArena(uint16_t slots = ASSET_ARENA_DEFAULT_SLOTS,
+               size_t pool_bytes = ASSET_ARENA_DEFAULT_POOL_BYTES,
+               ArenaMemory memory = ArenaMemory::INTERNAL);
+
+    // Destructor - destroys every remaining asset
+    ~AssetArena();
+
+    AssetArena(const AssetArena&) = delete;
+    AssetArena& operator=(const AssetArena&) = delete;
+
+    bool isValid() const;
+
+    // Construct an asset in a free slot; ASSET_HANDLE_INVALID when full.
+    // Buffers the constructor allocates come from this arena's pool.
+    template <typename T, typename... Args>
+    AssetHandle create(Args&&... args) {
+        static_assert(std::is_base_of<GraphicsAsset, T>::value, "Arena slots hold GraphicsAsset types");
+        static_assert(sizeof(T) <= ASSET_ARENA_SLOT_SIZE, "Asset type does not fit an arena slot");
+        static_assert(alignof(T) <= alignof(std::max_align_t), "Asset type is over-aligned");
+
+        uint16_t index;
+        if (!claimSlot(index)) {
+            return ASSET_HANDLE_INVALID;
+        }
+        AssetArena* previous = active;
+        active = this;
+        T* asset = new (slots + index * slot_stride) T(std::forward<Args>(args)...);
+        active = previous;
+        return commitSlot(index, asset);
+    }
+
+    // Look up a handle; nullptr if it is invalid or the asset was destroyed
+    GraphicsAsset* get(AssetHandle handle) const;
+
+    // Unchecked downcast, for callers that know the type (see getAssetType())
+    template <typename T>
+    T* getAs(AssetHandle handle) const {
+        return static_cast<T*>(get(handle));
+    }
+
+    // Destroy the asset and put its slot on the free list. Remove it from any
+    // LedScreen128_64 first - the screen keeps plain pointers.
+    bool destroy(AssetHandle handle);
+    void destroyAll();
+
+    // Slot indices are small, stable numbers for the lifetime of an asset
+    // (e.g. IDs on a serial console); handleAt() is invalid for free slots
+    AssetHandle handleAt(uint16_t index) const;
+    static uint16_t indexOf(AssetHandle handle);
+
+    // Buffers allocated outside create() (draw-time caches, new bitmap data)
+    // go to the active arena
+    void activate();
+    static void deactivate();
+    static AssetArena* getActive();
+
+    // Statistics
+    uint16_t getCapacity() const;
+    uint16_t getCount() const;
+    size_t getPoolSize() const;
+    size_t getPoolUsed() const;   // High-water mark of the bump allocator
+    size_t getPoolInUse() const;  // Bytes currently handed out (headers included)
+};
+
+// Makes an arena the active one for the lifetime of the scope, then restores
+// whichever arena (or none) was active before
+class AssetArenaScope {
+private:
+    AssetArena* previous;
+
+public:
+    explicit AssetArenaScope(AssetArena& arena) : previous(AssetArena::getActive()) {
+        arena.activate();
+    }
+    ~AssetArenaScope() {
+        if (previous != nullptr) {
+            previous->activate();
+        } else {
+            AssetArena::deactivate();
+        }
+    }
+
+    AssetArenaScope(const AssetArenaScope&) = delete;
+    AssetArenaScope& operator=(const AssetArenaScope&) = delete;
+};
+
+#endif // ASSET_ARENA_HPP
@@ -0,0 +1,58 @@
+#ifndef ASSET_BUFFER_HPP
+#define ASSET_BUFFER_HPP
+
+#include <Arduino.h>
+#include <new>
+#include <utility>
+
+// Storage for the buffers graphics assets own (plot data, bitmap pixels,
+// table cells, caches). Allocations come from the size-class pools of the
+// active AssetArena (AssetArena::create() activates the arena it builds in)
+// and fall back to the general heap when no arena is active or its pool is
+// exhausted. assetBufferFree() returns a buffer to wherever it came from, so
+// it also accepts memory allocated with new uint8_t[].
+void* assetBufferAlloc(size_t bytes);
+void assetBufferFree(void* buffer);
+
+// Typed array helpers; elements are value-initialised
+template <typename T>
+T* assetBufferNew(size_t count) {
+    if (count == 0) {
+        return nullptr;
+    }
+    T* items = static_cast<T*>(assetBufferAlloc(count * sizeof(T)));
+    if (items != nullptr) {
+        for (size_t i = 0; i < count; i++) {
+            new (&items[i]) T();
+        }
+    }
+    return items;
+}
+
+template <typename T>
+void assetBufferDelete(T* items, size_t count) {
+    if (items == nullptr) {
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        items[i].~T();
+    }
+    assetBufferFree(items);
+}
+
+// Single-object helpers
+template <typename T, typename... Args>
+T* assetBufferCreate(Args&&... args) {
+    void* memory = assetBufferAlloc(sizeof(T));
+    return memory != nullptr ? new (memory) T(std::forward<Args>(args)...) : nullptr;
+}
+
+template <typename T>
+void assetBufferDestroy(T* item) {
+    if (item != nullptr) {
+        item->~T();
+        assetBufferFree(item);
+    }
+}
+
+#endif // ASSET_BUFFER_HPP
@@ -0,0 +1,60 @@
+#ifndef AXIS_LABEL_CACHE_HPP
+#define AXIS_LABEL_CACHE_HPP
+
+#include <Arduino.h>
+#include "LedScreen128_64.hpp"
+
+// Labels kept per plot (both axes); ticks past either limit are not drawn
+#define AXIS_LABEL_MAX 32
+#define AXIS_LABEL_TEXT_POOL 256
+
+// Everything the tick label layout depends on
+struct AxisLabelParams {
+    int16_t x, y, width, height;                      // Plot bounds
+    int16_t contentX, contentY, contentW, contentH;   // Plotting area
+    float minX, maxX, minY, maxY;                     // Axis ranges
+    int16_t zeroX, zeroY;                             // Screen position of data 0 on each axis
+    uint8_t gridSpacing;                              // Tick spacing when maxTicks < 2
+    uint8_t maxTicks;
+    uint8_t labelSize;                                // Text size of regular labels
+    uint8_t tinyScale;                                // Scale of TinyFont labels
+    bool tinyX, tinyY;                                // Use TinyFont for that axis
+};
+
+// Tick labels of a DataPlot or FunctionPlot, laid out once and replayed on
+// every draw until AxisLabelParams change (usually the axis range)
+class AxisLabelCache {
+private:
+    struct Label {
+        int16_t x, y;
+        uint8_t textOffset;  // Into textPool, null-terminated
+        bool tiny;
+    };
+
+    AxisLabelParams params;
+    bool valid;
+    Label labels[AXIS_LABEL_MAX];
+    uint8_t labelCount;
+    char textPool[AXIS_LABEL_TEXT_POOL];
+    uint16_t textUsed;
+    uint32_t rebuildCount;
+
+    bool matches(const AxisLabelParams& other) const;
+    void rebuild(const AxisLabelParams& layout);
+    void addLabel(int16_t lx, int16_t ly, const char* text, bool tiny);
+    void addXLabel(int16_t tickX, int16_t labelY, const char* text, int16_t& prevLabelX);
+    void addYLabel(int16_t tickY, const char* text, int16_t& prevLabelY);
+
+public:
+    AxisLabelCache();
+
+    // Draw the labels for this layout, laying them out again if it changed.
+    // Regular labels use the screen's current text size and color.
+    void draw(LedScreen128_64* screen, const AxisLabelParams& layout);
+    void invalidate();
+
+    uint8_t getLabelCount() const;
+    uint32_t getRebuildCount() const;
+};
+
+#endif // AXIS_LABEL_CACHE_HPP
@@ -3,40 +3,117 @@
 
 #include "GraphicsAsset.hpp"
 #include "LedScreen128_64.hpp"
+#include "FrameRaster.hpp"
 #include <Arduino.h>
 
+// Bitmap data layouts
+enum class BitmapFormat : uint8_t {
+    ROW_MAJOR,    // XBM-style rows, MSB first, (width + 7) / 8 bytes per row
+    PAGE_NATIVE,  // SSD1306 pages: width bytes per 8 rows, LSB on top
+    RLE_PAGES     // PAGE_NATIVE bytes, run-length encoded (may live in PROGMEM)
+};
+
+// RLE packets: a control byte c < 0x80 is followed by c + 1 literal bytes,
+// c >= 0x80 by one byte repeated (c & 0x7F) + 1 times
+#define BITMAP_RLE_RUN 0x80
+#define BITMAP_RLE_MAX_PACKET 128
+
+// Byte source for FrameRaster::pageBitmapFrom() that expands RLE_PAGES data
+class BitmapRleReader {
+private:
+    const uint8_t* data;
+    uint8_t remaining;
+    bool run;
+    uint8_t value;
+
+public:
+    explicit BitmapRleReader(const uint8_t* encoded)
+        : data(encoded), remaining(0), run(false), value(0) {}
+
+    inline uint8_t next() {
+        if (remaining == 0) {
+            uint8_t control = pgm_read_byte(data++);
+            run = (control & BITMAP_RLE_RUN) != 0;
+            remaining = (control & ~BITMAP_RLE_RUN) + 1;
+            if (run) {
+                value = pgm_read_byte(data++);
+            }
+        }
+        remaining--;
+        return run ? value : pgm_read_byte(data++);
+    }
+};
+
 class Bitmap : public GraphicsAsset {
 private:
     const uint8_t* bitmapData;  // Pointer to bitmap data
     bool ownsData;              // Whether this object owns the bitmap data
     bool inverted;              // Invert colors
-    
+    BitmapFormat format;        // Layout of bitmapData
+
+    uint8_t* allocatePages();
+
 public:
     // Constructor
     Bitmap(int16_t x = 0, int16_t y = 0, int16_t width = 8, int16_t height = 8,
-           const uint8_t* bitmapData = nullptr);
-    
+           const uint8_t* bitmapData = nullptr, BitmapFormat format = BitmapFormat::ROW_MAJOR);
+
     // Destructor
     virtual ~Bitmap();
-    
+
     // Draw method implementation
     void draw(LedScreen128_64* screen) override;
-    
+
+    // Draw the image data (no border) in its own format
+    template <uint8_t Rotation>
+    void rasterize(FrameRaster<Rotation>& raster) const {
+        if (bitmapData == nullptr) {
+            return;
+        }
+        switch (format) {
+            case BitmapFormat::PAGE_NATIVE:
+                raster.pageBitmap(x, y, bitmapData, width, height, !inverted);
+                break;
+            case BitmapFormat::RLE_PAGES: {
+                BitmapRleReader reader(bitmapData);
+                raster.pageBitmapFrom(x, y, reader, width, height, !inverted);
+                break;
+            }
+            default:
+                raster.bitmap(x, y, bitmapData, width, height, !inverted);
+                break;
+        }
+    }
+
     // Bitmap data management
-    void setBitmapData(const uint8_t* data, bool takeOwnership = false);
+    void setBitmapData(const uint8_t* data, bool takeOwnership = false,
+                       BitmapFormat format = BitmapFormat::ROW_MAJOR);
     const uint8_t* getBitmapData() const;
-    
-    // Create bitmap from simple pattern (allocates memory)
+    BitmapFormat getFormat() const;
+
+    // One-time conversion of the current data into an owned buffer of the
+    // other layout; false if there is no data or no memory
+    bool convertToPageNative();
+    bool convertToRle();
+
+    // Create bitmap from simple pattern (allocates memory, page-native)
     void createFromPattern(bool pattern[], int size);
     void createCheckerboard(int squareSize = 4);
     void createGradient(bool horizontal = true);
-    
+
     // Color inversion
     void setInverted(bool inverted);
     bool isInverted() const;
-    
+
     // Free owned bitmap data
     void freeBitmapData();
+
+    // Layout converters, usable offline to prepare PROGMEM images
+    static size_t pageNativeSize(int16_t width, int16_t height);
+    static void rowMajorToPageNative(const uint8_t* rows, int16_t width, int16_t height, uint8_t* pages);
+    // Encoded size of length page-native bytes; writes them to out when it is
+    // not null and the result fits in capacity (0 otherwise)
+    static size_t encodeRle(const uint8_t* pages, size_t length, uint8_t* out = nullptr, size_t capacity = 0);
 };
 
 #endif // BITMAP_HPP
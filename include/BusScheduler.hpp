@@ -0,0 +1,220 @@
+#ifndef BUS_SCHEDULER_HPP
+#define BUS_SCHEDULER_HPP
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <atomic>
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#define BUS_SCHEDULER_RTOS 1
+#else
+#define BUS_SCHEDULER_RTOS 0
+#endif
+
+// Bulk requests go straight to the ESP-IDF I2C driver where Wire itself is
+// built on it (arduino-esp32 2.x); elsewhere they are chunked through TwoWire
+#if defined(ESP32) && defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR < 3
+#include <driver/i2c.h>
+#define BUS_SCHEDULER_IDF_BULK 1
+#else
+#define BUS_SCHEDULER_IDF_BULK 0
+#endif
+
+// Largest TwoWire transaction used by the chunked bulk fallback
+#if defined(I2C_BUFFER_LENGTH)
+#define BUS_BULK_CHUNK_SIZE I2C_BUFFER_LENGTH
+#else
+#define BUS_BULK_CHUNK_SIZE 32
+#endif
+
+// Timeout for a single IDF bulk transaction
+#define BUS_BULK_TIMEOUT_MS 100
+
+// Longest prefix accepted for bulk requests
+#define BUS_BULK_MAX_PREFIX 4
+
+// Standard I2C bus rates
+#define I2C_STANDARD_CLOCK 100000UL
+#define I2C_FAST_CLOCK 400000UL
+#define I2C_FAST_PLUS_CLOCK 1000000UL
+
+// Number of distinct TwoWire buses tracked (clock state, device addressing)
+#define MAX_I2C_BUSES 2
+
+// Scheduler task defaults
+#define BUS_SCHEDULER_QUEUE_DEPTH 16
+#define BUS_SCHEDULER_STACK_SIZE 4096
+#define BUS_SCHEDULER_TASK_PRIORITY 5
+#define BUS_SCHEDULER_CORE 0
+
+// Priority classes - lower values are always served first
+enum class BusPriority : uint8_t {
+    SENSOR = 0,   // Time-critical sensor reads
+    CONTROL = 1,  // Configuration and register access
+    BULK = 2      // Large transfers such as display flushes
+};
+
+#define BUS_PRIORITY_COUNT 3
+
+// Outcome of a bulk request
+struct BusTransferStats {
+    size_t bytes;               // Payload bytes moved (prefix excluded)
+    unsigned long bus_time_us;  // Time spent on the bus
+    uint16_t transactions;      // Bus transactions used (1 on the IDF path)
+};
+
+// Completion callback, run on the scheduler task
+typedef void (*BusCallback)(bool success, void* context);
+
+// One bus transaction: an optional write followed by an optional read. With
+// repeated_start the read follows the write without a STOP in between. Data
+// buffers are owned by the caller and must stay valid until completion.
+struct BusRequest {
+    TwoWire* wire;
+    uint8_t address;
+    const uint8_t* tx_data;
+    size_t tx_length;
+    uint8_t* rx_data;
+    size_t rx_length;
+    bool repeated_start;
+    uint32_t clock_hz;  // SCL rate for this request (0 = keep the current rate)
+    BusCallback callback;
+    void* context;
+    void* notify_task;  // TaskHandle_t notified on completion (value 1 = ok, 2 = failed)
+    
+    // Bulk mode: buffers of any size, sent without an intermediate copy where
+    // the driver allows. The prefix (e.g. an SSD1306 control byte or register
+    // address) opens every write transaction; when chunking a write it is
+    // repeated per chunk.
+    bool bulk;
+    uint8_t prefix[BUS_BULK_MAX_PREFIX];
+    uint8_t prefix_length;
+    BusTransferStats* stats;  // Filled in on completion when set
+};
+
+// Owns the I2C buses once started: a dedicated task drains one ISR-safe
+// FreeRTOS queue per priority class, always emptying higher classes first.
+// Without FreeRTOS every request runs synchronously on the caller.
+class BusScheduler {
+private:
+    // Private constructor for singleton
+    BusScheduler();
+
+    // Delete copy constructor and assignment operator
+    BusScheduler(const BusScheduler&) = delete;
+    BusScheduler& operator=(const BusScheduler&) = delete;
+
+    bool running;
+    std::atomic<uint32_t> completed_requests;  // Counted by whichever task completes the request
+    std::atomic<uint32_t> failed_requests;
+    size_t peak_pending[BUS_PRIORITY_COUNT];
+    static uint64_t busy_time_us;  // Time spent in transactions, updated under the bus lock
+
+#if BUS_SCHEDULER_RTOS
+    QueueHandle_t queues[BUS_PRIORITY_COUNT];
+    SemaphoreHandle_t bus_mutex;  // Recursive; held by the task for each transaction
+    TaskHandle_t task_handle;
+
+    static void taskEntry(void* param);
+    void taskLoop();
+#endif
+
+    void complete(const BusRequest& request, bool success);
+    
+    // Per-bus clock bookkeeping, only touched while holding the bus lock
+    struct BusClockState {
+        TwoWire* wire;
+        uint32_t current_hz;  // Rate last applied (0 = unknown)
+        uint32_t limit_hz;    // Ceiling for every request (0 = none)
+    };
+    static BusClockState clock_states[MAX_I2C_BUSES];
+    static BusClockState* clockState(TwoWire* wire);
+    static void applyClock(TwoWire* wire, uint32_t clock_hz);
+    
+    // Run a request while holding the bus lock
+    static bool executeLocked(const BusRequest& request);
+    
+    // Bulk request implementations
+    static bool executeBulk(const BusRequest& request, BusTransferStats& stats);
+    static bool executeChunked(const BusRequest& request, BusTransferStats& stats);
+#if BUS_SCHEDULER_IDF_BULK
+    static bool executeIdf(const BusRequest& request, i2c_port_t port, BusTransferStats& stats);
+#endif
+
+public:
+    // Get singleton instance
+    static BusScheduler& getInstance();
+
+    // Start the scheduler task; until then requests run on the caller
+    bool begin(size_t queue_depth = BUS_SCHEDULER_QUEUE_DEPTH,
+               int core = BUS_SCHEDULER_CORE,
+               uint32_t stack_size = BUS_SCHEDULER_STACK_SIZE,
+               uint8_t task_priority = BUS_SCHEDULER_TASK_PRIORITY);
+    bool isRunning() const;
+
+    // True when a transaction can run directly on this task without deadlock
+    // (scheduler not running, called from the scheduler task, or bus locked here)
+    bool canRunInline() const;
+
+    // Queue a request and return immediately; completion is reported through
+    // request.callback / request.notify_task
+    bool submit(const BusRequest& request, BusPriority priority);
+    bool submitFromISR(const BusRequest& request, BusPriority priority);
+
+    // Run a request and block until it completes. Waits on the calling task's
+    // notification value, so the caller must not use it for anything else
+    bool transfer(const BusRequest& request, BusPriority priority);
+
+    // Perform a request on the calling task (bus lock taken internally)
+    static bool execute(const BusRequest& request);
+
+    // Exclusive bus access for code that drives TwoWire directly (e.g. the
+    // Adafruit drivers); recursive, so nested locking is fine
+    void lockBus();
+    void unlockBus();
+
+    // Bus clock control. Requests run at their own clock_hz, capped by the
+    // bus limit (e.g. for long wiring or weak pull-ups); setClock() is only
+    // called when the rate actually changes.
+    void setBusClockLimit(TwoWire* wire, uint32_t clock_hz);
+    uint32_t getBusClockLimit(TwoWire* wire);
+    uint32_t getBusClock(TwoWire* wire);  // Rate last applied (0 = unknown)
+    
+    // Forget the applied rate after code outside the scheduler changed it
+    void invalidateClock(TwoWire* wire);
+    
+    // Statistics
+    size_t getPendingCount(BusPriority priority) const;
+    unsigned long getCompletedCount() const;
+    unsigned long getFailedCount() const;
+    size_t getPeakPendingCount(BusPriority priority) const;  // Deepest queue seen since boot
+    uint64_t getBusyTime() const;  // Microseconds spent in transactions since boot
+};
+
+// RAII helper around BusScheduler::lockBus()/unlockBus(). Pass the bus when
+// the guarded code may change its clock (the Adafruit SSD1306 driver and
+// TwoWire::begin() do), so the next request re-applies its own rate.
+class BusGuard {
+private:
+    TwoWire* clock_changed;
+    
+public:
+    explicit BusGuard(TwoWire* clock_changed_on = nullptr) : clock_changed(clock_changed_on) {
+        BusScheduler::getInstance().lockBus();
+    }
+    ~BusGuard() {
+        if (clock_changed != nullptr) {
+            BusScheduler::getInstance().invalidateClock(clock_changed);
+        }
+        BusScheduler::getInstance().unlockBus();
+    }
+
+    BusGuard(const BusGuard&) = delete;
+    BusGuard& operator=(const BusGuard&) = delete;
+};
+
+#endif // BUS_SCHEDULER_HPP
@@ -3,6 +3,8 @@
 
 #include "GraphicsAsset.hpp"
 #include "LedScreen128_64.hpp"
+#include "AxisLabelCache.hpp"
+#include "SlidingExtrema.hpp"
 #include <Arduino.h>
 
 // Plot style options
@@ -12,12 +14,27 @@ enum class PlotStyle {
     LINES_POINTS    // Draw both lines and points
 };
 
+// Screen-space summary of every point that maps to one pixel column
+struct PlotColumn {
+    int16_t screenX;
+    int16_t firstY, lastY;  // First and last point in logical order
+    int16_t minY, maxY;     // Vertical extent (screen coordinates)
+    uint16_t points;        // Number of points in the column
+    bool linked;            // Joined to the previous column by a line
+};
+
 class DataPlot : public GraphicsAsset {
 private:
-    float* dataX;           // X data array
+    float* dataX;           // X data array (nullptr with implicit X)
     float* dataY;           // Y data array
+    int dataHead;           // Ring index of the oldest point
     int dataSize;           // Current number of data points
     int dataCapacity;       // Maximum capacity of arrays
+    bool implicitX;         // X is derived from the point index instead of stored
+    float implicitXOrigin;  // X of the oldest point when implicitX is set
+    float implicitXStep;    // X spacing between consecutive points
+    SlidingExtrema* xExtrema; // Running X min/max, created on first auto-scale (explicit X only)
+    SlidingExtrema* yExtrema; // Running Y min/max, created on first auto-scale
     float minX, maxX;       // X axis range
     float minY, maxY;       // Y axis range
     bool autoScale;         // Auto-scale axes to fit data
@@ -33,18 +50,40 @@ private:
     uint8_t tinyLabelAutoThreshold; // threshold width (in pixels) to auto-enable tiny font
     uint8_t maxTicks;       // Maximum number of ticks to draw (0 -> use gridSpacing)
     int animationFrame;     // Current animation frame (number of points drawn)
+    AxisLabelCache* labelCache; // Tick labels, created the first time labels are drawn
+    
+    // Column decimation - used when there are more points than pixel columns
+    bool decimate;              // Allow drawing through the column cache
+    uint32_t dataVersion;       // Bumped whenever the stored points change
+    PlotColumn* columns;        // Cached columns, left to right
+    int16_t columnCapacity;
+    int16_t columnCount;
+    bool columnsUsable;         // False when X is not sorted (per-point drawing is used)
+    bool columnsCached;         // Cache key below is valid
+    uint32_t columnVersion;     // Cache key: data version, point count, ranges and content rect
+    int columnPoints;
+    float columnMinX, columnMaxX, columnMinY, columnMaxY;
+    int16_t columnContentX, columnContentY, columnContentW, columnContentH;
     
     // Helper methods
+    int ringIndex(int index) const;  // Logical (oldest first) to array index
+    float pointX(int index) const;
+    float pointY(int index) const;
     int16_t mapX(float fx) const;
     int16_t mapY(float fy) const;
     void drawAxes(LedScreen128_64* screen);
     void drawGrid(LedScreen128_64* screen);
+    void drawAxisLabels(LedScreen128_64* screen);
     void calculateRanges();
+    void rebuildExtrema();
+    bool updateColumns(int points, int16_t contentX, int16_t contentY, int16_t contentW, int16_t contentH);
+    void drawColumns(LedScreen128_64* screen);
     
 public:
-    // Constructor
+    // Constructor - with implicitX only Y values are stored and point i has
+    // X = origin + step * i (oldest point first), see setImplicitXSpacing()
     DataPlot(int16_t x = 0, int16_t y = 0, int16_t width = 64, int16_t height = 32,
-             int capacity = 50);
+             int capacity = 50, bool implicitX = false);
     
     // Destructor
     virtual ~DataPlot();
@@ -52,14 +91,19 @@ public:
     // Draw method implementation
     void draw(LedScreen128_64* screen) override;
     
-    // Data management
-    void addPoint(float x, float y);
-    void setData(const float* xData, const float* yData, int size);
+    // Data management - once full, new points overwrite the oldest in O(1)
+    void addPoint(float x, float y);  // x is ignored with implicit X
+    void addValue(float y);           // X continues from the newest point by the X step
+    void setData(const float* xData, const float* yData, int size);  // xData may be nullptr with implicit X
     void clearData();
     int getDataSize() const;
     int getDataCapacity() const;
     
-    // Get data points
+    // Implicit X control
+    bool hasImplicitX() const;
+    void setImplicitXSpacing(float origin, float step);
+    
+    // Get data points (index 0 is the oldest point)
     bool getPoint(int index, float& x, float& y) const;
     
     // Range settings
@@ -98,6 +142,11 @@ public:
     void setMaxTicks(uint8_t max);
     uint8_t getMaxTicks() const;
     
+    // Decimation - with more points than pixel columns, draw one min/max
+    // envelope per column (cached until the data, ranges or size change)
+    void setDecimation(bool enable);
+    bool getDecimation() const;
+    
     // Animation control
     void resetAnimation();
     void advanceAnimation();
@@ -3,22 +3,104 @@
 
 #include <Arduino.h>
 #include <Wire.h>
-#include <queue>
-#include <vector>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "BusScheduler.hpp"
 
-// Action structure for the global queue
+// Payloads up to this size are stored inside the action itself
+#define DEVICE_ACTION_INLINE_SIZE 32
+
+// Consecutive probes a bus rate must pass in negotiateBusFrequency()
+#define BUS_CLOCK_PROBE_COUNT 4
+
+// Capacity of the global action queue (fixed, no heap allocation)
+#define ACTION_QUEUE_CAPACITY 32
+
+// Action structure for the global queue. Small payloads are copied into
+// the inline buffer; larger ones (e.g. display data) can reference a caller
+// owned buffer instead, which must stay valid until the action has run.
 struct DeviceAction {
     uint8_t device_address;
+    TwoWire* wire;  // Bus of the target device (nullptr = any bus)
     uint8_t action_type;  // 0 = read, 1 = write, etc.
-    std::vector<uint8_t> data; // Owns the data buffer for safety
+    uint8_t* external_data;  // Caller-owned buffer, or nullptr for inline storage
+    size_t data_length;
     unsigned long timestamp;
+    uint8_t inline_data[DEVICE_ACTION_INLINE_SIZE];
+    
+    DeviceAction()
+        : device_address(0), wire(nullptr), action_type(0), external_data(nullptr), data_length(0), timestamp(0) {
+    }
     
+    // Copy the payload inline (truncated to DEVICE_ACTION_INLINE_SIZE)
     DeviceAction(uint8_t addr, uint8_t type, const uint8_t* d, size_t len)
-        : device_address(addr), action_type(type), data(), timestamp(millis()) {
+        : device_address(addr), wire(nullptr), action_type(type), external_data(nullptr), data_length(0), timestamp(millis()) {
         if (d != nullptr && len > 0) {
-            data.assign(d, d + len);
+            data_length = len < DEVICE_ACTION_INLINE_SIZE ? len : DEVICE_ACTION_INLINE_SIZE;
+            memcpy(inline_data, d, data_length);
         }
     }
+    
+    // Reference a caller-owned buffer without copying
+    static DeviceAction external(uint8_t addr, uint8_t type, uint8_t* d, size_t len) {
+        DeviceAction action;
+        action.device_address = addr;
+        action.action_type = type;
+        action.external_data = d;
+        action.data_length = d != nullptr ? len : 0;
+        action.timestamp = millis();
+        return action;
+    }
+    
+    uint8_t* data() { return external_data != nullptr ? external_data : inline_data; }
+    const uint8_t* data() const { return external_data != nullptr ? external_data : inline_data; }
+    size_t size() const { return data_length; }
+    bool empty() const { return data_length == 0; }
+    bool isExternal() const { return external_data != nullptr; }
+};
+
+// Fixed-capacity FIFO ring of DeviceActions
+class ActionQueue {
+private:
+    DeviceAction slots[ACTION_QUEUE_CAPACITY];
+    size_t head;
+    size_t count;
+    size_t peak_count;  // Deepest the queue has been
+    
+    // Claim the tail slot; nullptr when the queue is full
+    DeviceAction* claimTail();
+    
+public:
+    ActionQueue();
+    
+    // Append an action; false when the queue is full
+    bool push(const DeviceAction& action);
+    bool push(DeviceAction&& action);
+    
+    // Construct an action directly in the tail slot from DeviceAction
+    // constructor arguments; returns it, or nullptr when the queue is full
+    template <typename... Args>
+    DeviceAction* emplace(Args&&... args) {
+        static_assert(std::is_trivially_destructible<DeviceAction>::value,
+                      "slots are reused without running a destructor");
+        DeviceAction* slot = claimTail();
+        return slot != nullptr ? new (slot) DeviceAction(std::forward<Args>(args)...) : nullptr;
+    }
+    
+    // Oldest action (queue must not be empty)
+    DeviceAction& front();
+    const DeviceAction& front() const;
+    
+    // Remove the oldest action
+    void pop();
+    
+    bool empty() const;
+    bool full() const;
+    size_t size() const;
+    size_t capacity() const;
+    size_t peak() const;
+    void clear();
 };
 
 class Device {
@@ -26,10 +108,21 @@ protected:
     uint8_t i2c_address;
     TwoWire* wire_instance;
     bool initialized;
+    BusPriority bus_priority;  // Scheduler class used for this device's transfers
+    uint32_t max_bus_frequency;  // Fastest SCL rate this device is driven at
+    uint32_t known_bus_frequency;  // Trusted rate for the next begin(), 0 = negotiate
+    
+    // Run one write/read transaction through the bus scheduler
+    bool transact(const uint8_t* tx_data, size_t tx_length, uint8_t* rx_data, size_t rx_length,
+                  bool repeated_start = false) const;
+    
+    // Run one bulk request through the bus scheduler
+    bool transactBulk(const uint8_t* tx_data, size_t tx_length, uint8_t* rx_data, size_t rx_length,
+                      const uint8_t* prefix, size_t prefix_length, BusTransferStats* stats) const;
 
 public:
-    // Global action queue shared across all Device instances
-    static std::queue<DeviceAction> action_queue;
+    // Global action queue shared across all Device instances (lock with BusGuard)
+    static ActionQueue action_queue;
     
     // Constructor
     Device(uint8_t address, TwoWire* wire = &Wire);
@@ -40,12 +133,34 @@ public:
     // Initialize the device
     virtual bool begin();
     
+    // Two-phase initialization used by DeviceRegistry::beginAll(). startBegin()
+    // does the setup and may leave slow work running on the device (e.g. a
+    // conversion) while other devices start; finishBegin() completes it. The
+    // defaults run begin() in startBegin() and leave nothing to finish.
+    virtual bool startBegin();
+    virtual bool finishBegin();
+    
+    // True once Device::begin() has found the device on the bus
+    bool isInitialized() const;
+    
     // Generic send function - sends data to the device over I2C
     bool send(const uint8_t* data, size_t length);
     
     // Generic receive function - receives data from the device over I2C
     bool receive(uint8_t* buffer, size_t length);
     
+    // Bulk transfers with caller-owned buffers of any size. On the ESP32 IDF
+    // path each call is a single zero-copy transaction; elsewhere it is split
+    // into TwoWire-sized chunks. prefix (up to BUS_BULK_MAX_PREFIX bytes) opens
+    // each write, e.g. an SSD1306 data control byte or a register address.
+    // stats, when given, receives the bytes moved and bus time.
+    bool sendBulk(const uint8_t* data, size_t length, const uint8_t* prefix = nullptr,
+                  size_t prefix_length = 0, BusTransferStats* stats = nullptr);
+    
+    // Bulk read; a prefix is written first and joined to the read by a repeated start
+    bool receiveBulk(uint8_t* buffer, size_t length, const uint8_t* prefix = nullptr,
+                     size_t prefix_length = 0, BusTransferStats* stats = nullptr);
+    
     // Write to a specific register
     bool writeRegister(uint8_t reg, uint8_t value);
     
@@ -55,14 +170,46 @@ public:
     // Read multiple bytes from a register
     bool readRegisters(uint8_t reg, uint8_t* buffer, size_t length);
     
+    // Write then read in one transaction, joined by a repeated start
+    bool writeThenRead(const uint8_t* tx_data, size_t tx_length, uint8_t* rx_data, size_t rx_length);
+    
     // Check if device is connected
     bool isConnected() const;
     
     // Get device address
     uint8_t getAddress() const;
     
-    // Add action to global queue (copies data into the queue)
-    void addActionToQueue(uint8_t action_type, const uint8_t* data, size_t length);
+    // Get the bus this device is attached to
+    TwoWire* getWire() const;
+    
+    // Bus scheduler priority class
+    void setBusPriority(BusPriority priority);
+    BusPriority getBusPriority() const;
+    
+    // Fastest SCL rate for this device; each transfer switches the bus to it
+    // (capped by BusScheduler::setBusClockLimit). Set before begin(), which
+    // steps it down if the device is not stable at that rate.
+    void setMaxBusFrequency(uint32_t frequency);
+    uint32_t getMaxBusFrequency() const;
+    
+    // Probe the device BUS_CLOCK_PROBE_COUNT times at the configured rate,
+    // falling back through Fast-mode Plus, Fast and Standard mode until every
+    // probe succeeds. Keeps and returns that rate, or returns 0 (rate unchanged)
+    // if the device never answered.
+    uint32_t negotiateBusFrequency();
+    
+    // Rate found by an earlier negotiation (e.g. kept across deep sleep); the
+    // next begin() adopts it without probing. 0 restores normal negotiation.
+    void setKnownBusFrequency(uint32_t frequency);
+    
+    // Add action to global queue (copies up to DEVICE_ACTION_INLINE_SIZE bytes);
+    // false if the payload is too large or the queue is full
+    bool addActionToQueue(uint8_t action_type, const uint8_t* data, size_t length);
+    
+    // Queue an action that uses the caller's buffer directly (no copy, any size).
+    // The buffer must stay valid until the action is performed or skipped;
+    // read actions receive into it.
+    bool addExternalActionToQueue(uint8_t action_type, uint8_t* data, size_t length);
 };
 
 #endif // DEVICE_HPP
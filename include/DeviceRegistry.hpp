@@ -2,9 +2,25 @@
 #define DEVICE_REGISTRY_HPP
 
 #include <Arduino.h>
+#include <atomic>
 #include <vector>
 #include "Device.hpp"
 
+// Size of the 7-bit I2C address space
+#define I2C_ADDRESS_COUNT 128
+
+// Default time budget for performPendingActions()
+#define DEVICE_REGISTRY_ACTION_BUDGET_US 2000
+
+// Capacity of the deferred boot task list
+#define DEVICE_REGISTRY_MAX_DEFERRED 8
+
+// Devices whose bus state beginAll() keeps in RTC memory across deep sleep
+#define DEVICE_REGISTRY_BOOT_RECORDS 8
+
+// Non-critical boot work, run by runDeferredTasks()
+typedef void (*DeferredTask)(void* context);
+
 class DeviceRegistry {
 private:
     // Private constructor for singleton
@@ -17,8 +33,38 @@ private:
     // Vector to store registered devices
     std::vector<Device*> registered_devices;
     
-    // Track if an action is currently being processed
-    bool action_in_progress;
+    // Direct address map per bus, kept in sync with registered_devices
+    TwoWire* buses[MAX_I2C_BUSES];
+    Device* address_map[MAX_I2C_BUSES][I2C_ADDRESS_COUNT];
+    
+    // Slot of a bus in the address map, or -1
+    int findBus(TwoWire* wire) const;
+    
+    // Slot of a bus, claiming a free one for a new bus (-1 when all are taken)
+    int claimBus(TwoWire* wire);
+    
+    // Track if an action is currently being processed (may be polled from several tasks)
+    std::atomic<bool> action_in_progress;
+    
+    // Run a single dequeued action on its device
+    static bool executeAction(Device* device, DeviceAction& action);
+    
+    // Devices begun by the last beginAll(), one bit per address and bus
+    uint32_t ready_map[MAX_I2C_BUSES][I2C_ADDRESS_COUNT / 32];
+    bool resumed_from_sleep;
+    unsigned long boot_time_us;
+    
+    // Work postponed until after the first sample
+    struct DeferredEntry {
+        DeferredTask task;
+        void* context;
+    };
+    DeferredEntry deferred[DEVICE_REGISTRY_MAX_DEFERRED];
+    size_t deferred_count;
+    
+    // Bus state kept in RTC memory across deep sleep
+    uint32_t restoredFrequency(int bus, uint8_t address) const;
+    void saveBootRecord();
     
 public:
     // Get singleton instance
@@ -27,7 +73,8 @@ public:
     // Destructor
     ~DeviceRegistry();
     
-    // Register a device with the registry
+    // Register a device with the registry; fails for duplicates, addresses
+    // already taken on the same bus, or more than MAX_I2C_BUSES buses
     bool registerDevice(Device* device);
     
     // Unregister a device from the registry
@@ -42,15 +89,52 @@ public:
     // Get a device by index
     Device* getDevice(size_t index) const;
     
-    // Get a device by I2C address
+    // Get a device by I2C address (first match across buses)
     Device* getDeviceByAddress(uint8_t address) const;
     
+    // Get a device by bus and I2C address
+    Device* getDeviceByAddress(uint8_t address, TwoWire* wire) const;
+    
+    // Fast boot sequencer. Probes every registered device once (absent ones
+    // are skipped without retries), then runs startBegin() on all of them,
+    // sensors first so their conversions overlap the other devices' setup,
+    // and finally finishBegin(). After a deep sleep wake-up the bus rates
+    // negotiated on the previous boot are restored from RTC memory and the
+    // probes are skipped. Returns the number of devices ready.
+    size_t beginAll();
+    
+    // Whether the last beginAll() brought this device up
+    bool isDeviceReady(Device* device) const;
+    
+    // Whether the last beginAll() restored bus state after deep sleep
+    bool isResumedFromSleep() const;
+    
+    // Duration of the last beginAll() in microseconds
+    unsigned long getBootTime() const;
+    
+    // Postpone non-critical work (e.g. reading serial numbers, banners) until
+    // runDeferredTasks(); false when DEVICE_REGISTRY_MAX_DEFERRED are queued
+    bool deferTask(DeferredTask task, void* context = nullptr);
+    
+    // Run and clear the deferred tasks in the order they were added (tasks
+    // deferred meanwhile run too); returns how many ran
+    size_t runDeferredTasks();
+    size_t getDeferredTaskCount() const;
+    
     // Get the next action from the global queue without removing it
     bool getNextAction(DeviceAction& action);
     
     // Perform the next action in the queue
     bool performNextAction();
     
+    // Drain queued actions until the queue is empty or budget_us has elapsed
+    // (at least one action is always attempted). A write followed by a read
+    // for the same address runs as one transaction with a repeated start.
+    // Returns the number of actions removed from the queue; failures are
+    // counted in *failed when given.
+    size_t performPendingActions(unsigned long budget_us = DEVICE_REGISTRY_ACTION_BUDGET_US,
+                                 size_t* failed = nullptr);
+    
     // Skip the next action in the queue (remove without performing)
     bool skipNextAction();
     
@@ -60,6 +144,9 @@ public:
     // Get the number of pending actions
     size_t getPendingActionCount() const;
     
+    // Deepest the action queue has been since boot
+    size_t getPeakActionCount() const;
+    
     // Clear all pending actions
     void clearAllActions();
 };
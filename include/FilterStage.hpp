@@ -0,0 +1,94 @@
+#ifndef FILTER_STAGE_HPP
+#define FILTER_STAGE_HPP
+
+#include <Arduino.h>
+
+// Window limits for the windowed stages
+#define MOVING_AVERAGE_MAX_WINDOW 32
+#define MEDIAN_FILTER_MAX_WINDOW 9
+
+// One step of a per-channel processing chain in SensorPipeline. Stages are
+// stateful, so every channel needs its own instance.
+class FilterStage {
+public:
+    virtual ~FilterStage() {}
+
+    // Process one sample and return the value passed to the next stage
+    virtual float apply(float value, uint32_t timestamp_ms) = 0;
+
+    // Forget all history
+    virtual void reset() = 0;
+};
+
+// Mean of the last N values (running sum, O(1) per sample)
+class MovingAverageStage : public FilterStage {
+private:
+    float window[MOVING_AVERAGE_MAX_WINDOW];
+    uint8_t window_size;
+    uint8_t head;
+    uint8_t count;
+    float sum;
+
+public:
+    MovingAverageStage(uint8_t size = 4);
+
+    float apply(float value, uint32_t timestamp_ms) override;
+    void reset() override;
+};
+
+// Exponential moving average: out += alpha * (in - out)
+class EmaStage : public FilterStage {
+private:
+    float alpha;
+    float state;
+    bool primed;
+
+public:
+    EmaStage(float alpha = 0.25f);
+
+    float apply(float value, uint32_t timestamp_ms) override;
+    void reset() override;
+
+    void setAlpha(float alpha);
+    float getAlpha() const;
+};
+
+// Median of the last N values, rejects single-sample spikes
+class MedianStage : public FilterStage {
+private:
+    float window[MEDIAN_FILTER_MAX_WINDOW];
+    uint8_t window_size;
+    uint8_t head;
+    uint8_t count;
+
+public:
+    MedianStage(uint8_t size = 3);
+
+    float apply(float value, uint32_t timestamp_ms) override;
+    void reset() override;
+};
+
+// Passes values through unchanged while tracking the rate of change (units
+// per second) and flagging when it exceeds a threshold
+class RateOfChangeStage : public FilterStage {
+private:
+    float threshold;  // Absolute rate that counts as a change event
+    float last_value;
+    uint32_t last_timestamp;
+    bool primed;
+    float rate;
+    bool triggered;  // Latched until acknowledge()
+
+public:
+    RateOfChangeStage(float threshold_per_second);
+
+    float apply(float value, uint32_t timestamp_ms) override;
+    void reset() override;
+
+    float getRate() const;
+    bool isTriggered() const;
+    void acknowledge();
+    void setThreshold(float threshold_per_second);
+};
+
+#endif // FILTER_STAGE_HPP
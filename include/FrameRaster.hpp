@@ -0,0 +1,551 @@
+#ifndef FRAME_RASTER_HPP
+#define FRAME_RASTER_HPP
+
+#include <Arduino.h>
+#include <string.h>
+#include "LedScreen128_64.hpp"
+
+// Page masks for a span whose top (bottom) pixel is bit n of its page
+static const uint8_t frameRasterTopMask[8] = {0xFF, 0xFE, 0xFC, 0xF8, 0xF0, 0xE0, 0xC0, 0x80};
+static const uint8_t frameRasterBottomMask[8] = {0x01, 0x03, 0x07, 0x0F, 0x1F, 0x3F, 0x7F, 0xFF};
+
+// Four framebuffer columns of one page at once
+typedef uint32_t __attribute__((__may_alias__)) FrameRasterWord;
+
+// Apply one page mask to count consecutive columns: whole bytes become a
+// memset, partial masks are ORed (or cleared) a 32-bit word at a time
+static inline void frameRasterSpan(uint8_t* row, int16_t count, uint8_t mask, bool white) {
+    if (mask == 0xFF) {
+        memset(row, white ? 0xFF : 0x00, count);
+        return;
+    }
+    if (!white) {
+        mask = ~mask;
+    }
+    while (count > 0 && ((uintptr_t)row & 3) != 0) {
+        *row = white ? (*row | mask) : (*row & mask);
+        row++;
+        count--;
+    }
+    FrameRasterWord word = mask * 0x01010101UL;
+    for (; count >= 4; count -= 4, row += 4) {
+        FrameRasterWord* cell = reinterpret_cast<FrameRasterWord*>(row);
+        *cell = white ? (*cell | word) : (*cell & word);
+    }
+    for (; count > 0; count--, row++) {
+        *row = white ? (*row | mask) : (*row & mask);
+    }
+}
+
+// Byte source for FrameRaster::pageBitmapFrom() over uncompressed page-native data
+struct FramePageReader {
+    const uint8_t* data;
+
+    explicit FramePageReader(const uint8_t* pages) : data(pages) {}
+    inline uint8_t next() { return *data++; }
+};
+
+// Primitives that write straight into the SSD1306 framebuffer (128 columns x
+// 8 pages, one byte = 8 vertical pixels, LSB on top). The rotation is a
+// template parameter so the coordinate mapping folds away at compile time;
+// every primitive clips once and then writes whole spans without per-pixel
+// virtual calls. The algorithms mirror Adafruit_GFX, so shapes come out
+// pixel-identical to the Adafruit path of the LedScreen128_64 wrappers. The
+// caller marks what it touched as dirty (see StaticScene).
+template <uint8_t Rotation = 0>
+class FrameRaster {
+    static_assert(Rotation < 4, "Rotation must be 0-3");
+
+private:
+    uint8_t* buffer;
+
+    static constexpr bool SWAPPED = (Rotation & 1) != 0;
+
+    // Span in physical coordinates, already clipped and ordered
+    inline void fillPhysical(int16_t px0, int16_t py0, int16_t px1, int16_t py1, bool white) {
+        int16_t count = px1 - px0 + 1;
+        int16_t page = py0 >> 3;
+        int16_t lastPage = py1 >> 3;
+        uint8_t* row = &buffer[page * SCREEN_WIDTH + px0];
+        uint8_t top = frameRasterTopMask[py0 & 7];
+        uint8_t bottom = frameRasterBottomMask[py1 & 7];
+        if (page == lastPage) {
+            frameRasterSpan(row, count, top & bottom, white);
+            return;
+        }
+        frameRasterSpan(row, count, top, white);
+        for (page++, row += SCREEN_WIDTH; page < lastPage; page++, row += SCREEN_WIDTH) {
+            memset(row, white ? 0xFF : 0x00, count);
+        }
+        frameRasterSpan(row, count, bottom, white);
+    }
+
+    // Single pixel already known to be on screen
+    inline void plot(int16_t x, int16_t y, bool white) {
+        int16_t px, py;
+        switch (Rotation) {
+            case 1:
+                px = SCREEN_WIDTH - 1 - y;
+                py = x;
+                break;
+            case 2:
+                px = SCREEN_WIDTH - 1 - x;
+                py = SCREEN_HEIGHT - 1 - y;
+                break;
+            case 3:
+                px = y;
+                py = SCREEN_HEIGHT - 1 - x;
+                break;
+            default:
+                px = x;
+                py = y;
+                break;
+        }
+        uint8_t& cell = buffer[(py >> 3) * SCREEN_WIDTH + px];
+        uint8_t bit = (uint8_t)(1 << (py & 7));
+        cell = white ? (cell | bit) : (cell & ~bit);
+    }
+
+    template <bool Clip>
+    inline void put(int16_t x, int16_t y, bool white) {
+        if (Clip) {
+            pixel(x, y, white);
+        } else {
+            plot(x, y, white);
+        }
+    }
+
+    // Where a primitive's bounding box (inclusive) lies
+    enum Coverage { OUTSIDE, INSIDE, PARTIAL };
+
+    static inline Coverage cover(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+        if (x1 < 0 || y1 < 0 || x0 >= width() || y0 >= height()) {
+            return OUTSIDE;
+        }
+        if (x0 >= 0 && y0 >= 0 && x1 < width() && y1 < height()) {
+            return INSIDE;
+        }
+        return PARTIAL;
+    }
+
+    // Bresenham on ordered end points (x0 <= x1); steep lines come in with x and y swapped
+    template <bool Clip>
+    void lineSteps(int16_t x0, int16_t y0, int16_t x1, int16_t y1, bool steep, bool white) {
+        int16_t dx = x1 - x0;
+        int16_t dy = abs(y1 - y0);
+        int16_t err = dx / 2;
+        int16_t ystep = y0 < y1 ? 1 : -1;
+        for (; x0 <= x1; x0++) {
+            if (steep) {
+                put<Clip>(y0, x0, white);
+            } else {
+                put<Clip>(x0, y0, white);
+            }
+            err -= dy;
+            if (err < 0) {
+                y0 += ystep;
+                err += dx;
+            }
+        }
+    }
+
+    template <bool Clip>
+    void circleSteps(int16_t x0, int16_t y0, int16_t r, bool white) {
+        int16_t f = 1 - r;
+        int16_t ddF_x = 1;
+        int16_t ddF_y = -2 * r;
+        int16_t x = 0;
+        int16_t y = r;
+        put<Clip>(x0, y0 + r, white);
+        put<Clip>(x0, y0 - r, white);
+        put<Clip>(x0 + r, y0, white);
+        put<Clip>(x0 - r, y0, white);
+        while (x < y) {
+            if (f >= 0) {
+                y--;
+                ddF_y += 2;
+                f += ddF_y;
+            }
+            x++;
+            ddF_x += 2;
+            f += ddF_x;
+            put<Clip>(x0 + x, y0 + y, white);
+            put<Clip>(x0 - x, y0 + y, white);
+            put<Clip>(x0 + x, y0 - y, white);
+            put<Clip>(x0 - x, y0 - y, white);
+            put<Clip>(x0 + y, y0 + x, white);
+            put<Clip>(x0 - y, y0 + x, white);
+            put<Clip>(x0 + y, y0 - x, white);
+            put<Clip>(x0 - y, y0 - x, white);
+        }
+    }
+
+    template <bool Clip>
+    void bitmapSteps(int16_t x, int16_t y, const uint8_t* data, int16_t w, int16_t h, bool white) {
+        int16_t byteWidth = (w + 7) / 8;
+        for (int16_t j = 0; j < h; j++) {
+            const uint8_t* row = &data[j * byteWidth];
+            for (int16_t i = 0; i < w; i++) {
+                if (row[i >> 3] & (0x80 >> (i & 7))) {
+                    put<Clip>(x + i, y + j, white);
+                }
+            }
+        }
+    }
+
+    // Page-native bitmap one set bit at a time, for the rotated layouts
+    template <bool Clip, typename Source>
+    void pageSteps(int16_t x, int16_t y, Source& source, int16_t w, int16_t h, bool white) {
+        for (int16_t top = 0; top < h; top += 8) {
+            uint8_t mask = h - top >= 8 ? 0xFF : frameRasterBottomMask[(h - top - 1) & 7];
+            for (int16_t i = 0; i < w; i++) {
+                uint8_t bits = source.next() & mask;
+                for (uint8_t bit = 0; bits != 0; bit++, bits >>= 1) {
+                    if (bits & 1) {
+                        put<Clip>(x + i, y + top + bit, white);
+                    }
+                }
+            }
+        }
+    }
+
+    static inline void blend(uint8_t& cell, uint8_t bits, bool white) {
+        cell = white ? (cell | bits) : (cell & ~bits);
+    }
+
+    // Logical rectangle (inclusive, clipped) -> physical rectangle
+    inline void fillClipped(int16_t x0, int16_t y0, int16_t x1, int16_t y1, bool white) {
+        switch (Rotation) {
+            case 1:
+                fillPhysical(SCREEN_WIDTH - 1 - y1, x0, SCREEN_WIDTH - 1 - y0, x1, white);
+                break;
+            case 2:
+                fillPhysical(SCREEN_WIDTH - 1 - x1, SCREEN_HEIGHT - 1 - y1,
+                             SCREEN_WIDTH - 1 - x0, SCREEN_HEIGHT - 1 - y0, white);
+                break;
+            case 3:
+                fillPhysical(y0, SCREEN_HEIGHT - 1 - x1, y1, SCREEN_HEIGHT - 1 - x0, white);
+                break;
+            default:
+                fillPhysical(x0, y0, x1, y1, white);
+                break;
+        }
+    }
+
+    // Shared by drawRoundRect()
+    void circleCorners(int16_t x0, int16_t y0, int16_t r, uint8_t corners, bool white) {
+        int16_t f = 1 - r;
+        int16_t ddF_x = 1;
+        int16_t ddF_y = -2 * r;
+        int16_t x = 0;
+        int16_t y = r;
+        while (x < y) {
+            if (f >= 0) {
+                y--;
+                ddF_y += 2;
+                f += ddF_y;
+            }
+            x++;
+            ddF_x += 2;
+            f += ddF_x;
+            if (corners & 0x4) {
+                pixel(x0 + x, y0 + y, white);
+                pixel(x0 + y, y0 + x, white);
+            }
+            if (corners & 0x2) {
+                pixel(x0 + x, y0 - y, white);
+                pixel(x0 + y, y0 - x, white);
+            }
+            if (corners & 0x8) {
+                pixel(x0 - y, y0 + x, white);
+                pixel(x0 - x, y0 + y, white);
+            }
+            if (corners & 0x1) {
+                pixel(x0 - y, y0 - x, white);
+                pixel(x0 - x, y0 - y, white);
+            }
+        }
+    }
+
+    // Shared by fillCircle() and fillRoundRect()
+    void fillCircleHalves(int16_t x0, int16_t y0, int16_t r, uint8_t corners, int16_t delta, bool white) {
+        int16_t f = 1 - r;
+        int16_t ddF_x = 1;
+        int16_t ddF_y = -2 * r;
+        int16_t x = 0;
+        int16_t y = r;
+        int16_t px = x;
+        int16_t py = y;
+        delta++;
+        while (x < y) {
+            if (f >= 0) {
+                y--;
+                ddF_y += 2;
+                f += ddF_y;
+            }
+            x++;
+            ddF_x += 2;
+            f += ddF_x;
+            if (x < y + 1) {
+                if (corners & 1) vline(x0 + x, y0 - y, 2 * y + delta, white);
+                if (corners & 2) vline(x0 - x, y0 - y, 2 * y + delta, white);
+            }
+            if (y != py) {
+                if (corners & 1) vline(x0 + py, y0 - px, 2 * px + delta, white);
+                if (corners & 2) vline(x0 - py, y0 - px, 2 * px + delta, white);
+                py = y;
+            }
+            px = x;
+        }
+    }
+
+public:
+    explicit FrameRaster(uint8_t* framebuffer) : buffer(framebuffer) {}
+
+    static constexpr int16_t width() { return SWAPPED ? SCREEN_HEIGHT : SCREEN_WIDTH; }
+    static constexpr int16_t height() { return SWAPPED ? SCREEN_WIDTH : SCREEN_HEIGHT; }
+
+    void clear() {
+        memset(buffer, 0, SCREEN_WIDTH * SCREEN_PAGES);
+    }
+
+    inline void pixel(int16_t x, int16_t y, bool white = true) {
+        if (x < 0 || y < 0 || x >= width() || y >= height()) {
+            return;
+        }
+        plot(x, y, white);
+    }
+
+    // Rectangles and spans; non-positive sizes draw nothing, like Adafruit_GFX
+    inline void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, bool white = true) {
+        if (w <= 0 || h <= 0) {
+            return;
+        }
+        int16_t x1 = x + w - 1;
+        int16_t y1 = y + h - 1;
+        if (x1 < 0 || y1 < 0 || x >= width() || y >= height()) {
+            return;
+        }
+        fillClipped(x < 0 ? 0 : x, y < 0 ? 0 : y,
+                    x1 >= width() ? width() - 1 : x1, y1 >= height() ? height() - 1 : y1, white);
+    }
+
+    inline void hline(int16_t x, int16_t y, int16_t w, bool white = true) {
+        fillRect(x, y, w, 1, white);
+    }
+
+    inline void vline(int16_t x, int16_t y, int16_t h, bool white = true) {
+        fillRect(x, y, 1, h, white);
+    }
+
+    void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, bool white = true) {
+        hline(x, y, w, white);
+        hline(x, y + h - 1, w, white);
+        vline(x, y, h, white);
+        vline(x + w - 1, y, h, white);
+    }
+
+    // Bresenham, with axis-aligned lines as spans
+    void line(int16_t x0, int16_t y0, int16_t x1, int16_t y1, bool white = true) {
+        if (x0 == x1) {
+            if (y0 > y1) {
+                int16_t t = y0; y0 = y1; y1 = t;
+            }
+            vline(x0, y0, y1 - y0 + 1, white);
+            return;
+        }
+        if (y0 == y1) {
+            if (x0 > x1) {
+                int16_t t = x0; x0 = x1; x1 = t;
+            }
+            hline(x0, y0, x1 - x0 + 1, white);
+            return;
+        }
+
+        bool steep = abs(y1 - y0) > abs(x1 - x0);
+        if (steep) {
+            int16_t t = x0; x0 = y0; y0 = t;
+            t = x1; x1 = y1; y1 = t;
+        }
+        if (x0 > x1) {
+            int16_t t = x0; x0 = x1; x1 = t;
+            t = y0; y0 = y1; y1 = t;
+        }
+
+        // Clip test once on the bounding box, in logical coordinates
+        int16_t lx0 = steep ? min(y0, y1) : x0;
+        int16_t lx1 = steep ? max(y0, y1) : x1;
+        int16_t ly0 = steep ? x0 : min(y0, y1);
+        int16_t ly1 = steep ? x1 : max(y0, y1);
+        switch (cover(lx0, ly0, lx1, ly1)) {
+            case INSIDE:
+                lineSteps<false>(x0, y0, x1, y1, steep, white);
+                break;
+            case PARTIAL:
+                lineSteps<true>(x0, y0, x1, y1, steep, white);
+                break;
+            default:
+                break;
+        }
+    }
+
+    void drawCircle(int16_t x0, int16_t y0, int16_t r, bool white = true) {
+        int16_t reach = abs(r);
+        switch (cover(x0 - reach, y0 - reach, x0 + reach, y0 + reach)) {
+            case INSIDE:
+                circleSteps<false>(x0, y0, r, white);
+                break;
+            case PARTIAL:
+                circleSteps<true>(x0, y0, r, white);
+                break;
+            default:
+                break;
+        }
+    }
+
+    void fillCircle(int16_t x0, int16_t y0, int16_t r, bool white = true) {
+        vline(x0, y0 - r, 2 * r + 1, white);
+        fillCircleHalves(x0, y0, r, 3, 0, white);
+    }
+
+    void drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, bool white = true) {
+        int16_t max_radius = (w < h ? w : h) / 2;
+        if (r > max_radius) r = max_radius;
+        hline(x + r, y, w - 2 * r, white);
+        hline(x + r, y + h - 1, w - 2 * r, white);
+        vline(x, y + r, h - 2 * r, white);
+        vline(x + w - 1, y + r, h - 2 * r, white);
+        circleCorners(x + r, y + r, r, 1, white);
+        circleCorners(x + w - r - 1, y + r, r, 2, white);
+        circleCorners(x + w - r - 1, y + h - r - 1, r, 4, white);
+        circleCorners(x + r, y + h - r - 1, r, 8, white);
+    }
+
+    void fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, bool white = true) {
+        int16_t max_radius = (w < h ? w : h) / 2;
+        if (r > max_radius) r = max_radius;
+        fillRect(x + r, y, w - 2 * r, h, white);
+        fillCircleHalves(x + w - r - 1, y + r, r, 1, h - 2 * r - 1, white);
+        fillCircleHalves(x + r, y + r, r, 2, h - 2 * r - 1, white);
+    }
+
+    void drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, bool white = true) {
+        line(x0, y0, x1, y1, white);
+        line(x1, y1, x2, y2, white);
+        line(x2, y2, x0, y0, white);
+    }
+
+    // Scanline fill, sorted by Y
+    void fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, bool white = true) {
+        int16_t t;
+        if (y0 > y1) { t = y0; y0 = y1; y1 = t; t = x0; x0 = x1; x1 = t; }
+        if (y1 > y2) { t = y2; y2 = y1; y1 = t; t = x2; x2 = x1; x1 = t; }
+        if (y0 > y1) { t = y0; y0 = y1; y1 = t; t = x0; x0 = x1; x1 = t; }
+
+        int16_t a, b, y;
+        if (y0 == y2) {
+            a = b = x0;
+            if (x1 < a) a = x1; else if (x1 > b) b = x1;
+            if (x2 < a) a = x2; else if (x2 > b) b = x2;
+            hline(a, y0, b - a + 1, white);
+            return;
+        }
+
+        int16_t dx01 = x1 - x0, dy01 = y1 - y0;
+        int16_t dx02 = x2 - x0, dy02 = y2 - y0;
+        int16_t dx12 = x2 - x1, dy12 = y2 - y1;
+        int32_t sa = 0;
+        int32_t sb = 0;
+        int16_t last = (y1 == y2) ? y1 : y1 - 1;
+
+        for (y = y0; y <= last; y++) {
+            a = x0 + sa / dy01;
+            b = x0 + sb / dy02;
+            sa += dx01;
+            sb += dx02;
+            if (a > b) { t = a; a = b; b = t; }
+            hline(a, y, b - a + 1, white);
+        }
+
+        sa = (int32_t)dx12 * (y - y1);
+        sb = (int32_t)dx02 * (y - y0);
+        for (; y <= y2; y++) {
+            a = x1 + sa / dy12;
+            b = x0 + sb / dy02;
+            sa += dx12;
+            sb += dx02;
+            if (a > b) { t = a; a = b; b = t; }
+            hline(a, y, b - a + 1, white);
+        }
+    }
+
+    // Row-major, MSB-first bitmap with (w + 7) / 8 bytes per row, set bits only
+    void bitmap(int16_t x, int16_t y, const uint8_t* data, int16_t w, int16_t h, bool white = true) {
+        if (w <= 0 || h <= 0) {
+            return;
+        }
+        switch (cover(x, y, x + w - 1, y + h - 1)) {
+            case INSIDE:
+                bitmapSteps<false>(x, y, data, w, h, white);
+                break;
+            case PARTIAL:
+                bitmapSteps<true>(x, y, data, w, h, white);
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Page-native bitmap: w bytes per 8-pixel page, LSB on top, set bits only.
+    // Upright, each source byte lands in at most two framebuffer bytes (one
+    // when y is a multiple of 8). The source supplies the bytes in order.
+    template <typename Source>
+    void pageBitmapFrom(int16_t x, int16_t y, Source& source, int16_t w, int16_t h, bool white = true) {
+        if (w <= 0 || h <= 0) {
+            return;
+        }
+        Coverage coverage = cover(x, y, x + w - 1, y + h - 1);
+        if (coverage == OUTSIDE) {
+            return;
+        }
+        if (Rotation != 0) {
+            if (coverage == INSIDE) {
+                pageSteps<false>(x, y, source, w, h, white);
+            } else {
+                pageSteps<true>(x, y, source, w, h, white);
+            }
+            return;
+        }
+
+        for (int16_t top = 0; top < h; top += 8) {
+            uint8_t mask = h - top >= 8 ? 0xFF : frameRasterBottomMask[(h - top - 1) & 7];
+            int16_t row = y + top;
+            int16_t page = row >> 3;
+            uint8_t shift = row & 7;
+            uint8_t* upper = page >= 0 && page < SCREEN_PAGES ? &buffer[page * SCREEN_WIDTH] : nullptr;
+            uint8_t* lower = shift != 0 && page + 1 >= 0 && page + 1 < SCREEN_PAGES
+                                 ? &buffer[(page + 1) * SCREEN_WIDTH] : nullptr;
+            for (int16_t i = 0; i < w; i++) {
+                uint8_t bits = source.next() & mask;
+                int16_t px = x + i;
+                if (bits == 0 || px < 0 || px >= SCREEN_WIDTH) {
+                    continue;
+                }
+                uint16_t shifted = (uint16_t)bits << shift;
+                if (upper != nullptr) {
+                    blend(upper[px], (uint8_t)shifted, white);
+                }
+                if (lower != nullptr) {
+                    blend(lower[px], (uint8_t)(shifted >> 8), white);
+                }
+            }
+        }
+    }
+
+    void pageBitmap(int16_t x, int16_t y, const uint8_t* pages, int16_t w, int16_t h, bool white = true) {
+        FramePageReader reader(pages);
+        pageBitmapFrom(x, y, reader, w, h, white);
+    }
+};
+
+#endif // FRAME_RASTER_HPP
@@ -3,6 +3,7 @@
 
 #include "GraphicsAsset.hpp"
 #include "LedScreen128_64.hpp"
+#include "AxisLabelCache.hpp"
 #include <Arduino.h>
 
 // Function pointer type for mathematical functions
@@ -27,13 +28,32 @@ private:
     uint8_t tinyLabelAutoThreshold;
     uint8_t maxTicks;
     int animationFrame;  // Current animation frame (pixels drawn from left)
+    AxisLabelCache* labelCache;  // Tick labels, created the first time labels are drawn
+    
+    // Sample cache - function values per content column, reused until the
+    // function, X range or content width change
+    float* samples;
+    int16_t sampleCapacity;
+    int16_t sampleCount;         // Cached columns (0 when the cache is empty)
+    MathFunction sampleFunction;
+    float sampleMinX, sampleMaxX;
+    
+    // Auto-scale cache - result of calculateYRange() for the same key plus width
+    bool rangeCached;
+    bool rangeFound;             // Valid samples with a non-zero span were found
+    MathFunction rangeFunction;
+    float rangeMinX, rangeMaxX;
+    int16_t rangeWidth;
+    float rangeMinY, rangeMaxY;
     
     // Helper methods
     int16_t mapX(float fx) const;
     int16_t mapY(float fy) const;
     void drawAxes(LedScreen128_64* screen);
     void drawGrid(LedScreen128_64* screen);
+    void drawAxisLabels(LedScreen128_64* screen);
     void calculateYRange();
+    void updateSamples(int16_t contentW);
     
 public:
     // Constructor
@@ -49,6 +69,7 @@ public:
     // Function management
     void setFunction(MathFunction func);
     MathFunction getFunction() const;
+    void invalidateSamples();  // Call when the function's output changes (e.g. new calibration)
     
     // Range settings
     void setXRange(float minX, float maxX);
@@ -35,6 +35,9 @@ public:
     // Draw method implementation
     void draw(LedScreen128_64* screen) override;
     
+    // Circles are centred on x/y and lines/triangles use their end points
+    void getBounds(int16_t& bx, int16_t& by, int16_t& bw, int16_t& bh) const override;
+    
     // Shape management
     void setShape(GeometryShape shape);
     GeometryShape getShape() const;
@@ -14,7 +14,8 @@ enum class AssetType {
     DATAPLOT,
     TABLE,
     GEOMETRY,
-    BITMAP
+    BITMAP,
+    PROFILER_OVERLAY
 };
 
 class GraphicsAsset {
@@ -28,6 +29,8 @@ protected:
     bool animate;       // Whether to use animated drawing
     int16_t zIndex;     // Z-index for layering (higher values drawn on top)
     AssetType assetType; // Type identifier
+    bool dirty;         // Needs redrawing (used by retained-mode drawAssets)
+    bool partialDirty;  // Every change since the last draw is covered by getDamage()
     
 public:
     // Constructor
@@ -74,8 +77,28 @@ public:
     // Check if a point is inside the asset bounds
     bool contains(int16_t px, int16_t py) const;
     
+    // Screen area touched by draw(); override when drawing extends past x/y/width/height
+    virtual void getBounds(int16_t& bx, int16_t& by, int16_t& bw, int16_t& bh) const;
+    
+    // Invalidation - setters mark the asset dirty so retained mode redraws it
+    bool isDirty() const;
+    void markDirty();
+    void clearDirty();
+    
+    // Partial repaint - an asset that changed without moving may report a
+    // smaller area for retained mode to clear, which it then repaints through
+    // drawDamage(). Only used while isPartiallyDirty(); the defaults report
+    // nothing and fall back to draw().
+    bool isPartiallyDirty() const;
+    virtual bool getDamage(int16_t& dx, int16_t& dy, int16_t& dw, int16_t& dh) const;
+    virtual void drawDamage(LedScreen128_64* screen);
+    
     // Type identification
     AssetType getAssetType() const;
+
+protected:
+    // Dirty, but only in ways the asset's getDamage() accounts for
+    void markPartiallyDirty();
 };
 
 #endif // GRAPHICS_ASSET_HPP
@@ -4,10 +4,26 @@
 #include <Arduino.h>
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
+#include <atomic>
 #include <memory>
 #include <vector>
 #include "Device.hpp"
 
+// Background flush task support; build with LED_SCREEN_FLUSH_RTOS=0 to leave it out
+#ifndef LED_SCREEN_FLUSH_RTOS
+#if defined(ESP32)
+#define LED_SCREEN_FLUSH_RTOS 1
+#else
+#define LED_SCREEN_FLUSH_RTOS 0
+#endif
+#endif
+
+#if LED_SCREEN_FLUSH_RTOS
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#endif
+
 // Forward declaration
 class GraphicsAsset;
 
@@ -15,15 +31,115 @@ class GraphicsAsset;
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
 #define OLED_RESET -1  // Reset pin (or -1 if sharing Arduino reset pin)
-#define MAX_SCREEN_ASSETS 20
+#define MAX_SCREEN_ASSETS 1024  // Sanity cap; the asset list grows as needed
+#define SCREEN_DAMAGE_RECTS 20  // Tracked damage areas before they are merged
+#define SCREEN_PAGES (SCREEN_HEIGHT / 8)  // SSD1306 RAM is organised in 8-pixel pages
+
+// 1: the drawing wrappers rasterize with FrameRaster straight into the
+// framebuffer; 0: they go through Adafruit_GFX. Both produce the same pixels
+// (test/test_frame_raster); text and drawChar() always use Adafruit_GFX.
+#ifndef LED_SCREEN_NATIVE_RASTER
+#define LED_SCREEN_NATIVE_RASTER 0
+#endif
+
+// Background flush task defaults (loop() runs on core 1)
+#define SCREEN_FLUSH_STACK_SIZE 3072
+#define SCREEN_FLUSH_TASK_PRIORITY 2
+#define SCREEN_FLUSH_CORE 0
+
+// Largest single I2C write used when flushing (control byte included)
+#if defined(I2C_BUFFER_LENGTH)
+#define SSD1306_FLUSH_CHUNK I2C_BUFFER_LENGTH
+#else
+#define SSD1306_FLUSH_CHUNK 32
+#endif
+
+// Screen-space rectangle used by retained-mode asset drawing
+struct ScreenRect {
+    int16_t x;
+    int16_t y;
+    int16_t w;  // w <= 0 or h <= 0 means empty
+    int16_t h;
+};
+
+// An asset registered with the screen plus the area it covered when last drawn
+struct AssetEntry {
+    GraphicsAsset* asset;
+    ScreenRect drawn;
+    bool redrawn;        // Scratch flags for retained-mode drawAssets(): painted outside the cleared damage
+    int8_t damage_slot;  // Damage rect holding only this asset's getDamage() area, -1 if none
+    ScreenRect painted;  // Area repainted this frame
+};
 
 class LedScreen128_64 : public Device {
 private:
     std::unique_ptr<Adafruit_SSD1306> display;
     bool display_initialized;
+    uint8_t text_size;  // Tracked so printed text can be marked dirty
     
-    // Graphics assets management
-    std::vector<GraphicsAsset*> assets;
+    // Partial flush state: per-page dirty column span (inclusive, start > end
+    // when clean) and a copy of what the panel currently shows
+    bool partial_flush;
+    bool flushed_frame_valid;
+    uint8_t dirty_col_start[SCREEN_PAGES];
+    uint8_t dirty_col_end[SCREEN_PAGES];
+    uint8_t flushed_frame[SCREEN_WIDTH * SCREEN_PAGES];
+    size_t last_flush_bytes;
+    unsigned long last_flush_time_us;
+    
+    // Frame pacing: flushes start at most once per frame_interval_us (0 = unpaced)
+    uint32_t frame_interval_us;
+    unsigned long last_flush_start_us;
+    
+    // Background flushing: displayBuffer() copies the framebuffer and its
+    // dirty spans into a slot the flush task sends from. slots[0] is being
+    // sent; with triple buffering slots[1] queues the next frame.
+    struct FlushSlot {
+        uint8_t* pixels;
+        uint8_t col_start[SCREEN_PAGES];
+        uint8_t col_end[SCREEN_PAGES];
+    };
+    FlushSlot flush_slots[2];
+    uint8_t flush_buffers;          // 0 = flushing in displayBuffer(), else 2 or 3
+    bool frame_queued;              // Queued slot holds a frame not yet started
+    std::atomic<bool> flush_busy;   // A presented frame is not on the panel yet
+    std::atomic<uint32_t> frames_flushed;
+    std::atomic<uint32_t> frames_replaced;  // Queued frames overwritten before they were sent
+#if LED_SCREEN_FLUSH_RTOS
+    TaskHandle_t flush_task;
+    SemaphoreHandle_t flush_mutex;  // Guards the queued slot and frame_queued
+    SemaphoreHandle_t flush_idle;   // Given each time the task runs out of frames
+    SemaphoreHandle_t flush_wake;   // Given per queued frame; the task's notification is left to BusScheduler
+    
+    static void flushTaskEntry(void* param);
+    void queueFrame();
+    void flushQueuedFrames();
+#endif
+    
+    // Graphics assets management - kept sorted by z-index (stable for equal values)
+    std::vector<AssetEntry> assets;
+    bool retained_mode;
+    bool assets_invalid;  // Screen no longer shows the assets; next drawAssets() draws all
+    ScreenRect pending_damage[SCREEN_DAMAGE_RECTS];  // Areas of removed assets
+    uint8_t pending_damage_count;
+    
+    // Dirty tracking helpers
+    void markDirtyPhysical(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+    void markTextDirty(int16_t start_x, int16_t start_y);
+    void clearDirty();
+    
+    // Flush helpers - frame is the buffer being sent, col_start/col_end its dirty spans
+    void paceFrame();
+    void flushFrame(const uint8_t* frame, const uint8_t* col_start, const uint8_t* col_end);
+    void flushDirtyWindows(const uint8_t* frame, const uint8_t* col_start, const uint8_t* col_end);
+    bool flushWindow(const uint8_t* frame, uint8_t page_start, uint8_t page_end, uint8_t col_start,
+                     uint8_t col_end);
+    
+    // Asset helpers
+    void sortAssets();
+    void addPendingDamage(const ScreenRect& rect);
+    void clearRect(const ScreenRect& rect);
+    void drawAssetsRetained();
     
 public:
     // Constructor - default address is 0x3C for most SSD1306 displays
@@ -38,12 +154,47 @@ public:
     // Display control methods
     void clearDisplay();
     void displayBuffer();  // Call this to actually show changes on screen
+    
+    // Partial flush control - when enabled displayBuffer() only sends the
+    // page/column windows that changed since the last flush
+    void setPartialFlush(bool enable);
+    bool getPartialFlush() const;
+    void markDirty(int16_t x, int16_t y, int16_t w, int16_t h);  // Screen coordinates
+    void markAllDirty();  // Use after drawing through getDisplayObject()
+    size_t getLastFlushBytes() const;  // Framebuffer bytes sent by the last flush
+    unsigned long getLastFlushTime() const;  // Duration of the last flush in microseconds
+    
+    // Frame pacing - flushes start at most max_fps times a second (0 = no limit).
+    // Without the flush task displayBuffer() waits out the rest of the interval.
+    void setMaxFrameRate(uint8_t max_fps);
+    uint8_t getMaxFrameRate() const;
+    
+    // Background flushing - a FreeRTOS task sends frames while the caller keeps
+    // drawing. displayBuffer() copies the framebuffer (the back buffer, which
+    // keeps its contents) into a flush slot and returns. With 2 buffers it
+    // first waits for the previous flush to finish; with 3 it never waits and
+    // a queued frame that has not started yet is replaced by the newer one.
+    bool startFlushTask(uint8_t buffers = 2, int core = SCREEN_FLUSH_CORE,
+                        uint32_t stack_size = SCREEN_FLUSH_STACK_SIZE,
+                        uint8_t task_priority = SCREEN_FLUSH_TASK_PRIORITY);
+    void stopFlushTask();  // Waits for pending frames, then flushes in displayBuffer() again
+    bool isFlushTaskRunning() const;
+    void waitForFlush();   // Until every presented frame is on the panel
+    uint32_t getFramesFlushed() const;
+    uint32_t getFramesReplaced() const;
+    
+    // Copy page-native data (one byte = 8 vertical pixels, LSB on top) straight
+    // into the framebuffer window and mark it dirty. Physical panel coordinates,
+    // independent of rotation; data holds page_count rows of col_count bytes.
+    bool writeFramebuffer(uint8_t page_start, uint8_t page_count, uint8_t col_start, uint8_t col_count,
+                          const uint8_t* data);
     void invertDisplay(bool invert);
     void dim(bool dimmed);
     
     // Screen operations
     void fillScreen(bool white = true);
     void setRotation(uint8_t rotation);  // 0, 1, 2, or 3
+    uint8_t getRotation() const;
     
     // Pixel operations
     void drawPixel(int16_t x, int16_t y, bool white = true);
@@ -71,6 +222,7 @@ public:
     void setTextColor(bool white, bool background = false);
     void setTextWrap(bool wrap);
     void print(const char* text);
+    void write(const char* text, size_t length);  // First length characters, no terminator needed
     void print(int value);
     void print(long value);
     void print(unsigned long value);
@@ -100,6 +252,10 @@ public:
     // Get display object for advanced operations
     Adafruit_SSD1306* getDisplayObject();
     
+    // Raw framebuffer for direct rasterizers (see FrameRaster); nullptr until
+    // begin() succeeds. Mark what you change with markDirty().
+    uint8_t* getFramebuffer();
+    
     // Screen dimensions
     int16_t getWidth() const;
     int16_t getHeight() const;
@@ -109,6 +265,12 @@ public:
     bool removeAsset(GraphicsAsset* asset);
     void clearAssets();
     void drawAssets();  // Draw all assets in z-index order
+    
+    // Retained mode - drawAssets() only repaints dirty assets and whatever
+    // overlaps them, so the caller must not clear the screen between frames
+    void setRetainedMode(bool enable);
+    bool getRetainedMode() const;
+    void invalidateAssets();  // Redraw every asset on the next drawAssets()
     int getAssetCount() const;
 };
 
@@ -0,0 +1,179 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <Arduino.h>
+#include <atomic>
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#endif
+
+// Build flag: 0 compiles every PROFILE_SCOPE out
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+
+// Zone table and histogram geometry. Bucket widths grow with the value:
+// PROFILER_SUB_BUCKETS per power of two of microseconds (about 19% wide),
+// up to 2^PROFILER_OCTAVES us (~8 s); longer samples land in the last bucket.
+#define PROFILER_MAX_ZONES 12
+#define PROFILER_SUB_BUCKETS 4
+#define PROFILER_OCTAVES 23
+#define PROFILER_BUCKETS (PROFILER_SUB_BUCKETS * (PROFILER_OCTAVES - 1))
+
+// Built-in zones; addZone() hands out the ids after these
+enum class ProfileZone : uint8_t {
+    DRAW_ASSETS,     // LedScreen128_64::drawAssets()
+    ASSET_DRAW,      // One asset's draw()/drawDamage()
+    DISPLAY_FLUSH,   // Framebuffer transfer to the panel
+    FRAME_INTERVAL,  // Time between presented frames
+    SENSOR_READ,     // Blocking SHT45 read, conversion included
+    COMMAND,         // One SerialLedControl command or binary frame
+    BUS_TRANSFER,    // One BusScheduler transaction
+    BUILTIN_COUNT
+};
+
+// Snapshot of one zone
+struct ProfileZoneStats {
+    const char* name;
+    uint32_t count;
+    float mean_us;
+    float min_us;
+    float max_us;
+    float p50_us;   // Percentiles are bucket midpoints, clamped to min/max
+    float p99_us;
+};
+
+// Heap and stack headroom (zeros where the platform cannot tell)
+struct ProfileHeapStats {
+    size_t free_bytes;
+    size_t min_free_bytes;      // Low-water mark since boot
+    size_t largest_block;
+    size_t psram_free_bytes;
+    size_t psram_min_free_bytes;
+    size_t stack_headroom;      // Unused stack of the calling task, in bytes
+};
+
+// Always-on timing of named code zones. Samples are cycle counts (ESP32
+// CCOUNT, micros() elsewhere) folded into per-zone log-linear histograms,
+// so recording costs a few dozen instructions and no allocation. Zones may
+// be recorded from any task; the fold is a short critical section.
+class Profiler {
+private:
+    // Private constructor for singleton
+    Profiler();
+
+    // Delete copy constructor and assignment operator
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    struct Zone {
+        const char* name;
+        uint32_t count;
+        uint64_t total_cycles;
+        uint32_t min_cycles;
+        uint32_t max_cycles;
+        uint32_t buckets[PROFILER_BUCKETS];
+    };
+    Zone zones[PROFILER_MAX_ZONES];
+    uint8_t zone_count;
+
+    std::atomic<bool> enabled;
+    uint32_t cycles_per_us;
+
+    // Window for bus utilization: reset() restarts it
+    unsigned long window_start_us;
+    uint64_t window_bus_busy_us;
+
+    // Last presented frame, for FRAME_INTERVAL
+    uint32_t last_frame_cycles;
+    bool frame_seen;
+
+#if defined(ESP32)
+    portMUX_TYPE lock;
+#endif
+
+    static uint8_t bucketOf(uint32_t us);
+    static float bucketMid(uint8_t bucket);
+    float percentile(const Zone& zone, float fraction) const;
+
+public:
+    // Get singleton instance
+    static Profiler& getInstance();
+
+    // Runtime switch; scopes cost one load while disabled
+    void setEnabled(bool enable);
+    bool isEnabled() const;
+
+    // Register a zone of your own; returns its id, or 0xFF when the table is full
+    uint8_t addZone(const char* name);
+    uint8_t getZoneCount() const;
+
+    // Raw cycle counter, and cycles to microseconds at the current CPU clock
+    static inline uint32_t cycles() {
+#if defined(ESP32)
+        return ESP.getCycleCount();
+#else
+        return (uint32_t)micros();
+#endif
+    }
+    float cyclesToMicros(uint32_t cycles) const;
+
+    // Add one sample of elapsed cycles to a zone
+    void record(uint8_t zone, uint32_t elapsed_cycles);
+    void record(ProfileZone zone, uint32_t elapsed_cycles) { record((uint8_t)zone, elapsed_cycles); }
+
+    // Called per presented frame; records FRAME_INTERVAL from the previous one
+    void markFrame();
+
+    // Zone snapshot; false for an unknown zone
+    bool getZoneStats(uint8_t zone, ProfileZoneStats& stats) const;
+
+    // Share of time the bus was busy since reset(), 0..1
+    float getBusUtilization() const;
+    unsigned long getWindowTime() const;  // Microseconds since reset()
+
+    static ProfileHeapStats getHeapStats();
+
+    // Clear every zone and restart the utilization window
+    void reset();
+
+    // Zone table, bus, queue and heap summary as text
+    void printReport(Print& out) const;
+};
+
+// Times the enclosing block into a zone
+class ProfileScope {
+private:
+    uint8_t zone;
+    uint32_t start;
+    bool active;
+
+public:
+    explicit ProfileScope(uint8_t zone_id)
+        : zone(zone_id), start(0), active(Profiler::getInstance().isEnabled()) {
+        if (active) {
+            start = Profiler::cycles();
+        }
+    }
+    explicit ProfileScope(ProfileZone zone_id) : ProfileScope((uint8_t)zone_id) {}
+
+    ~ProfileScope() {
+        if (active) {
+            Profiler::getInstance().record(zone, Profiler::cycles() - start);
+        }
+    }
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if PROFILER_ENABLED
+#define PROFILE_SCOPE(zone) ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)(zone)
+#define PROFILE_FRAME() Profiler::getInstance().markFrame()
+#else
+#define PROFILE_SCOPE(zone) do { } while (0)
+#define PROFILE_FRAME() do { } while (0)
+#endif
+
+#endif // PROFILER_HPP
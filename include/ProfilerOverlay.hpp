@@ -0,0 +1,39 @@
+#ifndef PROFILER_OVERLAY_HPP
+#define PROFILER_OVERLAY_HPP
+
+#include "GraphicsAsset.hpp"
+#include "LedScreen128_64.hpp"
+#include <Arduino.h>
+
+// Characters per line; the default size fits two lines of the 6x8 font
+#define PROFILER_OVERLAY_CHARS 21
+#define PROFILER_OVERLAY_LINES 2
+
+// On-screen Profiler readout: frame rate and median flush time on the first
+// line, bus utilization and free heap on the second. draw() always shows
+// current figures; in retained mode call update() once per frame before
+// drawAssets() so the overlay is only repainted when its text changes.
+class ProfilerOverlay : public GraphicsAsset {
+private:
+    char lines[PROFILER_OVERLAY_LINES][PROFILER_OVERLAY_CHARS + 1];
+
+    void formatLines(char (&out)[PROFILER_OVERLAY_LINES][PROFILER_OVERLAY_CHARS + 1]) const;
+
+public:
+    // Constructor
+    ProfilerOverlay(int16_t x = 0, int16_t y = 0, int16_t width = 128, int16_t height = 18);
+
+    // Destructor
+    virtual ~ProfilerOverlay();
+
+    // Draw method implementation
+    void draw(LedScreen128_64* screen) override;
+
+    // Re-format the figures; marks the asset dirty and returns true when the text changed
+    bool update();
+
+    // Current text of one line
+    const char* getLine(uint8_t line) const;
+};
+
+#endif // PROFILER_OVERLAY_HPP
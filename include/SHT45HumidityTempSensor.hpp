@@ -30,6 +30,34 @@ private:
     // Reading validity check
     static const unsigned long READ_TIMEOUT = 5000; // 5 seconds timeout
     
+    // Measurement settings, mirrored so the async path can pick the command
+    sht4x_precision_t precision_mode;
+    sht4x_heater_t heater_mode;
+    
+    // Asynchronous measurement state
+    bool measurement_pending;             // Command sent, result not fetched yet
+    unsigned long measurement_start;      // micros() when the command was sent
+    unsigned long measurement_duration;   // Conversion time in us for that command
+    
+    /**
+     * @brief Select the measurement command and its conversion time
+     * @param duration_ms Receives the time to wait before reading the result
+     * @return SHT4x command byte for the current precision and heater settings
+     */
+    uint8_t measurementCommand(unsigned long& duration_ms) const;
+    
+    /**
+     * @brief Block until a pending measurement completes and fetch it
+     * 
+     * Used by the blocking calls so they never talk to the sensor mid-conversion.
+     */
+    void finishPendingMeasurement();
+    
+    /**
+     * @brief CRC-8 used by the SHT4x (polynomial 0x31, init 0xFF)
+     */
+    static uint8_t crc8(const uint8_t* data, size_t length);
+    
 public:
     /**
      * @brief Constructor for SHT45HumidityTempSensor
@@ -54,6 +82,23 @@ public:
      */
     bool begin() override;
     
+    /**
+     * @brief First half of begin(): set up the sensor and start a measurement
+     * @return true if the sensor answered and accepted the command
+     * 
+     * Lets DeviceRegistry::beginAll() initialize other devices (e.g. the
+     * display) during the conversion instead of waiting for it.
+     */
+    bool startBegin() override;
+    
+    /**
+     * @brief Second half of begin(): collect the first measurement
+     * @return true if the reading was valid, false otherwise
+     * 
+     * Waits only for whatever part of the conversion time is left.
+     */
+    bool finishBegin() override;
+    
     /**
      * @brief Set the precision mode of the sensor
      * @param precision Precision mode (SHT4X_HIGH_PRECISION, SHT4X_MED_PRECISION, SHT4X_LOW_PRECISION)
@@ -65,6 +110,12 @@ public:
      */
     void setPrecision(sht4x_precision_t precision);
     
+    /**
+     * @brief Get the current precision mode
+     * @return The precision used by the next measurement
+     */
+    sht4x_precision_t getPrecision() const;
+    
     /**
      * @brief Enable or disable the built-in heater
      * @param duration Heater duration (SHT4X_NO_HEATER, SHT4X_HIGH_HEATER_1S, etc.)
@@ -80,9 +131,43 @@ public:
      * 
      * This method queries the sensor and updates the internal cached values.
      * Use getTemperature() and getHumidity() to retrieve the values.
+     * Blocks for the conversion time; see startMeasurement() for the
+     * non-blocking alternative.
      */
     bool readSensor();
     
+    /**
+     * @brief Send a measurement command without waiting for the result
+     * @return true if the command was accepted, false otherwise
+     * 
+     * Uses the current precision and heater settings. The conversion takes
+     * 2-10ms (1.1s with a 1s heater pulse). Call isMeasurementReady() and
+     * then fetchResult() from loop() to collect it.
+     */
+    bool startMeasurement();
+    
+    /**
+     * @brief Check if a measurement is in progress
+     * @return true between startMeasurement() and fetchResult()
+     */
+    bool isMeasurementPending() const;
+    
+    /**
+     * @brief Check if the pending measurement's conversion time has elapsed
+     * @return true if fetchResult() can be called, false otherwise
+     */
+    bool isMeasurementReady() const;
+    
+    /**
+     * @brief Read the 6-byte result of a finished measurement
+     * @return true if the result passed its CRC checks, false otherwise
+     * 
+     * Updates the cached temperature and humidity on success. The pending
+     * state is cleared either way. Returns false if called before
+     * isMeasurementReady().
+     */
+    bool fetchResult();
+    
     /**
      * @brief Get the most recent temperature reading
      * @return Temperature in degrees Celsius
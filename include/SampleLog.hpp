@@ -0,0 +1,141 @@
+#ifndef SAMPLE_LOG_HPP
+#define SAMPLE_LOG_HPP
+
+#include <Arduino.h>
+#include <FS.h>
+#include "DataPlot.hpp"
+
+// Log geometry: SAMPLE_LOG_BLOCKS blocks of SAMPLE_LOG_BLOCK_SIZE bytes in
+// one file, reused oldest-first once the ring is full
+#define SAMPLE_LOG_BLOCK_SIZE 256
+#define SAMPLE_LOG_BLOCKS 1024
+#define SAMPLE_LOG_MAX_CHANNELS 4
+#define SAMPLE_LOG_PATH "/samples.log"
+
+// Defaults
+#define SAMPLE_LOG_RESOLUTION 0.01f       // Quantization step, in channel units
+#define SAMPLE_LOG_COMMIT_INTERVAL 300    // Seconds between writes of the open block
+
+// Called once per stored sample, oldest first; values has one entry per channel
+typedef void (*SampleLogVisitor)(uint32_t time_s, const float* values, void* context);
+
+// Append-only ring log of timestamped multi-channel samples (e.g. SHT45
+// temperature and humidity means) for LittleFS or any other fs::FS.
+//
+// Samples are quantized to int16 steps of each channel's resolution and
+// stored as zigzag varint deltas (time and values) inside fixed-size blocks.
+// Every block header carries its time span, per-channel min/max and a CRC,
+// and a RAM index of the block time spans lets range queries seek straight
+// to the first block of interest. The newest block is built in RAM and
+// written when it fills up or every commit interval, so flash sees one block
+// write per interval rather than one per sample. Blocks are rewritten in
+// place round-robin, which spreads wear evenly over the file.
+class SampleLog {
+private:
+    uint8_t channel_count;
+    uint16_t block_capacity;               // Blocks in the ring
+    float resolution[SAMPLE_LOG_MAX_CHANNELS];
+    uint32_t commit_interval_s;
+
+    fs::FS* fs;
+    const char* path;
+    fs::File file;
+    bool opened;
+
+    // Time span of every stored block, indexed by ring slot
+    struct BlockSpan {
+        uint32_t sequence;
+        uint32_t start_s;
+        uint32_t end_s;
+    };
+    BlockSpan* index;
+    uint32_t newest_sequence;              // Sequence number of the open block
+    uint16_t stored_blocks;                // Including the open block once it has samples
+
+    // The open block and the encoder state at its end
+    uint8_t block[SAMPLE_LOG_BLOCK_SIZE];
+    uint16_t block_used;
+    uint16_t block_count;
+    uint32_t last_time_s;
+    int16_t last_value[SAMPLE_LOG_MAX_CHANNELS];
+    bool block_dirty;
+    unsigned long last_commit_ms;
+
+    // Clock: seconds since an arbitrary epoch, continued across reboots
+    uint32_t clock_offset_s;
+
+    uint32_t total_samples;
+    uint32_t commit_count;
+
+    // Block layout helpers
+    static uint16_t checksum(const uint8_t* data, size_t length);
+    uint16_t headerSize() const;
+    void startBlock(uint32_t sequence);
+    bool writeBlock();
+    bool readBlock(uint16_t slot, uint8_t* out, size_t length = SAMPLE_LOG_BLOCK_SIZE);
+    bool validHeader(const uint8_t* data, uint32_t& sequence) const;
+    bool validBlock(const uint8_t* data, uint32_t& sequence) const;
+    bool encodeSample(uint32_t time_s, const int16_t* values);
+
+    // Ring order: 0 = oldest stored block
+    uint16_t slotAt(uint16_t position) const;
+    uint16_t findFirstBlock(uint32_t from_s) const;
+    size_t decodeBlock(const uint8_t* data, uint32_t from_s, uint32_t to_s,
+                       SampleLogVisitor visitor, void* context);
+
+    int16_t quantize(uint8_t channel, float value) const;
+
+public:
+    // Constructor - channels is clamped to SAMPLE_LOG_MAX_CHANNELS
+    SampleLog(uint8_t channels, uint16_t blocks = SAMPLE_LOG_BLOCKS);
+
+    // Destructor - commits and closes the log
+    ~SampleLog();
+
+    // Quantization step of one channel (before begin(); stored data is
+    // read back with the current steps)
+    void setResolution(uint8_t channel, float step);
+    float getResolution(uint8_t channel) const;
+    void setCommitInterval(uint32_t interval_s);  // 0 = write on every sample
+
+    // Open (or create) the log file and rebuild the index from the block
+    // headers; only the newest block is read whole. The filesystem must
+    // already be mounted.
+    bool begin(fs::FS& filesystem, const char* file_path = SAMPLE_LOG_PATH);
+    void end();
+    bool isOpen() const;
+
+    // Append one sample, stamped with now() or with time_s. Times earlier
+    // than the newest stored sample are stored as that sample's time.
+    bool append(const float* values);
+    bool append(const float* values, uint32_t time_s);
+
+    // Write the open block now (also done when it fills up)
+    bool commit();
+
+    // Log clock. Without a time source it continues from the newest stored
+    // sample after a reboot; setClock() aligns it with real time (e.g. NTP).
+    uint32_t now() const;
+    void setClock(uint32_t now_s);
+
+    // Visit every sample with from_s <= time <= to_s; returns the number visited
+    size_t query(uint32_t from_s, uint32_t to_s, SampleLogVisitor visitor, void* context = nullptr);
+
+    // Min/max of one channel over a time range. Blocks entirely inside the
+    // range are answered from their headers; only the edge blocks are decoded.
+    bool getExtrema(uint32_t from_s, uint32_t to_s, uint8_t channel, float& min_value, float& max_value);
+
+    // Replace the plot's data with the last window_s seconds of one channel,
+    // averaged down to at most the plot's capacity; returns the points added
+    int loadPlot(DataPlot* plot, uint8_t channel, uint32_t window_s);
+
+    // Statistics
+    uint8_t getChannelCount() const;
+    uint16_t getBlockCapacity() const;
+    uint16_t getStoredBlocks() const;
+    uint32_t getSampleCount() const;      // Appended since begin()
+    uint32_t getCommitCount() const;      // Block writes since begin()
+    bool getTimeSpan(uint32_t& oldest_s, uint32_t& newest_s) const;
+};
+
+#endif // SAMPLE_LOG_HPP
@@ -0,0 +1,181 @@
+#ifndef SENSOR_PIPELINE_HPP
+#define SENSOR_PIPELINE_HPP
+
+#include <Arduino.h>
+#include <atomic>
+#include "FilterStage.hpp"
+#include "AdaptiveSamplingPolicy.hpp"
+#include "DataPlot.hpp"
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <esp_sleep.h>
+#define SENSOR_PIPELINE_RTOS 1
+#else
+#define SENSOR_PIPELINE_RTOS 0
+#endif
+
+// Pipeline limits
+#define SENSOR_PIPELINE_MAX_CHANNELS 4
+#define SENSOR_PIPELINE_MAX_STAGES 4   // Per channel
+#define SENSOR_PIPELINE_RING_SIZE 32   // Power of two
+#define SENSOR_PIPELINE_MAX_BINDINGS 4 // Plots per channel and tier
+
+// Sampler task defaults
+#define SENSOR_PIPELINE_STACK_SIZE 4096
+#define SENSOR_PIPELINE_TASK_PRIORITY 3
+#define SENSOR_PIPELINE_CORE 1
+
+// Downsampled output tiers (bucket means)
+enum class SensorTier : uint8_t {
+    SECOND = 0,  // 1 s buckets
+    MINUTE = 1,  // 1 min buckets
+    HOUR = 2     // 1 h buckets
+};
+
+#define SENSOR_TIER_COUNT 3
+
+// One timestamped reading of every channel
+struct SensorSample {
+    uint32_t timestamp_ms;
+    float values[SENSOR_PIPELINE_MAX_CHANNELS];
+};
+
+// Reads one sample of every channel into values; false when the read failed
+typedef bool (*SampleSource)(float* values, void* context);
+
+// Sampler -> filter stages -> tiered bucket means -> bound plots.
+//
+// The producer side (sample(), normally run by the sampler task) pushes
+// timestamped raw samples into a lock-free single-producer/single-consumer
+// ring. The consumer side (process(), called from loop()) drains it, runs
+// each channel's stage chain and folds the filtered value into the 1 s /
+// 1 min / 1 h buckets. A DataPlot bound to a tier receives one addValue()
+// per completed bucket, so plots never copy individual samples.
+class SensorPipeline {
+private:
+    uint8_t channel_count;
+    SampleSource source;
+    void* source_context;
+    uint32_t sample_period_ms;
+    std::atomic<uint32_t> last_sample_ms;
+    bool started;
+    AdaptiveSamplingPolicy* policy;  // Optional, overrides sample_period_ms
+
+    // SPSC ring: only sample() writes head, only process() writes tail
+    SensorSample ring[SENSOR_PIPELINE_RING_SIZE];
+    std::atomic<uint16_t> ring_head;
+    std::atomic<uint16_t> ring_tail;
+    std::atomic<uint32_t> dropped_samples;
+    std::atomic<uint32_t> failed_samples;
+
+    // Per-channel stage chains (stages are owned by the caller)
+    FilterStage* stages[SENSOR_PIPELINE_MAX_CHANNELS][SENSOR_PIPELINE_MAX_STAGES];
+    uint8_t stage_count[SENSOR_PIPELINE_MAX_CHANNELS];
+
+    // Latest values on the consumer side
+    SensorSample latest_raw;
+    SensorSample latest_filtered;
+    bool has_latest;
+
+    // Tier buckets
+    struct TierState {
+        uint32_t interval_ms;
+        uint32_t bucket_start;
+        bool bucket_open;
+        uint16_t count;
+        float sum[SENSOR_PIPELINE_MAX_CHANNELS];
+        float last_mean[SENSOR_PIPELINE_MAX_CHANNELS];
+        bool has_value;
+        bool updated;  // Cleared by takeTierUpdate()
+        DataPlot* plots[SENSOR_PIPELINE_MAX_CHANNELS][SENSOR_PIPELINE_MAX_BINDINGS];
+        uint8_t plot_count[SENSOR_PIPELINE_MAX_CHANNELS];
+    };
+    TierState tiers[SENSOR_TIER_COUNT];
+
+#if SENSOR_PIPELINE_RTOS
+    TaskHandle_t task_handle;
+    SemaphoreHandle_t source_mutex;  // Held around every source read
+
+    static void taskEntry(void* param);
+#endif
+
+    void processSample(const SensorSample& sample);
+    void foldIntoTier(TierState& tier, const SensorSample& filtered);
+
+public:
+    // Constructor - channels is clamped to SENSOR_PIPELINE_MAX_CHANNELS
+    SensorPipeline(uint8_t channels, SampleSource source, void* context = nullptr);
+
+    // Destructor
+    ~SensorPipeline();
+
+    // Start sampling every period_ms. With use_task a dedicated FreeRTOS task
+    // runs the sampler; otherwise (or without FreeRTOS) run() samples when due.
+    bool begin(uint32_t period_ms, bool use_task = true,
+               int core = SENSOR_PIPELINE_CORE,
+               uint32_t stack_size = SENSOR_PIPELINE_STACK_SIZE,
+               uint8_t task_priority = SENSOR_PIPELINE_TASK_PRIORITY);
+    bool isTaskRunning() const;
+
+    // Producer side: read the source once and queue the sample
+    bool sample();
+
+    // Producer side: queue an externally obtained sample (e.g. from a timer task)
+    bool pushSample(const float* values, uint32_t timestamp_ms);
+
+    // Consumer side: drain queued samples through stages and tiers;
+    // returns the number of samples processed
+    size_t process();
+
+    // Call from loop(): samples when due (no task) and then process()es
+    size_t run();
+
+    // Adaptive scheduling: the policy sees every filtered sample and sets the
+    // sampling period (and the effort the source should read with)
+    void setAdaptivePolicy(AdaptiveSamplingPolicy* policy);
+    AdaptiveSamplingPolicy* getAdaptivePolicy() const;
+    uint32_t getSamplePeriod() const;  // Currently effective period
+
+    // Milliseconds until the next sample is due (0 = due now)
+    uint32_t getTimeUntilNextSample() const;
+
+    // Enter ESP32 light sleep until the next sample is due, if that is at
+    // least min_sleep_ms away and nothing is waiting to be processed. Light
+    // sleep pauses both cores and USB serial; returns true if it slept.
+    bool sleepUntilNextSample(uint32_t min_sleep_ms = 20);
+
+    // Keep the sampler off the source while the caller uses it directly
+    // (e.g. to reset the sensor); blocks until an in-flight read finishes
+    void suspendSampling();
+    void resumeSampling();
+
+    // Stage chains, applied in the order they were added
+    bool addStage(uint8_t channel, FilterStage* stage);
+    void clearStages(uint8_t channel);
+    void resetStages();
+
+    // Tiers
+    bool bindPlot(uint8_t channel, SensorTier tier, DataPlot* plot);
+    void unbindPlots(SensorTier tier);
+    void setTierInterval(SensorTier tier, uint32_t interval_ms);
+    uint32_t getTierInterval(SensorTier tier) const;
+    bool getTierValue(uint8_t channel, SensorTier tier, float& value) const;
+    bool takeTierUpdate(SensorTier tier);  // True once per completed bucket
+
+    // Latest processed values
+    bool hasData() const;
+    float getLatest(uint8_t channel) const;     // After the stage chain
+    float getLatestRaw(uint8_t channel) const;  // Straight from the source
+    uint32_t getLatestTimestamp() const;
+
+    // Statistics
+    uint8_t getChannelCount() const;
+    size_t getQueuedCount() const;
+    uint32_t getDroppedCount() const;  // Ring was full
+    uint32_t getFailedCount() const;   // Source read failed
+};
+
+#endif // SENSOR_PIPELINE_HPP
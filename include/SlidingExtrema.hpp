@@ -0,0 +1,43 @@
+#ifndef SLIDING_EXTREMA_HPP
+#define SLIDING_EXTREMA_HPP
+
+#include <Arduino.h>
+
+// Slots are stored as 16-bit ring indices
+#define SLIDING_EXTREMA_MAX_CAPACITY 65535
+
+// Running min/max over a sliding window of values kept in someone else's
+// ring buffer. Two monotonic queues of ring slots give O(1) amortised push,
+// O(1) eviction of the oldest value and O(1) getMin()/getMax().
+class SlidingExtrema {
+private:
+    const float* values;  // Owner's ring storage, indexed by slot
+    int capacity;         // Owner's ring capacity
+    uint16_t* minQueue;   // Slots with non-decreasing values, oldest first
+    uint16_t* maxQueue;   // Slots with non-increasing values, oldest first
+    int minHead, minCount;
+    int maxHead, maxCount;
+    
+public:
+    // Constructor - values must stay valid for the lifetime of this object
+    SlidingExtrema(const float* values, int capacity);
+    
+    // Destructor
+    ~SlidingExtrema();
+    
+    // Forget every value
+    void clear();
+    
+    // Call after writing a new newest value into values[slot]
+    void push(int slot);
+    
+    // Call before the oldest value (at values[slot]) is dropped or overwritten
+    void evict(int slot);
+    
+    // Extremes of the values currently in the window
+    bool isEmpty() const;
+    float getMin() const;
+    float getMax() const;
+};
+
+#endif // SLIDING_EXTREMA_HPP
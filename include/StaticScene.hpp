@@ -0,0 +1,180 @@
+#ifndef STATIC_SCENE_HPP
+#define STATIC_SCENE_HPP
+
+#include <Arduino.h>
+#include <stddef.h>
+#include <tuple>
+#include <type_traits>
+#include "LedScreen128_64.hpp"
+#include "FrameRaster.hpp"
+#include "GraphicsAsset.hpp"
+#include "Geometry.hpp"
+#include "Bitmap.hpp"
+
+// How a StaticScene draws one asset type. The default makes a qualified call
+// to T::draw(), so the compiler binds it statically instead of going through
+// the vtable; specialisations below skip the LedScreen128_64 wrappers and
+// rasterize straight into the framebuffer.
+template <typename T>
+struct AssetRenderer {
+    template <uint8_t Rotation>
+    static inline void draw(T& asset, LedScreen128_64& screen, FrameRaster<Rotation>&) {
+        asset.T::draw(&screen);
+    }
+};
+
+template <>
+struct AssetRenderer<Geometry> {
+    template <uint8_t Rotation>
+    static inline void draw(Geometry& shape, LedScreen128_64&, FrameRaster<Rotation>& raster) {
+        int16_t x = shape.getX();
+        int16_t y = shape.getY();
+        int16_t w = shape.getWidth();
+        int16_t h = shape.getHeight();
+        bool filled = shape.isFilled();
+
+        switch (shape.getShape()) {
+            case GeometryShape::RECTANGLE:
+                if (filled) {
+                    raster.fillRect(x, y, w, h);
+                } else {
+                    raster.drawRect(x, y, w, h);
+                }
+                break;
+
+            case GeometryShape::ROUNDED_RECTANGLE:
+                if (filled) {
+                    raster.fillRoundRect(x, y, w, h, shape.getRadius());
+                } else {
+                    raster.drawRoundRect(x, y, w, h, shape.getRadius());
+                }
+                break;
+
+            case GeometryShape::CIRCLE:
+                if (filled) {
+                    raster.fillCircle(x, y, shape.getRadius());
+                } else {
+                    raster.drawCircle(x, y, shape.getRadius());
+                }
+                break;
+
+            case GeometryShape::LINE: {
+                int16_t x0, y0, x1, y1;
+                shape.getLinePoints(x0, y0, x1, y1);
+                raster.line(x0, y0, x1, y1);
+                return;
+            }
+
+            case GeometryShape::TRIANGLE: {
+                int16_t x0, y0, x1, y1, x2, y2;
+                shape.getTrianglePoints(x0, y0, x1, y1, x2, y2);
+                if (filled) {
+                    raster.fillTriangle(x0, y0, x1, y1, x2, y2);
+                } else {
+                    raster.drawTriangle(x0, y0, x1, y1, x2, y2);
+                }
+                return;
+            }
+        }
+
+        // Same border rules as Geometry::draw()
+        if (shape.hasBorder()) {
+            if (shape.getShape() == GeometryShape::CIRCLE) {
+                raster.drawCircle(x, y, shape.getRadius() + 1);
+            } else {
+                raster.drawRect(x - 1, y - 1, w + 2, h + 2);
+            }
+        }
+    }
+};
+
+template <>
+struct AssetRenderer<Bitmap> {
+    template <uint8_t Rotation>
+    static inline void draw(Bitmap& image, LedScreen128_64&, FrameRaster<Rotation>& raster) {
+        if (image.getBitmapData() == nullptr) {
+            return;
+        }
+        if (image.hasBorder()) {
+            raster.drawRect(image.getX(), image.getY(), image.getWidth(), image.getHeight());
+        }
+        image.rasterize(raster);
+    }
+};
+
+// A fixed set of assets whose types are known at compile time. The assets
+// live inside the scene (default-constructed; configure them through get<I>())
+// and draw() renders them in declaration order - the later type is on top -
+// with every call resolved statically, so the whole loop can be inlined.
+// Use with an immediate-mode loop: clearDisplay(), scene.draw(), displayBuffer().
+// Assets here are not registered with the screen and ignore z-index.
+template <typename... Assets>
+class StaticScene {
+private:
+    std::tuple<Assets...> assets;
+
+    template <uint8_t Rotation, size_t I>
+    inline typename std::enable_if<(I == sizeof...(Assets))>::type
+    drawFrom(LedScreen128_64&, FrameRaster<Rotation>&) {
+    }
+
+    template <uint8_t Rotation, size_t I>
+    inline typename std::enable_if<(I < sizeof...(Assets))>::type
+    drawFrom(LedScreen128_64& screen, FrameRaster<Rotation>& raster) {
+        typedef typename std::tuple_element<I, std::tuple<Assets...> >::type Asset;
+        Asset& asset = std::get<I>(assets);
+        asset.clearDirty();
+        if (asset.isVisible()) {
+            AssetRenderer<Asset>::draw(asset, screen, raster);
+            // Raster writes bypass the screen's dirty tracking
+            int16_t bx, by, bw, bh;
+            asset.getBounds(bx, by, bw, bh);
+            screen.markDirty(bx, by, bw, bh);
+        }
+        drawFrom<Rotation, I + 1>(screen, raster);
+    }
+
+    template <uint8_t Rotation>
+    void render(LedScreen128_64& screen, uint8_t* framebuffer) {
+        FrameRaster<Rotation> raster(framebuffer);
+        drawFrom<Rotation, 0>(screen, raster);
+    }
+
+public:
+    StaticScene() {}
+
+    // Assets own buffers, so scenes are not copyable
+    StaticScene(const StaticScene&) = delete;
+    StaticScene& operator=(const StaticScene&) = delete;
+
+    template <size_t I>
+    typename std::tuple_element<I, std::tuple<Assets...> >::type& get() {
+        return std::get<I>(assets);
+    }
+
+    static constexpr size_t size() { return sizeof...(Assets); }
+
+    // One rotation switch per frame, then a specialised loop per rotation
+    void draw(LedScreen128_64& screen) {
+        uint8_t* framebuffer = screen.getFramebuffer();
+        if (framebuffer == nullptr) {
+            return;
+        }
+        switch (screen.getRotation()) {
+            case 1:
+                render<1>(screen, framebuffer);
+                break;
+            case 2:
+                render<2>(screen, framebuffer);
+                break;
+            case 3:
+                render<3>(screen, framebuffer);
+                break;
+            default:
+                render<0>(screen, framebuffer);
+                break;
+        }
+    }
+};
+
+#endif // STATIC_SCENE_HPP
@@ -5,9 +5,33 @@
 #include "LedScreen128_64.hpp"
 #include <Arduino.h>
 
+// Bytes of text kept per cell, terminator included; longer text is cut short
+#define TABLE_CELL_TEXT 24
+
 class Table : public GraphicsAsset {
 private:
-    String* cells;          // Cell data stored as 1D array (row-major order)
+    enum CellKind : uint8_t {
+        CELL_EMPTY,
+        CELL_TEXT,
+        CELL_INT,
+        CELL_FLOAT
+    };
+    
+    // Numbers are kept as raw values and only formatted into the cell's text
+    // slot when the cell is drawn after a change
+    struct Cell {
+        union {
+            int32_t i;
+            float f;
+        } value;
+        uint8_t kind;       // CellKind
+        uint8_t decimals;   // CELL_FLOAT precision
+        bool formatted;     // Text slot matches the numeric value
+        bool dirty;         // Changed since the last draw
+    };
+    
+    Cell* cells;            // Cell metadata stored as 1D array (row-major order)
+    char* cellText;         // TABLE_CELL_TEXT bytes per cell, same order
     int rows;               // Number of rows
     int cols;               // Number of columns
     int* colWidths;         // Width of each column in pixels
@@ -20,6 +44,11 @@ private:
     // Helper methods
     int getCellIndex(int row, int col) const;
     void calculateColumnWidths();
+    int16_t getRowPixels(int row) const;
+    void storeText(int index, const char* text, size_t length);
+    void touchCell(int index);
+    const char* getCellText(int index);
+    void drawTable(LedScreen128_64* screen, const ScreenRect* clip);
     void drawCell(LedScreen128_64* screen, int row, int col, int16_t cellX, int16_t cellY, int16_t cellW, int16_t cellH);
     
 public:
@@ -33,6 +62,12 @@ public:
     // Draw method implementation
     void draw(LedScreen128_64* screen) override;
     
+    // Partial repaint - in retained mode a cell change only repaints the block
+    // of cells spanning the changed ones; setting a cell to the value it
+    // already holds does not mark the table dirty at all
+    bool getDamage(int16_t& dx, int16_t& dy, int16_t& dw, int16_t& dh) const override;
+    void drawDamage(LedScreen128_64* screen) override;
+    
     // Cell content management
     void setCell(int row, int col, const char* text);
     void setCell(int row, int col, const String& text);
@@ -5,6 +5,9 @@
 #include "LedScreen128_64.hpp"
 #include <Arduino.h>
 
+// Wrapped lines kept in the layout; lines past this are not drawn
+#define TEXTBOX_MAX_LINES 16
+
 // Text alignment options
 enum class TextAlign {
     LEFT,
@@ -21,6 +24,26 @@ private:
     bool fillBackground;
     int animationFrame;  // Current animation frame (character count for typewriter effect)
     
+    // Wrapped layout - line spans over text, reused until the text, size,
+    // alignment, wrapping or width change
+    struct LineSpan {
+        uint16_t offset;  // First character in text
+        uint16_t length;
+        int16_t xOffset;  // Line start relative to x
+    };
+    mutable LineSpan lines[TEXTBOX_MAX_LINES];
+    mutable uint8_t lineSpans;   // Spans stored in lines
+    mutable int lineCount;       // All lines, including those past TEXTBOX_MAX_LINES
+    mutable bool layoutValid;
+    mutable int16_t layoutWidth;
+    mutable uint8_t layoutTextSize;
+    mutable TextAlign layoutAlignment;
+    mutable bool layoutWrap;
+    
+    // Helper methods
+    void updateLayout() const;
+    void addLine(uint16_t offset, uint16_t length) const;
+    
 public:
     // Constructor
     TextBox(int16_t x = 0, int16_t y = 0, int16_t width = 60, int16_t height = 10,
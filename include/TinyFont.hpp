@@ -0,0 +1,28 @@
+#ifndef TINY_FONT_HPP
+#define TINY_FONT_HPP
+
+#include <Arduino.h>
+#include "LedScreen128_64.hpp"
+
+// Glyph cell of the tiny font; characters advance by width + 1 at scale 1
+#define TINY_FONT_WIDTH 3
+#define TINY_FONT_HEIGHT 5
+#define TINY_FONT_ADVANCE 4
+
+// Tiny 3x5 font for plot axis labels: digits, '-', '.', '%', 'C', 'T' and
+// 'H' (either case). Other characters draw as blanks but still advance the
+// cursor. Glyphs are stored as SSD1306 column bytes and blitted straight into
+// the framebuffer.
+class TinyFont {
+public:
+    // Draw text with its top-left corner at x/y and mark the covered area dirty
+    static void drawText(LedScreen128_64* screen, int16_t x, int16_t y, const char* text, uint8_t scale = 1);
+
+    static int16_t textWidth(const char* text, uint8_t scale = 1);
+    static bool hasGlyph(char c);
+
+    // Column bytes (bit 0 = top row) of a glyph; nullptr if there is none
+    static const uint8_t* glyphColumns(char c);
+};
+
+#endif // TINY_FONT_HPP
@@ -0,0 +1,181 @@
+#ifndef NATIVE_MOCKS_ADAFRUIT_GFX_H
+#define NATIVE_MOCKS_ADAFRUIT_GFX_H
+
+#include <Arduino.h>
+
+// Adafruit_GFX with every primitive reduced to drawPixel(), so pixel writes
+// can be counted in one place. Shapes follow the library's algorithms where
+// the firmware depends on them (lines, rects, bitmaps, the text cursor);
+// circles, triangles and glyphs are cheaper stand-ins with similar coverage.
+// Use the real library wherever exact pixels matter (test_frame_raster).
+class Adafruit_GFX : public Print {
+protected:
+    int16_t WIDTH, HEIGHT;
+    int16_t _width, _height;
+    int16_t cursor_x, cursor_y;
+    uint16_t textcolor, textbgcolor;
+    uint8_t textsize, rotation;
+    bool wrap;
+
+public:
+    Adafruit_GFX(int16_t w, int16_t h)
+        : WIDTH(w), HEIGHT(h), _width(w), _height(h), cursor_x(0), cursor_y(0),
+          textcolor(1), textbgcolor(1), textsize(1), rotation(0), wrap(true) {}
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+    virtual void startWrite() {}
+    virtual void endWrite() {}
+    virtual void writePixel(int16_t x, int16_t y, uint16_t color) { drawPixel(x, y, color); }
+    virtual void invertDisplay(bool invert) { (void)invert; }
+
+    virtual void setRotation(uint8_t r) {
+        rotation = r & 3;
+        _width = (rotation & 1) ? HEIGHT : WIDTH;
+        _height = (rotation & 1) ? WIDTH : HEIGHT;
+    }
+
+    virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+        for (int16_t i = 0; i < h; i++) drawPixel(x, y + i, color);
+    }
+    virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+        for (int16_t i = 0; i < w; i++) drawPixel(x + i, y, color);
+    }
+    virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+        for (int16_t i = x; i < x + w; i++) drawFastVLine(i, y, h, color);
+    }
+    virtual void fillScreen(uint16_t color) { fillRect(0, 0, _width, _height, color); }
+
+    virtual void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+        if (x0 == x1) {
+            if (y0 > y1) std::swap(y0, y1);
+            drawFastVLine(x0, y0, y1 - y0 + 1, color);
+        } else if (y0 == y1) {
+            if (x0 > x1) std::swap(x0, x1);
+            drawFastHLine(x0, y0, x1 - x0 + 1, color);
+        } else {
+            writeLine(x0, y0, x1, y1, color);
+        }
+    }
+
+    // Bresenham, as in the library
+    void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+        bool steep = abs(y1 - y0) > abs(x1 - x0);
+        if (steep) {
+            std::swap(x0, y0);
+            std::swap(x1, y1);
+        }
+        if (x0 > x1) {
+            std::swap(x0, x1);
+            std::swap(y0, y1);
+        }
+        int16_t dx = x1 - x0, dy = abs(y1 - y0);
+        int16_t err = dx / 2, ystep = y0 < y1 ? 1 : -1;
+        for (; x0 <= x1; x0++) {
+            if (steep) drawPixel(y0, x0, color);
+            else drawPixel(x0, y0, color);
+            err -= dy;
+            if (err < 0) {
+                y0 += ystep;
+                err += dx;
+            }
+        }
+    }
+
+    virtual void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+        drawFastHLine(x, y, w, color);
+        drawFastHLine(x, y + h - 1, w, color);
+        drawFastVLine(x, y, h, color);
+        drawFastVLine(x + w - 1, y, h, color);
+    }
+    void drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color) {
+        (void)r;
+        drawRect(x, y, w, h, color);
+    }
+    void fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color) {
+        (void)r;
+        fillRect(x, y, w, h, color);
+    }
+
+    void drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+        for (int a = 0; a < 64; a++) {
+            float angle = a * (float)(M_PI / 32.0);
+            drawPixel(x0 + (int16_t)(r * cosf(angle)), y0 + (int16_t)(r * sinf(angle)), color);
+        }
+    }
+    void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+        for (int16_t dy = -r; dy <= r; dy++) {
+            for (int16_t dx = -r; dx <= r; dx++) {
+                if (dx * dx + dy * dy <= r * r) drawPixel(x0 + dx, y0 + dy, color);
+            }
+        }
+    }
+    void drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color) {
+        drawLine(x0, y0, x1, y1, color);
+        drawLine(x1, y1, x2, y2, color);
+        drawLine(x2, y2, x0, y0, color);
+    }
+    void fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color) {
+        drawTriangle(x0, y0, x1, y1, x2, y2, color);
+    }
+
+    // XBM-style rows, MSB first
+    void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color) {
+        int16_t byte_width = (w + 7) / 8;
+        for (int16_t j = 0; j < h; j++) {
+            for (int16_t i = 0; i < w; i++) {
+                if (pgm_read_byte(&bitmap[j * byte_width + i / 8]) & (0x80 >> (i & 7))) {
+                    drawPixel(x + i, y + j, color);
+                }
+            }
+        }
+    }
+
+    // 5x8 cell plus a spacing column, like the classic font; the glyph bits
+    // are a deterministic pattern derived from the character code
+    void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size) {
+        for (int8_t i = 0; i < 5; i++) {
+            uint8_t line = (uint8_t)(c * 7 + i * 13);
+            for (int8_t j = 0; j < 8; j++, line >>= 1) {
+                if (line & 1) {
+                    fillRect(x + i * size, y + j * size, size, size, color);
+                } else if (bg != color) {
+                    fillRect(x + i * size, y + j * size, size, size, bg);
+                }
+            }
+        }
+        if (bg != color) {
+            fillRect(x + 5 * size, y, size, 8 * size, bg);
+        }
+    }
+
+    size_t write(uint8_t c) override {
+        if (c == '\n') {
+            cursor_x = 0;
+            cursor_y += textsize * 8;
+        } else if (c != '\r') {
+            if (wrap && (cursor_x + textsize * 6) > _width) {
+                cursor_x = 0;
+                cursor_y += textsize * 8;
+            }
+            drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize);
+            cursor_x += textsize * 6;
+        }
+        return 1;
+    }
+    using Print::write;
+
+    void setCursor(int16_t x, int16_t y) { cursor_x = x; cursor_y = y; }
+    void setTextSize(uint8_t size) { textsize = size > 0 ? size : 1; }
+    void setTextColor(uint16_t color) { textcolor = textbgcolor = color; }
+    void setTextColor(uint16_t color, uint16_t background) { textcolor = color; textbgcolor = background; }
+    void setTextWrap(bool enable) { wrap = enable; }
+
+    int16_t width() const { return _width; }
+    int16_t height() const { return _height; }
+    uint8_t getRotation() const { return rotation; }
+    int16_t getCursorX() const { return cursor_x; }
+    int16_t getCursorY() const { return cursor_y; }
+};
+
+#endif // NATIVE_MOCKS_ADAFRUIT_GFX_H
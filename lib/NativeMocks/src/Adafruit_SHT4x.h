@@ -0,0 +1,52 @@
+#ifndef NATIVE_MOCKS_ADAFRUIT_SHT4X_H
+#define NATIVE_MOCKS_ADAFRUIT_SHT4X_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+typedef enum {
+    SHT4X_HIGH_PRECISION,
+    SHT4X_MED_PRECISION,
+    SHT4X_LOW_PRECISION
+} sht4x_precision_t;
+
+typedef enum {
+    SHT4X_NO_HEATER,
+    SHT4X_HIGH_HEATER_1S,
+    SHT4X_HIGH_HEATER_100MS,
+    SHT4X_MED_HEATER_1S,
+    SHT4X_MED_HEATER_100MS,
+    SHT4X_LOW_HEATER_1S,
+    SHT4X_LOW_HEATER_100MS
+} sht4x_heater_t;
+
+struct sensors_event_t {
+    float temperature;
+    float relative_humidity;
+};
+
+// Sensor that always reads 21.5 C and 45 %RH
+class Adafruit_SHT4x {
+private:
+    sht4x_precision_t precision;
+    sht4x_heater_t heater;
+
+public:
+    Adafruit_SHT4x() : precision(SHT4X_HIGH_PRECISION), heater(SHT4X_NO_HEATER) {}
+
+    bool begin(TwoWire* wire = &Wire) { (void)wire; return true; }
+    void setPrecision(sht4x_precision_t value) { precision = value; }
+    sht4x_precision_t getPrecision() { return precision; }
+    void setHeater(sht4x_heater_t value) { heater = value; }
+    sht4x_heater_t getHeater() { return heater; }
+    uint32_t readSerial() { return 0x12345678; }
+    bool reset() { return true; }
+
+    bool getEvent(sensors_event_t* humidity, sensors_event_t* temp) {
+        humidity->relative_humidity = 45.0f;
+        temp->temperature = 21.5f;
+        return true;
+    }
+};
+
+#endif // NATIVE_MOCKS_ADAFRUIT_SHT4X_H
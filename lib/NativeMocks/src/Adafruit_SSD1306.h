@@ -0,0 +1,70 @@
+#ifndef NATIVE_MOCKS_ADAFRUIT_SSD1306_H
+#define NATIVE_MOCKS_ADAFRUIT_SSD1306_H
+
+#include <Adafruit_GFX.h>
+#include <Wire.h>
+
+#define SSD1306_BLACK 0
+#define SSD1306_WHITE 1
+#define SSD1306_INVERSE 2
+
+#define SSD1306_SWITCHCAPVCC 0x02
+#define SSD1306_MEMORYMODE 0x20
+#define SSD1306_COLUMNADDR 0x21
+#define SSD1306_PAGEADDR 0x22
+#define SSD1306_SETCONTRAST 0x81
+#define SSD1306_NORMALDISPLAY 0xA6
+#define SSD1306_INVERTDISPLAY 0xA7
+#define SSD1306_DISPLAYOFF 0xAE
+#define SSD1306_DISPLAYON 0xAF
+#define SSD1306_DEACTIVATE_SCROLL 0x2E
+#define SSD1306_ACTIVATE_SCROLL 0x2F
+
+// SSD1306 driver keeping the library's buffer layout and bus traffic shape:
+// commands go out as 0x00-prefixed writes and display() sends the whole
+// buffer in I2C_BUFFER_LENGTH chunks, so the TwoWire counters see what the
+// real driver would send. Pixels land in the buffer and are counted.
+class Adafruit_SSD1306 : public Adafruit_GFX {
+protected:
+    TwoWire* wire;
+    uint8_t* buffer;
+    uint8_t i2caddr;
+    uint32_t wireClk;
+    uint32_t restoreClk;
+
+    size_t bufferSize() const { return (size_t)WIDTH * ((HEIGHT + 7) / 8); }
+    void commandList(const uint8_t* commands, size_t count);
+    void setPixel(int16_t x, int16_t y, uint16_t color);  // Uncounted, rotated and clipped
+
+public:
+    Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi = &Wire, int8_t rst_pin = -1,
+                     uint32_t clkDuring = 400000UL, uint32_t clkAfter = 100000UL)
+        : Adafruit_GFX(w, h), wire(twi), buffer(nullptr), i2caddr(0), wireClk(clkDuring), restoreClk(clkAfter) {
+        (void)rst_pin;
+    }
+    ~Adafruit_SSD1306() { free(buffer); }
+
+    bool begin(uint8_t switchvcc = SSD1306_SWITCHCAPVCC, uint8_t i2caddr = 0, bool reset = true,
+               bool periphBegin = true);
+    void display();
+    void clearDisplay() { memset(buffer, 0, bufferSize()); }
+    void invertDisplay(bool invert) override;
+    void dim(bool dim);
+    void ssd1306_command(uint8_t c);
+
+    // Fast lines write the buffer directly, like the library; every pixel
+    // of the line counts as one pixel write
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+    bool getPixel(int16_t x, int16_t y);
+    uint8_t* getBuffer() { return buffer; }
+
+    void startscrollright(uint8_t start, uint8_t stop);
+    void startscrollleft(uint8_t start, uint8_t stop);
+    void startscrolldiagright(uint8_t start, uint8_t stop);
+    void startscrolldiagleft(uint8_t start, uint8_t stop);
+    void stopscroll() { ssd1306_command(SSD1306_DEACTIVATE_SCROLL); }
+};
+
+#endif // NATIVE_MOCKS_ADAFRUIT_SSD1306_H
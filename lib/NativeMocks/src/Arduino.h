@@ -0,0 +1,199 @@
+#ifndef NATIVE_MOCKS_ARDUINO_H
+#define NATIVE_MOCKS_ARDUINO_H
+
+// The part of the Arduino core the firmware uses, for host builds. Time comes
+// from std::chrono; Serial writes to stdout and never has input.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <ctype.h>
+#include <math.h>
+#include <algorithm>
+#include <string>
+
+#define ARDUINO 10819
+#define PROGMEM
+#define HEX 16
+#define DEC 10
+
+inline uint8_t pgm_read_byte(const void* address) {
+    return *static_cast<const uint8_t*>(address);
+}
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+// Deterministic for a given seed, like the core's
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+using std::min;
+using std::max;
+
+class String {
+private:
+    std::string text;
+
+public:
+    String() {}
+    String(const char* value) : text(value != nullptr ? value : "") {}
+    String(const std::string& value) : text(value) {}
+    String(char value) : text(1, value) {}
+    explicit String(int value) : text(std::to_string(value)) {}
+    explicit String(unsigned int value) : text(std::to_string(value)) {}
+    explicit String(long value) : text(std::to_string(value)) {}
+    explicit String(unsigned long value) : text(std::to_string(value)) {}
+    String(float value, unsigned int decimals) : String((double)value, decimals) {}
+    String(double value, unsigned int decimals) {
+        char buffer[40];
+        snprintf(buffer, sizeof(buffer), "%.*f", (int)decimals, value);
+        text = buffer;
+    }
+
+    // Assigning reuses the existing buffer, as the Arduino String does
+    String& operator=(const char* value) { text.assign(value != nullptr ? value : ""); return *this; }
+
+    unsigned int length() const { return text.size(); }
+    const char* c_str() const { return text.c_str(); }
+    bool reserve(unsigned int size) { text.reserve(size); return true; }
+
+    char operator[](unsigned int index) const { return index < text.size() ? text[index] : 0; }
+    char charAt(unsigned int index) const { return (*this)[index]; }
+
+    String substring(unsigned int from) const {
+        return from >= text.size() ? String() : String(text.substr(from));
+    }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from > to) {
+            std::swap(from, to);
+        }
+        return from >= text.size() ? String() : String(text.substr(from, to - from));
+    }
+
+    int indexOf(char c, unsigned int from = 0) const {
+        size_t found = text.find(c, from);
+        return found == std::string::npos ? -1 : (int)found;
+    }
+    int lastIndexOf(char c) const {
+        size_t found = text.rfind(c);
+        return found == std::string::npos ? -1 : (int)found;
+    }
+    int lastIndexOf(char c, unsigned int from) const {
+        size_t found = text.rfind(c, from);
+        return found == std::string::npos ? -1 : (int)found;
+    }
+    bool startsWith(const String& prefix) const { return text.compare(0, prefix.text.size(), prefix.text) == 0; }
+    bool equals(const String& other) const { return text == other.text; }
+
+    void trim() {
+        size_t first = text.find_first_not_of(" \t\r\n");
+        if (first == std::string::npos) {
+            text.clear();
+            return;
+        }
+        size_t last = text.find_last_not_of(" \t\r\n");
+        text = text.substr(first, last - first + 1);
+    }
+    void toLowerCase() { for (char& c : text) c = (char)tolower((unsigned char)c); }
+    void toUpperCase() { for (char& c : text) c = (char)toupper((unsigned char)c); }
+    void remove(unsigned int index) { if (index < text.size()) text.erase(index); }
+    void remove(unsigned int index, unsigned int count) { if (index < text.size()) text.erase(index, count); }
+
+    long toInt() const { return atol(text.c_str()); }
+    float toFloat() const { return (float)atof(text.c_str()); }
+
+    bool concat(const char* value) { text += value; return true; }
+    String& operator+=(char c) { text += c; return *this; }
+    String& operator+=(const char* value) { text += value; return *this; }
+    String& operator+=(const String& other) { text += other.text; return *this; }
+
+    bool operator==(const char* value) const { return text == value; }
+    bool operator==(const String& other) const { return text == other.text; }
+    bool operator!=(const char* value) const { return text != value; }
+
+    friend String operator+(const String& a, const String& b) { return String(a.text + b.text); }
+    friend String operator+(const String& a, const char* b) { return String(a.text + b); }
+    friend String operator+(const char* a, const String& b) { return String(std::string(a) + b.text); }
+};
+
+class Print {
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t written = 0;
+        while (size--) {
+            written += write(*buffer++);
+        }
+        return written;
+    }
+    size_t write(const char* text) { return write((const uint8_t*)text, strlen(text)); }
+    size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+
+    size_t print(const char* text) { return write(text); }
+    size_t print(const String& text) { return write(text.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int value, int base = DEC) { return print((long)value, base); }
+    size_t print(unsigned int value, int base = DEC) { return print((unsigned long)value, base); }
+    size_t print(long value, int base = DEC);
+    size_t print(unsigned long value, int base = DEC);
+    size_t print(double value, int decimals = 2);
+
+    size_t println() { return write("\r\n"); }
+    template <typename T>
+    size_t println(T value) { return print(value) + println(); }
+    template <typename T>
+    size_t println(T value, int format) { return print(value, format) + println(); }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() { return -1; }
+    virtual void flush() {}
+
+    size_t readBytes(uint8_t* buffer, size_t length) {
+        size_t count = 0;
+        while (count < length && available() > 0) {
+            buffer[count++] = (uint8_t)read();
+        }
+        return count;
+    }
+    size_t readBytes(char* buffer, size_t length) { return readBytes((uint8_t*)buffer, length); }
+    String readStringUntil(char terminator) {
+        String text;
+        while (available() > 0) {
+            int c = read();
+            if (c == terminator) {
+                break;
+            }
+            text += (char)c;
+        }
+        return text;
+    }
+};
+
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    int available() override { return 0; }
+    int read() override { return -1; }
+    size_t write(uint8_t c) override;
+    using Print::write;
+    operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif // NATIVE_MOCKS_ARDUINO_H
@@ -0,0 +1,48 @@
+#ifndef NATIVE_MOCKS_FS_H
+#define NATIVE_MOCKS_FS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// In-memory filesystem: files live in a map for the life of the program
+namespace fs {
+
+typedef std::vector<uint8_t> FileData;
+
+class File {
+private:
+    std::shared_ptr<FileData> data;
+    size_t position;
+
+public:
+    File() : position(0) {}
+    explicit File(std::shared_ptr<FileData> contents) : data(contents), position(0) {}
+
+    explicit operator bool() const { return (bool)data; }
+
+    bool seek(uint32_t offset);
+    size_t read(uint8_t* buffer, size_t length);
+    size_t write(const uint8_t* buffer, size_t length);
+    int available() const { return data ? (int)(data->size() - position) : 0; }
+    size_t size() const { return data ? data->size() : 0; }
+    void flush() {}
+    void close() { data.reset(); }
+};
+
+class FS {
+private:
+    std::map<std::string, std::shared_ptr<FileData>> files;
+
+public:
+    bool exists(const char* path) const { return files.count(path) != 0; }
+    bool remove(const char* path) { return files.erase(path) != 0; }
+    File open(const char* path, const char* mode = "r");
+};
+
+}  // namespace fs
+
+#endif // NATIVE_MOCKS_FS_H
@@ -0,0 +1,14 @@
+#ifndef NATIVE_MOCKS_LITTLEFS_H
+#define NATIVE_MOCKS_LITTLEFS_H
+
+#include <FS.h>
+
+class LittleFSFS : public fs::FS {
+public:
+    bool begin(bool formatOnFail = false) { (void)formatOnFail; return true; }
+    void end() {}
+};
+
+extern LittleFSFS LittleFS;
+
+#endif // NATIVE_MOCKS_LITTLEFS_H
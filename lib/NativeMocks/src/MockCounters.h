@@ -0,0 +1,40 @@
+#ifndef NATIVE_MOCKS_MOCK_COUNTERS_H
+#define NATIVE_MOCKS_MOCK_COUNTERS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Everything the mocks observe, summed over all buses and displays. Tests
+// reset the counters, run the code under test and compare the difference.
+struct MockCounters {
+    // TwoWire
+    unsigned long i2c_bytes_written;   // Payload bytes, address bytes not included
+    unsigned long i2c_bytes_read;
+    unsigned long i2c_transactions;    // endTransmission() and requestFrom() calls
+    unsigned long i2c_nacks;           // Transactions to an absent address
+    unsigned long i2c_clock_changes;   // setClock() calls that changed the rate
+
+    // Adafruit_SSD1306
+    unsigned long pixel_writes;        // drawPixel() calls, clipped ones included
+    unsigned long display_refreshes;   // Adafruit_SSD1306::display() calls
+
+    // fs::File
+    unsigned long fs_bytes_read;
+    unsigned long fs_bytes_written;
+
+    // Global operator new/delete
+    unsigned long allocations;
+    unsigned long frees;
+    unsigned long long allocated_bytes;
+};
+
+extern MockCounters mock_counters;
+
+// Zero every counter
+void resetMockCounters();
+
+// Addresses that acknowledge on the mock buses; all of them do by default
+void setMockDevicePresent(uint8_t address, bool present);
+bool isMockDevicePresent(uint8_t address);
+
+#endif // NATIVE_MOCKS_MOCK_COUNTERS_H
@@ -0,0 +1,12 @@
+// Entry point for programs written against the Arduino core: setup() runs
+// once, then loop() once (tests do their work in setup()). Kept in its own
+// file so a test that defines main() never pulls this one in.
+
+void setup();
+void loop();
+
+int main() {
+    setup();
+    loop();
+    return 0;
+}
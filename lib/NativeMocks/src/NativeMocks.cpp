@@ -0,0 +1,477 @@
+#include <Arduino.h>
+#include <Wire.h>
+#include <Adafruit_SSD1306.h>
+#include <LittleFS.h>
+#include "MockCounters.h"
+#include <stdarg.h>
+#include <chrono>
+#include <new>
+#include <random>
+#include <thread>
+
+MockCounters mock_counters;
+
+// Addresses that do not acknowledge, one bit each
+static uint32_t absent_addresses[4];
+
+void resetMockCounters() {
+    memset(&mock_counters, 0, sizeof(mock_counters));
+}
+
+void setMockDevicePresent(uint8_t address, bool present) {
+    address &= 0x7F;
+    if (present) {
+        absent_addresses[address / 32] &= ~(1UL << (address % 32));
+    } else {
+        absent_addresses[address / 32] |= 1UL << (address % 32);
+    }
+}
+
+bool isMockDevicePresent(uint8_t address) {
+    address &= 0x7F;
+    return (absent_addresses[address / 32] & (1UL << (address % 32))) == 0;
+}
+
+// Heap accounting: every global new/delete passes through here (GCC flags
+// free() in operator delete as a mismatch, which it is not)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void* operator new(size_t size) {
+    mock_counters.allocations++;
+    mock_counters.allocated_bytes += size;
+    void* block = malloc(size > 0 ? size : 1);
+    if (block == nullptr) {
+        throw std::bad_alloc();
+    }
+    return block;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    mock_counters.allocations++;
+    mock_counters.allocated_bytes += size;
+    return malloc(size > 0 ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* block) noexcept {
+    if (block != nullptr) {
+        mock_counters.frees++;
+        free(block);
+    }
+}
+
+void operator delete[](void* block) noexcept {
+    operator delete(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+    operator delete(block);
+}
+
+void operator delete[](void* block, size_t) noexcept {
+    operator delete(block);
+}
+
+#pragma GCC diagnostic pop
+
+// Time
+static const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+unsigned long millis() {
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start_time).count();
+}
+
+unsigned long micros() {
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start_time).count();
+}
+
+void delay(unsigned long ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us) {
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield() {
+}
+
+// Random numbers
+static std::minstd_rand random_engine;
+
+long random(long howbig) {
+    if (howbig <= 0) {
+        return 0;
+    }
+    return (long)(random_engine() % (unsigned long)howbig);
+}
+
+long random(long howsmall, long howbig) {
+    if (howsmall >= howbig) {
+        return howsmall;
+    }
+    return howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed) {
+    if (seed != 0) {
+        random_engine.seed((std::minstd_rand::result_type)seed);
+    }
+}
+
+// Print number formatting
+size_t Print::print(long value, int base) {
+    char text[24];
+    snprintf(text, sizeof(text), base == HEX ? "%lX" : "%ld", value);
+    return write(text);
+}
+
+size_t Print::print(unsigned long value, int base) {
+    char text[24];
+    snprintf(text, sizeof(text), base == HEX ? "%lX" : "%lu", value);
+    return write(text);
+}
+
+size_t Print::print(double value, int decimals) {
+    char text[48];
+    snprintf(text, sizeof(text), "%.*f", decimals, value);
+    return write(text);
+}
+
+size_t Print::printf(const char* format, ...) {
+    char text[256];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    if (length < 0) {
+        return 0;
+    }
+    return write((const uint8_t*)text, (size_t)length < sizeof(text) ? (size_t)length : sizeof(text) - 1);
+}
+
+HardwareSerial Serial;
+
+size_t HardwareSerial::write(uint8_t c) {
+    return fputc(c, stdout) == EOF ? 0 : 1;
+}
+
+// TwoWire
+TwoWire Wire(0);
+TwoWire Wire1(1);
+
+bool TwoWire::begin(int sda, int scl, uint32_t frequency) {
+    (void)sda;
+    (void)scl;
+    if (frequency != 0) {
+        setClock(frequency);
+    }
+    return true;
+}
+
+bool TwoWire::setClock(uint32_t frequency) {
+    if (frequency != clock) {
+        clock = frequency;
+        mock_counters.i2c_clock_changes++;
+    }
+    return true;
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+    tx_address = address;
+    tx_length = 0;
+    last_tx_length = 0;
+}
+
+uint8_t TwoWire::endTransmission(bool send_stop) {
+    (void)send_stop;
+    mock_counters.i2c_transactions++;
+    last_tx_length = tx_length;
+    tx_length = 0;
+    if (!isMockDevicePresent(tx_address)) {
+        mock_counters.i2c_nacks++;
+        return 2;  // NACK on address, as the ESP32 core reports it
+    }
+    return 0;
+}
+
+size_t TwoWire::requestFrom(uint8_t address, size_t length, bool send_stop) {
+    (void)send_stop;
+    mock_counters.i2c_transactions++;
+    if (!isMockDevicePresent(address)) {
+        mock_counters.i2c_nacks++;
+        rx_remaining = 0;
+        return 0;
+    }
+    if (length > I2C_BUFFER_LENGTH) {
+        length = I2C_BUFFER_LENGTH;
+    }
+    rx_remaining = length;
+    return length;
+}
+
+size_t TwoWire::write(uint8_t c) {
+    if (tx_length >= I2C_BUFFER_LENGTH) {
+        return 0;
+    }
+    tx_buffer[tx_length++] = c;
+    mock_counters.i2c_bytes_written++;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* buffer, size_t size) {
+    size_t written = 0;
+    while (written < size && write(buffer[written]) == 1) {
+        written++;
+    }
+    return written;
+}
+
+int TwoWire::read() {
+    if (rx_remaining == 0) {
+        return -1;
+    }
+    rx_remaining--;
+    mock_counters.i2c_bytes_read++;
+    return 0;
+}
+
+// Adafruit_SSD1306
+bool Adafruit_SSD1306::begin(uint8_t switchvcc, uint8_t addr, bool reset, bool periphBegin) {
+    (void)switchvcc;
+    (void)reset;
+    if (buffer == nullptr) {
+        buffer = (uint8_t*)malloc(bufferSize());
+        if (buffer == nullptr) {
+            return false;
+        }
+    }
+    clearDisplay();
+    i2caddr = addr != 0 ? addr : 0x3C;
+    if (periphBegin) {
+        wire->begin();
+    }
+
+    // The library's 128x64 init sequence
+    static const uint8_t init_sequence[] = {
+        SSD1306_DISPLAYOFF, 0xD5, 0x80, 0xA8, 0x3F, 0xD3, 0x00, 0x40, 0x8D, 0x14,
+        SSD1306_MEMORYMODE, 0x00, 0xA1, 0xC8, 0xDA, 0x12, SSD1306_SETCONTRAST, 0xCF,
+        0xD9, 0xF1, 0xDB, 0x40, 0xA4, SSD1306_NORMALDISPLAY, SSD1306_DEACTIVATE_SCROLL,
+        SSD1306_DISPLAYON
+    };
+    wire->setClock(wireClk);
+    commandList(init_sequence, sizeof(init_sequence));
+    wire->setClock(restoreClk);
+    return isMockDevicePresent(i2caddr);
+}
+
+// One 0x00-prefixed write per I2C_BUFFER_LENGTH - 1 commands
+void Adafruit_SSD1306::commandList(const uint8_t* commands, size_t count) {
+    while (count > 0) {
+        size_t chunk = count < I2C_BUFFER_LENGTH - 1 ? count : I2C_BUFFER_LENGTH - 1;
+        wire->beginTransmission(i2caddr);
+        wire->write((uint8_t)0x00);
+        wire->write(commands, chunk);
+        wire->endTransmission();
+        commands += chunk;
+        count -= chunk;
+    }
+}
+
+void Adafruit_SSD1306::ssd1306_command(uint8_t c) {
+    wire->setClock(wireClk);
+    commandList(&c, 1);
+    wire->setClock(restoreClk);
+}
+
+void Adafruit_SSD1306::display() {
+    mock_counters.display_refreshes++;
+    const uint8_t window[] = {
+        SSD1306_PAGEADDR, 0, 0xFF, SSD1306_COLUMNADDR, 0, (uint8_t)(WIDTH - 1)
+    };
+    wire->setClock(wireClk);
+    commandList(window, sizeof(window));
+
+    // Data in I2C_BUFFER_LENGTH transfers, each led by the 0x40 control byte
+    size_t count = bufferSize();
+    const uint8_t* data = buffer;
+    while (count > 0) {
+        size_t chunk = count < I2C_BUFFER_LENGTH - 1 ? count : I2C_BUFFER_LENGTH - 1;
+        wire->beginTransmission(i2caddr);
+        wire->write((uint8_t)0x40);
+        wire->write(data, chunk);
+        wire->endTransmission();
+        data += chunk;
+        count -= chunk;
+    }
+    wire->setClock(restoreClk);
+}
+
+void Adafruit_SSD1306::invertDisplay(bool invert) {
+    ssd1306_command(invert ? SSD1306_INVERTDISPLAY : SSD1306_NORMALDISPLAY);
+}
+
+void Adafruit_SSD1306::dim(bool dim) {
+    ssd1306_command(SSD1306_SETCONTRAST);
+    ssd1306_command(dim ? 0 : 0xCF);
+}
+
+void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    mock_counters.pixel_writes++;
+    setPixel(x, y, color);
+}
+
+void Adafruit_SSD1306::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    if (w <= 0) {
+        return;
+    }
+    mock_counters.pixel_writes += w;
+    for (int16_t i = 0; i < w; i++) {
+        setPixel(x + i, y, color);
+    }
+}
+
+void Adafruit_SSD1306::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    if (h <= 0) {
+        return;
+    }
+    mock_counters.pixel_writes += h;
+    for (int16_t i = 0; i < h; i++) {
+        setPixel(x, y + i, color);
+    }
+}
+
+void Adafruit_SSD1306::setPixel(int16_t x, int16_t y, uint16_t color) {
+    if (x < 0 || x >= width() || y < 0 || y >= height()) {
+        return;
+    }
+    switch (getRotation()) {
+        case 1:
+            std::swap(x, y);
+            x = WIDTH - x - 1;
+            break;
+        case 2:
+            x = WIDTH - x - 1;
+            y = HEIGHT - y - 1;
+            break;
+        case 3:
+            std::swap(x, y);
+            y = HEIGHT - y - 1;
+            break;
+    }
+    uint8_t& cell = buffer[x + (y / 8) * WIDTH];
+    uint8_t bit = 1 << (y & 7);
+    switch (color) {
+        case SSD1306_WHITE: cell |= bit; break;
+        case SSD1306_BLACK: cell &= ~bit; break;
+        case SSD1306_INVERSE: cell ^= bit; break;
+    }
+}
+
+bool Adafruit_SSD1306::getPixel(int16_t x, int16_t y) {
+    if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT) {
+        return false;
+    }
+    return (buffer[x + (y / 8) * WIDTH] & (1 << (y & 7))) != 0;
+}
+
+// Scrolling: the library's command layout, sent and otherwise ignored
+static void sendScroll(Adafruit_SSD1306* display, uint8_t command, uint8_t start, uint8_t stop, bool diagonal) {
+    display->ssd1306_command(command);
+    display->ssd1306_command(0x00);
+    display->ssd1306_command(start);
+    display->ssd1306_command(0x00);
+    display->ssd1306_command(stop);
+    if (diagonal) {
+        display->ssd1306_command(0x01);
+    } else {
+        display->ssd1306_command(0x00);
+        display->ssd1306_command(0xFF);
+    }
+    display->ssd1306_command(SSD1306_ACTIVATE_SCROLL);
+}
+
+void Adafruit_SSD1306::startscrollright(uint8_t start, uint8_t stop) {
+    sendScroll(this, 0x26, start, stop, false);
+}
+
+void Adafruit_SSD1306::startscrollleft(uint8_t start, uint8_t stop) {
+    sendScroll(this, 0x27, start, stop, false);
+}
+
+void Adafruit_SSD1306::startscrolldiagright(uint8_t start, uint8_t stop) {
+    sendScroll(this, 0x29, start, stop, true);
+}
+
+void Adafruit_SSD1306::startscrolldiagleft(uint8_t start, uint8_t stop) {
+    sendScroll(this, 0x2A, start, stop, true);
+}
+
+// Filesystem
+LittleFSFS LittleFS;
+
+namespace fs {
+
+bool File::seek(uint32_t offset) {
+    if (!data || offset > data->size()) {
+        return false;
+    }
+    position = offset;
+    return true;
+}
+
+size_t File::read(uint8_t* buffer, size_t length) {
+    if (!data) {
+        return 0;
+    }
+    size_t count = std::min(length, data->size() - position);
+    memcpy(buffer, data->data() + position, count);
+    position += count;
+    mock_counters.fs_bytes_read += count;
+    return count;
+}
+
+size_t File::write(const uint8_t* buffer, size_t length) {
+    if (!data) {
+        return 0;
+    }
+    if (position + length > data->size()) {
+        data->resize(position + length);
+    }
+    memcpy(data->data() + position, buffer, length);
+    position += length;
+    mock_counters.fs_bytes_written += length;
+    return length;
+}
+
+File FS::open(const char* path, const char* mode) {
+    std::string flags(mode != nullptr ? mode : "r");
+    if (flags[0] == 'w') {
+        files[path] = std::make_shared<FileData>();
+        return File(files[path]);
+    }
+    auto found = files.find(path);
+    if (found == files.end()) {
+        if (flags[0] != 'a') {
+            return File();
+        }
+        found = files.emplace(path, std::make_shared<FileData>()).first;
+    }
+    File file(found->second);
+    if (flags[0] == 'a') {
+        file.seek(file.size());
+    }
+    return file;
+}
+
+}  // namespace fs
@@ -0,0 +1,53 @@
+#ifndef NATIVE_MOCKS_WIRE_H
+#define NATIVE_MOCKS_WIRE_H
+
+#include <Arduino.h>
+
+// Same transmit buffer as the ESP32 core, so chunked transfers split the way
+// they do on the target
+#define I2C_BUFFER_LENGTH 128
+
+// I2C master that moves no data: writes are counted and kept until the next
+// transmission starts, reads return zeros. Addresses acknowledge unless
+// setMockDevicePresent() says otherwise.
+class TwoWire : public Stream {
+private:
+    uint8_t bus_num;
+    uint32_t clock;
+    uint8_t tx_address;
+    uint8_t tx_buffer[I2C_BUFFER_LENGTH];
+    size_t tx_length;
+    size_t last_tx_length;
+    size_t rx_remaining;
+
+public:
+    explicit TwoWire(uint8_t bus) : bus_num(bus), clock(100000), tx_address(0), tx_length(0), last_tx_length(0),
+          rx_remaining(0) {}
+
+    bool begin() { return true; }
+    bool begin(int sda, int scl, uint32_t frequency = 0);
+    bool setClock(uint32_t frequency);
+    uint32_t getClock() const { return clock; }
+    uint8_t getBusNum() const { return bus_num; }
+
+    void beginTransmission(uint8_t address);
+    uint8_t endTransmission(bool send_stop = true);
+    size_t requestFrom(uint8_t address, size_t length, bool send_stop = true);
+    size_t requestFrom(uint8_t address, uint8_t length) { return requestFrom(address, (size_t)length, true); }
+    size_t requestFrom(int address, int length) { return requestFrom((uint8_t)address, (size_t)length, true); }
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    int available() override { return (int)rx_remaining; }
+    int read() override;
+
+    // Bytes of the last endTransmission(), valid until the next beginTransmission()
+    const uint8_t* getLastTransmission() const { return tx_buffer; }
+    size_t getLastTransmissionLength() const { return last_tx_length; }
+};
+
+extern TwoWire Wire;
+extern TwoWire Wire1;
+
+#endif // NATIVE_MOCKS_WIRE_H
@@ -0,0 +1,122 @@
+#include "AdaptiveSamplingPolicy.hpp"
+
+// Constructor
+AdaptiveSamplingPolicy::AdaptiveSamplingPolicy(uint32_t min_period, uint32_t max_period,
+                                               uint16_t stable_samples)
+    : min_period_ms(min_period > 0 ? min_period : 1), max_period_ms(max_period),
+      stable_samples(stable_samples > 0 ? stable_samples : 1), enabled(true),
+      last_timestamp(0), primed(false), stable_count(0),
+      period_ms(min_period_ms), effort(static_cast<uint8_t>(SamplingEffort::PRECISE)) {
+    if (max_period_ms < min_period_ms) {
+        max_period_ms = min_period_ms;
+    }
+    for (uint8_t ch = 0; ch < ADAPTIVE_POLICY_MAX_CHANNELS; ch++) {
+        escalate_rate[ch] = 0.0f;
+        stable_rate[ch] = 0.0f;
+        last_value[ch] = 0.0f;
+    }
+}
+
+// Channel thresholds
+bool AdaptiveSamplingPolicy::setChannelThresholds(uint8_t channel, float escalate_per_second,
+                                                  float stable_per_second) {
+    if (channel >= ADAPTIVE_POLICY_MAX_CHANNELS || escalate_per_second < 0.0f ||
+        stable_per_second < 0.0f || stable_per_second > escalate_per_second) {
+        return false;
+    }
+    escalate_rate[channel] = escalate_per_second;
+    stable_rate[channel] = stable_per_second;
+    return true;
+}
+
+// Classify the sample by its rate of change and step the schedule
+void AdaptiveSamplingPolicy::observe(const float* values, uint8_t channel_count, uint32_t timestamp_ms) {
+    if (channel_count > ADAPTIVE_POLICY_MAX_CHANNELS) {
+        channel_count = ADAPTIVE_POLICY_MAX_CHANNELS;
+    }
+
+    if (!primed || timestamp_ms == last_timestamp) {
+        for (uint8_t ch = 0; ch < channel_count; ch++) {
+            last_value[ch] = values[ch];
+        }
+        last_timestamp = timestamp_ms;
+        primed = true;
+        return;
+    }
+
+    float dt = (timestamp_ms - last_timestamp) / 1000.0f;
+    bool fast = false;
+    bool stable = true;
+    for (uint8_t ch = 0; ch < channel_count; ch++) {
+        if (escalate_rate[ch] > 0.0f) {
+            float rate = fabsf(values[ch] - last_value[ch]) / dt;
+            if (rate > escalate_rate[ch]) {
+                fast = true;
+            }
+            if (rate >= stable_rate[ch]) {
+                stable = false;
+            }
+        }
+        last_value[ch] = values[ch];
+    }
+    last_timestamp = timestamp_ms;
+
+    if (!enabled) {
+        return;
+    }
+
+    if (fast) {
+        escalate();
+        return;
+    }
+    if (!stable) {
+        stable_count = 0;
+        return;
+    }
+
+    if (++stable_count >= stable_samples) {
+        stable_count = 0;
+        uint32_t period = period_ms.load() * 2;
+        period_ms = period < max_period_ms ? period : max_period_ms;
+        uint8_t level = effort.load();
+        if (level < static_cast<uint8_t>(SamplingEffort::ECONOMY)) {
+            effort = level + 1;
+        }
+    }
+}
+
+// Enable/disable
+void AdaptiveSamplingPolicy::setEnabled(bool enable) {
+    enabled = enable;
+    if (!enabled) {
+        escalate();
+    }
+}
+
+bool AdaptiveSamplingPolicy::isEnabled() const {
+    return enabled;
+}
+
+// Back to the fastest, most precise setting
+void AdaptiveSamplingPolicy::escalate() {
+    stable_count = 0;
+    period_ms = min_period_ms;
+    effort = static_cast<uint8_t>(SamplingEffort::PRECISE);
+}
+
+// Getters
+uint32_t AdaptiveSamplingPolicy::getPeriod() const {
+    return period_ms.load();
+}
+
+SamplingEffort AdaptiveSamplingPolicy::getEffort() const {
+    return static_cast<SamplingEffort>(effort.load());
+}
+
+uint32_t AdaptiveSamplingPolicy::getMinPeriod() const {
+    return min_period_ms;
+}
+
+uint32_t AdaptiveSamplingPolicy::getMaxPeriod() const {
+    return max_period_ms;
+}
@@ -0,0 +1,272 @@
+#include "AssetArena.hpp"
+#include <cstddef>
+
+#if defined(ESP32)
+#include <esp_heap_caps.h>
+#endif
+
+AssetArena* AssetArena::arenas = nullptr;
+AssetArena* AssetArena::active = nullptr;
+
+namespace {
+
+const size_t ARENA_ALIGNMENT = alignof(std::max_align_t);
+
+uint8_t* alignUp(uint8_t* pointer, size_t alignment) {
+    uintptr_t value = reinterpret_cast<uintptr_t>(pointer);
+    return reinterpret_cast<uint8_t*>((value + alignment - 1) & ~(uintptr_t)(alignment - 1));
+}
+
+// Smallest size class whose block (header included) fits the request
+int sizeClassFor(size_t bytes) {
+    size_t block = ASSET_ARENA_MIN_BLOCK;
+    for (int size_class = 0; size_class < ASSET_ARENA_SIZE_CLASSES; size_class++, block <<= 1) {
+        if (bytes + ASSET_ARENA_BLOCK_HEADER <= block) {
+            return size_class;
+        }
+    }
+    return -1;
+}
+
+} // namespace
+
+// Constructor
+AssetArena::AssetArena(uint16_t slots, size_t pool_bytes, ArenaMemory memory)
+    : slot_memory(nullptr), slots(nullptr),
+      slot_stride((ASSET_ARENA_SLOT_SIZE + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1)),
+      slot_count(0), slot_info(nullptr), free_head(0), live_count(0),
+      pool_memory(nullptr), pool(nullptr), pool_size(0), pool_used(0), pool_in_use(0),
+      next_arena(arenas) {
+    for (int i = 0; i < ASSET_ARENA_SIZE_CLASSES; i++) {
+        free_blocks[i] = nullptr;
+    }
+    arenas = this;
+
+    // The top index is reserved as the free-list terminator
+    if (slots == 0 || slots == 0xFFFF) {
+        return;
+    }
+
+    slot_memory = allocateRegion(slots * slot_stride + ARENA_ALIGNMENT, memory);
+    slot_info = new (std::nothrow) SlotInfo[slots];
+    if (slot_memory == nullptr || slot_info == nullptr) {
+        freeRegion(slot_memory);
+        slot_memory = nullptr;
+        delete[] slot_info;
+        slot_info = nullptr;
+        return;
+    }
+    this->slots = alignUp(slot_memory, ARENA_ALIGNMENT);
+    slot_count = slots;
+    for (uint16_t i = 0; i < slot_count; i++) {
+        slot_info[i].asset = nullptr;
+        slot_info[i].generation = 1;
+        slot_info[i].next_free = i + 1 < slot_count ? i + 1 : 0xFFFF;
+    }
+
+    if (pool_bytes > 0) {
+        pool_memory = allocateRegion(pool_bytes + ARENA_ALIGNMENT, memory);
+        if (pool_memory != nullptr) {
+            pool = alignUp(pool_memory, ARENA_ALIGNMENT);
+            pool_size = pool_bytes;
+        }
+    }
+}
+
+// Destructor
+AssetArena::~AssetArena() {
+    destroyAll();
+
+    for (AssetArena** link = &arenas; *link != nullptr; link = &(*link)->next_arena) {
+        if (*link == this) {
+            *link = next_arena;
+            break;
+        }
+    }
+    if (active == this) {
+        active = nullptr;
+    }
+
+    freeRegion(slot_memory);
+    freeRegion(pool_memory);
+    delete[] slot_info;
+}
+
+// PSRAM when requested and present, internal RAM otherwise
+uint8_t* AssetArena::allocateRegion(size_t bytes, ArenaMemory memory) {
+#if defined(ESP32)
+    if (memory == ArenaMemory::PSRAM) {
+        void* region = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (region != nullptr) {
+            return static_cast<uint8_t*>(region);
+        }
+    }
+    return static_cast<uint8_t*>(heap_caps_malloc(bytes, MALLOC_CAP_8BIT));
+#else
+    (void)memory;
+    return static_cast<uint8_t*>(malloc(bytes));
+#endif
+}
+
+void AssetArena::freeRegion(uint8_t* region) {
+#if defined(ESP32)
+    heap_caps_free(region);
+#else
+    free(region);
+#endif
+}
+
+bool AssetArena::isValid() const {
+    return slot_count > 0;
+}
+
+// Slot management
+bool AssetArena::claimSlot(uint16_t& index) {
+    if (slot_count == 0 || free_head == 0xFFFF || live_count == slot_count) {
+        return false;
+    }
+    index = free_head;
+    free_head = slot_info[index].next_free;
+    return true;
+}
+
+AssetHandle AssetArena::commitSlot(uint16_t index, GraphicsAsset* asset) {
+    slot_info[index].asset = asset;
+    live_count++;
+    return ((AssetHandle)slot_info[index].generation << 16) | index;
+}
+
+// Bump the generation (skipping 0) so outstanding handles go stale
+void AssetArena::releaseSlot(uint16_t index) {
+    slot_info[index].asset = nullptr;
+    if (++slot_info[index].generation == 0) {
+        slot_info[index].generation = 1;
+    }
+    slot_info[index].next_free = free_head;
+    free_head = index;
+    live_count--;
+}
+
+bool AssetArena::decode(AssetHandle handle, uint16_t& index) const {
+    index = indexOf(handle);
+    return index < slot_count && slot_info[index].asset != nullptr &&
+           slot_info[index].generation == (uint16_t)(handle >> 16);
+}
+
+// Lookup
+GraphicsAsset* AssetArena::get(AssetHandle handle) const {
+    uint16_t index;
+    return decode(handle, index) ? slot_info[index].asset : nullptr;
+}
+
+// Destruction
+bool AssetArena::destroy(AssetHandle handle) {
+    uint16_t index;
+    if (!decode(handle, index)) {
+        return false;
+    }
+    slot_info[index].asset->~GraphicsAsset();
+    releaseSlot(index);
+    return true;
+}
+
+void AssetArena::destroyAll() {
+    for (uint16_t i = 0; i < slot_count; i++) {
+        if (slot_info[i].asset != nullptr) {
+            slot_info[i].asset->~GraphicsAsset();
+            releaseSlot(i);
+        }
+    }
+}
+
+// Index <-> handle
+AssetHandle AssetArena::handleAt(uint16_t index) const {
+    if (index >= slot_count || slot_info[index].asset == nullptr) {
+        return ASSET_HANDLE_INVALID;
+    }
+    return ((AssetHandle)slot_info[index].generation << 16) | index;
+}
+
+uint16_t AssetArena::indexOf(AssetHandle handle) {
+    return (uint16_t)(handle & 0xFFFF);
+}
+
+// Active arena for buffer allocations
+void AssetArena::activate() {
+    active = this;
+}
+
+void AssetArena::deactivate() {
+    active = nullptr;
+}
+
+AssetArena* AssetArena::getActive() {
+    return active;
+}
+
+// Statistics
+uint16_t AssetArena::getCapacity() const {
+    return slot_count;
+}
+
+uint16_t AssetArena::getCount() const {
+    return live_count;
+}
+
+size_t AssetArena::getPoolSize() const {
+    return pool_size;
+}
+
+size_t AssetArena::getPoolUsed() const {
+    return pool_used;
+}
+
+size_t AssetArena::getPoolInUse() const {
+    return pool_in_use;
+}
+
+// Buffer allocation: reuse a freed block of the right class, else bump
+void* assetBufferAlloc(size_t bytes) {
+    AssetArena* arena = AssetArena::active;
+    int size_class = sizeClassFor(bytes);
+
+    if (arena != nullptr && arena->pool != nullptr && size_class >= 0) {
+        size_t block_size = (size_t)ASSET_ARENA_MIN_BLOCK << size_class;
+        uint8_t* block = static_cast<uint8_t*>(arena->free_blocks[size_class]);
+        if (block != nullptr) {
+            // Free blocks keep the next-pointer right after their header
+            memcpy(&arena->free_blocks[size_class], block + ASSET_ARENA_BLOCK_HEADER, sizeof(void*));
+        } else if (arena->pool_used + block_size <= arena->pool_size) {
+            block = arena->pool + arena->pool_used;
+            arena->pool_used += block_size;
+        }
+        if (block != nullptr) {
+            block[0] = (uint8_t)size_class;
+            arena->pool_in_use += block_size;
+            return block + ASSET_ARENA_BLOCK_HEADER;
+        }
+    }
+
+    return new (std::nothrow) uint8_t[bytes > 0 ? bytes : 1];
+}
+
+// Return the block to the arena whose pool holds it, or to the heap
+void assetBufferFree(void* buffer) {
+    if (buffer == nullptr) {
+        return;
+    }
+
+    uint8_t* data = static_cast<uint8_t*>(buffer);
+    for (AssetArena* arena = AssetArena::arenas; arena != nullptr; arena = arena->next_arena) {
+        if (arena->pool != nullptr && data >= arena->pool && data < arena->pool + arena->pool_size) {
+            uint8_t* block = data - ASSET_ARENA_BLOCK_HEADER;
+            uint8_t size_class = block[0];
+            memcpy(data, &arena->free_blocks[size_class], sizeof(void*));
+            arena->free_blocks[size_class] = block;
+            arena->pool_in_use -= (size_t)ASSET_ARENA_MIN_BLOCK << size_class;
+            return;
+        }
+    }
+
+    delete[] data;
+}
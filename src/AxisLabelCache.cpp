@@ -0,0 +1,163 @@
+#include "AxisLabelCache.hpp"
+#include "TinyFont.hpp"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// Whole numbers without decimals, everything else with one
+static void formatLabel(char* buf, size_t size, float value) {
+    if (fabs(value - (int)value) < 0.001f) {
+        snprintf(buf, size, "%d", (int)value);
+    } else {
+        snprintf(buf, size, "%.1f", value);
+    }
+}
+
+// Constructor
+AxisLabelCache::AxisLabelCache()
+    : valid(false), labelCount(0), textUsed(0), rebuildCount(0) {
+    memset(&params, 0, sizeof(params));
+}
+
+void AxisLabelCache::invalidate() {
+    valid = false;
+}
+
+bool AxisLabelCache::matches(const AxisLabelParams& other) const {
+    return valid &&
+           params.x == other.x && params.y == other.y &&
+           params.width == other.width && params.height == other.height &&
+           params.contentX == other.contentX && params.contentY == other.contentY &&
+           params.contentW == other.contentW && params.contentH == other.contentH &&
+           params.minX == other.minX && params.maxX == other.maxX &&
+           params.minY == other.minY && params.maxY == other.maxY &&
+           params.zeroX == other.zeroX && params.zeroY == other.zeroY &&
+           params.gridSpacing == other.gridSpacing && params.maxTicks == other.maxTicks &&
+           params.labelSize == other.labelSize && params.tinyScale == other.tinyScale &&
+           params.tinyX == other.tinyX && params.tinyY == other.tinyY;
+}
+
+// Store a label; dropped once either the label slots or the text pool run out
+void AxisLabelCache::addLabel(int16_t lx, int16_t ly, const char* text, bool tiny) {
+    size_t length = strlen(text) + 1;
+    if (labelCount >= AXIS_LABEL_MAX || textUsed + length > AXIS_LABEL_TEXT_POOL) {
+        return;
+    }
+    Label& label = labels[labelCount++];
+    label.x = lx;
+    label.y = ly;
+    label.textOffset = (uint8_t)textUsed;
+    label.tiny = tiny;
+    memcpy(&textPool[textUsed], text, length);
+    textUsed += length;
+}
+
+// X labels are centred on their tick and skipped when they would overlap the previous one
+void AxisLabelCache::addXLabel(int16_t tickX, int16_t labelY, const char* text, int16_t& prevLabelX) {
+    int16_t charWidth = params.tinyX ? TINY_FONT_ADVANCE * params.tinyScale : 6 * params.labelSize;
+    int16_t labelW = (int16_t)strlen(text) * charWidth;
+    int16_t labelX = tickX - labelW / 2;
+    if (prevLabelX < -1000 || abs(labelX - prevLabelX) >= (labelW + 2)) {
+        addLabel(labelX, labelY, text, params.tinyX);
+        prevLabelX = labelX;
+    }
+}
+
+// Y labels sit left of the Y axis, or in the left margin when that is off the plot
+void AxisLabelCache::addYLabel(int16_t tickY, const char* text, int16_t& prevLabelY) {
+    int16_t textW = (int16_t)strlen(text) * 6 * params.labelSize;
+    int16_t labelX;
+    if (params.minX <= 0.0f && params.maxX >= 0.0f) {
+        labelX = params.zeroX - textW - 2;
+        if (labelX < params.x) {
+            labelX = params.contentX - textW - 2;
+            if (labelX < params.x) labelX = params.x + 1;
+        }
+    } else {
+        labelX = params.contentX - textW - 2;
+        if (labelX < params.x) labelX = params.x + 1;
+    }
+
+    int16_t labelH = params.tinyY ? TINY_FONT_HEIGHT * params.tinyScale : 8 * params.labelSize;
+    int16_t labelY = tickY - labelH / 2;
+    if (prevLabelY < -1000 || abs(labelY - prevLabelY) >= (labelH + 2)) {
+        addLabel(labelX, labelY, text, params.tinyY);
+        prevLabelY = labelY;
+    }
+}
+
+// Tick positions and label text for both axes
+void AxisLabelCache::rebuild(const AxisLabelParams& layout) {
+    params = layout;
+    valid = true;
+    labelCount = 0;
+    textUsed = 0;
+    rebuildCount++;
+
+    const AxisLabelParams& p = params;
+    char buf[12];
+
+    // X labels go just below the X axis when it is visible and there is room
+    int16_t labelY = p.contentY + p.contentH + 1;
+    if (p.minY <= 0.0f && p.maxY >= 0.0f) {
+        if (p.zeroY + (8 * p.labelSize) + 1 < (p.y + p.height)) {
+            labelY = p.zeroY + 1;
+        } else {
+            labelY = p.zeroY - (8 * p.labelSize) - 1;
+        }
+    }
+
+    // Ticks are either spread evenly with both ends included, or placed
+    // every gridSpacing pixels starting one spacing in from the edge
+    int16_t prevLabelX = -9999;
+    bool evenX = p.maxTicks > 1 || p.gridSpacing >= p.contentW;
+    int16_t ticks = p.maxTicks > 1 ? p.maxTicks : (evenX ? 2 : (p.contentW - 1) / p.gridSpacing);
+    float step = evenX ? (p.contentW - 1) / (float)(ticks - 1) : 0.0f;
+    for (int16_t k = 0; k < ticks; k++) {
+        int16_t i = evenX ? (int16_t)round(k * step) : (int16_t)((k + 1) * p.gridSpacing);
+        float normalized = (p.contentW > 1) ? ((float)i) / (float)(p.contentW - 1) : 0.0f;
+        formatLabel(buf, sizeof(buf), p.minX + normalized * (p.maxX - p.minX));
+        addXLabel(p.contentX + i, labelY, buf, prevLabelX);
+    }
+
+    int16_t prevLabelY = -9999;
+    bool evenY = p.maxTicks > 1;
+    ticks = evenY ? p.maxTicks : (p.contentH - 1) / p.gridSpacing;
+    step = evenY ? (p.contentH - 1) / (float)(ticks - 1) : 0.0f;
+    for (int16_t k = 0; k < ticks; k++) {
+        int16_t i = evenY ? (int16_t)round(k * step) : (int16_t)((k + 1) * p.gridSpacing);
+        float normalized = (p.contentH > 1) ? (1.0f - ((float)i / (float)(p.contentH - 1))) : 0.0f;
+        formatLabel(buf, sizeof(buf), p.minY + normalized * (p.maxY - p.minY));
+        addYLabel(p.contentY + i, buf, prevLabelY);
+    }
+}
+
+// Replay the cached labels
+void AxisLabelCache::draw(LedScreen128_64* screen, const AxisLabelParams& layout) {
+    if (screen == nullptr) {
+        return;
+    }
+    if (!matches(layout)) {
+        rebuild(layout);
+    }
+
+    for (uint8_t i = 0; i < labelCount; i++) {
+        const Label& label = labels[i];
+        const char* text = &textPool[label.textOffset];
+        if (label.tiny) {
+            TinyFont::drawText(screen, label.x, label.y, text, params.tinyScale);
+        } else {
+            screen->setCursor(label.x, label.y);
+            screen->print(text);
+        }
+    }
+}
+
+// Statistics
+uint8_t AxisLabelCache::getLabelCount() const {
+    return labelCount;
+}
+
+uint32_t AxisLabelCache::getRebuildCount() const {
+    return rebuildCount;
+}
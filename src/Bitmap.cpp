@@ -1,9 +1,12 @@
 #include "Bitmap.hpp"
+#include "AssetBuffer.hpp"
+#include <string.h>
 
 // Constructor
-Bitmap::Bitmap(int16_t x, int16_t y, int16_t width, int16_t height, const uint8_t* bitmapData)
+Bitmap::Bitmap(int16_t x, int16_t y, int16_t width, int16_t height, const uint8_t* bitmapData,
+               BitmapFormat format)
     : GraphicsAsset(x, y, width, height, AssetType::BITMAP), bitmapData(bitmapData),
-      ownsData(false), inverted(false) {
+      ownsData(false), inverted(false), format(format) {
 }
 
 // Destructor
@@ -23,69 +26,220 @@ void Bitmap::draw(LedScreen128_64* screen) {
     }
     
     // Draw the bitmap
-    screen->drawBitmap(x, y, bitmapData, width, height, !inverted);
+    if (format == BitmapFormat::ROW_MAJOR) {
+        screen->drawBitmap(x, y, bitmapData, width, height, !inverted);
+        return;
+    }
+    
+    // Page formats are blitted straight into the framebuffer
+    uint8_t* framebuffer = screen->getFramebuffer();
+    if (framebuffer == nullptr) {
+        return;
+    }
+    switch (screen->getRotation()) {
+        case 1: {
+            FrameRaster<1> raster(framebuffer);
+            rasterize(raster);
+            break;
+        }
+        case 2: {
+            FrameRaster<2> raster(framebuffer);
+            rasterize(raster);
+            break;
+        }
+        case 3: {
+            FrameRaster<3> raster(framebuffer);
+            rasterize(raster);
+            break;
+        }
+        default: {
+            FrameRaster<0> raster(framebuffer);
+            rasterize(raster);
+            break;
+        }
+    }
+    screen->markDirty(x, y, width, height);
 }
 
 // Bitmap data management
-void Bitmap::setBitmapData(const uint8_t* data, bool takeOwnership) {
+void Bitmap::setBitmapData(const uint8_t* data, bool takeOwnership, BitmapFormat format) {
+    markDirty();
     // Free old data if we own it
     if (ownsData && bitmapData != nullptr) {
-        delete[] bitmapData;
+        assetBufferFree(const_cast<uint8_t*>(bitmapData));
     }
     
     bitmapData = data;
     ownsData = takeOwnership;
+    this->format = format;
 }
 
 const uint8_t* Bitmap::getBitmapData() const {
     return bitmapData;
 }
 
+BitmapFormat Bitmap::getFormat() const {
+    return format;
+}
+
+// Format conversion
+bool Bitmap::convertToPageNative() {
+    if (bitmapData == nullptr) {
+        return false;
+    }
+    if (format == BitmapFormat::PAGE_NATIVE) {
+        return true;
+    }
+    
+    size_t size = pageNativeSize(width, height);
+    uint8_t* pages = assetBufferNew<uint8_t>(size);
+    if (pages == nullptr) {
+        return false;
+    }
+    if (format == BitmapFormat::RLE_PAGES) {
+        BitmapRleReader reader(bitmapData);
+        for (size_t i = 0; i < size; i++) {
+            pages[i] = reader.next();
+        }
+    } else {
+        rowMajorToPageNative(bitmapData, width, height, pages);
+    }
+    setBitmapData(pages, true, BitmapFormat::PAGE_NATIVE);
+    return true;
+}
+
+bool Bitmap::convertToRle() {
+    if (format == BitmapFormat::RLE_PAGES) {
+        return bitmapData != nullptr;
+    }
+    if (!convertToPageNative()) {
+        return false;
+    }
+    
+    size_t length = pageNativeSize(width, height);
+    size_t size = encodeRle(bitmapData, length);
+    uint8_t* encoded = assetBufferNew<uint8_t>(size);
+    if (encoded == nullptr) {
+        return false;
+    }
+    encodeRle(bitmapData, length, encoded, size);
+    setBitmapData(encoded, true, BitmapFormat::RLE_PAGES);
+    return true;
+}
+
+size_t Bitmap::pageNativeSize(int16_t width, int16_t height) {
+    if (width <= 0 || height <= 0) {
+        return 0;
+    }
+    return (size_t)width * ((height + 7) / 8);
+}
+
+void Bitmap::rowMajorToPageNative(const uint8_t* rows, int16_t width, int16_t height, uint8_t* pages) {
+    memset(pages, 0, pageNativeSize(width, height));
+    int16_t byteWidth = (width + 7) / 8;
+    for (int16_t row = 0; row < height; row++) {
+        const uint8_t* line = &rows[row * byteWidth];
+        uint8_t* page = &pages[(row >> 3) * width];
+        for (int16_t col = 0; col < width; col++) {
+            if (pgm_read_byte(&line[col >> 3]) & (0x80 >> (col & 7))) {
+                page[col] |= 1 << (row & 7);
+            }
+        }
+    }
+}
+
+// Greedy: runs of three or more equal bytes become run packets, everything
+// between them literal packets
+size_t Bitmap::encodeRle(const uint8_t* pages, size_t length, uint8_t* out, size_t capacity) {
+    size_t size = 0;
+    bool fits = true;
+    size_t i = 0;
+    
+    while (i < length) {
+        size_t run = 1;
+        while (i + run < length && run < BITMAP_RLE_MAX_PACKET && pages[i + run] == pages[i]) {
+            run++;
+        }
+        if (run >= 3) {
+            if (out != nullptr && size + 2 <= capacity) {
+                out[size] = BITMAP_RLE_RUN | (uint8_t)(run - 1);
+                out[size + 1] = pages[i];
+            }
+            fits = fits && size + 2 <= capacity;
+            size += 2;
+            i += run;
+            continue;
+        }
+        
+        size_t start = i;
+        size_t count = 0;
+        while (i < length && count < BITMAP_RLE_MAX_PACKET) {
+            if (i + 2 < length && pages[i] == pages[i + 1] && pages[i] == pages[i + 2]) {
+                break;
+            }
+            i++;
+            count++;
+        }
+        if (out != nullptr && size + 1 + count <= capacity) {
+            out[size] = (uint8_t)(count - 1);
+            memcpy(&out[size + 1], &pages[start], count);
+        }
+        fits = fits && size + 1 + count <= capacity;
+        size += 1 + count;
+    }
+    
+    return out == nullptr || fits ? size : 0;
+}
+
+// Zeroed page-native buffer for the pattern generators
+uint8_t* Bitmap::allocatePages() {
+    freeBitmapData();
+    size_t size = pageNativeSize(width, height);
+    uint8_t* pages = assetBufferNew<uint8_t>(size);
+    if (pages != nullptr) {
+        memset(pages, 0, size);
+    }
+    return pages;
+}
+
 // Create bitmap from simple pattern (allocates memory)
 void Bitmap::createFromPattern(bool pattern[], int size) {
+    markDirty();
     freeBitmapData();
     
     if (size <= 0) {
         return;
     }
     
-    // Calculate bytes needed for bitmap
-    int bytesNeeded = ((width * height) + 7) / 8;
-    uint8_t* newData = new uint8_t[bytesNeeded];
-    
-    // Initialize to zero
-    for (int i = 0; i < bytesNeeded; i++) {
-        newData[i] = 0;
+    uint8_t* newData = allocatePages();
+    if (newData == nullptr) {
+        return;
     }
     
-    // Fill bitmap from pattern
-    int patternIdx = 0;
+    // Fill bitmap from pattern (row-major, one entry per pixel)
     for (int i = 0; i < width * height && i < size; i++) {
         if (pattern[i]) {
-            int byteIdx = i / 8;
-            int bitIdx = i % 8;
-            newData[byteIdx] |= (1 << (7 - bitIdx));
+            int row = i / width;
+            int col = i % width;
+            newData[(row >> 3) * width + col] |= 1 << (row & 7);
         }
     }
     
     bitmapData = newData;
     ownsData = true;
+    format = BitmapFormat::PAGE_NATIVE;
 }
 
 void Bitmap::createCheckerboard(int squareSize) {
-    freeBitmapData();
+    markDirty();
     
     if (squareSize <= 0) {
         squareSize = 1;
     }
     
-    // Calculate bytes needed
-    int bytesNeeded = ((width * height) + 7) / 8;
-    uint8_t* newData = new uint8_t[bytesNeeded];
-    
-    // Initialize to zero
-    for (int i = 0; i < bytesNeeded; i++) {
-        newData[i] = 0;
+    uint8_t* newData = allocatePages();
+    if (newData == nullptr) {
+        return;
     }
     
     // Create checkerboard pattern
@@ -96,28 +250,22 @@ void Bitmap::createCheckerboard(int squareSize) {
             bool isWhite = ((squareRow + squareCol) % 2) == 0;
             
             if (isWhite) {
-                int bitIndex = row * width + col;
-                int byteIdx = bitIndex / 8;
-                int bitIdx = bitIndex % 8;
-                newData[byteIdx] |= (1 << (7 - bitIdx));
+                newData[(row >> 3) * width + col] |= 1 << (row & 7);
             }
         }
     }
     
     bitmapData = newData;
     ownsData = true;
+    format = BitmapFormat::PAGE_NATIVE;
 }
 
 void Bitmap::createGradient(bool horizontal) {
-    freeBitmapData();
-    
-    // Calculate bytes needed
-    int bytesNeeded = ((width * height) + 7) / 8;
-    uint8_t* newData = new uint8_t[bytesNeeded];
+    markDirty();
     
-    // Initialize to zero
-    for (int i = 0; i < bytesNeeded; i++) {
-        newData[i] = 0;
+    uint8_t* newData = allocatePages();
+    if (newData == nullptr) {
+        return;
     }
     
     // Create gradient pattern
@@ -136,20 +284,19 @@ void Bitmap::createGradient(bool horizontal) {
             }
             
             if (isWhite) {
-                int bitIndex = row * width + col;
-                int byteIdx = bitIndex / 8;
-                int bitIdx = bitIndex % 8;
-                newData[byteIdx] |= (1 << (7 - bitIdx));
+                newData[(row >> 3) * width + col] |= 1 << (row & 7);
             }
         }
     }
     
     bitmapData = newData;
     ownsData = true;
+    format = BitmapFormat::PAGE_NATIVE;
 }
 
 // Color inversion
 void Bitmap::setInverted(bool inverted) {
+    markDirty();
     this->inverted = inverted;
 }
 
@@ -160,7 +307,7 @@ bool Bitmap::isInverted() const {
 // Free owned bitmap data
 void Bitmap::freeBitmapData() {
     if (ownsData && bitmapData != nullptr) {
-        delete[] bitmapData;
+        assetBufferFree(const_cast<uint8_t*>(bitmapData));
         bitmapData = nullptr;
         ownsData = false;
     }
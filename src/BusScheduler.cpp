@@ -0,0 +1,462 @@
+#include "BusScheduler.hpp"
+#include "Profiler.hpp"
+
+// Task notification values used to report a blocking transfer's result
+#define BUS_NOTIFY_SUCCESS 1
+#define BUS_NOTIFY_FAILURE 2
+
+BusScheduler::BusClockState BusScheduler::clock_states[MAX_I2C_BUSES] = {};
+uint64_t BusScheduler::busy_time_us = 0;
+
+// Private constructor
+BusScheduler::BusScheduler()
+    : running(false), completed_requests(0), failed_requests(0) {
+    for (int i = 0; i < BUS_PRIORITY_COUNT; i++) {
+        peak_pending[i] = 0;
+    }
+#if BUS_SCHEDULER_RTOS
+    for (int i = 0; i < BUS_PRIORITY_COUNT; i++) {
+        queues[i] = nullptr;
+    }
+    bus_mutex = xSemaphoreCreateRecursiveMutex();
+    task_handle = nullptr;
+#endif
+}
+
+// Get singleton instance
+BusScheduler& BusScheduler::getInstance() {
+    static BusScheduler instance;
+    return instance;
+}
+
+// Start the scheduler task
+bool BusScheduler::begin(size_t queue_depth, int core, uint32_t stack_size, uint8_t task_priority) {
+    if (running) {
+        return true;
+    }
+#if BUS_SCHEDULER_RTOS
+    if (bus_mutex == nullptr) {
+        return false;
+    }
+    for (int i = 0; i < BUS_PRIORITY_COUNT; i++) {
+        queues[i] = xQueueCreate(queue_depth, sizeof(BusRequest));
+        if (queues[i] == nullptr) {
+            return false;
+        }
+    }
+    
+    BaseType_t created = xTaskCreatePinnedToCore(taskEntry, "bus_sched", stack_size, this,
+                                                 task_priority, &task_handle, core);
+    if (created != pdPASS) {
+        task_handle = nullptr;
+        return false;
+    }
+    running = true;
+    return true;
+#else
+    (void)queue_depth;
+    (void)core;
+    (void)stack_size;
+    (void)task_priority;
+    return false;
+#endif
+}
+
+bool BusScheduler::isRunning() const {
+    return running;
+}
+
+// Inline execution is safe when nobody else can be waiting on this task
+bool BusScheduler::canRunInline() const {
+#if BUS_SCHEDULER_RTOS
+    if (!running) {
+        return true;
+    }
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    return self == task_handle || xSemaphoreGetMutexHolder(bus_mutex) == self;
+#else
+    return true;
+#endif
+}
+
+// Queue a request without waiting for it
+bool BusScheduler::submit(const BusRequest& request, BusPriority priority) {
+#if BUS_SCHEDULER_RTOS
+    if (running) {
+        if (xQueueSend(queues[(uint8_t)priority], &request, portMAX_DELAY) != pdTRUE) {
+            return false;
+        }
+        size_t depth = uxQueueMessagesWaiting(queues[(uint8_t)priority]);
+        if (depth > peak_pending[(uint8_t)priority]) {
+            peak_pending[(uint8_t)priority] = depth;
+        }
+        xTaskNotifyGive(task_handle);
+        return true;
+    }
+#endif
+    (void)priority;
+    complete(request, execute(request));
+    return true;
+}
+
+bool BusScheduler::submitFromISR(const BusRequest& request, BusPriority priority) {
+#if BUS_SCHEDULER_RTOS
+    if (!running) {
+        return false;  // The bus cannot be driven from an ISR
+    }
+    BaseType_t woken = pdFALSE;
+    if (xQueueSendFromISR(queues[(uint8_t)priority], &request, &woken) != pdTRUE) {
+        return false;
+    }
+    vTaskNotifyGiveFromISR(task_handle, &woken);
+    portYIELD_FROM_ISR(woken);
+    return true;
+#else
+    (void)request;
+    (void)priority;
+    return false;
+#endif
+}
+
+// Run a request and block the caller until the scheduler has completed it
+bool BusScheduler::transfer(const BusRequest& request, BusPriority priority) {
+    if (canRunInline()) {
+        bool success = execute(request);
+        complete(request, success);
+        return success;
+    }
+#if BUS_SCHEDULER_RTOS
+    BusRequest waiting = request;
+    waiting.notify_task = xTaskGetCurrentTaskHandle();
+    xTaskNotifyStateClear(nullptr);
+    if (!submit(waiting, priority)) {
+        return false;
+    }
+    uint32_t value = 0;
+    xTaskNotifyWait(0, 0xFFFFFFFF, &value, portMAX_DELAY);
+    return value == BUS_NOTIFY_SUCCESS;
+#else
+    (void)priority;
+    return false;
+#endif
+}
+
+// Write then read on the calling task
+bool BusScheduler::execute(const BusRequest& request) {
+    if (request.wire == nullptr) {
+        return false;
+    }
+    BusGuard guard;
+    PROFILE_SCOPE(ProfileZone::BUS_TRANSFER);
+    unsigned long start = micros();
+    bool success = executeLocked(request);
+    busy_time_us += micros() - start;
+    return success;
+}
+
+// Transaction body; the caller holds the bus lock
+bool BusScheduler::executeLocked(const BusRequest& request) {
+    TwoWire* wire = request.wire;
+    applyClock(wire, request.clock_hz);
+    
+    if (request.bulk) {
+        BusTransferStats stats = {};
+        unsigned long start = micros();
+        bool success = executeBulk(request, stats);
+        stats.bus_time_us = micros() - start;
+        if (request.stats != nullptr) {
+            *request.stats = stats;
+        }
+        return success;
+    }
+    
+    bool keep_bus = request.repeated_start && request.rx_length > 0;
+    if (request.tx_length > 0 || request.rx_length == 0) {
+        // A zero-length write is an address probe
+        wire->beginTransmission(request.address);
+        size_t written = (request.tx_length > 0) ? wire->write(request.tx_data, request.tx_length) : 0;
+        uint8_t error = wire->endTransmission(!keep_bus);
+        if (error != 0 || written != request.tx_length) {
+            return false;
+        }
+    }
+    
+    if (request.rx_length > 0) {
+        size_t received = wire->requestFrom(request.address, request.rx_length);
+        if (received != request.rx_length) {
+            return false;
+        }
+        for (size_t i = 0; i < request.rx_length; i++) {
+            if (!wire->available()) {
+                return false;
+            }
+            request.rx_data[i] = wire->read();
+        }
+    }
+    return true;
+}
+
+// Pick the bulk path for the request's bus
+bool BusScheduler::executeBulk(const BusRequest& request, BusTransferStats& stats) {
+    if (request.prefix_length > BUS_BULK_MAX_PREFIX) {
+        return false;
+    }
+#if BUS_SCHEDULER_IDF_BULK
+    if (request.wire == &Wire) {
+        return executeIdf(request, I2C_NUM_0, stats);
+    }
+#if SOC_I2C_NUM > 1
+    if (request.wire == &Wire1) {
+        return executeIdf(request, I2C_NUM_1, stats);
+    }
+#endif
+#endif
+    return executeChunked(request, stats);
+}
+
+#if BUS_SCHEDULER_IDF_BULK
+// One command-link transaction straight from the caller's buffers
+bool BusScheduler::executeIdf(const BusRequest& request, i2c_port_t port, BusTransferStats& stats) {
+    // Only the bus lock holder gets here, so a static link buffer is safe
+    static uint8_t link_buffer[I2C_LINK_RECOMMENDED_SIZE(3)];
+    i2c_cmd_handle_t cmd = i2c_cmd_link_create_static(link_buffer, sizeof(link_buffer));
+    if (cmd == nullptr) {
+        return false;
+    }
+    
+    bool has_write = request.prefix_length > 0 || request.tx_length > 0;
+    bool ok = true;
+    if (has_write || request.rx_length == 0) {
+        ok = i2c_master_start(cmd) == ESP_OK &&
+             i2c_master_write_byte(cmd, (request.address << 1) | I2C_MASTER_WRITE, true) == ESP_OK;
+        if (ok && request.prefix_length > 0) {
+            ok = i2c_master_write(cmd, request.prefix, request.prefix_length, true) == ESP_OK;
+        }
+        if (ok && request.tx_length > 0) {
+            ok = i2c_master_write(cmd, request.tx_data, request.tx_length, true) == ESP_OK;
+        }
+    }
+    if (ok && request.rx_length > 0) {
+        // Start (or repeated start) straight into the read
+        ok = i2c_master_start(cmd) == ESP_OK &&
+             i2c_master_write_byte(cmd, (request.address << 1) | I2C_MASTER_READ, true) == ESP_OK &&
+             i2c_master_read(cmd, request.rx_data, request.rx_length, I2C_MASTER_LAST_NACK) == ESP_OK;
+    }
+    ok = ok && i2c_master_stop(cmd) == ESP_OK &&
+         i2c_master_cmd_begin(port, cmd, pdMS_TO_TICKS(BUS_BULK_TIMEOUT_MS)) == ESP_OK;
+    i2c_cmd_link_delete_static(cmd);
+    
+    stats.transactions = 1;
+    if (ok) {
+        stats.bytes = request.tx_length + request.rx_length;
+    }
+    return ok;
+}
+#endif
+
+// Split the request into transactions that fit the TwoWire buffer
+bool BusScheduler::executeChunked(const BusRequest& request, BusTransferStats& stats) {
+    TwoWire* wire = request.wire;
+    size_t chunk = BUS_BULK_CHUNK_SIZE - request.prefix_length;
+    bool keep_bus = request.repeated_start && request.rx_length > 0;
+    
+    // A request with nothing to send or read is an address probe
+    bool has_write = request.prefix_length > 0 || request.tx_length > 0 || request.rx_length == 0;
+    if (has_write) {
+        size_t sent = 0;
+        do {
+            size_t count = min(chunk, request.tx_length - sent);
+            bool last = sent + count >= request.tx_length;
+            
+            wire->beginTransmission(request.address);
+            if (request.prefix_length > 0) {
+                wire->write(request.prefix, request.prefix_length);
+            }
+            size_t written = (count > 0) ? wire->write(request.tx_data + sent, count) : 0;
+            uint8_t error = wire->endTransmission(!(last && keep_bus));
+            stats.transactions++;
+            if (error != 0 || written != count) {
+                return false;
+            }
+            sent += count;
+            stats.bytes += count;
+        } while (sent < request.tx_length);
+    }
+    
+    // Later read chunks continue from where the device left off
+    size_t received = 0;
+    while (received < request.rx_length) {
+        size_t count = min((size_t)BUS_BULK_CHUNK_SIZE, request.rx_length - received);
+        size_t got = wire->requestFrom(request.address, count);
+        stats.transactions++;
+        if (got != count) {
+            return false;
+        }
+        for (size_t i = 0; i < count; i++) {
+            if (!wire->available()) {
+                return false;
+            }
+            request.rx_data[received++] = wire->read();
+        }
+        stats.bytes += count;
+    }
+    return true;
+}
+
+// Report a finished request to its owner
+void BusScheduler::complete(const BusRequest& request, bool success) {
+    if (success) {
+        completed_requests.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        failed_requests.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (request.callback != nullptr) {
+        request.callback(success, request.context);
+    }
+#if BUS_SCHEDULER_RTOS
+    if (request.notify_task != nullptr) {
+        xTaskNotify((TaskHandle_t)request.notify_task,
+                    success ? BUS_NOTIFY_SUCCESS : BUS_NOTIFY_FAILURE, eSetValueWithOverwrite);
+    }
+#endif
+}
+
+// Find (or claim) the clock state slot of a bus
+BusScheduler::BusClockState* BusScheduler::clockState(TwoWire* wire) {
+    BusClockState* free_slot = nullptr;
+    for (size_t i = 0; i < MAX_I2C_BUSES; i++) {
+        if (clock_states[i].wire == wire) {
+            return &clock_states[i];
+        }
+        if (clock_states[i].wire == nullptr && free_slot == nullptr) {
+            free_slot = &clock_states[i];
+        }
+    }
+    if (free_slot != nullptr) {
+        free_slot->wire = wire;
+        free_slot->current_hz = 0;
+        free_slot->limit_hz = 0;
+    }
+    return free_slot;
+}
+
+// Switch the bus to a request's rate if it differs from the current one
+void BusScheduler::applyClock(TwoWire* wire, uint32_t clock_hz) {
+    if (clock_hz == 0) {
+        return;
+    }
+    
+    BusClockState* state = clockState(wire);
+    if (state == nullptr) {
+        wire->setClock(clock_hz);  // Untracked bus: always set
+        return;
+    }
+    if (state->limit_hz != 0 && clock_hz > state->limit_hz) {
+        clock_hz = state->limit_hz;
+    }
+    if (state->current_hz != clock_hz) {
+        wire->setClock(clock_hz);
+        state->current_hz = clock_hz;
+    }
+}
+
+// Bus clock control
+void BusScheduler::setBusClockLimit(TwoWire* wire, uint32_t clock_hz) {
+    BusGuard guard;
+    BusClockState* state = clockState(wire);
+    if (state != nullptr) {
+        state->limit_hz = clock_hz;
+    }
+}
+
+uint32_t BusScheduler::getBusClockLimit(TwoWire* wire) {
+    BusGuard guard;
+    BusClockState* state = clockState(wire);
+    return state != nullptr ? state->limit_hz : 0;
+}
+
+uint32_t BusScheduler::getBusClock(TwoWire* wire) {
+    BusGuard guard;
+    BusClockState* state = clockState(wire);
+    return state != nullptr ? state->current_hz : 0;
+}
+
+void BusScheduler::invalidateClock(TwoWire* wire) {
+    BusGuard guard;
+    BusClockState* state = clockState(wire);
+    if (state != nullptr) {
+        state->current_hz = 0;
+    }
+}
+
+// Bus locking
+void BusScheduler::lockBus() {
+#if BUS_SCHEDULER_RTOS
+    if (bus_mutex != nullptr) {
+        xSemaphoreTakeRecursive(bus_mutex, portMAX_DELAY);
+    }
+#endif
+}
+
+void BusScheduler::unlockBus() {
+#if BUS_SCHEDULER_RTOS
+    if (bus_mutex != nullptr) {
+        xSemaphoreGiveRecursive(bus_mutex);
+    }
+#endif
+}
+
+// Statistics
+size_t BusScheduler::getPendingCount(BusPriority priority) const {
+#if BUS_SCHEDULER_RTOS
+    if (running) {
+        return uxQueueMessagesWaiting(queues[(uint8_t)priority]);
+    }
+#endif
+    (void)priority;
+    return 0;
+}
+
+unsigned long BusScheduler::getCompletedCount() const {
+    return completed_requests.load(std::memory_order_relaxed);
+}
+
+unsigned long BusScheduler::getFailedCount() const {
+    return failed_requests.load(std::memory_order_relaxed);
+}
+
+size_t BusScheduler::getPeakPendingCount(BusPriority priority) const {
+    return peak_pending[(uint8_t)priority];
+}
+
+uint64_t BusScheduler::getBusyTime() const {
+    BusGuard guard;  // 64-bit counter: read it whole
+    return busy_time_us;
+}
+
+#if BUS_SCHEDULER_RTOS
+void BusScheduler::taskEntry(void* param) {
+    static_cast<BusScheduler*>(param)->taskLoop();
+}
+
+// Serve one request at a time, rechecking the highest class after each so a
+// sensor read waits at most one display chunk
+void BusScheduler::taskLoop() {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        
+        BusRequest request;
+        bool found = true;
+        while (found) {
+            found = false;
+            for (int i = 0; i < BUS_PRIORITY_COUNT; i++) {
+                if (xQueueReceive(queues[i], &request, 0) == pdTRUE) {
+                    complete(request, execute(request));
+                    found = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+#endif
@@ -1,4 +1,6 @@
 #include "DataPlot.hpp"
+#include "AssetBuffer.hpp"
+#include "AxisLabelCache.hpp"
 #include <math.h>
 #include <string.h>
 
@@ -23,105 +25,44 @@ static void computeContentRect(int16_t x, int16_t y, int16_t width, int16_t heig
     if (contentH < 1) contentH = 1;
 }
 
-// Tiny 3x5 font for digits and basic symbols
-static const uint8_t tinyFont[][5] = {
-    // 0
-    {0b111,0b101,0b101,0b101,0b111},
-    // 1
-    {0b010,0b110,0b010,0b010,0b111},
-    // 2
-    {0b111,0b001,0b111,0b100,0b111},
-    // 3
-    {0b111,0b001,0b111,0b001,0b111},
-    // 4
-    {0b101,0b101,0b111,0b001,0b001},
-    // 5
-    {0b111,0b100,0b111,0b001,0b111},
-    // 6
-    {0b111,0b100,0b111,0b101,0b111},
-    // 7
-    {0b111,0b001,0b001,0b001,0b001},
-    // 8
-    {0b111,0b101,0b111,0b101,0b111},
-    // 9
-    {0b111,0b101,0b111,0b001,0b111},
-    // - (index 10)
-    {0b000,0b000,0b111,0b000,0b000},
-    // . (index 11)
-    {0b000,0b000,0b000,0b000,0b010},
-    // C (index 12)
-    {0b111,0b100,0b100,0b100,0b111},
-    // T (index 13)
-    {0b111,0b010,0b010,0b010,0b010},
-    // H (index 14)
-    {0b101,0b101,0b111,0b101,0b101},
-    // % (index 15)
-    {0b101,0b001,0b100,0b010,0b101}
-};
-
-static void drawTinyChar(LedScreen128_64* screen, int16_t x, int16_t y, char c, uint8_t scale=1) {
-    int index = -1;
-    if (c >= '0' && c <= '9') index = c - '0';
-    else if (c == '-') index = 10;
-    else if (c == '.') index = 11;
-    else if (c == 'C' || c == 'c') index = 12;
-    else if (c == 'T' || c == 't') index = 13;
-    else if (c == 'H' || c == 'h') index = 14;
-    else if (c == '%') index = 15;
-    if (index < 0) return; // unsupported char
-
-    for (int row = 0; row < 5; row++) {
-        uint8_t bits = tinyFont[index][row];
-        for (int col = 0; col < 3; col++) {
-            bool on = (bits >> (2 - col)) & 0x1;
-            if (on) {
-                for (int sy = 0; sy < scale; sy++) {
-                    for (int sx = 0; sx < scale; sx++) {
-                        screen->drawPixel(x + col * scale + sx, y + row * scale + sy, true);
-                    }
-                }
-            }
-        }
-    }
-}
-
-static void drawTinyText(LedScreen128_64* screen, int16_t x, int16_t y, const char* text, uint8_t scale=1) {
-    int16_t cursorX = x;
-    while (*text) {
-        char c = *text++;
-        if (c == ' ')
-            cursorX += (3*scale + scale); // spacing
-        else {
-            drawTinyChar(screen, cursorX, y, c, scale);
-            cursorX += (3*scale + scale); // char width + spacing
-        }
-    }
-}
-
 // Constructor
-DataPlot::DataPlot(int16_t x, int16_t y, int16_t width, int16_t height, int capacity)
+DataPlot::DataPlot(int16_t x, int16_t y, int16_t width, int16_t height, int capacity, bool implicitX)
         : GraphicsAsset(x, y, width, height, AssetType::DATAPLOT), dataX(nullptr), dataY(nullptr),
-      dataSize(0), dataCapacity(capacity), minX(0.0f), maxX(100.0f),
+      dataHead(0), dataSize(0), dataCapacity(capacity > 0 ? capacity : 0), implicitX(implicitX),
+      implicitXOrigin(0.0f), implicitXStep(1.0f), xExtrema(nullptr), yExtrema(nullptr), minX(0.0f), maxX(100.0f),
       minY(0.0f), maxY(100.0f), autoScale(true), style(PlotStyle::LINES),
-    showAxes(true), showGrid(false), gridSpacing(10), showAxisLabels(false), axisLabelSize(1), useTinyAxisLabels(false), tinyAxisLabelScale(1), autoTinyAxisLabels(true), tinyLabelAutoThreshold(36), maxTicks(0), animationFrame(0) {
+    showAxes(true), showGrid(false), gridSpacing(10), showAxisLabels(false), axisLabelSize(1), useTinyAxisLabels(false), tinyAxisLabelScale(1), autoTinyAxisLabels(true), tinyLabelAutoThreshold(36), maxTicks(0), animationFrame(0),
+      labelCache(nullptr), decimate(true), dataVersion(0), columns(nullptr), columnCapacity(0), columnCount(0),
+      columnsUsable(false), columnsCached(false), columnVersion(0), columnPoints(0),
+      columnMinX(0.0f), columnMaxX(0.0f), columnMinY(0.0f), columnMaxY(0.0f),
+      columnContentX(0), columnContentY(0), columnContentW(0), columnContentH(0) {
     
     // Allocate data arrays
     if (capacity > 0) {
-        dataX = new float[capacity];
-        dataY = new float[capacity];
+        if (!implicitX) {
+            dataX = assetBufferNew<float>(capacity);
+        }
+        dataY = assetBufferNew<float>(capacity);
+        if (dataY == nullptr || (!implicitX && dataX == nullptr)) {
+            assetBufferFree(dataX);
+            assetBufferFree(dataY);
+            dataX = nullptr;
+            dataY = nullptr;
+            dataCapacity = 0;
+        }
     }
 }
 
 // Destructor
 DataPlot::~DataPlot() {
-    if (dataX != nullptr) {
-        delete[] dataX;
-        dataX = nullptr;
-    }
-    if (dataY != nullptr) {
-        delete[] dataY;
-        dataY = nullptr;
-    }
+    assetBufferFree(dataX);
+    dataX = nullptr;
+    assetBufferFree(dataY);
+    dataY = nullptr;
+    assetBufferDestroy(xExtrema);
+    assetBufferDestroy(yExtrema);
+    assetBufferFree(columns);
+    assetBufferDestroy(labelCache);
 }
 
 // Draw method implementation
@@ -154,227 +95,8 @@ void DataPlot::draw(LedScreen128_64* screen) {
 
     // Draw axis labels if enabled
     if (showAxisLabels) {
-        // We'll draw ticks and numeric labels alongside axes
-        // Simple textual labels are small to avoid overlap
         screen->setTextSize(axisLabelSize);
-        int16_t contentX, contentY, contentW, contentH;
-        computeContentRect(x, y, width, height, axisLabelSize, showAxisLabels, contentX, contentY, contentW, contentH);
-    // Draw X axis tick labels
-    // We use the gridSpacing to determine tick spacing in pixels
-        int16_t prevLabelX = -9999;
-        bool effectiveTiny = useTinyAxisLabels || (autoTinyAxisLabels && contentW <= tinyLabelAutoThreshold);
-        bool effectiveTinyY = useTinyAxisLabels || (autoTinyAxisLabels && contentH <= tinyLabelAutoThreshold);
-        if (maxTicks > 1) {
-            float step = (contentW - 1) / (float)(maxTicks - 1);
-            for (int k = 0; k < maxTicks; k++) {
-                int16_t i = (int16_t)round(k * step);
-                int16_t tickX = contentX + i;
-                // Inverse map to get data X value at this screen X
-                float normalized = (contentW > 1) ? ((float)i) / (float)(contentW - 1) : 0.0f;
-                float dataValue = minX + normalized * (maxX - minX);
-                // Position label slightly below x-axis if possible; otherwise above
-                int16_t labelY = contentY + contentH + 1; // default below content rect
-                // If the x-axis is within range, place label near axis
-                if (minY <= 0.0f && maxY >= 0.0f) {
-                    int16_t y0 = mapY(0.0f);
-                    if (y0 + (8 * axisLabelSize) + 1 < (y + height)) {
-                        // Place below axis if there's space
-                        labelY = y0 + 1;
-                    } else {
-                        labelY = y0 - (8 * axisLabelSize) - 1;
-                    }
-                }
-                char buf[12];
-                // Print with 1 decimal when necessary
-                if (fabs(dataValue - (int)dataValue) < 0.001f) {
-                    snprintf(buf, sizeof(buf), "%d", (int)dataValue);
-                } else {
-                    snprintf(buf, sizeof(buf), "%.1f", dataValue);
-                }
-                    if (effectiveTiny) {
-                    int16_t labelW = (int)strlen(buf) * (3 * tinyAxisLabelScale + tinyAxisLabelScale);
-                    int16_t labelX = tickX - labelW / 2;
-                    if (prevLabelX < -1000 || abs(labelX - prevLabelX) >= (labelW + 2)) {
-                        drawTinyText(screen, labelX, labelY, buf, tinyAxisLabelScale);
-                        prevLabelX = labelX;
-                    }
-                } else {
-                    int16_t labelW = (int)strlen(buf) * 6 * axisLabelSize;
-                    int16_t labelX = tickX - labelW / 2;
-                    if (prevLabelX < -1000 || abs(labelX - prevLabelX) >= (labelW + 2)) {
-                        screen->setCursor(labelX, labelY);
-                        screen->print(buf);
-                        prevLabelX = labelX;
-                    }
-                }
-            }
-        } else {
-            if (gridSpacing <= 0 || gridSpacing >= contentW) {
-                // At least draw the min and max tick
-                for (int k = 0; k < 2; k++) {
-                    int16_t i = (k == 0) ? 0 : (contentW - 1);
-                    int16_t tickX = contentX + i;
-                    float normalized = (contentW > 1) ? ((float)i) / (float)(contentW - 1) : 0.0f;
-                    float dataValue = minX + normalized * (maxX - minX);
-                    int16_t labelY = contentY + contentH + 1;
-                    if (minY <= 0.0f && maxY >= 0.0f) {
-                        int16_t y0 = mapY(0.0f);
-                        if (y0 + (8 * axisLabelSize) + 1 < (y + height)) {
-                            labelY = y0 + 1;
-                        } else {
-                            labelY = y0 - (8 * axisLabelSize) - 1;
-                        }
-                    }
-                    char buf[12];
-                    if (fabs(dataValue - (int)dataValue) < 0.001f) {
-                        snprintf(buf, sizeof(buf), "%d", (int)dataValue);
-                    } else {
-                        snprintf(buf, sizeof(buf), "%.1f", dataValue);
-                    }
-                        if (effectiveTiny) {
-                        int16_t labelW = (int)strlen(buf) * (3 * tinyAxisLabelScale + tinyAxisLabelScale);
-                        int16_t labelX = tickX - labelW / 2;
-                        if (prevLabelX < -1000 || abs(labelX - prevLabelX) >= (labelW + 2)) {
-                            drawTinyText(screen, labelX, labelY, buf, tinyAxisLabelScale);
-                            prevLabelX = labelX;
-                        }
-                    } else {
-                        int16_t labelW = (int)strlen(buf) * 6 * axisLabelSize;
-                        int16_t labelX = tickX - labelW / 2;
-                        if (prevLabelX < -1000 || abs(labelX - prevLabelX) >= (labelW + 2)) {
-                            screen->setCursor(labelX, labelY);
-                            screen->print(buf);
-                            prevLabelX = labelX;
-                        }
-                    }
-                }
-            } else {
-                for (int16_t i = gridSpacing; i < contentW; i += gridSpacing) {
-                    int16_t tickX = contentX + i;
-                    float normalized = (contentW > 1) ? ((float)i) / (float)(contentW - 1) : 0.0f;
-                    float dataValue = minX + normalized * (maxX - minX);
-                    int16_t labelY = contentY + contentH + 1; // default below content rect
-                    if (minY <= 0.0f && maxY >= 0.0f) {
-                        int16_t y0 = mapY(0.0f);
-                        if (y0 + (8 * axisLabelSize) + 1 < (y + height)) {
-                            labelY = y0 + 1;
-                        } else {
-                            labelY = y0 - (8 * axisLabelSize) - 1;
-                        }
-                    }
-                    char buf[12];
-                    if (fabs(dataValue - (int)dataValue) < 0.001f) {
-                        snprintf(buf, sizeof(buf), "%d", (int)dataValue);
-                    } else {
-                        snprintf(buf, sizeof(buf), "%.1f", dataValue);
-                    }
-                        if (effectiveTiny) {
-                        int16_t labelW = (int)strlen(buf) * (3 * tinyAxisLabelScale + tinyAxisLabelScale);
-                        int16_t labelX = tickX - labelW / 2;
-                        if (prevLabelX < -1000 || abs(labelX - prevLabelX) >= (labelW + 2)) {
-                            drawTinyText(screen, labelX, labelY, buf, tinyAxisLabelScale);
-                            prevLabelX = labelX;
-                        }
-                    } else {
-                        int16_t labelW = (int)strlen(buf) * 6 * axisLabelSize;
-                        int16_t labelX = tickX - labelW / 2;
-                        if (prevLabelX < -1000 || abs(labelX - prevLabelX) >= (labelW + 2)) {
-                            screen->setCursor(labelX, labelY);
-                            screen->print(buf);
-                            prevLabelX = labelX;
-                        }
-                    }
-                }
-            }
-        }
-
-        // Draw Y axis tick labels
-        int16_t prevLabelY = -9999;
-        if (maxTicks > 1) {
-            float stepY = (contentH - 1) / (float)(maxTicks - 1);
-            for (int k = 0; k < maxTicks; k++) {
-                int16_t i = (int16_t)round(k * stepY);
-                int16_t tickY = contentY + i;
-                float normalized = (contentH > 1) ? (1.0f - ((float)(i) / (float)(contentH - 1))) : 0.0f;
-                float dataValue = minY + normalized * (maxY - minY);
-            char buf[12];
-            if (fabs(dataValue - (int)dataValue) < 0.001f) {
-                snprintf(buf, sizeof(buf), "%d", (int)dataValue);
-            } else {
-                snprintf(buf, sizeof(buf), "%.1f", dataValue);
-            }
-            // Position label left of y-axis or at left edge
-                int16_t labelX;
-                if (minX <= 0.0f && maxX >= 0.0f) {
-                    int16_t x0 = mapX(0.0f);
-                    labelX = x0 - (int)strlen(buf) * 6 * axisLabelSize - 2;
-                    if (labelX < x) {
-                        // If the calculated position is inside the content rect, push it into the left margin
-                        labelX = contentX - (int)strlen(buf) * 6 * axisLabelSize - 2;
-                        if (labelX < x) labelX = x + 1;
-                    }
-                } else {
-                    labelX = contentX - (int)strlen(buf) * 6 * axisLabelSize - 2;
-                    if (labelX < x) labelX = x + 1;
-                }
-            if (effectiveTinyY) {
-                    int16_t labelH = 5 * tinyAxisLabelScale;
-                    int16_t labelYAdj = tickY - labelH / 2;
-                if (prevLabelY < -1000 || abs(labelYAdj - prevLabelY) >= (labelH + 2)) {
-                    drawTinyText(screen, labelX, labelYAdj, buf, tinyAxisLabelScale);
-                    prevLabelY = labelYAdj;
-                }
-            } else {
-                int16_t labelH = 8 * axisLabelSize;
-                int16_t labelYAdj = tickY - labelH / 2;
-                if (prevLabelY < -1000 || abs(labelYAdj - prevLabelY) >= (labelH + 2)) {
-                    screen->setCursor(labelX, labelYAdj);
-                    screen->print(buf);
-                    prevLabelY = labelYAdj;
-                }
-            }
-            }
-        } else {
-            for (int16_t i = gridSpacing; i < contentH; i += gridSpacing) {
-                int16_t tickY = contentY + i;
-                float normalized = 1.0f - ((float)(i) / (float)(contentH - 1));
-                float dataValue = minY + normalized * (maxY - minY);
-                char buf[12];
-                if (fabs(dataValue - (int)dataValue) < 0.001f) {
-                    snprintf(buf, sizeof(buf), "%d", (int)dataValue);
-                } else {
-                    snprintf(buf, sizeof(buf), "%.1f", dataValue);
-                }
-                int16_t labelX;
-                if (minX <= 0.0f && maxX >= 0.0f) {
-                    int16_t x0 = mapX(0.0f);
-                    labelX = x0 - (int)strlen(buf) * 6 * axisLabelSize - 2;
-                    if (labelX < x) {
-                        labelX = contentX - (int)strlen(buf) * 6 * axisLabelSize - 2;
-                        if (labelX < x) labelX = x + 1;
-                    }
-                } else {
-                    labelX = contentX - (int)strlen(buf) * 6 * axisLabelSize - 2;
-                    if (labelX < x) labelX = x + 1;
-                }
-                if (effectiveTinyY) {
-                    int16_t labelH = 5 * tinyAxisLabelScale;
-                    int16_t labelYAdj = tickY - labelH / 2;
-                    if (prevLabelY < -1000 || abs(labelYAdj - prevLabelY) >= (labelH + 2)) {
-                        drawTinyText(screen, labelX, labelYAdj, buf, tinyAxisLabelScale);
-                        prevLabelY = labelYAdj;
-                    }
-                } else {
-                    int16_t labelH = 8 * axisLabelSize;
-                    int16_t labelYAdj = tickY - labelH / 2;
-                    if (prevLabelY < -1000 || abs(labelYAdj - prevLabelY) >= (labelH + 2)) {
-                        screen->setCursor(labelX, labelYAdj);
-                        screen->print(buf);
-                        prevLabelY = labelYAdj;
-                    }
-                }
-            }
-        }
+        drawAxisLabels(screen);
     }
     
     // Determine how many points to draw (for animation)
@@ -383,33 +105,40 @@ void DataPlot::draw(LedScreen128_64* screen) {
         maxPoints = animationFrame;
         // Auto-advance animation on each draw
         animationFrame++;
+        markDirty();  // Next frame still has to be drawn in retained mode
     }
     
-    // Plot the data
+    // More points than columns: draw the cached per-column envelope instead
+    if (decimate && maxPoints > contentW &&
+        updateColumns(maxPoints, contentX, contentY, contentW, contentH)) {
+        drawColumns(screen);
+        return;
+    }
+    
+    // Plot the data in logical order, carrying the previous point forward
+    bool prevInRange = false;
+    int16_t prevScreenX = 0;
+    int16_t prevScreenY = 0;
     for (int i = 0; i < maxPoints; i++) {
+        float px = pointX(i);
+        float py = pointY(i);
+        
         // Check if data point is within range
-        if (dataX[i] < minX || dataX[i] > maxX || 
-            dataY[i] < minY || dataY[i] > maxY) {
+        if (px < minX || px > maxX || py < minY || py > maxY) {
+            prevInRange = false;
             continue;
         }
         
         // Map to screen coordinates
-        int16_t screenX = mapX(dataX[i]);
-        int16_t screenY = mapY(dataY[i]);
+        int16_t screenX = mapX(px);
+        int16_t screenY = mapY(py);
         
-        // Draw line to previous point if applicable
-        if (i > 0 && (style == PlotStyle::LINES || style == PlotStyle::LINES_POINTS)) {
-            // Check if previous point is also in range
-            if (dataX[i-1] >= minX && dataX[i-1] <= maxX &&
-                dataY[i-1] >= minY && dataY[i-1] <= maxY) {
-                int16_t prevScreenX = mapX(dataX[i-1]);
-                int16_t prevScreenY = mapY(dataY[i-1]);
-                
-                // Only draw line if points are reasonably close
-                if (abs(screenX - prevScreenX) < contentW && 
-                    abs(screenY - prevScreenY) < contentH) {
-                    screen->drawLine(prevScreenX, prevScreenY, screenX, screenY, true);
-                }
+        // Draw line to previous point if it was also in range
+        if (prevInRange && (style == PlotStyle::LINES || style == PlotStyle::LINES_POINTS)) {
+            // Only draw line if points are reasonably close
+            if (abs(screenX - prevScreenX) < contentW && 
+                abs(screenY - prevScreenY) < contentH) {
+                screen->drawLine(prevScreenX, prevScreenY, screenX, screenY, true);
             }
         }
         
@@ -422,39 +151,73 @@ void DataPlot::draw(LedScreen128_64* screen) {
             if (screenY > 0) screen->drawPixel(screenX, screenY - 1, true);
             if (screenY < 63) screen->drawPixel(screenX, screenY + 1, true);
         }
+        
+        prevInRange = true;
+        prevScreenX = screenX;
+        prevScreenY = screenY;
     }
 }
 
 // Data management
 void DataPlot::addPoint(float x, float y) {
+    markDirty();
+    if (dataCapacity <= 0) {
+        return;
+    }
+    
+    int slot;
     if (dataSize < dataCapacity) {
-        dataX[dataSize] = x;
-        dataY[dataSize] = y;
+        slot = ringIndex(dataSize);
         dataSize++;
     } else {
-        // Shift data left and add new point at end (rolling buffer)
-        for (int i = 0; i < dataCapacity - 1; i++) {
-            dataX[i] = dataX[i + 1];
-            dataY[i] = dataY[i + 1];
-        }
-        dataX[dataCapacity - 1] = x;
-        dataY[dataCapacity - 1] = y;
+        // Full: overwrite the oldest point and advance the head
+        slot = dataHead;
+        dataHead = (dataHead + 1) % dataCapacity;
+        if (xExtrema != nullptr) xExtrema->evict(slot);
+        if (yExtrema != nullptr) yExtrema->evict(slot);
+    }
+    if (dataX != nullptr) {
+        dataX[slot] = x;
     }
+    dataY[slot] = y;
+    dataVersion++;
+    if (xExtrema != nullptr) xExtrema->push(slot);
+    if (yExtrema != nullptr) yExtrema->push(slot);
+}
+
+void DataPlot::addValue(float y) {
+    float x = implicitXOrigin;
+    if (!implicitX && dataSize > 0) {
+        x = pointX(dataSize - 1) + implicitXStep;
+    }
+    addPoint(x, y);
 }
 
 void DataPlot::setData(const float* xData, const float* yData, int size) {
     clearData();
+    if (yData == nullptr || (xData == nullptr && !implicitX)) {
+        return;
+    }
     
     int pointsToAdd = (size < dataCapacity) ? size : dataCapacity;
     for (int i = 0; i < pointsToAdd; i++) {
-        dataX[i] = xData[i];
+        if (dataX != nullptr) {
+            dataX[i] = xData[i];
+        }
         dataY[i] = yData[i];
     }
     dataSize = pointsToAdd;
+    dataVersion++;
+    rebuildExtrema();
 }
 
 void DataPlot::clearData() {
+    markDirty();
+    dataHead = 0;
     dataSize = 0;
+    dataVersion++;
+    if (xExtrema != nullptr) xExtrema->clear();
+    if (yExtrema != nullptr) yExtrema->clear();
 }
 
 int DataPlot::getDataSize() const {
@@ -465,11 +228,23 @@ int DataPlot::getDataCapacity() const {
     return dataCapacity;
 }
 
+// Implicit X control
+bool DataPlot::hasImplicitX() const {
+    return implicitX;
+}
+
+void DataPlot::setImplicitXSpacing(float origin, float step) {
+    markDirty();
+    implicitXOrigin = origin;
+    implicitXStep = step;
+    dataVersion++;
+}
+
 // Get data points
 bool DataPlot::getPoint(int index, float& x, float& y) const {
     if (index >= 0 && index < dataSize) {
-        x = dataX[index];
-        y = dataY[index];
+        x = pointX(index);
+        y = pointY(index);
         return true;
     }
     return false;
@@ -477,6 +252,7 @@ bool DataPlot::getPoint(int index, float& x, float& y) const {
 
 // Range settings
 void DataPlot::setXRange(float minX, float maxX) {
+    markDirty();
     if (minX < maxX) {
         this->minX = minX;
         this->maxX = maxX;
@@ -485,6 +261,7 @@ void DataPlot::setXRange(float minX, float maxX) {
 }
 
 void DataPlot::setYRange(float minY, float maxY) {
+    markDirty();
     if (minY < maxY) {
         this->minY = minY;
         this->maxY = maxY;
@@ -504,6 +281,7 @@ void DataPlot::getYRange(float& minY, float& maxY) const {
 
 // Display options
 void DataPlot::setAutoScale(bool autoScale) {
+    markDirty();
     this->autoScale = autoScale;
 }
 
@@ -512,6 +290,7 @@ bool DataPlot::getAutoScale() const {
 }
 
 void DataPlot::setPlotStyle(PlotStyle style) {
+    markDirty();
     this->style = style;
 }
 
@@ -520,6 +299,7 @@ PlotStyle DataPlot::getPlotStyle() const {
 }
 
 void DataPlot::setShowAxes(bool show) {
+    markDirty();
     this->showAxes = show;
 }
 
@@ -528,6 +308,7 @@ bool DataPlot::getShowAxes() const {
 }
 
 void DataPlot::setShowGrid(bool show) {
+    markDirty();
     this->showGrid = show;
 }
 
@@ -536,6 +317,7 @@ bool DataPlot::getShowGrid() const {
 }
 
 void DataPlot::setGridSpacing(uint8_t spacing) {
+    markDirty();
     if (spacing > 0) {
         this->gridSpacing = spacing;
     }
@@ -546,6 +328,7 @@ uint8_t DataPlot::getGridSpacing() const {
 }
 
 void DataPlot::setShowAxisLabels(bool show) {
+    markDirty();
     this->showAxisLabels = show;
 }
 
@@ -554,6 +337,7 @@ bool DataPlot::getShowAxisLabels() const {
 }
 
 void DataPlot::setAxisLabelSize(uint8_t size) {
+    markDirty();
     if (size < 1) size = 1;
     if (size > 4) size = 4;
     this->axisLabelSize = size;
@@ -564,6 +348,7 @@ uint8_t DataPlot::getAxisLabelSize() const {
 }
 
 void DataPlot::setAutoTinyAxisLabels(bool autoEnable) {
+    markDirty();
     this->autoTinyAxisLabels = autoEnable;
 }
 
@@ -572,6 +357,7 @@ bool DataPlot::getAutoTinyAxisLabels() const {
 }
 
 void DataPlot::setTinyLabelAutoThreshold(uint8_t threshold) {
+    markDirty();
     this->tinyLabelAutoThreshold = threshold;
 }
 
@@ -580,6 +366,7 @@ uint8_t DataPlot::getTinyLabelAutoThreshold() const {
 }
 
 void DataPlot::setMaxTicks(uint8_t max) {
+    markDirty();
     this->maxTicks = max;
 }
 
@@ -587,7 +374,18 @@ uint8_t DataPlot::getMaxTicks() const {
     return maxTicks;
 }
 
+// Decimation control
+void DataPlot::setDecimation(bool enable) {
+    markDirty();
+    decimate = enable;
+}
+
+bool DataPlot::getDecimation() const {
+    return decimate;
+}
+
 void DataPlot::setUseTinyAxisLabels(bool use) {
+    markDirty();
     this->useTinyAxisLabels = use;
 }
 
@@ -596,6 +394,7 @@ bool DataPlot::getUseTinyAxisLabels() const {
 }
 
 void DataPlot::setTinyAxisLabelScale(uint8_t scale) {
+    markDirty();
     if (scale < 1) scale = 1;
     this->tinyAxisLabelScale = scale;
 }
@@ -657,22 +456,222 @@ void DataPlot::drawGrid(LedScreen128_64* screen) {
     }
 }
 
+// Tick labels are laid out once per axis range and replayed from the cache
+void DataPlot::drawAxisLabels(LedScreen128_64* screen) {
+    if (labelCache == nullptr) {
+        labelCache = assetBufferCreate<AxisLabelCache>();
+        if (labelCache == nullptr) {
+            return;
+        }
+    }
+    
+    AxisLabelParams layout;
+    layout.x = x;
+    layout.y = y;
+    layout.width = width;
+    layout.height = height;
+    computeContentRect(x, y, width, height, axisLabelSize, showAxisLabels,
+                      layout.contentX, layout.contentY, layout.contentW, layout.contentH);
+    layout.minX = minX;
+    layout.maxX = maxX;
+    layout.minY = minY;
+    layout.maxY = maxY;
+    layout.zeroX = mapX(0.0f);
+    layout.zeroY = mapY(0.0f);
+    layout.gridSpacing = gridSpacing;
+    layout.maxTicks = maxTicks;
+    layout.labelSize = axisLabelSize;
+    layout.tinyScale = tinyAxisLabelScale;
+    layout.tinyX = useTinyAxisLabels || (autoTinyAxisLabels && layout.contentW <= tinyLabelAutoThreshold);
+    layout.tinyY = useTinyAxisLabels || (autoTinyAxisLabels && layout.contentH <= tinyLabelAutoThreshold);
+    labelCache->draw(screen, layout);
+}
+
+// Ring buffer access in logical order (index 0 is the oldest point)
+int DataPlot::ringIndex(int index) const {
+    int slot = dataHead + index;
+    return (slot >= dataCapacity) ? slot - dataCapacity : slot;
+}
+
+float DataPlot::pointX(int index) const {
+    if (implicitX) {
+        return implicitXOrigin + implicitXStep * (float)index;
+    }
+    return dataX[ringIndex(index)];
+}
+
+float DataPlot::pointY(int index) const {
+    return dataY[ringIndex(index)];
+}
+
+// Bin the first 'points' points into pixel columns. Only rebuilt when the data,
+// ranges or content rect differ from the cached key. Returns false when X is
+// not sorted, since the envelope would then join points in the wrong order.
+bool DataPlot::updateColumns(int points, int16_t contentX, int16_t contentY, int16_t contentW, int16_t contentH) {
+    if (columnsCached && columnVersion == dataVersion && columnPoints == points &&
+        columnMinX == minX && columnMaxX == maxX && columnMinY == minY && columnMaxY == maxY &&
+        columnContentX == contentX && columnContentY == contentY &&
+        columnContentW == contentW && columnContentH == contentH) {
+        return columnsUsable;
+    }
+    
+    columnsCached = true;
+    columnVersion = dataVersion;
+    columnPoints = points;
+    columnMinX = minX;
+    columnMaxX = maxX;
+    columnMinY = minY;
+    columnMaxY = maxY;
+    columnContentX = contentX;
+    columnContentY = contentY;
+    columnContentW = contentW;
+    columnContentH = contentH;
+    
+    if (columnCapacity < contentW) {
+        assetBufferFree(columns);
+        columns = assetBufferNew<PlotColumn>(contentW);
+        columnCapacity = columns != nullptr ? contentW : 0;
+    }
+    if (columns == nullptr) {
+        columnsUsable = false;
+        return false;
+    }
+    
+    columnCount = 0;
+    columnsUsable = false;
+    bool broken = true;  // Previous point was out of range (or there is none)
+    for (int i = 0; i < points; i++) {
+        float px = pointX(i);
+        float py = pointY(i);
+        if (px < minX || px > maxX || py < minY || py > maxY) {
+            broken = true;
+            continue;
+        }
+        
+        int16_t screenX = mapX(px);
+        int16_t screenY = mapY(py);
+        PlotColumn* last = (columnCount > 0) ? &columns[columnCount - 1] : nullptr;
+        if (last != nullptr && screenX < last->screenX) {
+            return false;
+        }
+        
+        if (last != nullptr && screenX == last->screenX) {
+            last->lastY = screenY;
+            if (screenY < last->minY) last->minY = screenY;
+            if (screenY > last->maxY) last->maxY = screenY;
+            last->points++;
+        } else if (columnCount < columnCapacity) {
+            PlotColumn& column = columns[columnCount++];
+            column.screenX = screenX;
+            column.firstY = screenY;
+            column.lastY = screenY;
+            column.minY = screenY;
+            column.maxY = screenY;
+            column.points = 1;
+            column.linked = !broken && last != nullptr;
+        }
+        broken = false;
+    }
+    
+    columnsUsable = true;
+    return true;
+}
+
+// Rasterise the cached columns; for sorted X this matches per-point drawing
+// (consecutive points in one column form a single vertical run)
+void DataPlot::drawColumns(LedScreen128_64* screen) {
+    bool lines = (style == PlotStyle::LINES || style == PlotStyle::LINES_POINTS);
+    bool marks = (style == PlotStyle::POINTS || style == PlotStyle::LINES_POINTS);
+    
+    for (int16_t k = 0; k < columnCount; k++) {
+        const PlotColumn& column = columns[k];
+        if (lines) {
+            if (column.linked) {
+                const PlotColumn& prev = columns[k - 1];
+                screen->drawLine(prev.screenX, prev.lastY, column.screenX, column.firstY, true);
+            }
+            if (column.points > 1) {
+                screen->drawFastVLine(column.screenX, column.minY, column.maxY - column.minY + 1, true);
+            }
+        }
+        
+        if (marks) {
+            // Mark the column extremes so spikes stay visible
+            int16_t markY[2] = { column.minY, column.maxY };
+            for (int m = 0; m < (column.minY == column.maxY ? 1 : 2); m++) {
+                int16_t sx = column.screenX;
+                int16_t sy = markY[m];
+                screen->drawPixel(sx, sy, true);
+                if (sx > 0) screen->drawPixel(sx - 1, sy, true);
+                if (sx < 127) screen->drawPixel(sx + 1, sy, true);
+                if (sy > 0) screen->drawPixel(sx, sy - 1, true);
+                if (sy < 63) screen->drawPixel(sx, sy + 1, true);
+            }
+        }
+    }
+}
+
+// Refill the extreme trackers from the stored points
+void DataPlot::rebuildExtrema() {
+    if (xExtrema != nullptr) xExtrema->clear();
+    if (yExtrema != nullptr) yExtrema->clear();
+    for (int i = 0; i < dataSize; i++) {
+        int slot = ringIndex(i);
+        if (xExtrema != nullptr) xExtrema->push(slot);
+        if (yExtrema != nullptr) yExtrema->push(slot);
+    }
+}
+
 void DataPlot::calculateRanges() {
     if (dataSize == 0) {
         return;
     }
     
-    // Find min and max values
-    float calcMinX = dataX[0];
-    float calcMaxX = dataX[0];
-    float calcMinY = dataY[0];
-    float calcMaxY = dataY[0];
+    // Start tracking extremes incrementally the first time they are needed
+    if (yExtrema == nullptr && dataCapacity <= SLIDING_EXTREMA_MAX_CAPACITY) {
+        yExtrema = assetBufferCreate<SlidingExtrema>(dataY, dataCapacity);
+        if (dataX != nullptr) {
+            xExtrema = assetBufferCreate<SlidingExtrema>(dataX, dataCapacity);
+        }
+        rebuildExtrema();
+    }
     
-    for (int i = 1; i < dataSize; i++) {
-        if (dataX[i] < calcMinX) calcMinX = dataX[i];
-        if (dataX[i] > calcMaxX) calcMaxX = dataX[i];
-        if (dataY[i] < calcMinY) calcMinY = dataY[i];
-        if (dataY[i] > calcMaxY) calcMaxY = dataY[i];
+    float calcMinX;
+    float calcMaxX;
+    float calcMinY;
+    float calcMaxY;
+    if (yExtrema != nullptr) {
+        calcMinY = yExtrema->getMin();
+        calcMaxY = yExtrema->getMax();
+    } else {
+        // Too many points for the trackers, fall back to a scan (ring order does not matter)
+        calcMinY = dataY[0];
+        calcMaxY = dataY[0];
+        for (int i = 1; i < dataSize; i++) {
+            if (dataY[i] < calcMinY) calcMinY = dataY[i];
+            if (dataY[i] > calcMaxY) calcMaxY = dataY[i];
+        }
+    }
+    
+    if (implicitX) {
+        // Implicit X is monotonic, so the ends of the series are the extremes
+        calcMinX = pointX(0);
+        calcMaxX = pointX(dataSize - 1);
+        if (calcMinX > calcMaxX) {
+            float t = calcMinX;
+            calcMinX = calcMaxX;
+            calcMaxX = t;
+        }
+    } else if (xExtrema != nullptr) {
+        calcMinX = xExtrema->getMin();
+        calcMaxX = xExtrema->getMax();
+    } else {
+        calcMinX = dataX[0];
+        calcMaxX = dataX[0];
+        for (int i = 1; i < dataSize; i++) {
+            if (dataX[i] < calcMinX) calcMinX = dataX[i];
+            if (dataX[i] > calcMaxX) calcMaxX = dataX[i];
+        }
     }
     
     // Add 10% padding
@@ -694,10 +693,12 @@ void DataPlot::calculateRanges() {
 
 // Animation control
 void DataPlot::resetAnimation() {
+    markDirty();
     animationFrame = 0;
 }
 
 void DataPlot::advanceAnimation() {
+    markDirty();
     if (animationFrame < dataSize) {
         animationFrame++;
     }
@@ -1,11 +1,84 @@
 #include "Device.hpp"
 
 // Initialize the static global queue
-std::queue<DeviceAction> Device::action_queue;
+ActionQueue Device::action_queue;
+
+// Action queue constructor
+ActionQueue::ActionQueue() : head(0), count(0), peak_count(0) {
+}
+
+// Reserve the tail of the ring for a new action
+DeviceAction* ActionQueue::claimTail() {
+    if (count >= ACTION_QUEUE_CAPACITY) {
+        return nullptr;
+    }
+    
+    DeviceAction* slot = &slots[(head + count) % ACTION_QUEUE_CAPACITY];
+    count++;
+    if (count > peak_count) {
+        peak_count = count;
+    }
+    return slot;
+}
+
+// Append to the tail of the ring
+bool ActionQueue::push(const DeviceAction& action) {
+    return emplace(action) != nullptr;
+}
+
+bool ActionQueue::push(DeviceAction&& action) {
+    return emplace(std::move(action)) != nullptr;
+}
+
+// Oldest queued action
+DeviceAction& ActionQueue::front() {
+    return slots[head];
+}
+
+const DeviceAction& ActionQueue::front() const {
+    return slots[head];
+}
+
+// Drop the oldest action
+void ActionQueue::pop() {
+    if (count == 0) {
+        return;
+    }
+    
+    head = (head + 1) % ACTION_QUEUE_CAPACITY;
+    count--;
+}
+
+// Queue state
+bool ActionQueue::empty() const {
+    return count == 0;
+}
+
+bool ActionQueue::full() const {
+    return count >= ACTION_QUEUE_CAPACITY;
+}
+
+size_t ActionQueue::size() const {
+    return count;
+}
+
+size_t ActionQueue::capacity() const {
+    return ACTION_QUEUE_CAPACITY;
+}
+
+size_t ActionQueue::peak() const {
+    return peak_count;
+}
+
+void ActionQueue::clear() {
+    head = 0;
+    count = 0;
+}
 
 // Constructor
 Device::Device(uint8_t address, TwoWire* wire)
-    : i2c_address(address), wire_instance(wire), initialized(false) {
+    : i2c_address(address), wire_instance(wire), initialized(false), bus_priority(BusPriority::CONTROL),
+      max_bus_frequency(I2C_STANDARD_CLOCK), known_bus_frequency(0) {
 }
 
 // Destructor
@@ -15,23 +88,43 @@ Device::~Device() {
 // Initialize the device
 bool Device::begin() {
     if (!initialized) {
-        wire_instance->begin();
-        initialized = isConnected();
+        {
+            BusGuard guard(wire_instance);
+            wire_instance->begin();
+        }
+        if (known_bus_frequency != 0) {
+            // Already negotiated (e.g. before deep sleep): skip the probes
+            max_bus_frequency = known_bus_frequency;
+            known_bus_frequency = 0;
+            initialized = true;
+        } else {
+            initialized = negotiateBusFrequency() != 0;
+        }
     }
     return initialized;
 }
 
+// Two-phase initialization; by default all work happens in the first phase
+bool Device::startBegin() {
+    return begin();
+}
+
+bool Device::finishBegin() {
+    return true;
+}
+
+// Check if Device::begin() succeeded
+bool Device::isInitialized() const {
+    return initialized;
+}
+
 // Generic send function - sends data to the device over I2C
 bool Device::send(const uint8_t* data, size_t length) {
     if (!initialized || wire_instance == nullptr) {
         return false;
     }
     
-    wire_instance->beginTransmission(i2c_address);
-    size_t bytes_written = wire_instance->write(data, length);
-    uint8_t error = wire_instance->endTransmission();
-    
-    return (error == 0 && bytes_written == length);
+    return transact(data, length, nullptr, 0);
 }
 
 // Generic receive function - receives data from the device over I2C
@@ -39,22 +132,35 @@ bool Device::receive(uint8_t* buffer, size_t length) {
     if (!initialized || wire_instance == nullptr) {
         return false;
     }
+    if (length == 0) {
+        return true;
+    }
     
-    size_t bytes_received = wire_instance->requestFrom(i2c_address, length);
+    return transact(nullptr, 0, buffer, length);
+}
+
+// Bulk send from a caller-owned buffer
+bool Device::sendBulk(const uint8_t* data, size_t length, const uint8_t* prefix, size_t prefix_length,
+                      BusTransferStats* stats) {
+    if (!initialized || wire_instance == nullptr || (data == nullptr && length > 0)) {
+        return false;
+    }
     
-    if (bytes_received != length) {
+    return transactBulk(data, length, nullptr, 0, prefix, prefix_length, stats);
+}
+
+// Bulk receive into a caller-owned buffer
+bool Device::receiveBulk(uint8_t* buffer, size_t length, const uint8_t* prefix, size_t prefix_length,
+                         BusTransferStats* stats) {
+    if (!initialized || wire_instance == nullptr || buffer == nullptr) {
         return false;
     }
     
-    for (size_t i = 0; i < length; i++) {
-        if (wire_instance->available()) {
-            buffer[i] = wire_instance->read();
-        } else {
-            return false;
-        }
+    if (length == 0) {
+        return true;
     }
     
-    return true;
+    return transactBulk(nullptr, 0, buffer, length, prefix, prefix_length, stats);
 }
 
 // Write to a specific register
@@ -63,12 +169,8 @@ bool Device::writeRegister(uint8_t reg, uint8_t value) {
         return false;
     }
     
-    wire_instance->beginTransmission(i2c_address);
-    wire_instance->write(reg);
-    wire_instance->write(value);
-    uint8_t error = wire_instance->endTransmission();
-    
-    return (error == 0);
+    uint8_t data[2] = { reg, value };
+    return transact(data, sizeof(data), nullptr, 0);
 }
 
 // Read from a specific register
@@ -77,22 +179,8 @@ bool Device::readRegister(uint8_t reg, uint8_t* value) {
         return false;
     }
     
-    // Write register address
-    wire_instance->beginTransmission(i2c_address);
-    wire_instance->write(reg);
-    uint8_t error = wire_instance->endTransmission(false); // Keep connection alive
-    
-    if (error != 0) {
-        return false;
-    }
-    
-    // Read the register value
-    if (wire_instance->requestFrom(i2c_address, (uint8_t)1) == 1) {
-        *value = wire_instance->read();
-        return true;
-    }
-    
-    return false;
+    // Write register address, then read with a repeated start
+    return transact(&reg, 1, value, 1, true);
 }
 
 // Read multiple bytes from a register
@@ -101,31 +189,17 @@ bool Device::readRegisters(uint8_t reg, uint8_t* buffer, size_t length) {
         return false;
     }
     
-    // Write register address
-    wire_instance->beginTransmission(i2c_address);
-    wire_instance->write(reg);
-    uint8_t error = wire_instance->endTransmission(false); // Keep connection alive
-    
-    if (error != 0) {
-        return false;
-    }
-    
-    // Read the register values
-    size_t bytes_received = wire_instance->requestFrom(i2c_address, (uint8_t)length);
-    
-    if (bytes_received != length) {
+    // Write register address, then read with a repeated start
+    return transact(&reg, 1, buffer, length, true);
+}
+
+// Write then read with a repeated start
+bool Device::writeThenRead(const uint8_t* tx_data, size_t tx_length, uint8_t* rx_data, size_t rx_length) {
+    if (!initialized || wire_instance == nullptr) {
         return false;
     }
     
-    for (size_t i = 0; i < length; i++) {
-        if (wire_instance->available()) {
-            buffer[i] = wire_instance->read();
-        } else {
-            return false;
-        }
-    }
-    
-    return true;
+    return transact(tx_data, tx_length, rx_data, rx_length, true);
 }
 
 // Check if device is connected
@@ -133,9 +207,49 @@ bool Device::isConnected() const {
     if (wire_instance == nullptr) {
         return false;
     }
-    wire_instance->beginTransmission(i2c_address);
-    uint8_t error = wire_instance->endTransmission();
-    return (error == 0);
+    
+    // Address-only write: ACK means something answered
+    return transact(nullptr, 0, nullptr, 0);
+}
+
+// Run one transaction; goes through the scheduler task once it is running
+bool Device::transact(const uint8_t* tx_data, size_t tx_length, uint8_t* rx_data, size_t rx_length,
+                      bool repeated_start) const {
+    BusRequest request = {};
+    request.wire = wire_instance;
+    request.address = i2c_address;
+    request.tx_data = tx_data;
+    request.tx_length = tx_length;
+    request.rx_data = rx_data;
+    request.rx_length = rx_length;
+    request.repeated_start = repeated_start;
+    request.clock_hz = max_bus_frequency;
+    return BusScheduler::getInstance().transfer(request, bus_priority);
+}
+
+// Run one bulk transaction through the scheduler
+bool Device::transactBulk(const uint8_t* tx_data, size_t tx_length, uint8_t* rx_data, size_t rx_length,
+                          const uint8_t* prefix, size_t prefix_length, BusTransferStats* stats) const {
+    if (prefix_length > BUS_BULK_MAX_PREFIX || (prefix == nullptr && prefix_length > 0)) {
+        return false;
+    }
+    
+    BusRequest request = {};
+    request.wire = wire_instance;
+    request.address = i2c_address;
+    request.tx_data = tx_data;
+    request.tx_length = tx_length;
+    request.rx_data = rx_data;
+    request.rx_length = rx_length;
+    request.repeated_start = true;
+    request.clock_hz = max_bus_frequency;
+    request.bulk = true;
+    if (prefix_length > 0) {
+        memcpy(request.prefix, prefix, prefix_length);
+    }
+    request.prefix_length = prefix_length;
+    request.stats = stats;
+    return BusScheduler::getInstance().transfer(request, bus_priority);
 }
 
 // Get device address
@@ -143,8 +257,94 @@ uint8_t Device::getAddress() const {
     return i2c_address;
 }
 
+// Get the bus this device is attached to
+TwoWire* Device::getWire() const {
+    return wire_instance;
+}
+
+// Bus scheduler priority class
+void Device::setBusPriority(BusPriority priority) {
+    bus_priority = priority;
+}
+
+BusPriority Device::getBusPriority() const {
+    return bus_priority;
+}
+
+// Maximum bus frequency
+void Device::setMaxBusFrequency(uint32_t frequency) {
+    if (frequency > 0) {
+        max_bus_frequency = frequency;
+    }
+}
+
+uint32_t Device::getMaxBusFrequency() const {
+    return max_bus_frequency;
+}
+
+// Find the fastest standard rate (up to the configured one) the device handles reliably
+uint32_t Device::negotiateBusFrequency() {
+    if (wire_instance == nullptr) {
+        return 0;
+    }
+    
+    uint32_t configured = max_bus_frequency;
+    uint32_t rate = configured;
+    while (true) {
+        max_bus_frequency = rate;
+        bool stable = true;
+        for (uint8_t i = 0; i < BUS_CLOCK_PROBE_COUNT && stable; i++) {
+            stable = isConnected();
+        }
+        if (stable) {
+            return rate;
+        }
+        
+        // Next slower standard mode
+        if (rate > I2C_FAST_PLUS_CLOCK) {
+            rate = I2C_FAST_PLUS_CLOCK;
+        } else if (rate > I2C_FAST_CLOCK) {
+            rate = I2C_FAST_CLOCK;
+        } else if (rate > I2C_STANDARD_CLOCK) {
+            rate = I2C_STANDARD_CLOCK;
+        } else {
+            break;
+        }
+    }
+    
+    max_bus_frequency = configured;
+    return 0;
+}
+
+// Trust a previously negotiated rate on the next begin()
+void Device::setKnownBusFrequency(uint32_t frequency) {
+    known_bus_frequency = frequency;
+}
+
 // Add action to global queue
-void Device::addActionToQueue(uint8_t action_type, const uint8_t* data, size_t length) {
-    DeviceAction action(i2c_address, action_type, data, length);
-    action_queue.push(action);
+bool Device::addActionToQueue(uint8_t action_type, const uint8_t* data, size_t length) {
+    if (length > DEVICE_ACTION_INLINE_SIZE) {
+        return false;
+    }
+    
+    // Built in its queue slot: the payload is copied once
+    BusGuard guard;
+    DeviceAction* action = action_queue.emplace(i2c_address, action_type, data, length);
+    if (action == nullptr) {
+        return false;
+    }
+    action->wire = wire_instance;
+    return true;
+}
+
+// Add a zero-copy action referencing the caller's buffer
+bool Device::addExternalActionToQueue(uint8_t action_type, uint8_t* data, size_t length) {
+    if (data == nullptr || length == 0) {
+        return false;
+    }
+    
+    DeviceAction action = DeviceAction::external(i2c_address, action_type, data, length);
+    action.wire = wire_instance;
+    BusGuard guard;
+    return action_queue.push(std::move(action));
 }
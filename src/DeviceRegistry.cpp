@@ -1,7 +1,42 @@
 #include "DeviceRegistry.hpp"
+#include <algorithm>
+
+#if defined(ESP32)
+#include <esp_attr.h>
+#include <esp_sleep.h>
+#else
+#define RTC_DATA_ATTR
+#endif
+
+// Marks a valid boot record ("BOOT")
+#define BOOT_RECORD_MAGIC 0x424F4F54UL
+
+// Negotiated bus state of the devices that came up on the previous boot.
+// RTC slow memory survives deep sleep, so a wake-up can skip bus probing.
+struct BootRecord {
+    uint32_t magic;
+    uint8_t count;
+    struct {
+        uint8_t bus;
+        uint8_t address;
+        uint32_t frequency;
+    } devices[DEVICE_REGISTRY_BOOT_RECORDS];
+};
+
+RTC_DATA_ATTR static BootRecord boot_record;
 
 // Private constructor
-DeviceRegistry::DeviceRegistry() : action_in_progress(false) {
+DeviceRegistry::DeviceRegistry()
+    : action_in_progress(false), resumed_from_sleep(false), boot_time_us(0), deferred_count(0) {
+    for (size_t bus = 0; bus < MAX_I2C_BUSES; bus++) {
+        buses[bus] = nullptr;
+        for (size_t address = 0; address < I2C_ADDRESS_COUNT; address++) {
+            address_map[bus][address] = nullptr;
+        }
+        for (size_t word = 0; word < I2C_ADDRESS_COUNT / 32; word++) {
+            ready_map[bus][word] = 0;
+        }
+    }
 }
 
 // Get singleton instance
@@ -22,11 +57,22 @@ bool DeviceRegistry::registerDevice(Device* device) {
         return false;
     }
     
-    // Check if device is already registered
-    if (isDeviceRegistered(device)) {
+    uint8_t address = device->getAddress();
+    if (address >= I2C_ADDRESS_COUNT) {
+        return false;
+    }
+    
+    int bus = claimBus(device->getWire());
+    if (bus < 0) {
+        return false;
+    }
+    
+    // Rejects both the same device twice and two devices sharing an address
+    if (address_map[bus][address] != nullptr) {
         return false;
     }
     
+    address_map[bus][address] = device;
     registered_devices.push_back(device);
     return true;
 }
@@ -37,14 +83,55 @@ bool DeviceRegistry::unregisterDevice(Device* device) {
         return false;
     }
     
+    if (!isDeviceRegistered(device)) {
+        return false;
+    }
+    
+    int bus = findBus(device->getWire());
+    uint8_t address = device->getAddress();
+    address_map[bus][address] = nullptr;
+    ready_map[bus][address / 32] &= ~(1UL << (address % 32));
+    
     for (auto it = registered_devices.begin(); it != registered_devices.end(); ++it) {
         if (*it == device) {
             registered_devices.erase(it);
-            return true;
+            break;
+        }
+    }
+    
+    return true;
+}
+
+// Find the address map slot for a bus, claiming a free one for a new bus
+int DeviceRegistry::claimBus(TwoWire* wire) {
+    int index = findBus(wire);
+    if (index >= 0 || wire == nullptr) {
+        return index;
+    }
+    
+    for (size_t bus = 0; bus < MAX_I2C_BUSES; bus++) {
+        if (buses[bus] == nullptr) {
+            buses[bus] = wire;
+            return static_cast<int>(bus);
+        }
+    }
+    
+    return -1;
+}
+
+// Find the address map slot for a bus
+int DeviceRegistry::findBus(TwoWire* wire) const {
+    if (wire == nullptr) {
+        return -1;
+    }
+    
+    for (size_t bus = 0; bus < MAX_I2C_BUSES; bus++) {
+        if (buses[bus] == wire) {
+            return static_cast<int>(bus);
         }
     }
     
-    return false;
+    return -1;
 }
 
 // Get the number of registered devices
@@ -58,13 +145,13 @@ bool DeviceRegistry::isDeviceRegistered(Device* device) const {
         return false;
     }
     
-    for (const auto& registered_device : registered_devices) {
-        if (registered_device == device) {
-            return true;
-        }
+    uint8_t address = device->getAddress();
+    int bus = findBus(device->getWire());
+    if (bus < 0 || address >= I2C_ADDRESS_COUNT) {
+        return false;
     }
     
-    return false;
+    return address_map[bus][address] == device;
 }
 
 // Get a device by index
@@ -78,17 +165,172 @@ Device* DeviceRegistry::getDevice(size_t index) const {
 
 // Get a device by I2C address
 Device* DeviceRegistry::getDeviceByAddress(uint8_t address) const {
-    for (const auto& device : registered_devices) {
-        if (device->getAddress() == address) {
-            return device;
+    if (address >= I2C_ADDRESS_COUNT) {
+        return nullptr;
+    }
+    
+    for (size_t bus = 0; bus < MAX_I2C_BUSES; bus++) {
+        if (address_map[bus][address] != nullptr) {
+            return address_map[bus][address];
         }
     }
     
     return nullptr;
 }
 
+// Get a device by bus and I2C address
+Device* DeviceRegistry::getDeviceByAddress(uint8_t address, TwoWire* wire) const {
+    if (wire == nullptr) {
+        return getDeviceByAddress(address);
+    }
+    
+    int bus = findBus(wire);
+    if (bus < 0 || address >= I2C_ADDRESS_COUNT) {
+        return nullptr;
+    }
+    
+    return address_map[bus][address];
+}
+
+// Bring up every registered device with as little bus time as possible
+size_t DeviceRegistry::beginAll() {
+    unsigned long start = micros();
+    
+#if defined(ESP32)
+    resumed_from_sleep = esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_UNDEFINED &&
+                         boot_record.magic == BOOT_RECORD_MAGIC;
+#else
+    resumed_from_sleep = false;
+#endif
+    
+    for (size_t bus = 0; bus < MAX_I2C_BUSES; bus++) {
+        for (size_t word = 0; word < I2C_ADDRESS_COUNT / 32; word++) {
+            ready_map[bus][word] = 0;
+        }
+    }
+    
+    // Sensors first: their conversions then run during the display setup
+    std::vector<Device*> order(registered_devices);
+    std::stable_sort(order.begin(), order.end(), [](Device* a, Device* b) {
+        return a->getBusPriority() < b->getBusPriority();
+    });
+    
+    std::vector<Device*> started;
+    started.reserve(order.size());
+    for (Device* device : order) {
+        int bus = findBus(device->getWire());
+        // On a cold boot the negotiation doubles as the presence probe; its
+        // rate is handed to begin() so the device is not probed twice
+        uint32_t frequency = resumed_from_sleep ? restoredFrequency(bus, device->getAddress()) : 0;
+        if (frequency == 0) {
+            frequency = device->negotiateBusFrequency();
+        }
+        if (frequency == 0) {
+            continue;
+        }
+        device->setKnownBusFrequency(frequency);
+        if (device->startBegin()) {
+            started.push_back(device);
+        } else {
+            device->setKnownBusFrequency(0);
+        }
+    }
+    
+    size_t ready = 0;
+    for (Device* device : started) {
+        if (device->finishBegin()) {
+            uint8_t address = device->getAddress();
+            ready_map[findBus(device->getWire())][address / 32] |= 1UL << (address % 32);
+            ready++;
+        }
+    }
+    
+    saveBootRecord();
+    boot_time_us = micros() - start;
+    return ready;
+}
+
+// Rate recorded for a device on the previous boot, or 0
+uint32_t DeviceRegistry::restoredFrequency(int bus, uint8_t address) const {
+    uint8_t count = boot_record.count < DEVICE_REGISTRY_BOOT_RECORDS ? boot_record.count
+                                                                     : DEVICE_REGISTRY_BOOT_RECORDS;
+    for (uint8_t i = 0; i < count; i++) {
+        if (boot_record.devices[i].bus == bus && boot_record.devices[i].address == address) {
+            return boot_record.devices[i].frequency;
+        }
+    }
+    return 0;
+}
+
+// Remember the negotiated rate of every ready device for the next wake-up
+void DeviceRegistry::saveBootRecord() {
+    boot_record.magic = 0;
+    boot_record.count = 0;
+    for (Device* device : registered_devices) {
+        if (boot_record.count >= DEVICE_REGISTRY_BOOT_RECORDS) {
+            break;
+        }
+        if (!isDeviceReady(device)) {
+            continue;
+        }
+        boot_record.devices[boot_record.count].bus = (uint8_t)findBus(device->getWire());
+        boot_record.devices[boot_record.count].address = device->getAddress();
+        boot_record.devices[boot_record.count].frequency = device->getMaxBusFrequency();
+        boot_record.count++;
+    }
+    boot_record.magic = BOOT_RECORD_MAGIC;
+}
+
+// Check if the last beginAll() brought a device up
+bool DeviceRegistry::isDeviceReady(Device* device) const {
+    if (!isDeviceRegistered(device)) {
+        return false;
+    }
+    
+    uint8_t address = device->getAddress();
+    return (ready_map[findBus(device->getWire())][address / 32] & (1UL << (address % 32))) != 0;
+}
+
+// Boot statistics
+bool DeviceRegistry::isResumedFromSleep() const {
+    return resumed_from_sleep;
+}
+
+unsigned long DeviceRegistry::getBootTime() const {
+    return boot_time_us;
+}
+
+// Queue non-critical boot work
+bool DeviceRegistry::deferTask(DeferredTask task, void* context) {
+    if (task == nullptr || deferred_count >= DEVICE_REGISTRY_MAX_DEFERRED) {
+        return false;
+    }
+    
+    deferred[deferred_count].task = task;
+    deferred[deferred_count].context = context;
+    deferred_count++;
+    return true;
+}
+
+// Run the deferred tasks oldest first
+size_t DeviceRegistry::runDeferredTasks() {
+    size_t ran = 0;
+    while (ran < deferred_count) {
+        DeferredEntry entry = deferred[ran];
+        ran++;
+        entry.task(entry.context);
+    }
+    deferred_count = 0;
+    return ran;
+}
+
+size_t DeviceRegistry::getDeferredTaskCount() const {
+    return deferred_count;
+}
+
 // Get the next action from the global queue without removing it
 bool DeviceRegistry::getNextAction(DeviceAction& action) {
+    BusGuard guard;
     if (Device::action_queue.empty()) {
         return false;
     }
@@ -99,40 +341,111 @@ bool DeviceRegistry::getNextAction(DeviceAction& action) {
 
 // Perform the next action in the queue
 bool DeviceRegistry::performNextAction() {
-    if (Device::action_queue.empty()) {
+    if (action_in_progress.exchange(true)) {
         return false;
     }
     
-    if (action_in_progress) {
-        return false;
+    // Only hold the lock while dequeuing; the transfer itself goes through the bus scheduler
+    DeviceAction action;
+    {
+        BusGuard guard;
+        if (Device::action_queue.empty()) {
+            action_in_progress = false;
+            return false;
+        }
+        action = Device::action_queue.front();
+        Device::action_queue.pop();
     }
     
-    action_in_progress = true;
-    
-    DeviceAction action = Device::action_queue.front();
-    Device::action_queue.pop();
-    
     // Find the device by address
-    Device* device = getDeviceByAddress(action.device_address);
+    Device* device = getDeviceByAddress(action.device_address, action.wire);
     
     if (device == nullptr) {
         action_in_progress = false;
         return false;
     }
     
+    bool success = executeAction(device, action);
+    
+    action_in_progress = false;
+    return success;
+}
+
+// Perform queued actions within a time budget
+size_t DeviceRegistry::performPendingActions(unsigned long budget_us, size_t* failed) {
+    if (failed != nullptr) {
+        *failed = 0;
+    }
+    
+    if (action_in_progress.exchange(true)) {
+        return 0;
+    }
+    
+    unsigned long start = micros();
+    size_t processed = 0;
+    
+    do {
+        DeviceAction action;
+        DeviceAction follow_up;
+        bool paired = false;
+        
+        // Dequeue the next action, plus a directly following read on the same address
+        {
+            BusGuard guard;
+            if (Device::action_queue.empty()) {
+                break;
+            }
+            action = Device::action_queue.front();
+            Device::action_queue.pop();
+            
+            if (action.action_type == 1 && !action.empty() && !Device::action_queue.empty()) {
+                const DeviceAction& next = Device::action_queue.front();
+                if (next.action_type == 0 && !next.empty() && next.device_address == action.device_address &&
+                    next.wire == action.wire) {
+                    follow_up = next;
+                    Device::action_queue.pop();
+                    paired = true;
+                }
+            }
+        }
+        
+        Device* device = getDeviceByAddress(action.device_address, action.wire);
+        
+        bool success = false;
+        if (device != nullptr) {
+            if (paired) {
+                success = device->writeThenRead(action.data(), action.size(), follow_up.data(), follow_up.size());
+            } else {
+                success = executeAction(device, action);
+            }
+        }
+        
+        size_t count = paired ? 2 : 1;
+        processed += count;
+        if (!success && failed != nullptr) {
+            *failed += count;
+        }
+    } while (micros() - start < budget_us);
+    
+    action_in_progress = false;
+    return processed;
+}
+
+// Run one action on its device
+bool DeviceRegistry::executeAction(Device* device, DeviceAction& action) {
     bool success = false;
     
     // Perform the action based on action_type
     switch (action.action_type) {
         case 0: // Read operation
-            if (!action.data.empty()) {
-                success = device->receive(action.data.data(), action.data.size());
+            if (!action.empty()) {
+                success = device->receive(action.data(), action.size());
             }
             break;
             
         case 1: // Write operation
-            if (!action.data.empty()) {
-                success = device->send(action.data.data(), action.data.size());
+            if (!action.empty()) {
+                success = device->send(action.data(), action.size());
             }
             break;
             
@@ -142,12 +455,12 @@ bool DeviceRegistry::performNextAction() {
             break;
     }
     
-    action_in_progress = false;
     return success;
 }
 
 // Skip the next action in the queue (remove without performing)
 bool DeviceRegistry::skipNextAction() {
+    BusGuard guard;
     if (Device::action_queue.empty()) {
         return false;
     }
@@ -158,17 +471,24 @@ bool DeviceRegistry::skipNextAction() {
 
 // Check if there are pending actions
 bool DeviceRegistry::hasPendingActions() const {
+    BusGuard guard;
     return !Device::action_queue.empty();
 }
 
 // Get the number of pending actions
 size_t DeviceRegistry::getPendingActionCount() const {
+    BusGuard guard;
     return Device::action_queue.size();
 }
 
+// Get the deepest the queue has been
+size_t DeviceRegistry::getPeakActionCount() const {
+    BusGuard guard;
+    return Device::action_queue.peak();
+}
+
 // Clear all pending actions
 void DeviceRegistry::clearAllActions() {
-    while (!Device::action_queue.empty()) {
-        Device::action_queue.pop();
-    }
+    BusGuard guard;
+    Device::action_queue.clear();
 }
@@ -0,0 +1,148 @@
+#include "FilterStage.hpp"
+
+// Moving average constructor
+MovingAverageStage::MovingAverageStage(uint8_t size)
+    : window_size(size), head(0), count(0), sum(0.0f) {
+    if (window_size == 0) {
+        window_size = 1;
+    }
+    if (window_size > MOVING_AVERAGE_MAX_WINDOW) {
+        window_size = MOVING_AVERAGE_MAX_WINDOW;
+    }
+}
+
+// Replace the oldest value and update the running sum
+float MovingAverageStage::apply(float value, uint32_t timestamp_ms) {
+    (void)timestamp_ms;
+    if (count == window_size) {
+        sum -= window[head];
+    } else {
+        count++;
+    }
+    window[head] = value;
+    sum += value;
+    head = (head + 1) % window_size;
+    return sum / count;
+}
+
+void MovingAverageStage::reset() {
+    head = 0;
+    count = 0;
+    sum = 0.0f;
+}
+
+// EMA constructor
+EmaStage::EmaStage(float alpha) : alpha(alpha), state(0.0f), primed(false) {
+    setAlpha(alpha);
+}
+
+// First sample seeds the state so the output does not ramp up from zero
+float EmaStage::apply(float value, uint32_t timestamp_ms) {
+    (void)timestamp_ms;
+    if (!primed) {
+        state = value;
+        primed = true;
+    } else {
+        state += alpha * (value - state);
+    }
+    return state;
+}
+
+void EmaStage::reset() {
+    primed = false;
+    state = 0.0f;
+}
+
+void EmaStage::setAlpha(float alpha) {
+    if (alpha <= 0.0f || alpha > 1.0f) {
+        alpha = 1.0f;
+    }
+    this->alpha = alpha;
+}
+
+float EmaStage::getAlpha() const {
+    return alpha;
+}
+
+// Median constructor
+MedianStage::MedianStage(uint8_t size) : window_size(size), head(0), count(0) {
+    if (window_size == 0) {
+        window_size = 1;
+    }
+    if (window_size > MEDIAN_FILTER_MAX_WINDOW) {
+        window_size = MEDIAN_FILTER_MAX_WINDOW;
+    }
+}
+
+// Insertion sort of a copy; the window is at most MEDIAN_FILTER_MAX_WINDOW long
+float MedianStage::apply(float value, uint32_t timestamp_ms) {
+    (void)timestamp_ms;
+    window[head] = value;
+    head = (head + 1) % window_size;
+    if (count < window_size) {
+        count++;
+    }
+
+    float sorted[MEDIAN_FILTER_MAX_WINDOW];
+    for (uint8_t i = 0; i < count; i++) {
+        float v = window[i];
+        int j = i - 1;
+        while (j >= 0 && sorted[j] > v) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = v;
+    }
+
+    if (count % 2 == 1) {
+        return sorted[count / 2];
+    }
+    return 0.5f * (sorted[count / 2 - 1] + sorted[count / 2]);
+}
+
+void MedianStage::reset() {
+    head = 0;
+    count = 0;
+}
+
+// Rate-of-change constructor
+RateOfChangeStage::RateOfChangeStage(float threshold_per_second)
+    : threshold(threshold_per_second), last_value(0.0f), last_timestamp(0),
+      primed(false), rate(0.0f), triggered(false) {
+}
+
+// Slope against the previous sample
+float RateOfChangeStage::apply(float value, uint32_t timestamp_ms) {
+    if (primed && timestamp_ms != last_timestamp) {
+        rate = (value - last_value) * 1000.0f / (float)(timestamp_ms - last_timestamp);
+        if (fabsf(rate) > threshold) {
+            triggered = true;
+        }
+    }
+    last_value = value;
+    last_timestamp = timestamp_ms;
+    primed = true;
+    return value;
+}
+
+void RateOfChangeStage::reset() {
+    primed = false;
+    rate = 0.0f;
+    triggered = false;
+}
+
+float RateOfChangeStage::getRate() const {
+    return rate;
+}
+
+bool RateOfChangeStage::isTriggered() const {
+    return triggered;
+}
+
+void RateOfChangeStage::acknowledge() {
+    triggered = false;
+}
+
+void RateOfChangeStage::setThreshold(float threshold_per_second) {
+    threshold = threshold_per_second;
+}
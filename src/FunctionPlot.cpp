@@ -1,4 +1,6 @@
 #include "FunctionPlot.hpp"
+#include "AssetBuffer.hpp"
+#include "AxisLabelCache.hpp"
 #include <math.h>
 #include <string.h>
 
@@ -22,69 +24,14 @@ static void computeContentRectFP(int16_t x, int16_t y, int16_t width, int16_t he
     if (contentH < 1) contentH = 1;
 }
 
-// Tiny 3x5 font bitmap same as DataPlot
-static const uint8_t tinyFontFP[][5] = {
-    {0b111,0b101,0b101,0b101,0b111},
-    {0b010,0b110,0b010,0b010,0b111},
-    {0b111,0b001,0b111,0b100,0b111},
-    {0b111,0b001,0b111,0b001,0b111},
-    {0b101,0b101,0b111,0b001,0b001},
-    {0b111,0b100,0b111,0b001,0b111},
-    {0b111,0b100,0b111,0b101,0b111},
-    {0b111,0b001,0b001,0b001,0b001},
-    {0b111,0b101,0b111,0b101,0b111},
-    {0b111,0b101,0b111,0b001,0b111},
-    {0b000,0b000,0b111,0b000,0b000},
-    {0b000,0b000,0b000,0b000,0b010},
-    {0b111,0b100,0b100,0b100,0b111},
-    {0b111,0b010,0b010,0b010,0b010},
-    {0b101,0b101,0b111,0b101,0b101},
-    {0b101,0b001,0b100,0b010,0b101}
-};
-
-static void drawTinyCharFP(LedScreen128_64* screen, int16_t x, int16_t y, char c, uint8_t scale=1) {
-    int index = -1;
-    if (c >= '0' && c <= '9') index = c - '0';
-    else if (c == '-') index = 10;
-    else if (c == '.') index = 11;
-    else if (c == 'C' || c == 'c') index = 12;
-    else if (c == 'T' || c == 't') index = 13;
-    else if (c == 'H' || c == 'h') index = 14;
-    else if (c == '%') index = 15;
-    if (index < 0) return;
-
-    for (int row = 0; row < 5; row++) {
-        uint8_t bits = tinyFontFP[index][row];
-        for (int col = 0; col < 3; col++) {
-            bool on = (bits >> (2 - col)) & 0x1;
-            if (on) {
-                for (int sy = 0; sy < scale; sy++) {
-                    for (int sx = 0; sx < scale; sx++) {
-                        screen->drawPixel(x + col * scale + sx, y + row * scale + sy, true);
-                    }
-                }
-            }
-        }
-    }
-}
-
-static void drawTinyTextFP(LedScreen128_64* screen, int16_t x, int16_t y, const char* text, uint8_t scale=1) {
-    int16_t cursorX = x;
-    while (*text) {
-        char c = *text++;
-        if (c == ' ') cursorX += (3*scale + scale);
-        else {
-            drawTinyCharFP(screen, cursorX, y, c, scale);
-            cursorX += (3*scale + scale);
-        }
-    }
-}
-
 // Constructor
 FunctionPlot::FunctionPlot(int16_t x, int16_t y, int16_t width, int16_t height, MathFunction func)
         : GraphicsAsset(x, y, width, height, AssetType::FUNCTIONPLOT), function(func), 
             minX(-10.0f), maxX(10.0f), minY(-10.0f), maxY(10.0f),
-            autoScaleY(false), showAxes(true), showGrid(false), gridSpacing(10), showAxisLabels(false), axisLabelSize(1), useTinyAxisLabels(false), tinyAxisLabelScale(1), autoTinyAxisLabels(true), tinyLabelAutoThreshold(36), maxTicks(0), animationFrame(0) {
+            autoScaleY(false), showAxes(true), showGrid(false), gridSpacing(10), showAxisLabels(false), axisLabelSize(1), useTinyAxisLabels(false), tinyAxisLabelScale(1), autoTinyAxisLabels(true), tinyLabelAutoThreshold(36), maxTicks(0), animationFrame(0),
+            labelCache(nullptr), samples(nullptr), sampleCapacity(0), sampleCount(0), sampleFunction(nullptr), sampleMinX(0.0f), sampleMaxX(0.0f),
+            rangeCached(false), rangeFound(false), rangeFunction(nullptr), rangeMinX(0.0f), rangeMaxX(0.0f), rangeWidth(0),
+            rangeMinY(0.0f), rangeMaxY(0.0f) {
     // Initialize tiny font options
     useTinyAxisLabels = false;
     tinyAxisLabelScale = 1;
@@ -92,6 +39,8 @@ FunctionPlot::FunctionPlot(int16_t x, int16_t y, int16_t width, int16_t height,
 
 // Destructor
 FunctionPlot::~FunctionPlot() {
+    assetBufferFree(samples);
+    assetBufferDestroy(labelCache);
 }
 
 // Draw method implementation
@@ -123,217 +72,7 @@ void FunctionPlot::draw(LedScreen128_64* screen) {
     // Draw axis labels if enabled
     if (showAxisLabels) {
         screen->setTextSize(axisLabelSize);
-        // X axis labels
-        int16_t contentX, contentY, contentW, contentH;
-        computeContentRectFP(x, y, width, height, axisLabelSize, showAxisLabels, contentX, contentY, contentW, contentH);
-        int16_t prevLabelX = -9999;
-        bool effectiveTiny = useTinyAxisLabels || (autoTinyAxisLabels && contentW <= tinyLabelAutoThreshold);
-        if (maxTicks > 1) {
-            float step = (contentW > 1) ? (contentW - 1) / (float)(maxTicks - 1) : 1.0f;
-            for (int k = 0; k < maxTicks; k++) {
-                int16_t i = (int16_t)round(k * step);
-                int16_t tickX = contentX + i;
-                float normalized = (contentW > 1) ? ((float)i) / (float)(contentW - 1) : 0.0f;
-                float dataValue = minX + normalized * (maxX - minX);
-                char buf[12];
-                if (fabs(dataValue - (int)dataValue) < 0.001f) {
-                    snprintf(buf, sizeof(buf), "%d", (int)dataValue);
-                } else {
-                    snprintf(buf, sizeof(buf), "%.1f", dataValue);
-                }
-                int16_t labelY = contentY + contentH + 1;
-                if (minY <= 0.0f && maxY >= 0.0f) {
-                    int16_t y0 = mapY(0.0f);
-                    if (y0 + (8 * axisLabelSize) + 1 < (y + height)) {
-                        labelY = y0 + 1;
-                    } else {
-                        labelY = y0 - (8 * axisLabelSize) - 1;
-                    }
-                }
-                if (effectiveTiny) {
-                    int16_t labelW = (int)strlen(buf) * (3 * tinyAxisLabelScale + tinyAxisLabelScale);
-                    int16_t labelX = tickX - labelW / 2;
-                    if (prevLabelX < -1000 || abs(labelX - prevLabelX) >= (labelW + 2)) {
-                        drawTinyTextFP(screen, labelX, labelY, buf, tinyAxisLabelScale);
-                        prevLabelX = labelX;
-                    }
-                } else {
-                    int16_t labelW = (int)strlen(buf) * 6 * axisLabelSize;
-                    int16_t labelX = tickX - labelW / 2;
-                    if (prevLabelX < -1000 || abs(labelX - prevLabelX) >= (labelW + 2)) {
-                        screen->setCursor(labelX, labelY);
-                        screen->print(buf);
-                        prevLabelX = labelX;
-                    }
-                }
-            }
-        } else {
-            if (gridSpacing <= 0 || gridSpacing >= contentW) {
-                for (int k = 0; k < 2; k++) {
-                    int16_t i = (k == 0) ? 0 : (contentW - 1);
-                    int16_t tickX = contentX + i;
-                    float normalized = (contentW > 1) ? ((float)i) / (float)(contentW - 1) : 0.0f;
-                    float dataValue = minX + normalized * (maxX - minX);
-                    int16_t labelY = contentY + contentH + 1;
-                    if (minY <= 0.0f && maxY >= 0.0f) {
-                        int16_t y0 = mapY(0.0f);
-                        if (y0 + (8 * axisLabelSize) + 1 < (y + height)) {
-                            labelY = y0 + 1;
-                        } else {
-                            labelY = y0 - (8 * axisLabelSize) - 1;
-                        }
-                    }
-                    char buf[12];
-                    if (fabs(dataValue - (int)dataValue) < 0.001f) {
-                        snprintf(buf, sizeof(buf), "%d", (int)dataValue);
-                    } else {
-                        snprintf(buf, sizeof(buf), "%.1f", dataValue);
-                    }
-                    if (effectiveTiny) {
-                        int16_t labelW = (int)strlen(buf) * (3 * tinyAxisLabelScale + tinyAxisLabelScale);
-                        int16_t labelX = tickX - labelW / 2;
-                        if (prevLabelX < -1000 || abs(labelX - prevLabelX) >= (labelW + 2)) {
-                            drawTinyTextFP(screen, labelX, labelY, buf, tinyAxisLabelScale);
-                            prevLabelX = labelX;
-                        }
-                    } else {
-                        int16_t labelW = (int)strlen(buf) * 6 * axisLabelSize;
-                        int16_t labelX = tickX - labelW / 2;
-                        if (prevLabelX < -1000 || abs(labelX - prevLabelX) >= (labelW + 2)) {
-                            screen->setCursor(labelX, labelY);
-                            screen->print(buf);
-                            prevLabelX = labelX;
-                        }
-                    }
-                }
-            } else {
-                for (int16_t i = gridSpacing; i < contentW; i += gridSpacing) {
-                    int16_t tickX = contentX + i;
-                    float normalized = (contentW > 1) ? ((float)i) / (float)(contentW - 1) : 0.0f;
-                    float dataValue = minX + normalized * (maxX - minX);
-                    int16_t labelY = contentY + contentH + 1;
-                    if (minY <= 0.0f && maxY >= 0.0f) {
-                        int16_t y0 = mapY(0.0f);
-                        if (y0 + (8 * axisLabelSize) + 1 < (y + height)) {
-                            labelY = y0 + 1;
-                        } else {
-                            labelY = y0 - (8 * axisLabelSize) - 1;
-                        }
-                    }
-                    char buf[12];
-                    if (fabs(dataValue - (int)dataValue) < 0.001f) {
-                        snprintf(buf, sizeof(buf), "%d", (int)dataValue);
-                    } else {
-                        snprintf(buf, sizeof(buf), "%.1f", dataValue);
-                    }
-                    if (effectiveTiny) {
-                        int16_t labelW = (int)strlen(buf) * (3 * tinyAxisLabelScale + tinyAxisLabelScale);
-                        int16_t labelX = tickX - labelW / 2;
-                        if (prevLabelX < -1000 || abs(labelX - prevLabelX) >= (labelW + 2)) {
-                            drawTinyTextFP(screen, labelX, labelY, buf, tinyAxisLabelScale);
-                            prevLabelX = labelX;
-                        }
-                    } else {
-                        int16_t labelW = (int)strlen(buf) * 6 * axisLabelSize;
-                        int16_t labelX = tickX - labelW / 2;
-                        if (prevLabelX < -1000 || abs(labelX - prevLabelX) >= (labelW + 2)) {
-                            screen->setCursor(labelX, labelY);
-                            screen->print(buf);
-                            prevLabelX = labelX;
-                        }
-                    }
-                }
-            }
-        }
-
-        // Y axis labels
-    int16_t prevLabelY = -9999;
-    bool effectiveTinyY = useTinyAxisLabels || (autoTinyAxisLabels && contentH <= tinyLabelAutoThreshold);
-        if (maxTicks > 1) {
-            float stepY = (contentH - 1) / (float)(maxTicks - 1);
-            for (int k = 0; k < maxTicks; k++) {
-                int16_t i = (int16_t)round(k * stepY);
-                int16_t tickY = contentY + i;
-                float normalized = (contentH > 1) ? (1.0f - ((float)(i) / (float)(contentH - 1))) : 0.0f;
-                float dataValue = minY + normalized * (maxY - minY);
-            char buf[12];
-            if (fabs(dataValue - (int)dataValue) < 0.001f) {
-                snprintf(buf, sizeof(buf), "%d", (int)dataValue);
-            } else {
-                snprintf(buf, sizeof(buf), "%.1f", dataValue);
-            }
-            // Position label left of y-axis or at left edge
-            int16_t labelX;
-            if (minX <= 0.0f && maxX >= 0.0f) {
-                int16_t x0 = mapX(0.0f);
-                labelX = x0 - (int)strlen(buf) * 6 * axisLabelSize - 2;
-                if (labelX < x) {
-                    // If the calculated position is inside the content rect, push it into the left margin
-                    labelX = contentX - (int)strlen(buf) * 6 * axisLabelSize - 2;
-                    if (labelX < x) labelX = x + 1;
-                }
-            } else {
-                labelX = contentX - (int)strlen(buf) * 6 * axisLabelSize - 2;
-                if (labelX < x) labelX = x + 1;
-            }
-            if (effectiveTinyY) {
-                int16_t labelH = 5 * tinyAxisLabelScale;
-                int16_t labelYAdj = tickY - labelH / 2;
-                if (prevLabelY < -1000 || abs(labelYAdj - prevLabelY) >= (labelH + 2)) {
-                    drawTinyTextFP(screen, labelX, labelYAdj, buf, tinyAxisLabelScale);
-                    prevLabelY = labelYAdj;
-                }
-            } else {
-                int16_t labelH = 8 * axisLabelSize;
-                int16_t labelYAdj = tickY - labelH / 2;
-                if (prevLabelY < -1000 || abs(labelYAdj - prevLabelY) >= (labelH + 2)) {
-                    screen->setCursor(labelX, labelYAdj);
-                    screen->print(buf);
-                    prevLabelY = labelYAdj;
-                }
-            }
-            }
-        } else {
-            for (int16_t i = gridSpacing; i < contentH; i += gridSpacing) {
-                int16_t tickY = contentY + i;
-                float normalized = 1.0f - ((float)(i) / (float)(contentH - 1));
-                float dataValue = minY + normalized * (maxY - minY);
-            char buf[12];
-            if (fabs(dataValue - (int)dataValue) < 0.001f) {
-                snprintf(buf, sizeof(buf), "%d", (int)dataValue);
-            } else {
-                snprintf(buf, sizeof(buf), "%.1f", dataValue);
-            }
-            int16_t labelX;
-            if (minX <= 0.0f && maxX >= 0.0f) {
-                int16_t x0 = mapX(0.0f);
-                labelX = x0 - (int)strlen(buf) * 6 * axisLabelSize - 2;
-                if (labelX < x) {
-                    labelX = contentX - (int)strlen(buf) * 6 * axisLabelSize - 2;
-                    if (labelX < x) labelX = x + 1;
-                }
-            } else {
-                labelX = contentX - (int)strlen(buf) * 6 * axisLabelSize - 2;
-                if (labelX < x) labelX = x + 1;
-            }
-            if (effectiveTinyY) {
-                int16_t labelH = 5 * tinyAxisLabelScale;
-                int16_t labelYAdj = tickY - labelH / 2;
-                if (prevLabelY < -1000 || abs(labelYAdj - prevLabelY) >= (labelH + 2)) {
-                    drawTinyTextFP(screen, labelX, labelYAdj, buf, tinyAxisLabelScale);
-                    prevLabelY = labelYAdj;
-                }
-            } else {
-                int16_t labelH = 8 * axisLabelSize;
-                int16_t labelYAdj = tickY - labelH / 2;
-                if (prevLabelY < -1000 || abs(labelYAdj - prevLabelY) >= (labelH + 2)) {
-                    screen->setCursor(labelX, labelYAdj);
-                    screen->print(buf);
-                    prevLabelY = labelYAdj;
-                }
-            }
-            }
-        }
+        drawAxisLabels(screen);
     }
     
     // Plot the function
@@ -350,15 +89,18 @@ void FunctionPlot::draw(LedScreen128_64* screen) {
         maxPixels = animationFrame;
         // Auto-advance animation on each draw
         animationFrame++;
+        markDirty();  // Next frame still has to be drawn in retained mode
     }
     
-    // Sample the function across the width
+    // Sample the function across the width (evaluated once, then cached)
+    updateSamples(contentW);
+    if (samples == nullptr) {
+        return;
+    }
     for (int16_t i = 0; i < maxPixels; i++) {
         // Calculate the x value in function space
         float fx = minX + (maxX - minX) * (float)i / (float)(contentW - 1);
-        
-        // Evaluate the function
-        float fy = function(fx);
+        float fy = samples[i];
         
         // Check if the result is valid (not NaN or Inf)
         if (isnan(fy) || isinf(fy)) {
@@ -392,6 +134,7 @@ void FunctionPlot::draw(LedScreen128_64* screen) {
 
 // Function management
 void FunctionPlot::setFunction(MathFunction func) {
+    markDirty();
     this->function = func;
 }
 
@@ -399,8 +142,15 @@ MathFunction FunctionPlot::getFunction() const {
     return function;
 }
 
+void FunctionPlot::invalidateSamples() {
+    markDirty();
+    sampleCount = 0;
+    rangeCached = false;
+}
+
 // Range settings
 void FunctionPlot::setXRange(float minX, float maxX) {
+    markDirty();
     if (minX < maxX) {
         this->minX = minX;
         this->maxX = maxX;
@@ -408,6 +158,7 @@ void FunctionPlot::setXRange(float minX, float maxX) {
 }
 
 void FunctionPlot::setYRange(float minY, float maxY) {
+    markDirty();
     if (minY < maxY) {
         this->minY = minY;
         this->maxY = maxY;
@@ -427,6 +178,7 @@ void FunctionPlot::getYRange(float& minY, float& maxY) const {
 
 // Display options
 void FunctionPlot::setAutoScaleY(bool autoScale) {
+    markDirty();
     this->autoScaleY = autoScale;
 }
 
@@ -435,6 +187,7 @@ bool FunctionPlot::getAutoScaleY() const {
 }
 
 void FunctionPlot::setShowAxes(bool show) {
+    markDirty();
     this->showAxes = show;
 }
 
@@ -443,6 +196,7 @@ bool FunctionPlot::getShowAxes() const {
 }
 
 void FunctionPlot::setShowGrid(bool show) {
+    markDirty();
     this->showGrid = show;
 }
 
@@ -451,6 +205,7 @@ bool FunctionPlot::getShowGrid() const {
 }
 
 void FunctionPlot::setGridSpacing(uint8_t spacing) {
+    markDirty();
     if (spacing > 0) {
         this->gridSpacing = spacing;
     }
@@ -461,6 +216,7 @@ uint8_t FunctionPlot::getGridSpacing() const {
 }
 
 void FunctionPlot::setShowAxisLabels(bool show) {
+    markDirty();
     this->showAxisLabels = show;
 }
 
@@ -469,6 +225,7 @@ bool FunctionPlot::getShowAxisLabels() const {
 }
 
 void FunctionPlot::setAxisLabelSize(uint8_t size) {
+    markDirty();
     if (size < 1) size = 1;
     if (size > 4) size = 4;
     this->axisLabelSize = size;
@@ -479,6 +236,7 @@ uint8_t FunctionPlot::getAxisLabelSize() const {
 }
 
 void FunctionPlot::setAutoTinyAxisLabels(bool autoEnable) {
+    markDirty();
     this->autoTinyAxisLabels = autoEnable;
 }
 
@@ -487,6 +245,7 @@ bool FunctionPlot::getAutoTinyAxisLabels() const {
 }
 
 void FunctionPlot::setTinyLabelAutoThreshold(uint8_t threshold) {
+    markDirty();
     this->tinyLabelAutoThreshold = threshold;
 }
 
@@ -495,6 +254,7 @@ uint8_t FunctionPlot::getTinyLabelAutoThreshold() const {
 }
 
 void FunctionPlot::setMaxTicks(uint8_t max) {
+    markDirty();
     this->maxTicks = max;
 }
 
@@ -503,6 +263,7 @@ uint8_t FunctionPlot::getMaxTicks() const {
 }
 
 void FunctionPlot::setUseTinyAxisLabels(bool use) {
+    markDirty();
     this->useTinyAxisLabels = use;
 }
 
@@ -511,6 +272,7 @@ bool FunctionPlot::getUseTinyAxisLabels() const {
 }
 
 void FunctionPlot::setTinyAxisLabelScale(uint8_t scale) {
+    markDirty();
     if (scale < 1) scale = 1;
     this->tinyAxisLabelScale = scale;
 }
@@ -572,46 +334,118 @@ void FunctionPlot::drawGrid(LedScreen128_64* screen) {
     }
 }
 
+// Tick labels are laid out once per axis range and replayed from the cache
+void FunctionPlot::drawAxisLabels(LedScreen128_64* screen) {
+    if (labelCache == nullptr) {
+        labelCache = assetBufferCreate<AxisLabelCache>();
+        if (labelCache == nullptr) {
+            return;
+        }
+    }
+    
+    AxisLabelParams layout;
+    layout.x = x;
+    layout.y = y;
+    layout.width = width;
+    layout.height = height;
+    computeContentRectFP(x, y, width, height, axisLabelSize, showAxisLabels,
+                        layout.contentX, layout.contentY, layout.contentW, layout.contentH);
+    layout.minX = minX;
+    layout.maxX = maxX;
+    layout.minY = minY;
+    layout.maxY = maxY;
+    layout.zeroX = mapX(0.0f);
+    layout.zeroY = mapY(0.0f);
+    layout.gridSpacing = gridSpacing;
+    layout.maxTicks = maxTicks;
+    layout.labelSize = axisLabelSize;
+    layout.tinyScale = tinyAxisLabelScale;
+    layout.tinyX = useTinyAxisLabels || (autoTinyAxisLabels && layout.contentW <= tinyLabelAutoThreshold);
+    layout.tinyY = useTinyAxisLabels || (autoTinyAxisLabels && layout.contentH <= tinyLabelAutoThreshold);
+    labelCache->draw(screen, layout);
+}
+
 void FunctionPlot::calculateYRange() {
     if (function == nullptr) {
         return;
     }
     
-    float calcMinY = 1e6;
-    float calcMaxY = -1e6;
-    bool foundValid = false;
-    
-    // Sample the function to find min/max
-    int samples = width * 2; // Sample more densely than pixels
-    for (int i = 0; i < samples; i++) {
-        float fx = minX + (maxX - minX) * (float)i / (float)(samples - 1);
-        float fy = function(fx);
+    if (!rangeCached || rangeFunction != function || rangeMinX != minX ||
+        rangeMaxX != maxX || rangeWidth != width) {
+        float calcMinY = 1e6;
+        float calcMaxY = -1e6;
+        bool foundValid = false;
         
-        // Skip invalid values
-        if (isnan(fy) || isinf(fy)) {
-            continue;
+        // Sample the function to find min/max
+        int samples = width * 2; // Sample more densely than pixels
+        for (int i = 0; i < samples; i++) {
+            float fx = minX + (maxX - minX) * (float)i / (float)(samples - 1);
+            float fy = function(fx);
+            
+            // Skip invalid values
+            if (isnan(fy) || isinf(fy)) {
+                continue;
+            }
+            
+            if (fy < calcMinY) calcMinY = fy;
+            if (fy > calcMaxY) calcMaxY = fy;
+            foundValid = true;
         }
         
-        if (fy < calcMinY) calcMinY = fy;
-        if (fy > calcMaxY) calcMaxY = fy;
-        foundValid = true;
+        rangeCached = true;
+        rangeFunction = function;
+        rangeMinX = minX;
+        rangeMaxX = maxX;
+        rangeWidth = width;
+        rangeFound = foundValid && calcMinY < calcMaxY;
+        rangeMinY = calcMinY;
+        rangeMaxY = calcMaxY;
     }
     
-    if (foundValid && calcMinY < calcMaxY) {
+    if (rangeFound) {
         // Add 10% padding
-        float range = calcMaxY - calcMinY;
+        float range = rangeMaxY - rangeMinY;
         float padding = range * 0.1f;
-        minY = calcMinY - padding;
-        maxY = calcMaxY + padding;
+        minY = rangeMinY - padding;
+        maxY = rangeMaxY + padding;
+    }
+}
+
+// Evaluate the function once per content column unless the cache still matches
+void FunctionPlot::updateSamples(int16_t contentW) {
+    if (sampleCount == contentW && sampleFunction == function &&
+        sampleMinX == minX && sampleMaxX == maxX) {
+        return;
+    }
+    
+    if (sampleCapacity < contentW) {
+        assetBufferFree(samples);
+        samples = assetBufferNew<float>(contentW);
+        sampleCapacity = samples != nullptr ? contentW : 0;
+    }
+    if (samples == nullptr) {
+        sampleCount = 0;
+        return;
+    }
+    
+    for (int16_t i = 0; i < contentW; i++) {
+        float fx = minX + (maxX - minX) * (float)i / (float)(contentW - 1);
+        samples[i] = function(fx);
     }
+    sampleCount = contentW;
+    sampleFunction = function;
+    sampleMinX = minX;
+    sampleMaxX = maxX;
 }
 
 // Animation control
 void FunctionPlot::resetAnimation() {
+    markDirty();
     animationFrame = 0;
 }
 
 void FunctionPlot::advanceAnimation() {
+    markDirty();
     if (animationFrame < width) {
         animationFrame++;
     }
@@ -64,8 +64,49 @@ void Geometry::draw(LedScreen128_64* screen) {
     }
 }
 
+// Bounds of everything draw() touches, including the optional border
+void Geometry::getBounds(int16_t& bx, int16_t& by, int16_t& bw, int16_t& bh) const {
+    switch (shape) {
+        case GeometryShape::CIRCLE: {
+            int16_t r = border ? radius + 1 : radius;
+            bx = x - r;
+            by = y - r;
+            bw = r * 2 + 1;
+            bh = r * 2 + 1;
+            break;
+        }
+            
+        case GeometryShape::LINE:
+            bx = min(x, x1);
+            by = min(y, y1);
+            bw = abs(x1 - x) + 1;
+            bh = abs(y1 - y) + 1;
+            break;
+            
+        case GeometryShape::TRIANGLE: {
+            bx = min(x, min(x1, x2));
+            by = min(y, min(y1, y2));
+            bw = max(x, max(x1, x2)) - bx + 1;
+            bh = max(y, max(y1, y2)) - by + 1;
+            break;
+        }
+            
+        default:
+            if (border) {
+                bx = x - 1;
+                by = y - 1;
+                bw = width + 2;
+                bh = height + 2;
+            } else {
+                GraphicsAsset::getBounds(bx, by, bw, bh);
+            }
+            break;
+    }
+}
+
 // Shape management
 void Geometry::setShape(GeometryShape shape) {
+    markDirty();
     this->shape = shape;
 }
 
@@ -74,6 +115,7 @@ GeometryShape Geometry::getShape() const {
 }
 
 void Geometry::setFilled(bool filled) {
+    markDirty();
     this->filled = filled;
 }
 
@@ -83,6 +125,7 @@ bool Geometry::isFilled() const {
 
 // Shape-specific setters
 void Geometry::setAsRectangle(int16_t x, int16_t y, int16_t w, int16_t h, bool filled) {
+    markDirty();
     this->x = x;
     this->y = y;
     this->width = w;
@@ -92,6 +135,7 @@ void Geometry::setAsRectangle(int16_t x, int16_t y, int16_t w, int16_t h, bool f
 }
 
 void Geometry::setAsRoundedRectangle(int16_t x, int16_t y, int16_t w, int16_t h, int16_t radius, bool filled) {
+    markDirty();
     this->x = x;
     this->y = y;
     this->width = w;
@@ -102,6 +146,7 @@ void Geometry::setAsRoundedRectangle(int16_t x, int16_t y, int16_t w, int16_t h,
 }
 
 void Geometry::setAsCircle(int16_t centerX, int16_t centerY, int16_t radius, bool filled) {
+    markDirty();
     this->x = centerX;
     this->y = centerY;
     this->radius = radius;
@@ -112,6 +157,7 @@ void Geometry::setAsCircle(int16_t centerX, int16_t centerY, int16_t radius, boo
 }
 
 void Geometry::setAsLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+    markDirty();
     this->x = x0;
     this->y = y0;
     this->x1 = x1;
@@ -123,6 +169,7 @@ void Geometry::setAsLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
 }
 
 void Geometry::setAsTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, bool filled) {
+    markDirty();
     this->x = x0;
     this->y = y0;
     this->x1 = x1;
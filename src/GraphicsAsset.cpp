@@ -2,7 +2,7 @@
 
 // Constructor
 GraphicsAsset::GraphicsAsset(int16_t x, int16_t y, int16_t width, int16_t height, AssetType type)
-    : x(x), y(y), width(width), height(height), visible(true), border(false), animate(false), zIndex(0), assetType(type) {
+    : x(x), y(y), width(width), height(height), visible(true), border(false), animate(false), zIndex(0), assetType(type), dirty(true), partialDirty(false) {
 }
 
 // Virtual destructor
@@ -21,15 +21,18 @@ int16_t GraphicsAsset::getY() const {
 // Position setters
 void GraphicsAsset::setX(int16_t x) {
     this->x = x;
+    markDirty();
 }
 
 void GraphicsAsset::setY(int16_t y) {
     this->y = y;
+    markDirty();
 }
 
 void GraphicsAsset::setPosition(int16_t x, int16_t y) {
     this->x = x;
     this->y = y;
+    markDirty();
 }
 
 // Size getters
@@ -44,15 +47,18 @@ int16_t GraphicsAsset::getHeight() const {
 // Size setters
 void GraphicsAsset::setWidth(int16_t width) {
     this->width = width;
+    markDirty();
 }
 
 void GraphicsAsset::setHeight(int16_t height) {
     this->height = height;
+    markDirty();
 }
 
 void GraphicsAsset::setSize(int16_t width, int16_t height) {
     this->width = width;
     this->height = height;
+    markDirty();
 }
 
 // Visibility control
@@ -62,14 +68,17 @@ bool GraphicsAsset::isVisible() const {
 
 void GraphicsAsset::setVisible(bool visible) {
     this->visible = visible;
+    markDirty();
 }
 
 void GraphicsAsset::show() {
     visible = true;
+    markDirty();
 }
 
 void GraphicsAsset::hide() {
     visible = false;
+    markDirty();
 }
 
 // Border control
@@ -79,6 +88,7 @@ bool GraphicsAsset::hasBorder() const {
 
 void GraphicsAsset::setBorder(bool border) {
     this->border = border;
+    markDirty();
 }
 
 // Animation control
@@ -88,6 +98,7 @@ bool GraphicsAsset::isAnimated() const {
 
 void GraphicsAsset::setAnimate(bool animate) {
     this->animate = animate;
+    markDirty();
 }
 
 // Z-index control
@@ -97,6 +108,7 @@ int16_t GraphicsAsset::getZIndex() const {
 
 void GraphicsAsset::setZIndex(int16_t zIndex) {
     this->zIndex = zIndex;
+    markDirty();
 }
 
 // Check if a point is inside the asset bounds
@@ -104,6 +116,53 @@ bool GraphicsAsset::contains(int16_t px, int16_t py) const {
     return (px >= x && px < x + width && py >= y && py < y + height);
 }
 
+// Default bounds are the asset rectangle
+void GraphicsAsset::getBounds(int16_t& bx, int16_t& by, int16_t& bw, int16_t& bh) const {
+    bx = x;
+    by = y;
+    bw = width;
+    bh = height;
+}
+
+// Invalidation
+bool GraphicsAsset::isDirty() const {
+    return dirty;
+}
+
+void GraphicsAsset::markDirty() {
+    dirty = true;
+    partialDirty = false;
+}
+
+void GraphicsAsset::clearDirty() {
+    dirty = false;
+    partialDirty = false;
+}
+
+// Partial repaint
+void GraphicsAsset::markPartiallyDirty() {
+    if (!dirty) {
+        partialDirty = true;
+    }
+    dirty = true;
+}
+
+bool GraphicsAsset::isPartiallyDirty() const {
+    return dirty && partialDirty;
+}
+
+bool GraphicsAsset::getDamage(int16_t& dx, int16_t& dy, int16_t& dw, int16_t& dh) const {
+    (void)dx;
+    (void)dy;
+    (void)dw;
+    (void)dh;
+    return false;
+}
+
+void GraphicsAsset::drawDamage(LedScreen128_64* screen) {
+    draw(screen);
+}
+
 // Type identification
 AssetType GraphicsAsset::getAssetType() const {
     return assetType;
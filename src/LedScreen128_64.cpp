@@ -1,18 +1,66 @@
 #include "LedScreen128_64.hpp"
 #include "GraphicsAsset.hpp"
+#include "Profiler.hpp"
 #include <algorithm>
+#include <new>
+#include <string.h>
+#include "FrameRaster.hpp"
+
+// Cost in bytes of opening an extra flush window (address commands plus
+// the transaction overhead), used to decide whether to merge windows
+static const size_t FLUSH_WINDOW_OVERHEAD = 10;
+
+// Primitive drawing, through FrameRaster (native raster build) or Adafruit_GFX.
+// Expects a bool white in scope; the rotation switch runs once per call.
+#if LED_SCREEN_NATIVE_RASTER
+#define DRAW_PRIMITIVE(gfx_method, raster_method, ...)                                           \
+    do {                                                                                         \
+        uint8_t* framebuffer = display->getBuffer();                                             \
+        switch (display->getRotation()) {                                                        \
+            case 1: FrameRaster<1>(framebuffer).raster_method(__VA_ARGS__, white); break;        \
+            case 2: FrameRaster<2>(framebuffer).raster_method(__VA_ARGS__, white); break;        \
+            case 3: FrameRaster<3>(framebuffer).raster_method(__VA_ARGS__, white); break;        \
+            default: FrameRaster<0>(framebuffer).raster_method(__VA_ARGS__, white); break;       \
+        }                                                                                        \
+    } while (0)
+#else
+#define DRAW_PRIMITIVE(gfx_method, raster_method, ...) \
+    display->gfx_method(__VA_ARGS__, white ? SSD1306_WHITE : SSD1306_BLACK)
+#endif
 
 // Constructor
 LedScreen128_64::LedScreen128_64(uint8_t address)
-    : Device(address), display(nullptr), display_initialized(false) {
+    : Device(address), display(nullptr), display_initialized(false), text_size(1),
+      partial_flush(true), flushed_frame_valid(false), last_flush_bytes(0), last_flush_time_us(0),
+      frame_interval_us(0), last_flush_start_us(0), flush_buffers(0), frame_queued(false),
+      flush_busy(false), frames_flushed(0), frames_replaced(0),
+      retained_mode(false), assets_invalid(true), pending_damage_count(0) {
+    flush_slots[0].pixels = nullptr;
+    flush_slots[1].pixels = nullptr;
+#if LED_SCREEN_FLUSH_RTOS
+    flush_task = nullptr;
+    flush_mutex = nullptr;
+    flush_idle = nullptr;
+    flush_wake = nullptr;
+#endif
+    
     // Create display object with I2C
     display.reset(new Adafruit_SSD1306(SCREEN_WIDTH, SCREEN_HEIGHT, wire_instance, OLED_RESET));
     
     // assets vector default-initialized empty
+    clearDirty();
+    
+    // Frame flushes yield to sensor traffic on the bus scheduler
+    bus_priority = BusPriority::BULK;
+    
+    // SSD1306 is rated for Fast-mode; many modules also run at 1 MHz
+    // (setMaxBusFrequency(I2C_FAST_PLUS_CLOCK) before begin())
+    max_bus_frequency = I2C_FAST_CLOCK;
 }
 
 // Destructor
 LedScreen128_64::~LedScreen128_64() {
+    stopFlushTask();
     // unique_ptr will auto-delete
 }
 
@@ -22,13 +70,19 @@ bool LedScreen128_64::begin() {
         return false;
     }
     
-    // Initialize the SSD1306 display
-    if (!display->begin(SSD1306_SWITCHCAPVCC, i2c_address)) {
+    // Initialize the SSD1306 display (the driver talks to Wire directly)
+    bool ok;
+    {
+        BusGuard guard(wire_instance);
+        ok = display->begin(SSD1306_SWITCHCAPVCC, i2c_address);
+    }
+    if (!ok) {
         display_initialized = false;
         return false;
     }
     
     display_initialized = true;
+    flushed_frame_valid = false;  // Panel contents unknown until the first full flush
     clearDisplay();
     displayBuffer();
     
@@ -39,23 +93,474 @@ bool LedScreen128_64::begin() {
 void LedScreen128_64::clearDisplay() {
     if (display_initialized) {
         display->clearDisplay();
+        markAllDirty();
+        invalidateAssets();
     }
 }
 
 void LedScreen128_64::displayBuffer() {
-    if (display_initialized) {
-        display->display();
+    if (!display_initialized) {
+        return;
+    }
+    PROFILE_FRAME();
+    
+#if LED_SCREEN_FLUSH_RTOS
+    if (flush_task != nullptr) {
+        queueFrame();
+        return;
+    }
+#endif
+    
+    paceFrame();
+    flushFrame(display->getBuffer(), dirty_col_start, dirty_col_end);
+    clearDirty();
+}
+
+// Send one frame; each window is a separate scheduler request (run at this
+// display's bus rate), so sensor reads can run between them
+void LedScreen128_64::flushFrame(const uint8_t* frame, const uint8_t* col_start, const uint8_t* col_end) {
+    PROFILE_SCOPE(ProfileZone::DISPLAY_FLUSH);
+    unsigned long start = micros();
+    last_flush_start_us = start;
+    
+    if (!partial_flush || !flushed_frame_valid) {
+        // Full frame as a single full-width window (one bulk transfer)
+        last_flush_bytes = 0;
+        flushed_frame_valid = flushWindow(frame, 0, SCREEN_PAGES - 1, 0, SCREEN_WIDTH - 1);
+    } else {
+        flushDirtyWindows(frame, col_start, col_end);
+    }
+    
+    last_flush_time_us = micros() - start;
+    frames_flushed.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Wait until the frame interval has passed since the last flush started
+void LedScreen128_64::paceFrame() {
+    if (frame_interval_us == 0) {
+        return;
+    }
+    unsigned long elapsed = micros() - last_flush_start_us;
+    if (elapsed < frame_interval_us) {
+        unsigned long wait = frame_interval_us - elapsed;
+        delay(wait / 1000);
+        delayMicroseconds(wait % 1000);
+    }
+}
+
+// Frame pacing
+void LedScreen128_64::setMaxFrameRate(uint8_t max_fps) {
+    frame_interval_us = max_fps > 0 ? 1000000UL / max_fps : 0;
+}
+
+uint8_t LedScreen128_64::getMaxFrameRate() const {
+    return frame_interval_us > 0 ? (uint8_t)((1000000UL + frame_interval_us / 2) / frame_interval_us) : 0;
+}
+
+// Background flushing
+bool LedScreen128_64::startFlushTask(uint8_t buffers, int core, uint32_t stack_size, uint8_t task_priority) {
+#if LED_SCREEN_FLUSH_RTOS
+    if (flush_task != nullptr) {
+        return buffers == flush_buffers;
+    }
+    if (buffers != 2 && buffers != 3) {
+        return false;
+    }
+    
+    // One slot for double buffering, a second (queued) slot for triple
+    uint8_t slots = buffers - 1;
+    for (uint8_t i = 0; i < slots; i++) {
+        flush_slots[i].pixels = new (std::nothrow) uint8_t[SCREEN_WIDTH * SCREEN_PAGES];
+    }
+    flush_mutex = xSemaphoreCreateMutex();
+    flush_idle = xSemaphoreCreateBinary();
+    flush_wake = xSemaphoreCreateBinary();
+    bool ok = flush_slots[0].pixels != nullptr && (slots < 2 || flush_slots[1].pixels != nullptr) &&
+              flush_mutex != nullptr && flush_idle != nullptr && flush_wake != nullptr;
+    
+    if (ok) {
+        flush_buffers = buffers;
+        frame_queued = false;
+        flush_busy = false;
+        ok = xTaskCreatePinnedToCore(flushTaskEntry, "screen_flush", stack_size, this,
+                                     task_priority, &flush_task, core) == pdPASS;
+    }
+    if (!ok) {
+        flush_task = nullptr;
+        stopFlushTask();
+    }
+    return ok;
+#else
+    (void)buffers;
+    (void)core;
+    (void)stack_size;
+    (void)task_priority;
+    return false;
+#endif
+}
+
+void LedScreen128_64::stopFlushTask() {
+#if LED_SCREEN_FLUSH_RTOS
+    if (flush_task != nullptr) {
+        waitForFlush();
+        vTaskDelete(flush_task);
+        flush_task = nullptr;
+    }
+    if (flush_mutex != nullptr) {
+        vSemaphoreDelete(flush_mutex);
+        flush_mutex = nullptr;
+    }
+    if (flush_idle != nullptr) {
+        vSemaphoreDelete(flush_idle);
+        flush_idle = nullptr;
+    }
+    if (flush_wake != nullptr) {
+        vSemaphoreDelete(flush_wake);
+        flush_wake = nullptr;
+    }
+#endif
+    delete[] flush_slots[0].pixels;
+    delete[] flush_slots[1].pixels;
+    flush_slots[0].pixels = nullptr;
+    flush_slots[1].pixels = nullptr;
+    flush_buffers = 0;
+}
+
+bool LedScreen128_64::isFlushTaskRunning() const {
+#if LED_SCREEN_FLUSH_RTOS
+    return flush_task != nullptr;
+#else
+    return false;
+#endif
+}
+
+void LedScreen128_64::waitForFlush() {
+#if LED_SCREEN_FLUSH_RTOS
+    // Timed takes so a give that raced with the check is never waited out
+    while (flush_task != nullptr && flush_busy.load()) {
+        xSemaphoreTake(flush_idle, pdMS_TO_TICKS(5));
+    }
+#endif
+}
+
+uint32_t LedScreen128_64::getFramesFlushed() const {
+    return frames_flushed.load(std::memory_order_relaxed);
+}
+
+uint32_t LedScreen128_64::getFramesReplaced() const {
+    return frames_replaced.load(std::memory_order_relaxed);
+}
+
+#if LED_SCREEN_FLUSH_RTOS
+// Hand the current frame to the flush task
+void LedScreen128_64::queueFrame() {
+    if (flush_buffers == 2) {
+        waitForFlush();  // The only slot is free once the task is idle
+    }
+    
+    xSemaphoreTake(flush_mutex, portMAX_DELAY);
+    FlushSlot& slot = flush_slots[flush_buffers == 3 ? 1 : 0];
+    memcpy(slot.pixels, display->getBuffer(), SCREEN_WIDTH * SCREEN_PAGES);
+    for (uint8_t page = 0; page < SCREEN_PAGES; page++) {
+        // A replaced frame's changes still have to reach the panel
+        if (!frame_queued || slot.col_start[page] > slot.col_end[page]) {
+            slot.col_start[page] = dirty_col_start[page];
+            slot.col_end[page] = dirty_col_end[page];
+        } else if (dirty_col_start[page] <= dirty_col_end[page]) {
+            slot.col_start[page] = min(slot.col_start[page], dirty_col_start[page]);
+            slot.col_end[page] = max(slot.col_end[page], dirty_col_end[page]);
+        }
+    }
+    if (frame_queued) {
+        frames_replaced.fetch_add(1, std::memory_order_relaxed);
+    }
+    frame_queued = true;
+    flush_busy = true;
+    xSemaphoreGive(flush_mutex);
+    
+    clearDirty();
+    xSemaphoreGive(flush_wake);
+}
+
+// Flush task: send queued frames until there are none left. Frames wake the
+// task through flush_wake: its notification value belongs to
+// BusScheduler::transfer(), which waits on it for each bus completion
+void LedScreen128_64::flushTaskEntry(void* param) {
+    LedScreen128_64* screen = static_cast<LedScreen128_64*>(param);
+    for (;;) {
+        xSemaphoreTake(screen->flush_wake, portMAX_DELAY);
+        screen->flushQueuedFrames();
+    }
+}
+
+void LedScreen128_64::flushQueuedFrames() {
+    for (;;) {
+        // Frames presented while pacing are merged into the queued one
+        paceFrame();
+        
+        xSemaphoreTake(flush_mutex, portMAX_DELAY);
+        if (!frame_queued) {
+            flush_busy = false;
+            xSemaphoreGive(flush_mutex);
+            xSemaphoreGive(flush_idle);
+            return;
+        }
+        if (flush_buffers == 3) {
+            FlushSlot sending = flush_slots[1];
+            flush_slots[1] = flush_slots[0];
+            flush_slots[0] = sending;
+        }
+        frame_queued = false;
+        xSemaphoreGive(flush_mutex);
+        
+        flushFrame(flush_slots[0].pixels, flush_slots[0].col_start, flush_slots[0].col_end);
+    }
+}
+#endif
+
+// Partial flush control
+void LedScreen128_64::setPartialFlush(bool enable) {
+    partial_flush = enable;
+}
+
+bool LedScreen128_64::getPartialFlush() const {
+    return partial_flush;
+}
+
+size_t LedScreen128_64::getLastFlushBytes() const {
+    return last_flush_bytes;
+}
+
+unsigned long LedScreen128_64::getLastFlushTime() const {
+    return last_flush_time_us;
+}
+
+// Raw framebuffer write in physical page/column coordinates
+bool LedScreen128_64::writeFramebuffer(uint8_t page_start, uint8_t page_count, uint8_t col_start,
+                                       uint8_t col_count, const uint8_t* data) {
+    if (!display_initialized || data == nullptr || page_count == 0 || col_count == 0 ||
+        page_start + page_count > SCREEN_PAGES || col_start + col_count > SCREEN_WIDTH) {
+        return false;
+    }
+    
+    uint8_t* frame = display->getBuffer();
+    for (uint8_t page = 0; page < page_count; page++) {
+        memcpy(&frame[(page_start + page) * SCREEN_WIDTH + col_start], &data[page * col_count], col_count);
+    }
+    markDirtyPhysical(col_start, page_start * 8, col_start + col_count - 1,
+                      (page_start + page_count) * 8 - 1);
+    return true;
+}
+
+// Mark a rectangle given in screen (rotated) coordinates as modified
+void LedScreen128_64::markDirty(int16_t x, int16_t y, int16_t w, int16_t h) {
+    if (w == 0 || h == 0) {
+        return;
+    }
+    if (w < 0) {
+        x += w + 1;
+        w = -w;
+    }
+    if (h < 0) {
+        y += h + 1;
+        h = -h;
+    }
+    
+    int16_t x1 = x + w - 1;
+    int16_t y1 = y + h - 1;
+    
+    // Map the logical corners onto the physical panel, mirroring the
+    // transform Adafruit_SSD1306::drawPixel applies for each rotation
+    switch (display->getRotation()) {
+        case 1:
+            markDirtyPhysical(SCREEN_WIDTH - 1 - y1, x, SCREEN_WIDTH - 1 - y, x1);
+            break;
+        case 2:
+            markDirtyPhysical(SCREEN_WIDTH - 1 - x1, SCREEN_HEIGHT - 1 - y1,
+                              SCREEN_WIDTH - 1 - x, SCREEN_HEIGHT - 1 - y);
+            break;
+        case 3:
+            markDirtyPhysical(y, SCREEN_HEIGHT - 1 - x1, y1, SCREEN_HEIGHT - 1 - x);
+            break;
+        default:
+            markDirtyPhysical(x, y, x1, y1);
+            break;
+    }
+}
+
+void LedScreen128_64::markAllDirty() {
+    for (uint8_t page = 0; page < SCREEN_PAGES; page++) {
+        dirty_col_start[page] = 0;
+        dirty_col_end[page] = SCREEN_WIDTH - 1;
+    }
+}
+
+// Dirty tracking helpers
+void LedScreen128_64::markDirtyPhysical(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+    // Clip to the panel
+    if (x1 < 0 || y1 < 0 || x0 >= SCREEN_WIDTH || y0 >= SCREEN_HEIGHT) {
+        return;
+    }
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 >= SCREEN_WIDTH) x1 = SCREEN_WIDTH - 1;
+    if (y1 >= SCREEN_HEIGHT) y1 = SCREEN_HEIGHT - 1;
+    
+    for (int16_t page = y0 / 8; page <= y1 / 8; page++) {
+        if (dirty_col_start[page] > dirty_col_end[page]) {
+            dirty_col_start[page] = x0;
+            dirty_col_end[page] = x1;
+        } else {
+            if (x0 < dirty_col_start[page]) dirty_col_start[page] = x0;
+            if (x1 > dirty_col_end[page]) dirty_col_end[page] = x1;
+        }
+    }
+}
+
+void LedScreen128_64::markTextDirty(int16_t start_x, int16_t start_y) {
+    int16_t end_x = display->getCursorX();
+    int16_t end_y = display->getCursorY();
+    int16_t line_height = 8 * text_size;
+    
+    if (end_y == start_y) {
+        markDirty(start_x, start_y, end_x - start_x, line_height);
+    } else {
+        // Text wrapped or ended with a newline - mark the full rows it touched
+        int16_t top = min(start_y, end_y);
+        markDirty(0, top, display->width(), abs(end_y - start_y) + line_height);
     }
 }
 
+void LedScreen128_64::clearDirty() {
+    for (uint8_t page = 0; page < SCREEN_PAGES; page++) {
+        dirty_col_start[page] = 0xFF;
+        dirty_col_end[page] = 0;
+    }
+}
+
+// Flush helpers
+void LedScreen128_64::flushDirtyWindows(const uint8_t* frame, const uint8_t* col_start, const uint8_t* col_end) {
+    last_flush_bytes = 0;
+    
+    // Pending window, grown over consecutive pages while merging is cheaper
+    // than opening a new one
+    bool window_open = false;
+    uint8_t win_page_start = 0, win_page_end = 0, win_col_start = 0, win_col_end = 0;
+    
+    for (uint8_t page = 0; page < SCREEN_PAGES; page++) {
+        if (col_start[page] > col_end[page]) {
+            continue;
+        }
+        
+        // Trim the marked span down to bytes that differ from the panel
+        const uint8_t* row = frame + page * SCREEN_WIDTH;
+        const uint8_t* shown = flushed_frame + page * SCREEN_WIDTH;
+        int16_t start = col_start[page];
+        int16_t end = col_end[page];
+        while (start <= end && row[start] == shown[start]) start++;
+        while (end >= start && row[end] == shown[end]) end--;
+        if (start > end) {
+            continue;
+        }
+        
+        if (window_open && page == win_page_end + 1) {
+            uint8_t merged_start = min((int16_t)win_col_start, start);
+            uint8_t merged_end = max((int16_t)win_col_end, end);
+            size_t merged_cost = (size_t)(merged_end - merged_start + 1) * (page - win_page_start + 1);
+            size_t separate_cost = (size_t)(win_col_end - win_col_start + 1) * (win_page_end - win_page_start + 1)
+                                 + (end - start + 1) + FLUSH_WINDOW_OVERHEAD;
+            if (merged_cost <= separate_cost) {
+                win_page_end = page;
+                win_col_start = merged_start;
+                win_col_end = merged_end;
+                continue;
+            }
+        }
+        
+        if (window_open && !flushWindow(frame, win_page_start, win_page_end, win_col_start, win_col_end)) {
+            flushed_frame_valid = false;  // Panel state unknown, resend everything next time
+            break;
+        }
+        
+        window_open = true;
+        win_page_start = win_page_end = page;
+        win_col_start = start;
+        win_col_end = end;
+    }
+    
+    if (window_open && flushed_frame_valid &&
+        !flushWindow(frame, win_page_start, win_page_end, win_col_start, win_col_end)) {
+        flushed_frame_valid = false;
+    }
+}
+
+bool LedScreen128_64::flushWindow(const uint8_t* frame, uint8_t page_start, uint8_t page_end, uint8_t col_start,
+                                  uint8_t col_end) {
+    // Restrict the SSD1306 horizontal addressing window to the dirty area
+    const uint8_t commands[] = {
+        0x00,  // Control byte: command stream
+        SSD1306_PAGEADDR, page_start, page_end,
+        SSD1306_COLUMNADDR, col_start, col_end
+    };
+    if (!send(commands, sizeof(commands))) {
+        return false;
+    }
+    
+    // Full-width windows are contiguous in the framebuffer: send them as one
+    // zero-copy bulk transfer
+    if (col_start == 0 && col_end == SCREEN_WIDTH - 1) {
+        static const uint8_t data_control = 0x40;
+        size_t offset = page_start * SCREEN_WIDTH;
+        size_t count = (size_t)(page_end - page_start + 1) * SCREEN_WIDTH;
+        if (!sendBulk(frame + offset, count, &data_control, 1)) {
+            return false;
+        }
+        memcpy(flushed_frame + offset, frame + offset, count);
+        last_flush_bytes += count;
+        return true;
+    }
+    
+    uint8_t packet[SSD1306_FLUSH_CHUNK];
+    packet[0] = 0x40;  // Control byte: data stream
+    size_t fill = 1;
+    
+    for (uint8_t page = page_start; page <= page_end; page++) {
+        size_t offset = page * SCREEN_WIDTH + col_start;
+        size_t count = col_end - col_start + 1;
+        memcpy(flushed_frame + offset, frame + offset, count);
+        
+        for (size_t i = 0; i < count; i++) {
+            packet[fill++] = frame[offset + i];
+            if (fill == sizeof(packet)) {
+                if (!send(packet, fill)) {
+                    return false;
+                }
+                last_flush_bytes += fill - 1;
+                fill = 1;
+            }
+        }
+    }
+    
+    if (fill > 1) {
+        if (!send(packet, fill)) {
+            return false;
+        }
+        last_flush_bytes += fill - 1;
+    }
+    
+    return true;
+}
+
 void LedScreen128_64::invertDisplay(bool invert) {
     if (display_initialized) {
+        BusGuard guard(wire_instance);
         display->invertDisplay(invert);
     }
 }
 
 void LedScreen128_64::dim(bool dimmed) {
     if (display_initialized) {
+        BusGuard guard(wire_instance);
         display->dim(dimmed);
     }
 }
@@ -63,7 +568,13 @@ void LedScreen128_64::dim(bool dimmed) {
 // Screen operations
 void LedScreen128_64::fillScreen(bool white) {
     if (display_initialized) {
+#if LED_SCREEN_NATIVE_RASTER
+        memset(display->getBuffer(), white ? 0xFF : 0x00, SCREEN_WIDTH * SCREEN_PAGES);
+#else
         display->fillScreen(white ? SSD1306_WHITE : SSD1306_BLACK);
+#endif
+        markAllDirty();
+        invalidateAssets();
     }
 }
 
@@ -73,79 +584,99 @@ void LedScreen128_64::setRotation(uint8_t rotation) {
     }
 }
 
+uint8_t LedScreen128_64::getRotation() const {
+    return display_initialized ? display->getRotation() : 0;
+}
+
 // Pixel operations
 void LedScreen128_64::drawPixel(int16_t x, int16_t y, bool white) {
     if (display_initialized) {
-        display->drawPixel(x, y, white ? SSD1306_WHITE : SSD1306_BLACK);
+        DRAW_PRIMITIVE(drawPixel, pixel, x, y);
+        markDirty(x, y, 1, 1);
     }
 }
 
 // Line drawing
 void LedScreen128_64::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, bool white) {
     if (display_initialized) {
-        display->drawLine(x0, y0, x1, y1, white ? SSD1306_WHITE : SSD1306_BLACK);
+        DRAW_PRIMITIVE(drawLine, line, x0, y0, x1, y1);
+        markDirty(min(x0, x1), min(y0, y1), abs(x1 - x0) + 1, abs(y1 - y0) + 1);
     }
 }
 
 void LedScreen128_64::drawFastVLine(int16_t x, int16_t y, int16_t length, bool white) {
     if (display_initialized) {
-        display->drawFastVLine(x, y, length, white ? SSD1306_WHITE : SSD1306_BLACK);
+        DRAW_PRIMITIVE(drawFastVLine, vline, x, y, length);
+        markDirty(x, y, 1, length);
     }
 }
 
 void LedScreen128_64::drawFastHLine(int16_t x, int16_t y, int16_t length, bool white) {
     if (display_initialized) {
-        display->drawFastHLine(x, y, length, white ? SSD1306_WHITE : SSD1306_BLACK);
+        DRAW_PRIMITIVE(drawFastHLine, hline, x, y, length);
+        markDirty(x, y, length, 1);
     }
 }
 
 // Shape drawing - outlined
 void LedScreen128_64::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, bool white) {
     if (display_initialized) {
-        display->drawRect(x, y, w, h, white ? SSD1306_WHITE : SSD1306_BLACK);
+        DRAW_PRIMITIVE(drawRect, drawRect, x, y, w, h);
+        markDirty(x, y, w, h);
     }
 }
 
 void LedScreen128_64::drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, bool white) {
     if (display_initialized) {
-        display->drawRoundRect(x, y, w, h, r, white ? SSD1306_WHITE : SSD1306_BLACK);
+        DRAW_PRIMITIVE(drawRoundRect, drawRoundRect, x, y, w, h, r);
+        markDirty(x, y, w, h);
     }
 }
 
 void LedScreen128_64::drawCircle(int16_t x, int16_t y, int16_t r, bool white) {
     if (display_initialized) {
-        display->drawCircle(x, y, r, white ? SSD1306_WHITE : SSD1306_BLACK);
+        DRAW_PRIMITIVE(drawCircle, drawCircle, x, y, r);
+        markDirty(x - r, y - r, 2 * r + 1, 2 * r + 1);
     }
 }
 
 void LedScreen128_64::drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, bool white) {
     if (display_initialized) {
-        display->drawTriangle(x0, y0, x1, y1, x2, y2, white ? SSD1306_WHITE : SSD1306_BLACK);
+        DRAW_PRIMITIVE(drawTriangle, drawTriangle, x0, y0, x1, y1, x2, y2);
+        int16_t min_x = min(x0, min(x1, x2));
+        int16_t min_y = min(y0, min(y1, y2));
+        markDirty(min_x, min_y, max(x0, max(x1, x2)) - min_x + 1, max(y0, max(y1, y2)) - min_y + 1);
     }
 }
 
 // Shape drawing - filled
 void LedScreen128_64::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, bool white) {
     if (display_initialized) {
-        display->fillRect(x, y, w, h, white ? SSD1306_WHITE : SSD1306_BLACK);
+        DRAW_PRIMITIVE(fillRect, fillRect, x, y, w, h);
+        markDirty(x, y, w, h);
     }
 }
 
 void LedScreen128_64::fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, bool white) {
     if (display_initialized) {
-        display->fillRoundRect(x, y, w, h, r, white ? SSD1306_WHITE : SSD1306_BLACK);
+        DRAW_PRIMITIVE(fillRoundRect, fillRoundRect, x, y, w, h, r);
+        markDirty(x, y, w, h);
     }
 }
 
 void LedScreen128_64::fillCircle(int16_t x, int16_t y, int16_t r, bool white) {
     if (display_initialized) {
-        display->fillCircle(x, y, r, white ? SSD1306_WHITE : SSD1306_BLACK);
+        DRAW_PRIMITIVE(fillCircle, fillCircle, x, y, r);
+        markDirty(x - r, y - r, 2 * r + 1, 2 * r + 1);
     }
 }
 
 void LedScreen128_64::fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, bool white) {
     if (display_initialized) {
-        display->fillTriangle(x0, y0, x1, y1, x2, y2, white ? SSD1306_WHITE : SSD1306_BLACK);
+        DRAW_PRIMITIVE(fillTriangle, fillTriangle, x0, y0, x1, y1, x2, y2);
+        int16_t min_x = min(x0, min(x1, x2));
+        int16_t min_y = min(y0, min(y1, y2));
+        markDirty(min_x, min_y, max(x0, max(x1, x2)) - min_x + 1, max(y0, max(y1, y2)) - min_y + 1);
     }
 }
 
@@ -159,6 +690,7 @@ void LedScreen128_64::setCursor(int16_t x, int16_t y) {
 void LedScreen128_64::setTextSize(uint8_t size) {
     if (display_initialized) {
         display->setTextSize(size);
+        text_size = (size > 0) ? size : 1;
     }
 }
 
@@ -181,61 +713,100 @@ void LedScreen128_64::setTextWrap(bool wrap) {
 
 void LedScreen128_64::print(const char* text) {
     if (display_initialized) {
+        int16_t start_x = display->getCursorX();
+        int16_t start_y = display->getCursorY();
         display->print(text);
+        markTextDirty(start_x, start_y);
+    }
+}
+
+void LedScreen128_64::write(const char* text, size_t length) {
+    if (display_initialized && length > 0) {
+        int16_t start_x = display->getCursorX();
+        int16_t start_y = display->getCursorY();
+        display->write(reinterpret_cast<const uint8_t*>(text), length);
+        markTextDirty(start_x, start_y);
     }
 }
 
 void LedScreen128_64::print(int value) {
     if (display_initialized) {
+        int16_t start_x = display->getCursorX();
+        int16_t start_y = display->getCursorY();
         display->print(value);
+        markTextDirty(start_x, start_y);
     }
 }
 
 void LedScreen128_64::print(long value) {
     if (display_initialized) {
+        int16_t start_x = display->getCursorX();
+        int16_t start_y = display->getCursorY();
         display->print(value);
+        markTextDirty(start_x, start_y);
     }
 }
 
 void LedScreen128_64::print(unsigned long value) {
     if (display_initialized) {
+        int16_t start_x = display->getCursorX();
+        int16_t start_y = display->getCursorY();
         display->print(value);
+        markTextDirty(start_x, start_y);
     }
 }
 
 void LedScreen128_64::print(float value, int decimals) {
     if (display_initialized) {
+        int16_t start_x = display->getCursorX();
+        int16_t start_y = display->getCursorY();
         display->print(value, decimals);
+        markTextDirty(start_x, start_y);
     }
 }
 
 void LedScreen128_64::println(const char* text) {
     if (display_initialized) {
+        int16_t start_x = display->getCursorX();
+        int16_t start_y = display->getCursorY();
         display->println(text);
+        markTextDirty(start_x, start_y);
     }
 }
 
 void LedScreen128_64::println(int value) {
     if (display_initialized) {
+        int16_t start_x = display->getCursorX();
+        int16_t start_y = display->getCursorY();
         display->println(value);
+        markTextDirty(start_x, start_y);
     }
 }
 
 void LedScreen128_64::println(long value) {
     if (display_initialized) {
+        int16_t start_x = display->getCursorX();
+        int16_t start_y = display->getCursorY();
         display->println(value);
+        markTextDirty(start_x, start_y);
     }
 }
 
 void LedScreen128_64::println(unsigned long value) {
     if (display_initialized) {
+        int16_t start_x = display->getCursorX();
+        int16_t start_y = display->getCursorY();
         display->println(value);
+        markTextDirty(start_x, start_y);
     }
 }
 
 void LedScreen128_64::println(float value, int decimals) {
     if (display_initialized) {
+        int16_t start_x = display->getCursorX();
+        int16_t start_y = display->getCursorY();
         display->println(value, decimals);
+        markTextDirty(start_x, start_y);
     }
 }
 
@@ -245,6 +816,7 @@ void LedScreen128_64::drawChar(int16_t x, int16_t y, char c, bool white, bool bg
                          white ? SSD1306_WHITE : SSD1306_BLACK,
                          bg ? (white ? SSD1306_BLACK : SSD1306_WHITE) : (white ? SSD1306_WHITE : SSD1306_BLACK),
                          size);
+        markDirty(x, y, 6 * size, 8 * size);
     }
 }
 
@@ -306,38 +878,51 @@ void LedScreen128_64::drawRightAlignedNumber(int value, int16_t x, int16_t y, ui
 // Bitmap drawing
 void LedScreen128_64::drawBitmap(int16_t x, int16_t y, const uint8_t* bitmap, int16_t w, int16_t h, bool white) {
     if (display_initialized) {
-        display->drawBitmap(x, y, bitmap, w, h, white ? SSD1306_WHITE : SSD1306_BLACK);
+        DRAW_PRIMITIVE(drawBitmap, bitmap, x, y, bitmap, w, h);
+        markDirty(x, y, w, h);
     }
 }
 
 // Scrolling operations
 void LedScreen128_64::startScrollRight(uint8_t start, uint8_t stop) {
     if (display_initialized) {
+        waitForFlush();  // Scroll commands must not land between a flush's windows
+        BusGuard guard(wire_instance);
         display->startscrollright(start, stop);
     }
 }
 
 void LedScreen128_64::startScrollLeft(uint8_t start, uint8_t stop) {
     if (display_initialized) {
+        waitForFlush();
+        BusGuard guard(wire_instance);
         display->startscrollleft(start, stop);
     }
 }
 
 void LedScreen128_64::startScrollDiagRight(uint8_t start, uint8_t stop) {
     if (display_initialized) {
+        waitForFlush();
+        BusGuard guard(wire_instance);
         display->startscrolldiagright(start, stop);
     }
 }
 
 void LedScreen128_64::startScrollDiagLeft(uint8_t start, uint8_t stop) {
     if (display_initialized) {
+        waitForFlush();
+        BusGuard guard(wire_instance);
         display->startscrolldiagleft(start, stop);
     }
 }
 
 void LedScreen128_64::stopScroll() {
     if (display_initialized) {
+        waitForFlush();
+        BusGuard guard(wire_instance);
         display->stopscroll();
+        // Scrolling moves the panel RAM, so the next flush must be a full one
+        flushed_frame_valid = false;
     }
 }
 
@@ -346,6 +931,10 @@ Adafruit_SSD1306* LedScreen128_64::getDisplayObject() {
     return display.get();
 }
 
+uint8_t* LedScreen128_64::getFramebuffer() {
+    return display_initialized ? display->getBuffer() : nullptr;
+}
+
 // Screen dimensions
 int16_t LedScreen128_64::getWidth() const {
     return SCREEN_WIDTH;
@@ -355,25 +944,71 @@ int16_t LedScreen128_64::getHeight() const {
     return SCREEN_HEIGHT;
 }
 
+// Retained-mode rectangle helpers
+static bool rectEmpty(const ScreenRect& r) {
+    return r.w <= 0 || r.h <= 0;
+}
+
+static bool rectsIntersect(const ScreenRect& a, const ScreenRect& b) {
+    if (rectEmpty(a) || rectEmpty(b)) return false;
+    return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+static bool rectInside(const ScreenRect& inner, const ScreenRect& outer) {
+    return inner.x >= outer.x && inner.y >= outer.y &&
+           inner.x + inner.w <= outer.x + outer.w && inner.y + inner.h <= outer.y + outer.h;
+}
+
+static ScreenRect rectUnion(const ScreenRect& a, const ScreenRect& b) {
+    if (rectEmpty(a)) return b;
+    if (rectEmpty(b)) return a;
+    int16_t x0 = min(a.x, b.x);
+    int16_t y0 = min(a.y, b.y);
+    int16_t x1 = max((int16_t)(a.x + a.w), (int16_t)(b.x + b.w));
+    int16_t y1 = max((int16_t)(a.y + a.h), (int16_t)(b.y + b.h));
+    ScreenRect r = { x0, y0, (int16_t)(x1 - x0), (int16_t)(y1 - y0) };
+    return r;
+}
+
+static ScreenRect assetBounds(const GraphicsAsset* asset) {
+    ScreenRect r;
+    asset->getBounds(r.x, r.y, r.w, r.h);
+    return r;
+}
+
+static bool entryBefore(const AssetEntry& a, const AssetEntry& b) {
+    return a.asset->getZIndex() < b.asset->getZIndex();
+}
+
 // Graphics assets management
 bool LedScreen128_64::addAsset(GraphicsAsset* asset) {
     if (asset == nullptr) return false;
     if (assets.size() >= MAX_SCREEN_ASSETS) return false;
-    assets.push_back(asset);
+    
+    // Insert after any assets with the same z-index so the list stays sorted
+    sortAssets();
+    AssetEntry entry = { asset, { 0, 0, 0, 0 }, false, -1, { 0, 0, 0, 0 } };
+    assets.insert(std::upper_bound(assets.begin(), assets.end(), entry, entryBefore), entry);
+    asset->markDirty();
     return true;
 }
 
 bool LedScreen128_64::removeAsset(GraphicsAsset* asset) {
     if (asset == nullptr) return false;
-    auto it = std::find(assets.begin(), assets.end(), asset);
-    if (it != assets.end()) {
-        assets.erase(it);
-        return true;
+    for (auto it = assets.begin(); it != assets.end(); ++it) {
+        if (it->asset == asset) {
+            addPendingDamage(it->drawn);
+            assets.erase(it);
+            return true;
+        }
     }
     return false;
 }
 
 void LedScreen128_64::clearAssets() {
+    for (const AssetEntry& entry : assets) {
+        addPendingDamage(entry.drawn);
+    }
     assets.clear();
 }
 
@@ -381,19 +1016,181 @@ void LedScreen128_64::drawAssets() {
     if (!display_initialized) {
         return;
     }
+    PROFILE_SCOPE(ProfileZone::DRAW_ASSETS);
+    
+    sortAssets();
+    
+    if (retained_mode && !assets_invalid) {
+        drawAssetsRetained();
+        return;
+    }
     
-    // Sort assets by z-index (lower values drawn first)
-    std::sort(assets.begin(), assets.end(), [](GraphicsAsset* a, GraphicsAsset* b){
-        if (a == nullptr && b == nullptr) return false;
-        if (a == nullptr) return true;
-        if (b == nullptr) return false;
-        return a->getZIndex() < b->getZIndex();
-    });
-
     // Draw all assets in z-index order
-    for (auto asset : assets) {
-        if (asset != nullptr && asset->isVisible()) {
-            asset->draw(this);
+    for (AssetEntry& entry : assets) {
+        entry.asset->clearDirty();
+        if (entry.asset->isVisible()) {
+            entry.drawn = assetBounds(entry.asset);
+            PROFILE_SCOPE(ProfileZone::ASSET_DRAW);
+            entry.asset->draw(this);
+        } else {
+            entry.drawn.w = 0;
+        }
+    }
+    assets_invalid = false;
+    pending_damage_count = 0;
+}
+
+// Retained mode control
+void LedScreen128_64::setRetainedMode(bool enable) {
+    if (enable && !retained_mode) {
+        // Whatever is on screen may be stale, so repaint every asset's old and new area
+        for (AssetEntry& entry : assets) {
+            entry.asset->markDirty();
+        }
+    }
+    retained_mode = enable;
+}
+
+bool LedScreen128_64::getRetainedMode() const {
+    return retained_mode;
+}
+
+void LedScreen128_64::invalidateAssets() {
+    assets_invalid = true;
+}
+
+// Restore z-order only when a setZIndex() call has broken it
+void LedScreen128_64::sortAssets() {
+    if (!std::is_sorted(assets.begin(), assets.end(), entryBefore)) {
+        std::stable_sort(assets.begin(), assets.end(), entryBefore);
+    }
+}
+
+void LedScreen128_64::addPendingDamage(const ScreenRect& rect) {
+    if (rectEmpty(rect)) return;
+    if (pending_damage_count < SCREEN_DAMAGE_RECTS) {
+        pending_damage[pending_damage_count++] = rect;
+    } else {
+        pending_damage[SCREEN_DAMAGE_RECTS - 1] = rectUnion(pending_damage[SCREEN_DAMAGE_RECTS - 1], rect);
+    }
+}
+
+// Clear a damage area with page-span memsets, whatever the primitive backend
+void LedScreen128_64::clearRect(const ScreenRect& rect) {
+    uint8_t* framebuffer = display->getBuffer();
+    switch (display->getRotation()) {
+        case 1: FrameRaster<1>(framebuffer).fillRect(rect.x, rect.y, rect.w, rect.h, false); break;
+        case 2: FrameRaster<2>(framebuffer).fillRect(rect.x, rect.y, rect.w, rect.h, false); break;
+        case 3: FrameRaster<3>(framebuffer).fillRect(rect.x, rect.y, rect.w, rect.h, false); break;
+        default: FrameRaster<0>(framebuffer).fillRect(rect.x, rect.y, rect.w, rect.h, false); break;
+    }
+    markDirty(rect.x, rect.y, rect.w, rect.h);
+}
+
+// Repaint the old and new areas of dirty assets plus every asset overlapping them
+void LedScreen128_64::drawAssetsRetained() {
+    ScreenRect damage[SCREEN_DAMAGE_RECTS * 3];
+    size_t damage_count = 0;
+    const size_t damage_capacity = sizeof(damage) / sizeof(damage[0]);
+    bool damage_merged = false;
+    
+    auto addDamage = [&](const ScreenRect& r) {
+        if (rectEmpty(r)) return;
+        if (damage_count < damage_capacity) {
+            damage[damage_count++] = r;
+        } else {
+            damage[damage_capacity - 1] = rectUnion(damage[damage_capacity - 1], r);
+            damage_merged = true;
+        }
+    };
+    
+    for (uint8_t i = 0; i < pending_damage_count; i++) {
+        addDamage(pending_damage[i]);
+    }
+    pending_damage_count = 0;
+    
+    for (AssetEntry& entry : assets) {
+        entry.damage_slot = -1;
+        if (!entry.asset->isDirty()) continue;
+        
+        // Assets that changed in place may only need part of their area cleared
+        if (entry.asset->isVisible() && entry.asset->isPartiallyDirty() && damage_count < damage_capacity) {
+            ScreenRect now = assetBounds(entry.asset);
+            ScreenRect part;
+            if (now.x == entry.drawn.x && now.y == entry.drawn.y && now.w == entry.drawn.w && now.h == entry.drawn.h &&
+                entry.asset->getDamage(part.x, part.y, part.w, part.h) && !rectEmpty(part)) {
+                entry.damage_slot = (int8_t)damage_count;
+                addDamage(part);
+                continue;
+            }
+        }
+        
+        addDamage(entry.drawn);
+        if (entry.asset->isVisible()) {
+            ScreenRect now = assetBounds(entry.asset);
+            if (rectsIntersect(now, entry.drawn)) {
+                damage[damage_count - 1] = rectUnion(damage[damage_count - 1], now);
+            } else {
+                addDamage(now);
+            }
+        }
+    }
+    
+    if (damage_count == 0) {
+        return;
+    }
+    
+    for (size_t i = 0; i < damage_count; i++) {
+        clearRect(damage[i]);
+    }
+    
+    // Walk in z-order: an asset is redrawn when it is dirty, touches a cleared
+    // area, or overlaps the part of a lower asset's repaint that fell outside
+    // the cleared areas. Anything an asset paints inside a cleared area is
+    // covered again by the assets above it, which touch that area too
+    for (size_t i = 0; i < assets.size(); i++) {
+        AssetEntry& entry = assets[i];
+        entry.redrawn = false;
+        if (!entry.asset->isVisible()) {
+            entry.asset->clearDirty();
+            entry.drawn.w = 0;
+            continue;
+        }
+        
+        ScreenRect now = assetBounds(entry.asset);
+        bool needed = entry.asset->isDirty();
+        for (size_t d = 0; !needed && d < damage_count; d++) {
+            needed = rectsIntersect(now, damage[d]);
+        }
+        for (size_t j = 0; !needed && j < i; j++) {
+            needed = assets[j].redrawn && rectsIntersect(now, assets[j].painted);
+        }
+        if (!needed) continue;
+        
+        // A partial repaint is only safe while nothing else was cleared or
+        // drawn inside this asset's bounds
+        int8_t slot = entry.damage_slot;
+        bool partial = slot >= 0 && !(damage_merged && (size_t)slot == damage_capacity - 1);
+        for (size_t d = 0; partial && d < damage_count; d++) {
+            partial = d == (size_t)slot || !rectsIntersect(now, damage[d]);
+        }
+        for (size_t j = 0; partial && j < i; j++) {
+            partial = !(assets[j].redrawn && rectsIntersect(now, assets[j].painted));
+        }
+        
+        entry.asset->clearDirty();
+        entry.drawn = now;
+        PROFILE_SCOPE(ProfileZone::ASSET_DRAW);
+        if (partial) {
+            entry.painted = damage[slot];
+            entry.asset->drawDamage(this);
+        } else {
+            entry.painted = now;
+            entry.asset->draw(this);
+        }
+        entry.redrawn = true;
+        for (size_t d = 0; entry.redrawn && d < damage_count; d++) {
+            entry.redrawn = !rectInside(entry.painted, damage[d]);
         }
     }
 }
@@ -0,0 +1,265 @@
+#include "Profiler.hpp"
+#include "BusScheduler.hpp"
+#include "DeviceRegistry.hpp"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(ESP32)
+#define PROFILER_LOCK() portENTER_CRITICAL(&lock)
+#define PROFILER_UNLOCK() portEXIT_CRITICAL(&lock)
+#else
+#define PROFILER_LOCK() do { } while (0)
+#define PROFILER_UNLOCK() do { } while (0)
+#endif
+
+// Names of the built-in zones, in ProfileZone order
+static const char* const builtinZoneNames[] = {
+    "draw_assets",
+    "asset_draw",
+    "display_flush",
+    "frame",
+    "sensor_read",
+    "command",
+    "bus_transfer"
+};
+
+static_assert(sizeof(builtinZoneNames) / sizeof(builtinZoneNames[0]) == (size_t)ProfileZone::BUILTIN_COUNT,
+              "Zone names out of step with ProfileZone");
+static_assert((size_t)ProfileZone::BUILTIN_COUNT <= PROFILER_MAX_ZONES, "PROFILER_MAX_ZONES too small");
+
+// Private constructor
+Profiler::Profiler()
+    : zone_count((uint8_t)ProfileZone::BUILTIN_COUNT), enabled(true), cycles_per_us(1),
+      window_start_us(0), window_bus_busy_us(0), last_frame_cycles(0), frame_seen(false) {
+#if defined(ESP32)
+    portMUX_INITIALIZE(&lock);
+#endif
+    memset(zones, 0, sizeof(zones));
+    for (uint8_t i = 0; i < zone_count; i++) {
+        zones[i].name = builtinZoneNames[i];
+    }
+    reset();
+}
+
+// Get singleton instance
+Profiler& Profiler::getInstance() {
+    static Profiler instance;
+    return instance;
+}
+
+// Runtime switch
+void Profiler::setEnabled(bool enable) {
+    enabled.store(enable, std::memory_order_relaxed);
+}
+
+bool Profiler::isEnabled() const {
+    return enabled.load(std::memory_order_relaxed);
+}
+
+// Claim the next free zone slot
+uint8_t Profiler::addZone(const char* name) {
+    PROFILER_LOCK();
+    uint8_t id = 0xFF;
+    if (zone_count < PROFILER_MAX_ZONES) {
+        id = zone_count++;
+        memset(&zones[id], 0, sizeof(Zone));
+        zones[id].name = name != nullptr ? name : "zone";
+        zones[id].min_cycles = UINT32_MAX;
+    }
+    PROFILER_UNLOCK();
+    return id;
+}
+
+uint8_t Profiler::getZoneCount() const {
+    return zone_count;
+}
+
+float Profiler::cyclesToMicros(uint32_t elapsed) const {
+    return (float)elapsed / (float)cycles_per_us;
+}
+
+// Values below PROFILER_SUB_BUCKETS get a bucket each; above that every
+// power of two is split into PROFILER_SUB_BUCKETS equal parts
+uint8_t Profiler::bucketOf(uint32_t us) {
+    if (us < PROFILER_SUB_BUCKETS) {
+        return (uint8_t)us;
+    }
+    uint8_t octave = 31 - __builtin_clz(us);
+    if (octave >= PROFILER_OCTAVES) {
+        return PROFILER_BUCKETS - 1;
+    }
+    uint8_t sub = (us >> (octave - 2)) & (PROFILER_SUB_BUCKETS - 1);
+    return (uint8_t)(PROFILER_SUB_BUCKETS * (octave - 1) + sub);
+}
+
+float Profiler::bucketMid(uint8_t bucket) {
+    if (bucket < PROFILER_SUB_BUCKETS) {
+        return bucket + 0.5f;
+    }
+    uint8_t octave = bucket / PROFILER_SUB_BUCKETS + 1;
+    uint8_t sub = bucket % PROFILER_SUB_BUCKETS;
+    float width = (float)(1UL << (octave - 2));
+    return (PROFILER_SUB_BUCKETS + sub) * width + width / 2.0f;
+}
+
+// Recording
+void Profiler::record(uint8_t zone, uint32_t elapsed_cycles) {
+    if (zone >= zone_count) {
+        return;
+    }
+    uint8_t bucket = bucketOf(elapsed_cycles / cycles_per_us);
+
+    PROFILER_LOCK();
+    Zone& z = zones[zone];
+    z.count++;
+    z.total_cycles += elapsed_cycles;
+    if (elapsed_cycles < z.min_cycles) z.min_cycles = elapsed_cycles;
+    if (elapsed_cycles > z.max_cycles) z.max_cycles = elapsed_cycles;
+    z.buckets[bucket]++;
+    PROFILER_UNLOCK();
+}
+
+void Profiler::markFrame() {
+    if (!isEnabled()) {
+        return;
+    }
+    uint32_t now = cycles();
+    if (frame_seen) {
+        record(ProfileZone::FRAME_INTERVAL, now - last_frame_cycles);
+    }
+    last_frame_cycles = now;
+    frame_seen = true;
+}
+
+// Walk the histogram to the bucket holding the requested rank
+float Profiler::percentile(const Zone& zone, float fraction) const {
+    uint32_t rank = (uint32_t)(fraction * (zone.count - 1)) + 1;
+    uint32_t seen = 0;
+    uint8_t bucket = 0;
+    for (; bucket < PROFILER_BUCKETS - 1; bucket++) {
+        seen += zone.buckets[bucket];
+        if (seen >= rank) {
+            break;
+        }
+    }
+
+    float value = bucketMid(bucket);
+    float low = cyclesToMicros(zone.min_cycles);
+    float high = cyclesToMicros(zone.max_cycles);
+    return value < low ? low : (value > high ? high : value);
+}
+
+// Zone snapshot
+bool Profiler::getZoneStats(uint8_t zone, ProfileZoneStats& stats) const {
+    if (zone >= zone_count) {
+        return false;
+    }
+
+    // Copy under the lock, then do the float work outside it
+    Zone z;
+    PROFILER_LOCK();
+    z = zones[zone];
+    PROFILER_UNLOCK();
+
+    stats.name = z.name;
+    stats.count = z.count;
+    if (z.count == 0) {
+        stats.mean_us = stats.min_us = stats.max_us = stats.p50_us = stats.p99_us = 0.0f;
+        return true;
+    }
+    stats.mean_us = (float)((double)z.total_cycles / z.count / cycles_per_us);
+    stats.min_us = cyclesToMicros(z.min_cycles);
+    stats.max_us = cyclesToMicros(z.max_cycles);
+    stats.p50_us = percentile(z, 0.50f);
+    stats.p99_us = percentile(z, 0.99f);
+    return true;
+}
+
+// Bus busy time relative to the window
+float Profiler::getBusUtilization() const {
+    unsigned long window = getWindowTime();
+    if (window == 0) {
+        return 0.0f;
+    }
+    uint64_t busy = BusScheduler::getInstance().getBusyTime() - window_bus_busy_us;
+    float share = (float)busy / (float)window;
+    return share > 1.0f ? 1.0f : share;
+}
+
+unsigned long Profiler::getWindowTime() const {
+    return micros() - window_start_us;
+}
+
+// Heap and stack headroom
+ProfileHeapStats Profiler::getHeapStats() {
+    ProfileHeapStats stats = {};
+#if defined(ESP32)
+    stats.free_bytes = ESP.getFreeHeap();
+    stats.min_free_bytes = ESP.getMinFreeHeap();
+    stats.largest_block = ESP.getMaxAllocHeap();
+    stats.psram_free_bytes = ESP.getFreePsram();
+    stats.psram_min_free_bytes = ESP.getMinFreePsram();
+    stats.stack_headroom = uxTaskGetStackHighWaterMark(nullptr);  // Bytes on ESP-IDF
+#endif
+    return stats;
+}
+
+// Clear all zones
+void Profiler::reset() {
+#if defined(ESP32)
+    uint32_t mhz = getCpuFrequencyMhz();
+#else
+    uint32_t mhz = 1;  // micros() stands in for the cycle counter
+#endif
+
+    PROFILER_LOCK();
+    cycles_per_us = mhz > 0 ? mhz : 1;
+    for (uint8_t i = 0; i < zone_count; i++) {
+        const char* name = zones[i].name;
+        memset(&zones[i], 0, sizeof(Zone));
+        zones[i].name = name;
+        zones[i].min_cycles = UINT32_MAX;
+    }
+    frame_seen = false;
+    PROFILER_UNLOCK();
+
+    window_start_us = micros();
+    window_bus_busy_us = BusScheduler::getInstance().getBusyTime();
+}
+
+// Text report
+void Profiler::printReport(Print& out) const {
+    char line[96];
+    out.println("zone             count      p50      p99      max     mean (us)");
+    for (uint8_t i = 0; i < zone_count; i++) {
+        ProfileZoneStats stats;
+        if (!getZoneStats(i, stats) || stats.count == 0) {
+            continue;
+        }
+        snprintf(line, sizeof(line), "%-14s %7lu %8.1f %8.1f %8.1f %8.1f", stats.name,
+                 (unsigned long)stats.count, stats.p50_us, stats.p99_us, stats.max_us, stats.mean_us);
+        out.println(line);
+    }
+
+    BusScheduler& bus = BusScheduler::getInstance();
+    snprintf(line, sizeof(line), "bus: %.1f%% busy over %.1f s, %lu ok, %lu failed",
+             getBusUtilization() * 100.0f, getWindowTime() / 1e6f,
+             bus.getCompletedCount(), bus.getFailedCount());
+    out.println(line);
+
+    DeviceRegistry& registry = DeviceRegistry::getInstance();
+    snprintf(line, sizeof(line), "queues (now/peak): actions %u/%u, sensor %u/%u, control %u/%u, bulk %u/%u",
+             (unsigned)registry.getPendingActionCount(), (unsigned)registry.getPeakActionCount(),
+             (unsigned)bus.getPendingCount(BusPriority::SENSOR), (unsigned)bus.getPeakPendingCount(BusPriority::SENSOR),
+             (unsigned)bus.getPendingCount(BusPriority::CONTROL), (unsigned)bus.getPeakPendingCount(BusPriority::CONTROL),
+             (unsigned)bus.getPendingCount(BusPriority::BULK), (unsigned)bus.getPeakPendingCount(BusPriority::BULK));
+    out.println(line);
+
+    ProfileHeapStats heap = getHeapStats();
+    snprintf(line, sizeof(line), "heap: %u free, %u min free, %u largest; psram %u free, %u min free",
+             (unsigned)heap.free_bytes, (unsigned)heap.min_free_bytes, (unsigned)heap.largest_block,
+             (unsigned)heap.psram_free_bytes, (unsigned)heap.psram_min_free_bytes);
+    out.println(line);
+    snprintf(line, sizeof(line), "stack headroom: %u bytes", (unsigned)heap.stack_headroom);
+    out.println(line);
+}
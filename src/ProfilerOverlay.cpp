@@ -0,0 +1,74 @@
+#include "ProfilerOverlay.hpp"
+#include "Profiler.hpp"
+#include <stdio.h>
+#include <string.h>
+
+// Constructor
+ProfilerOverlay::ProfilerOverlay(int16_t x, int16_t y, int16_t width, int16_t height)
+    : GraphicsAsset(x, y, width, height, AssetType::PROFILER_OVERLAY) {
+    formatLines(lines);
+}
+
+// Destructor
+ProfilerOverlay::~ProfilerOverlay() {
+}
+
+// Frame rate from the mean frame interval, everything else as reported
+void ProfilerOverlay::formatLines(char (&out)[PROFILER_OVERLAY_LINES][PROFILER_OVERLAY_CHARS + 1]) const {
+    memset(out, 0, sizeof(out));  // update() compares whole buffers
+    Profiler& profiler = Profiler::getInstance();
+    ProfileZoneStats frame;
+    ProfileZoneStats flush;
+    profiler.getZoneStats((uint8_t)ProfileZone::FRAME_INTERVAL, frame);
+    profiler.getZoneStats((uint8_t)ProfileZone::DISPLAY_FLUSH, flush);
+
+    float fps = frame.mean_us > 0.0f ? 1e6f / frame.mean_us : 0.0f;
+    snprintf(out[0], sizeof(out[0]), "fps %4.1f flush %.1fms", fps, flush.p50_us / 1000.0f);
+
+    ProfileHeapStats heap = Profiler::getHeapStats();
+    snprintf(out[1], sizeof(out[1]), "bus %3d%% heap %uk", (int)(profiler.getBusUtilization() * 100.0f + 0.5f),
+             (unsigned)(heap.free_bytes / 1024));
+}
+
+// Draw the overlay
+void ProfilerOverlay::draw(LedScreen128_64* screen) {
+    if (!visible || screen == nullptr) {
+        return;
+    }
+
+    formatLines(lines);
+
+    // Opaque background so the figures stay readable over other assets
+    screen->fillRect(x, y, width, height, false);
+    if (border) {
+        screen->drawRect(x, y, width, height, true);
+    }
+
+    screen->setTextSize(1);
+    screen->setTextColor(true, false);
+    screen->setTextWrap(false);
+    for (uint8_t i = 0; i < PROFILER_OVERLAY_LINES; i++) {
+        int16_t lineY = y + 1 + i * 8;
+        if (lineY + 8 > y + height) {
+            break;
+        }
+        screen->setCursor(x + 1, lineY);
+        screen->print(lines[i]);
+    }
+}
+
+// Refresh the text, repainting only on change
+bool ProfilerOverlay::update() {
+    char fresh[PROFILER_OVERLAY_LINES][PROFILER_OVERLAY_CHARS + 1];
+    formatLines(fresh);
+    if (memcmp(fresh, lines, sizeof(lines)) == 0) {
+        return false;
+    }
+    memcpy(lines, fresh, sizeof(lines));
+    markDirty();
+    return true;
+}
+
+const char* ProfilerOverlay::getLine(uint8_t line) const {
+    return line < PROFILER_OVERLAY_LINES ? lines[line] : "";
+}
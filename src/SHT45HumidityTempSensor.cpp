@@ -1,11 +1,31 @@
 #include "SHT45HumidityTempSensor.hpp"
+#include "Profiler.hpp"
+
+// SHT4x measurement commands (datasheet table 7)
+#define SHT4X_CMD_MEASURE_HIGH   0xFD
+#define SHT4X_CMD_MEASURE_MED    0xF6
+#define SHT4X_CMD_MEASURE_LOW    0xE0
+#define SHT4X_CMD_HEATER_HIGH_1S     0x39
+#define SHT4X_CMD_HEATER_HIGH_100MS  0x32
+#define SHT4X_CMD_HEATER_MED_1S      0x2F
+#define SHT4X_CMD_HEATER_MED_100MS   0x24
+#define SHT4X_CMD_HEATER_LOW_1S      0x1E
+#define SHT4X_CMD_HEATER_LOW_100MS   0x15
 
 // Constructor
 SHT45HumidityTempSensor::SHT45HumidityTempSensor(uint8_t address)
     : Device(address), sht45(nullptr), sensor_initialized(false),
-      last_temperature(0.0f), last_humidity(0.0f), last_read_time(0) {
+      last_temperature(0.0f), last_humidity(0.0f), last_read_time(0),
+      precision_mode(SHT4X_HIGH_PRECISION), heater_mode(SHT4X_NO_HEATER),
+      measurement_pending(false), measurement_start(0), measurement_duration(0) {
     // Create the Adafruit SHT4x sensor object
     sht45 = new Adafruit_SHT4x();
+    
+    // Readings are time-critical, so they jump ahead of display traffic
+    bus_priority = BusPriority::SENSOR;
+    
+    // SHT4x supports Fast-mode
+    max_bus_frequency = I2C_FAST_CLOCK;
 }
 
 // Destructor
@@ -18,13 +38,23 @@ SHT45HumidityTempSensor::~SHT45HumidityTempSensor() {
 
 // Initialize the sensor
 bool SHT45HumidityTempSensor::begin() {
+    return startBegin() && finishBegin();
+}
+
+// Set up the sensor and start the first measurement without waiting for it
+bool SHT45HumidityTempSensor::startBegin() {
     // First initialize the base Device class
     if (!Device::begin()) {
         return false;
     }
     
     // Now initialize the SHT45 sensor using the Wire instance from Device class
-    if (!sht45->begin(wire_instance)) {
+    bool ok;
+    {
+        BusGuard guard;
+        ok = sht45->begin(wire_instance);
+    }
+    if (!ok) {
         sensor_initialized = false;
         return false;
     }
@@ -34,7 +64,17 @@ bool SHT45HumidityTempSensor::begin() {
     // Set default precision to high for best accuracy
     setPrecision(SHT4X_HIGH_PRECISION);
     
-    // Perform an initial reading to verify sensor is working
+    // The initial reading verifies the sensor; its conversion runs in the background
+    if (!startMeasurement()) {
+        sensor_initialized = false;
+        return false;
+    }
+    
+    return true;
+}
+
+// Collect the initial reading (waits for the rest of the conversion)
+bool SHT45HumidityTempSensor::finishBegin() {
     if (!readSensor()) {
         sensor_initialized = false;
         return false;
@@ -47,38 +87,147 @@ bool SHT45HumidityTempSensor::begin() {
 void SHT45HumidityTempSensor::setPrecision(sht4x_precision_t precision) {
     if (sensor_initialized && sht45 != nullptr) {
         sht45->setPrecision(precision);
+        precision_mode = precision;
     }
 }
 
+// Get the precision mode
+sht4x_precision_t SHT45HumidityTempSensor::getPrecision() const {
+    return precision_mode;
+}
+
 // Set the heater mode
 void SHT45HumidityTempSensor::setHeater(sht4x_heater_t duration) {
     if (sensor_initialized && sht45 != nullptr) {
         sht45->setHeater(duration);
+        heater_mode = duration;
     }
 }
 
-// Read temperature and humidity from sensor
+// Read temperature and humidity from sensor (blocking)
 bool SHT45HumidityTempSensor::readSensor() {
     if (!sensor_initialized || sht45 == nullptr) {
         return false;
     }
+    PROFILE_SCOPE(ProfileZone::SENSOR_READ);
+    
+    // Reuse a measurement the loop already started instead of restarting it
+    if (!measurement_pending && !startMeasurement()) {
+        return false;
+    }
+    
+    unsigned long elapsed = micros() - measurement_start;
+    if (elapsed < measurement_duration) {
+        delay((measurement_duration - elapsed + 999) / 1000);
+    }
+    
+    return fetchResult();
+}
+
+// Start a measurement without waiting for the conversion
+bool SHT45HumidityTempSensor::startMeasurement() {
+    if (!sensor_initialized || sht45 == nullptr) {
+        return false;
+    }
+    
+    unsigned long duration_ms = 0;
+    uint8_t command = measurementCommand(duration_ms);
+    if (!send(&command, 1)) {
+        measurement_pending = false;
+        return false;
+    }
+    
+    measurement_pending = true;
+    measurement_start = micros();
+    measurement_duration = duration_ms * 1000UL;
+    return true;
+}
+
+// Check if a measurement is in progress
+bool SHT45HumidityTempSensor::isMeasurementPending() const {
+    return measurement_pending;
+}
+
+// Check if the conversion time has elapsed
+bool SHT45HumidityTempSensor::isMeasurementReady() const {
+    return measurement_pending && (micros() - measurement_start >= measurement_duration);
+}
+
+// Read and convert the 6-byte result: T msb, T lsb, T crc, RH msb, RH lsb, RH crc
+bool SHT45HumidityTempSensor::fetchResult() {
+    if (!isMeasurementReady()) {
+        return false;
+    }
+    measurement_pending = false;
     
-    // Create sensor event structures
-    sensors_event_t humidity_event, temp_event;
+    uint8_t data[6];
+    if (!receive(data, sizeof(data))) {
+        return false;
+    }
     
-    // Read the sensor
-    if (!sht45->getEvent(&humidity_event, &temp_event)) {
+    if (crc8(&data[0], 2) != data[2] || crc8(&data[3], 2) != data[5]) {
         return false;
     }
     
+    uint16_t raw_temp = ((uint16_t)data[0] << 8) | data[1];
+    uint16_t raw_hum = ((uint16_t)data[3] << 8) | data[4];
+    
+    // Conversion formulas from the datasheet
+    float humidity = -6.0f + 125.0f * (float)raw_hum / 65535.0f;
+    if (humidity < 0.0f) humidity = 0.0f;
+    if (humidity > 100.0f) humidity = 100.0f;
+    
     // Update cached values
-    last_temperature = temp_event.temperature;  // Celsius
-    last_humidity = humidity_event.relative_humidity;  // Percent
+    last_temperature = -45.0f + 175.0f * (float)raw_temp / 65535.0f;  // Celsius
+    last_humidity = humidity;  // Percent
     last_read_time = millis();
     
     return true;
 }
 
+// Pick the command byte and conversion time for the current settings
+uint8_t SHT45HumidityTempSensor::measurementCommand(unsigned long& duration_ms) const {
+    switch (heater_mode) {
+        case SHT4X_HIGH_HEATER_1S:    duration_ms = 1100; return SHT4X_CMD_HEATER_HIGH_1S;
+        case SHT4X_HIGH_HEATER_100MS: duration_ms = 110;  return SHT4X_CMD_HEATER_HIGH_100MS;
+        case SHT4X_MED_HEATER_1S:     duration_ms = 1100; return SHT4X_CMD_HEATER_MED_1S;
+        case SHT4X_MED_HEATER_100MS:  duration_ms = 110;  return SHT4X_CMD_HEATER_MED_100MS;
+        case SHT4X_LOW_HEATER_1S:     duration_ms = 1100; return SHT4X_CMD_HEATER_LOW_1S;
+        case SHT4X_LOW_HEATER_100MS:  duration_ms = 110;  return SHT4X_CMD_HEATER_LOW_100MS;
+        default: break;
+    }
+    
+    switch (precision_mode) {
+        case SHT4X_LOW_PRECISION: duration_ms = 2; return SHT4X_CMD_MEASURE_LOW;
+        case SHT4X_MED_PRECISION: duration_ms = 5; return SHT4X_CMD_MEASURE_MED;
+        default:                  duration_ms = 10; return SHT4X_CMD_MEASURE_HIGH;
+    }
+}
+
+// Finish an in-flight measurement so another command can be sent
+void SHT45HumidityTempSensor::finishPendingMeasurement() {
+    if (!measurement_pending) {
+        return;
+    }
+    unsigned long elapsed = micros() - measurement_start;
+    if (elapsed < measurement_duration) {
+        delay((measurement_duration - elapsed + 999) / 1000);
+    }
+    fetchResult();
+}
+
+// CRC-8, polynomial 0x31, init 0xFF
+uint8_t SHT45HumidityTempSensor::crc8(const uint8_t* data, size_t length) {
+    uint8_t crc = 0xFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
 // Get temperature in Celsius
 float SHT45HumidityTempSensor::getTemperature() {
     return last_temperature;
@@ -118,6 +267,8 @@ uint32_t SHT45HumidityTempSensor::getSerialNumber() {
         return 0;
     }
     
+    finishPendingMeasurement();
+    BusGuard guard;
     return sht45->readSerial();
 }
 
@@ -127,7 +278,11 @@ bool SHT45HumidityTempSensor::softReset() {
         return false;
     }
     
-    sht45->reset();
+    finishPendingMeasurement();
+    {
+        BusGuard guard;
+        sht45->reset();
+    }
     
     // Wait for sensor to be ready after reset (spec says max 1ms)
     delay(2);
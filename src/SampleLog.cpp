@@ -0,0 +1,664 @@
+#include "SampleLog.hpp"
+#include <math.h>
+#include <new>
+#include <string.h>
+
+// Block header layout (little endian); the per-channel arrays follow it
+#define SAMPLE_LOG_MAGIC 0x474C5353UL  // "SSLG"
+static const size_t HEADER_MAGIC = 0;
+static const size_t HEADER_SEQUENCE = 4;
+static const size_t HEADER_START = 8;
+static const size_t HEADER_END = 12;
+static const size_t HEADER_COUNT = 16;
+static const size_t HEADER_USED = 18;
+static const size_t HEADER_CRC = 20;
+static const size_t HEADER_CHANNELS = 22;
+static const size_t HEADER_FIRST = 24;  // int16 first value, then min, then max, per channel
+
+// No block stored in a ring slot
+static const uint32_t NO_BLOCK = 0xFFFFFFFFUL;
+
+template <typename T>
+static inline T loadField(const uint8_t* data, size_t offset) {
+    T value;
+    memcpy(&value, data + offset, sizeof(T));
+    return value;
+}
+
+template <typename T>
+static inline void storeField(uint8_t* data, size_t offset, T value) {
+    memcpy(data + offset, &value, sizeof(T));
+}
+
+// Varints: 7 bits per byte, low bits first
+static size_t putVarint(uint8_t* out, uint32_t value) {
+    size_t length = 0;
+    while (value >= 0x80) {
+        out[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = (uint8_t)value;
+    return length;
+}
+
+static bool getVarint(const uint8_t* data, size_t& pos, size_t end, uint32_t& value) {
+    value = 0;
+    for (uint8_t shift = 0; shift < 35; shift += 7) {
+        if (pos >= end) {
+            return false;
+        }
+        uint8_t byte = data[pos++];
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline uint32_t zigzag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static inline int32_t unzigzag(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+// Walks the samples of one block in order: the first comes from the
+// header, every later one is a record of deltas
+class SampleBlockReader {
+private:
+    const uint8_t* data;
+    uint8_t channels;
+    size_t pos;
+    size_t end;
+    uint16_t remaining;
+    bool started;
+
+public:
+    uint32_t time_s;
+    int16_t values[SAMPLE_LOG_MAX_CHANNELS];
+
+    SampleBlockReader(const uint8_t* block, uint8_t channel_count)
+        : data(block), channels(channel_count), pos(HEADER_FIRST + 6 * channel_count), started(false) {
+        end = pos + loadField<uint16_t>(data, HEADER_USED);
+        remaining = loadField<uint16_t>(data, HEADER_COUNT);
+        time_s = 0;
+    }
+
+    bool next() {
+        if (remaining == 0) {
+            return false;
+        }
+        if (!started) {
+            started = true;
+            time_s = loadField<uint32_t>(data, HEADER_START);
+            for (uint8_t ch = 0; ch < channels; ch++) {
+                values[ch] = loadField<int16_t>(data, HEADER_FIRST + 2 * ch);
+            }
+            remaining--;
+            return true;
+        }
+
+        uint32_t delta;
+        if (!getVarint(data, pos, end, delta)) {
+            return false;
+        }
+        time_s += delta;
+        for (uint8_t ch = 0; ch < channels; ch++) {
+            if (!getVarint(data, pos, end, delta)) {
+                return false;
+            }
+            values[ch] = (int16_t)(values[ch] + unzigzag(delta));
+        }
+        remaining--;
+        return true;
+    }
+};
+
+// Constructor
+SampleLog::SampleLog(uint8_t channels, uint16_t blocks)
+    : channel_count(channels), block_capacity(blocks > 0 ? blocks : 1),
+      commit_interval_s(SAMPLE_LOG_COMMIT_INTERVAL), fs(nullptr), path(SAMPLE_LOG_PATH), opened(false),
+      index(nullptr), newest_sequence(0), stored_blocks(0), block_used(0), block_count(0),
+      last_time_s(0), block_dirty(false), last_commit_ms(0), clock_offset_s(0),
+      total_samples(0), commit_count(0) {
+    if (channel_count > SAMPLE_LOG_MAX_CHANNELS) {
+        channel_count = SAMPLE_LOG_MAX_CHANNELS;
+    }
+    for (uint8_t ch = 0; ch < SAMPLE_LOG_MAX_CHANNELS; ch++) {
+        resolution[ch] = SAMPLE_LOG_RESOLUTION;
+        last_value[ch] = 0;
+    }
+    memset(block, 0, sizeof(block));
+}
+
+// Destructor
+SampleLog::~SampleLog() {
+    end();
+}
+
+// Configuration
+void SampleLog::setResolution(uint8_t channel, float step) {
+    if (channel < channel_count && step > 0.0f) {
+        resolution[channel] = step;
+    }
+}
+
+float SampleLog::getResolution(uint8_t channel) const {
+    return channel < channel_count ? resolution[channel] : 0.0f;
+}
+
+void SampleLog::setCommitInterval(uint32_t interval_s) {
+    commit_interval_s = interval_s;
+}
+
+// Open the file and rebuild the index
+bool SampleLog::begin(fs::FS& filesystem, const char* file_path) {
+    if (opened) {
+        return true;
+    }
+    fs = &filesystem;
+    path = file_path;
+
+    if (!fs->exists(path)) {
+        fs::File created = fs->open(path, "w");
+        if (!created) {
+            return false;
+        }
+        created.close();
+    }
+    file = fs->open(path, "r+");
+    if (!file) {
+        return false;
+    }
+
+    index = new (std::nothrow) BlockSpan[block_capacity];
+    if (index == nullptr) {
+        file.close();
+        return false;
+    }
+
+    // Only the header of each slot: the payloads are CRC-checked when a
+    // query reads them. The open block doubles as the read buffer.
+    size_t slots = file.size() / SAMPLE_LOG_BLOCK_SIZE;
+    if (slots > block_capacity) {
+        slots = block_capacity;
+    }
+    bool found = false;
+    uint32_t newest = 0;
+    for (uint16_t slot = 0; slot < block_capacity; slot++) {
+        uint32_t sequence = NO_BLOCK;
+        index[slot].sequence = NO_BLOCK;
+        if (slot < slots && readBlock(slot, block, headerSize()) && validHeader(block, sequence) &&
+            sequence % block_capacity == slot) {
+            index[slot].sequence = sequence;
+            index[slot].start_s = loadField<uint32_t>(block, HEADER_START);
+            index[slot].end_s = loadField<uint32_t>(block, HEADER_END);
+            if (!found || sequence > newest) {
+                newest = sequence;
+                found = true;
+            }
+        }
+    }
+
+    // The newest block is read whole; a write cut short by a reset can leave
+    // a good header over a torn payload, in which case the block before it
+    // becomes the newest
+    uint32_t sequence = NO_BLOCK;
+    while (found && !(readBlock(newest % block_capacity, block) && validBlock(block, sequence) &&
+                      sequence == newest)) {
+        index[newest % block_capacity].sequence = NO_BLOCK;
+        found = newest > 0 && index[(newest - 1) % block_capacity].sequence == newest - 1;
+        newest--;
+    }
+
+    // Only the unbroken run of sequences ending at the newest block counts
+    stored_blocks = 0;
+    if (found) {
+        while (stored_blocks < block_capacity && stored_blocks <= newest &&
+               index[(newest - stored_blocks) % block_capacity].sequence == newest - stored_blocks) {
+            stored_blocks++;
+        }
+
+        // Keep appending to the newest block where it left off
+        newest_sequence = newest;
+        block_used = loadField<uint16_t>(block, HEADER_USED);
+        block_count = loadField<uint16_t>(block, HEADER_COUNT);
+        SampleBlockReader reader(block, channel_count);
+        while (reader.next()) {
+            last_time_s = reader.time_s;
+            memcpy(last_value, reader.values, sizeof(last_value));
+        }
+    } else {
+        startBlock(0);
+        last_time_s = 0;
+    }
+    block_dirty = false;
+
+    opened = true;
+    last_commit_ms = millis();
+    total_samples = 0;
+    commit_count = 0;
+    clock_offset_s = (stored_blocks > 0 ? last_time_s + 1 : 0) - (uint32_t)(millis() / 1000);
+    return true;
+}
+
+void SampleLog::end() {
+    if (!opened) {
+        return;
+    }
+    commit();
+    file.close();
+    delete[] index;
+    index = nullptr;
+    opened = false;
+}
+
+bool SampleLog::isOpen() const {
+    return opened;
+}
+
+// Appending
+bool SampleLog::append(const float* values) {
+    return append(values, now());
+}
+
+bool SampleLog::append(const float* values, uint32_t time_s) {
+    if (!opened || values == nullptr) {
+        return false;
+    }
+
+    int16_t quantized[SAMPLE_LOG_MAX_CHANNELS];
+    for (uint8_t ch = 0; ch < channel_count; ch++) {
+        quantized[ch] = quantize(ch, values[ch]);
+    }
+    if (stored_blocks > 0 && time_s < last_time_s) {
+        time_s = last_time_s;
+    }
+
+    if (!encodeSample(time_s, quantized)) {
+        // Block full: seal it and start the next ring slot
+        if (!writeBlock()) {
+            return false;
+        }
+        startBlock(newest_sequence + 1);
+        encodeSample(time_s, quantized);
+    }
+    total_samples++;
+
+    if (millis() - last_commit_ms >= commit_interval_s * 1000UL) {
+        commit();
+    }
+    return true;
+}
+
+bool SampleLog::commit() {
+    if (!opened) {
+        return false;
+    }
+    return !block_dirty || writeBlock();
+}
+
+// Clock
+uint32_t SampleLog::now() const {
+    return clock_offset_s + (uint32_t)(millis() / 1000);
+}
+
+void SampleLog::setClock(uint32_t now_s) {
+    clock_offset_s = now_s - (uint32_t)(millis() / 1000);
+}
+
+// Range queries
+size_t SampleLog::query(uint32_t from_s, uint32_t to_s, SampleLogVisitor visitor, void* context) {
+    if (!opened || visitor == nullptr || from_s > to_s) {
+        return 0;
+    }
+
+    uint8_t scratch[SAMPLE_LOG_BLOCK_SIZE];
+    uint32_t sequence = NO_BLOCK;
+    size_t visited = 0;
+    for (uint16_t position = findFirstBlock(from_s); position < stored_blocks; position++) {
+        uint16_t slot = slotAt(position);
+        if (index[slot].start_s > to_s) {
+            break;
+        }
+        if (position == stored_blocks - 1) {
+            visited += decodeBlock(block, from_s, to_s, visitor, context);
+        } else if (readBlock(slot, scratch) && validBlock(scratch, sequence) && sequence == index[slot].sequence) {
+            visited += decodeBlock(scratch, from_s, to_s, visitor, context);
+        }
+    }
+    return visited;
+}
+
+bool SampleLog::getExtrema(uint32_t from_s, uint32_t to_s, uint8_t channel, float& min_value, float& max_value) {
+    if (!opened || channel >= channel_count || from_s > to_s) {
+        return false;
+    }
+
+    uint8_t scratch[SAMPLE_LOG_BLOCK_SIZE];
+    bool found = false;
+    int16_t low = 0, high = 0;
+    for (uint16_t position = findFirstBlock(from_s); position < stored_blocks; position++) {
+        uint16_t slot = slotAt(position);
+        const BlockSpan& span = index[slot];
+        if (span.start_s > to_s) {
+            break;
+        }
+        bool inside = span.start_s >= from_s && span.end_s <= to_s;
+
+        // Inner blocks only need their header; edge blocks are decoded, so
+        // their payload is checked too
+        const uint8_t* data = scratch;
+        uint32_t sequence = NO_BLOCK;
+        if (position == stored_blocks - 1) {
+            data = block;
+        } else {
+            bool read = inside ? readBlock(slot, scratch, headerSize()) && validHeader(scratch, sequence)
+                               : readBlock(slot, scratch) && validBlock(scratch, sequence);
+            if (!read || sequence != span.sequence) {
+                continue;
+            }
+        }
+
+        if (inside) {
+            int16_t block_min = loadField<int16_t>(data, HEADER_FIRST + 2 * (channel_count + channel));
+            int16_t block_max = loadField<int16_t>(data, HEADER_FIRST + 2 * (2 * channel_count + channel));
+            low = found ? min(low, block_min) : block_min;
+            high = found ? max(high, block_max) : block_max;
+            found = true;
+            continue;
+        }
+        SampleBlockReader reader(data, channel_count);
+        while (reader.next() && reader.time_s <= to_s) {
+            if (reader.time_s >= from_s) {
+                int16_t value = reader.values[channel];
+                low = found ? min(low, value) : value;
+                high = found ? max(high, value) : value;
+                found = true;
+            }
+        }
+    }
+
+    if (found) {
+        min_value = low * resolution[channel];
+        max_value = high * resolution[channel];
+    }
+    return found;
+}
+
+// Bucket means of one channel, fed by query()
+struct PlotLoader {
+    DataPlot* plot;
+    uint8_t channel;
+    uint32_t from_s;
+    uint32_t to_s;
+    uint32_t bucket_s;
+    uint32_t bucket;
+    float sum;
+    uint16_t count;
+    int added;
+
+    void emit() {
+        if (count == 0) {
+            return;
+        }
+        float mean = sum / count;
+        if (plot->hasImplicitX()) {
+            plot->addValue(mean);
+        } else {
+            // X is seconds relative to the newest sample
+            uint32_t middle = from_s + bucket * bucket_s + bucket_s / 2;
+            plot->addPoint(-(float)(to_s - min(middle, to_s)), mean);
+        }
+        added++;
+        sum = 0.0f;
+        count = 0;
+    }
+
+    static void visit(uint32_t time_s, const float* values, void* context) {
+        PlotLoader* loader = static_cast<PlotLoader*>(context);
+        uint32_t bucket = (time_s - loader->from_s) / loader->bucket_s;
+        if (bucket != loader->bucket) {
+            loader->emit();
+            loader->bucket = bucket;
+        }
+        loader->sum += values[loader->channel];
+        loader->count++;
+    }
+};
+
+int SampleLog::loadPlot(DataPlot* plot, uint8_t channel, uint32_t window_s) {
+    if (plot == nullptr || channel >= channel_count || !opened || stored_blocks == 0 || window_s == 0) {
+        return 0;
+    }
+
+    int capacity = plot->getDataCapacity();
+    if (capacity <= 0) {
+        return 0;
+    }
+    PlotLoader loader;
+    loader.plot = plot;
+    loader.channel = channel;
+    loader.to_s = last_time_s;
+    loader.from_s = last_time_s >= window_s - 1 ? last_time_s - (window_s - 1) : 0;
+    loader.bucket_s = (window_s + capacity - 1) / capacity;
+    loader.bucket = 0;
+    loader.sum = 0.0f;
+    loader.count = 0;
+    loader.added = 0;
+
+    plot->clearData();
+    query(loader.from_s, loader.to_s, PlotLoader::visit, &loader);
+    loader.emit();
+    return loader.added;
+}
+
+// Statistics
+uint8_t SampleLog::getChannelCount() const {
+    return channel_count;
+}
+
+uint16_t SampleLog::getBlockCapacity() const {
+    return block_capacity;
+}
+
+uint16_t SampleLog::getStoredBlocks() const {
+    return stored_blocks;
+}
+
+uint32_t SampleLog::getSampleCount() const {
+    return total_samples;
+}
+
+uint32_t SampleLog::getCommitCount() const {
+    return commit_count;
+}
+
+bool SampleLog::getTimeSpan(uint32_t& oldest_s, uint32_t& newest_s) const {
+    if (!opened || stored_blocks == 0) {
+        return false;
+    }
+    oldest_s = index[slotAt(0)].start_s;
+    newest_s = last_time_s;
+    return true;
+}
+
+// Block helpers
+uint16_t SampleLog::checksum(const uint8_t* data, size_t length) {
+    // CRC-16/CCITT-FALSE
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+uint16_t SampleLog::headerSize() const {
+    return HEADER_FIRST + 6 * channel_count;
+}
+
+void SampleLog::startBlock(uint32_t sequence) {
+    memset(block, 0, sizeof(block));
+    storeField<uint32_t>(block, HEADER_MAGIC, SAMPLE_LOG_MAGIC);
+    storeField<uint32_t>(block, HEADER_SEQUENCE, sequence);
+    block[HEADER_CHANNELS] = channel_count;
+    newest_sequence = sequence;
+    block_used = 0;
+    block_count = 0;
+}
+
+// Seal the open block with its CRC and write it to its ring slot
+bool SampleLog::writeBlock() {
+    storeField<uint16_t>(block, HEADER_CRC, 0);
+    storeField<uint16_t>(block, HEADER_CRC, checksum(block, headerSize() + block_used));
+
+    uint32_t offset = (newest_sequence % block_capacity) * (uint32_t)SAMPLE_LOG_BLOCK_SIZE;
+    if (!file.seek(offset) || file.write(block, SAMPLE_LOG_BLOCK_SIZE) != SAMPLE_LOG_BLOCK_SIZE) {
+        return false;
+    }
+    file.flush();
+    block_dirty = false;
+    last_commit_ms = millis();
+    commit_count++;
+    return true;
+}
+
+bool SampleLog::readBlock(uint16_t slot, uint8_t* out, size_t length) {
+    return file.seek((uint32_t)slot * SAMPLE_LOG_BLOCK_SIZE) && file.read(out, length) == length;
+}
+
+// Header fields only; enough to index the block
+bool SampleLog::validHeader(const uint8_t* data, uint32_t& sequence) const {
+    if (loadField<uint32_t>(data, HEADER_MAGIC) != SAMPLE_LOG_MAGIC || data[HEADER_CHANNELS] != channel_count ||
+        loadField<uint16_t>(data, HEADER_COUNT) == 0 ||
+        loadField<uint16_t>(data, HEADER_USED) > SAMPLE_LOG_BLOCK_SIZE - headerSize() ||
+        loadField<uint32_t>(data, HEADER_END) < loadField<uint32_t>(data, HEADER_START)) {
+        return false;
+    }
+    sequence = loadField<uint32_t>(data, HEADER_SEQUENCE);
+    return true;
+}
+
+// Header and CRC of a whole block
+bool SampleLog::validBlock(const uint8_t* data, uint32_t& sequence) const {
+    if (!validHeader(data, sequence)) {
+        return false;
+    }
+
+    uint16_t used = loadField<uint16_t>(data, HEADER_USED);
+    uint8_t copy[SAMPLE_LOG_BLOCK_SIZE];
+    size_t length = headerSize() + used;
+    memcpy(copy, data, length);
+    storeField<uint16_t>(copy, HEADER_CRC, 0);
+    return checksum(copy, length) == loadField<uint16_t>(data, HEADER_CRC);
+}
+
+// Add one sample to the open block; false if the block has no room for it
+bool SampleLog::encodeSample(uint32_t time_s, const int16_t* values) {
+    uint16_t slot = newest_sequence % block_capacity;
+    size_t min_offset = HEADER_FIRST + 2 * channel_count;
+    size_t max_offset = HEADER_FIRST + 4 * channel_count;
+
+    if (block_count == 0) {
+        // The first sample lives in the header
+        storeField<uint32_t>(block, HEADER_START, time_s);
+        for (uint8_t ch = 0; ch < channel_count; ch++) {
+            storeField<int16_t>(block, HEADER_FIRST + 2 * ch, values[ch]);
+            storeField<int16_t>(block, min_offset + 2 * ch, values[ch]);
+            storeField<int16_t>(block, max_offset + 2 * ch, values[ch]);
+        }
+        if (stored_blocks < block_capacity) {
+            stored_blocks++;
+        }
+        index[slot].sequence = newest_sequence;
+        index[slot].start_s = time_s;
+    } else {
+        uint8_t record[5 + 3 * SAMPLE_LOG_MAX_CHANNELS];
+        size_t length = putVarint(record, time_s - last_time_s);
+        for (uint8_t ch = 0; ch < channel_count; ch++) {
+            length += putVarint(&record[length], zigzag((int32_t)values[ch] - last_value[ch]));
+        }
+        size_t offset = headerSize() + block_used;
+        if (offset + length > SAMPLE_LOG_BLOCK_SIZE || block_count == 0xFFFF) {
+            return false;
+        }
+        memcpy(&block[offset], record, length);
+        block_used += length;
+
+        for (uint8_t ch = 0; ch < channel_count; ch++) {
+            if (values[ch] < loadField<int16_t>(block, min_offset + 2 * ch)) {
+                storeField<int16_t>(block, min_offset + 2 * ch, values[ch]);
+            }
+            if (values[ch] > loadField<int16_t>(block, max_offset + 2 * ch)) {
+                storeField<int16_t>(block, max_offset + 2 * ch, values[ch]);
+            }
+        }
+    }
+
+    block_count++;
+    storeField<uint32_t>(block, HEADER_END, time_s);
+    storeField<uint16_t>(block, HEADER_COUNT, block_count);
+    storeField<uint16_t>(block, HEADER_USED, block_used);
+    index[slot].end_s = time_s;
+    last_time_s = time_s;
+    memcpy(last_value, values, channel_count * sizeof(int16_t));
+    block_dirty = true;
+    return true;
+}
+
+// Ring order helpers
+uint16_t SampleLog::slotAt(uint16_t position) const {
+    uint32_t oldest = newest_sequence - (stored_blocks - 1);
+    return (oldest + position) % block_capacity;
+}
+
+// First stored block (in ring order) that ends at or after from_s
+uint16_t SampleLog::findFirstBlock(uint32_t from_s) const {
+    uint16_t low = 0, high = stored_blocks;
+    while (low < high) {
+        uint16_t middle = low + (high - low) / 2;
+        if (index[slotAt(middle)].end_s < from_s) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+size_t SampleLog::decodeBlock(const uint8_t* data, uint32_t from_s, uint32_t to_s,
+                              SampleLogVisitor visitor, void* context) {
+    size_t visited = 0;
+    float values[SAMPLE_LOG_MAX_CHANNELS];
+    SampleBlockReader reader(data, channel_count);
+    while (reader.next() && reader.time_s <= to_s) {
+        if (reader.time_s < from_s) {
+            continue;
+        }
+        for (uint8_t ch = 0; ch < channel_count; ch++) {
+            values[ch] = reader.values[ch] * resolution[ch];
+        }
+        visitor(reader.time_s, values, context);
+        visited++;
+    }
+    return visited;
+}
+
+int16_t SampleLog::quantize(uint8_t channel, float value) const {
+    if (isnan(value)) {
+        return last_value[channel];
+    }
+    float steps = roundf(value / resolution[channel]);
+    if (steps > 32767.0f) {
+        return 32767;
+    }
+    if (steps < -32768.0f) {
+        return -32768;
+    }
+    return (int16_t)steps;
+}
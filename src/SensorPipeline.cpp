@@ -0,0 +1,399 @@
+#include "SensorPipeline.hpp"
+
+#define SENSOR_PIPELINE_RING_MASK (SENSOR_PIPELINE_RING_SIZE - 1)
+
+// Default tier bucket lengths
+static const uint32_t DEFAULT_TIER_INTERVALS[SENSOR_TIER_COUNT] = {1000UL, 60000UL, 3600000UL};
+
+// Constructor
+SensorPipeline::SensorPipeline(uint8_t channels, SampleSource source, void* context)
+    : channel_count(channels), source(source), source_context(context),
+      sample_period_ms(0), last_sample_ms(0), started(false), policy(nullptr),
+      ring_head(0), ring_tail(0), dropped_samples(0), failed_samples(0),
+      has_latest(false) {
+    if (channel_count > SENSOR_PIPELINE_MAX_CHANNELS) {
+        channel_count = SENSOR_PIPELINE_MAX_CHANNELS;
+    }
+
+    for (uint8_t ch = 0; ch < SENSOR_PIPELINE_MAX_CHANNELS; ch++) {
+        stage_count[ch] = 0;
+        latest_raw.values[ch] = NAN;
+        latest_filtered.values[ch] = NAN;
+    }
+    latest_raw.timestamp_ms = 0;
+    latest_filtered.timestamp_ms = 0;
+
+    for (uint8_t t = 0; t < SENSOR_TIER_COUNT; t++) {
+        TierState& tier = tiers[t];
+        tier.interval_ms = DEFAULT_TIER_INTERVALS[t];
+        tier.bucket_start = 0;
+        tier.bucket_open = false;
+        tier.count = 0;
+        tier.has_value = false;
+        tier.updated = false;
+        for (uint8_t ch = 0; ch < SENSOR_PIPELINE_MAX_CHANNELS; ch++) {
+            tier.sum[ch] = 0.0f;
+            tier.last_mean[ch] = NAN;
+            tier.plot_count[ch] = 0;
+        }
+    }
+
+#if SENSOR_PIPELINE_RTOS
+    task_handle = nullptr;
+    source_mutex = xSemaphoreCreateRecursiveMutex();
+#endif
+}
+
+// Destructor
+SensorPipeline::~SensorPipeline() {
+#if SENSOR_PIPELINE_RTOS
+    if (task_handle != nullptr) {
+        vTaskDelete(task_handle);
+    }
+    if (source_mutex != nullptr) {
+        vSemaphoreDelete(source_mutex);
+    }
+#endif
+}
+
+// Start periodic sampling
+bool SensorPipeline::begin(uint32_t period_ms, bool use_task, int core, uint32_t stack_size,
+                           uint8_t task_priority) {
+    if (period_ms == 0 || source == nullptr) {
+        return false;
+    }
+    sample_period_ms = period_ms;
+    last_sample_ms = millis() - period_ms;  // First run() samples immediately
+    started = true;
+
+#if SENSOR_PIPELINE_RTOS
+    if (use_task && task_handle == nullptr) {
+        BaseType_t created = xTaskCreatePinnedToCore(taskEntry, "sensor_pipe", stack_size, this,
+                                                     task_priority, &task_handle, core);
+        if (created != pdPASS) {
+            task_handle = nullptr;  // run() keeps sampling from loop()
+        }
+    }
+#else
+    (void)use_task;
+    (void)core;
+    (void)stack_size;
+    (void)task_priority;
+#endif
+    return true;
+}
+
+bool SensorPipeline::isTaskRunning() const {
+#if SENSOR_PIPELINE_RTOS
+    return task_handle != nullptr;
+#else
+    return false;
+#endif
+}
+
+#if SENSOR_PIPELINE_RTOS
+// Sampler task: fixed-rate reads independent of loop() timing
+void SensorPipeline::taskEntry(void* param) {
+    SensorPipeline* pipeline = static_cast<SensorPipeline*>(param);
+    TickType_t wake = xTaskGetTickCount();
+    for (;;) {
+        pipeline->sample();
+        TickType_t period = pdMS_TO_TICKS(pipeline->getSamplePeriod());
+        vTaskDelayUntil(&wake, period > 0 ? period : 1);
+    }
+}
+#endif
+
+// Read the source and queue the result
+bool SensorPipeline::sample() {
+    if (source == nullptr) {
+        return false;
+    }
+
+    float values[SENSOR_PIPELINE_MAX_CHANNELS];
+#if SENSOR_PIPELINE_RTOS
+    if (source_mutex != nullptr) {
+        xSemaphoreTakeRecursive(source_mutex, portMAX_DELAY);
+    }
+#endif
+    bool ok = source(values, source_context);
+    uint32_t timestamp = millis();
+    last_sample_ms = timestamp;
+#if SENSOR_PIPELINE_RTOS
+    if (source_mutex != nullptr) {
+        xSemaphoreGiveRecursive(source_mutex);
+    }
+#endif
+
+    if (!ok) {
+        failed_samples.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return pushSample(values, timestamp);
+}
+
+// Producer half of the SPSC ring
+bool SensorPipeline::pushSample(const float* values, uint32_t timestamp_ms) {
+    uint16_t head = ring_head.load(std::memory_order_relaxed);
+    uint16_t tail = ring_tail.load(std::memory_order_acquire);
+    if ((uint16_t)(head - tail) >= SENSOR_PIPELINE_RING_SIZE) {
+        dropped_samples.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    SensorSample& slot = ring[head & SENSOR_PIPELINE_RING_MASK];
+    slot.timestamp_ms = timestamp_ms;
+    for (uint8_t ch = 0; ch < channel_count; ch++) {
+        slot.values[ch] = values[ch];
+    }
+    ring_head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+// Consumer half of the SPSC ring
+size_t SensorPipeline::process() {
+    uint16_t tail = ring_tail.load(std::memory_order_relaxed);
+    uint16_t head = ring_head.load(std::memory_order_acquire);
+    size_t processed = 0;
+
+    while (tail != head) {
+        processSample(ring[tail & SENSOR_PIPELINE_RING_MASK]);
+        tail++;
+        ring_tail.store(tail, std::memory_order_release);  // Free the slot right away
+        processed++;
+    }
+    return processed;
+}
+
+// Poll-mode sampling plus processing
+size_t SensorPipeline::run() {
+    if (started && !isTaskRunning() && getTimeUntilNextSample() == 0) {
+        sample();
+    }
+    return process();
+}
+
+// Adaptive scheduling
+void SensorPipeline::setAdaptivePolicy(AdaptiveSamplingPolicy* policy) {
+    this->policy = policy;
+}
+
+AdaptiveSamplingPolicy* SensorPipeline::getAdaptivePolicy() const {
+    return policy;
+}
+
+uint32_t SensorPipeline::getSamplePeriod() const {
+    return policy != nullptr ? policy->getPeriod() : sample_period_ms;
+}
+
+uint32_t SensorPipeline::getTimeUntilNextSample() const {
+    uint32_t elapsed = millis() - last_sample_ms.load();
+    uint32_t period = getSamplePeriod();
+    return elapsed >= period ? 0 : period - elapsed;
+}
+
+// Light sleep between samples
+bool SensorPipeline::sleepUntilNextSample(uint32_t min_sleep_ms) {
+#if SENSOR_PIPELINE_RTOS
+    uint32_t remaining = getTimeUntilNextSample();
+    if (!started || remaining < min_sleep_ms || getQueuedCount() > 0) {
+        return false;
+    }
+    esp_sleep_enable_timer_wakeup((uint64_t)remaining * 1000ULL);
+    return esp_light_sleep_start() == ESP_OK;
+#else
+    (void)min_sleep_ms;
+    return false;
+#endif
+}
+
+// Source access control
+void SensorPipeline::suspendSampling() {
+#if SENSOR_PIPELINE_RTOS
+    if (source_mutex != nullptr) {
+        xSemaphoreTakeRecursive(source_mutex, portMAX_DELAY);
+    }
+#endif
+}
+
+void SensorPipeline::resumeSampling() {
+#if SENSOR_PIPELINE_RTOS
+    if (source_mutex != nullptr) {
+        xSemaphoreGiveRecursive(source_mutex);
+    }
+#endif
+}
+
+// Run the stage chains and feed the tiers
+void SensorPipeline::processSample(const SensorSample& sample) {
+    latest_raw = sample;
+    latest_filtered.timestamp_ms = sample.timestamp_ms;
+
+    for (uint8_t ch = 0; ch < channel_count; ch++) {
+        float value = sample.values[ch];
+        for (uint8_t s = 0; s < stage_count[ch]; s++) {
+            value = stages[ch][s]->apply(value, sample.timestamp_ms);
+        }
+        latest_filtered.values[ch] = value;
+    }
+    has_latest = true;
+
+    if (policy != nullptr) {
+        policy->observe(latest_filtered.values, channel_count, sample.timestamp_ms);
+    }
+
+    for (uint8_t t = 0; t < SENSOR_TIER_COUNT; t++) {
+        foldIntoTier(tiers[t], latest_filtered);
+    }
+}
+
+// Close the bucket when the sample falls past its end, then accumulate
+void SensorPipeline::foldIntoTier(TierState& tier, const SensorSample& filtered) {
+    uint32_t t = filtered.timestamp_ms;
+
+    if (!tier.bucket_open) {
+        tier.bucket_start = t - (t % tier.interval_ms);
+        tier.bucket_open = true;
+    } else if (t - tier.bucket_start >= tier.interval_ms) {
+        if (tier.count > 0) {
+            for (uint8_t ch = 0; ch < channel_count; ch++) {
+                float mean = tier.sum[ch] / tier.count;
+                tier.last_mean[ch] = mean;
+                for (uint8_t p = 0; p < tier.plot_count[ch]; p++) {
+                    tier.plots[ch][p]->addValue(mean);
+                }
+            }
+            tier.has_value = true;
+            tier.updated = true;
+        }
+
+        // Skip whole empty buckets after a gap
+        tier.bucket_start += ((t - tier.bucket_start) / tier.interval_ms) * tier.interval_ms;
+        tier.count = 0;
+        for (uint8_t ch = 0; ch < channel_count; ch++) {
+            tier.sum[ch] = 0.0f;
+        }
+    }
+
+    for (uint8_t ch = 0; ch < channel_count; ch++) {
+        tier.sum[ch] += filtered.values[ch];
+    }
+    tier.count++;
+}
+
+// Stage management
+bool SensorPipeline::addStage(uint8_t channel, FilterStage* stage) {
+    if (channel >= channel_count || stage == nullptr ||
+        stage_count[channel] >= SENSOR_PIPELINE_MAX_STAGES) {
+        return false;
+    }
+    stages[channel][stage_count[channel]++] = stage;
+    return true;
+}
+
+void SensorPipeline::clearStages(uint8_t channel) {
+    if (channel < channel_count) {
+        stage_count[channel] = 0;
+    }
+}
+
+void SensorPipeline::resetStages() {
+    for (uint8_t ch = 0; ch < channel_count; ch++) {
+        for (uint8_t s = 0; s < stage_count[ch]; s++) {
+            stages[ch][s]->reset();
+        }
+    }
+}
+
+// Tier management
+bool SensorPipeline::bindPlot(uint8_t channel, SensorTier tier, DataPlot* plot) {
+    uint8_t t = static_cast<uint8_t>(tier);
+    if (channel >= channel_count || t >= SENSOR_TIER_COUNT || plot == nullptr ||
+        tiers[t].plot_count[channel] >= SENSOR_PIPELINE_MAX_BINDINGS) {
+        return false;
+    }
+    tiers[t].plots[channel][tiers[t].plot_count[channel]++] = plot;
+    return true;
+}
+
+void SensorPipeline::unbindPlots(SensorTier tier) {
+    uint8_t t = static_cast<uint8_t>(tier);
+    if (t >= SENSOR_TIER_COUNT) {
+        return;
+    }
+    for (uint8_t ch = 0; ch < SENSOR_PIPELINE_MAX_CHANNELS; ch++) {
+        tiers[t].plot_count[ch] = 0;
+    }
+}
+
+void SensorPipeline::setTierInterval(SensorTier tier, uint32_t interval_ms) {
+    uint8_t t = static_cast<uint8_t>(tier);
+    if (t >= SENSOR_TIER_COUNT || interval_ms == 0) {
+        return;
+    }
+    tiers[t].interval_ms = interval_ms;
+    tiers[t].bucket_open = false;  // Restart bucketing on the new boundaries
+    tiers[t].count = 0;
+    for (uint8_t ch = 0; ch < SENSOR_PIPELINE_MAX_CHANNELS; ch++) {
+        tiers[t].sum[ch] = 0.0f;
+    }
+}
+
+uint32_t SensorPipeline::getTierInterval(SensorTier tier) const {
+    uint8_t t = static_cast<uint8_t>(tier);
+    return t < SENSOR_TIER_COUNT ? tiers[t].interval_ms : 0;
+}
+
+bool SensorPipeline::getTierValue(uint8_t channel, SensorTier tier, float& value) const {
+    uint8_t t = static_cast<uint8_t>(tier);
+    if (channel >= channel_count || t >= SENSOR_TIER_COUNT || !tiers[t].has_value) {
+        return false;
+    }
+    value = tiers[t].last_mean[channel];
+    return true;
+}
+
+bool SensorPipeline::takeTierUpdate(SensorTier tier) {
+    uint8_t t = static_cast<uint8_t>(tier);
+    if (t >= SENSOR_TIER_COUNT || !tiers[t].updated) {
+        return false;
+    }
+    tiers[t].updated = false;
+    return true;
+}
+
+// Latest values
+bool SensorPipeline::hasData() const {
+    return has_latest;
+}
+
+float SensorPipeline::getLatest(uint8_t channel) const {
+    return channel < channel_count ? latest_filtered.values[channel] : NAN;
+}
+
+float SensorPipeline::getLatestRaw(uint8_t channel) const {
+    return channel < channel_count ? latest_raw.values[channel] : NAN;
+}
+
+uint32_t SensorPipeline::getLatestTimestamp() const {
+    return latest_filtered.timestamp_ms;
+}
+
+// Statistics
+uint8_t SensorPipeline::getChannelCount() const {
+    return channel_count;
+}
+
+size_t SensorPipeline::getQueuedCount() const {
+    uint16_t head = ring_head.load(std::memory_order_acquire);
+    uint16_t tail = ring_tail.load(std::memory_order_acquire);
+    return (uint16_t)(head - tail);
+}
+
+uint32_t SensorPipeline::getDroppedCount() const {
+    return dropped_samples.load(std::memory_order_relaxed);
+}
+
+uint32_t SensorPipeline::getFailedCount() const {
+    return failed_samples.load(std::memory_order_relaxed);
+}
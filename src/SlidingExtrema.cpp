@@ -0,0 +1,79 @@
+#include "SlidingExtrema.hpp"
+#include "AssetBuffer.hpp"
+
+// Constructor
+SlidingExtrema::SlidingExtrema(const float* values, int capacity)
+    : values(values), capacity(capacity), minQueue(nullptr), maxQueue(nullptr),
+      minHead(0), minCount(0), maxHead(0), maxCount(0) {
+    if (capacity < 0 || capacity > SLIDING_EXTREMA_MAX_CAPACITY) {
+        this->capacity = 0;
+    }
+    if (this->capacity > 0) {
+        minQueue = assetBufferNew<uint16_t>(this->capacity);
+        maxQueue = assetBufferNew<uint16_t>(this->capacity);
+        if (minQueue == nullptr || maxQueue == nullptr) {
+            this->capacity = 0;
+        }
+    }
+}
+
+// Destructor
+SlidingExtrema::~SlidingExtrema() {
+    assetBufferFree(minQueue);
+    assetBufferFree(maxQueue);
+}
+
+void SlidingExtrema::clear() {
+    minHead = 0;
+    minCount = 0;
+    maxHead = 0;
+    maxCount = 0;
+}
+
+// Drop queued slots the new value dominates, then append it
+void SlidingExtrema::push(int slot) {
+    if (capacity == 0) {
+        return;
+    }
+    float v = values[slot];
+    
+    while (minCount > 0) {
+        int back = (minHead + minCount - 1) % capacity;
+        if (values[minQueue[back]] < v) break;
+        minCount--;
+    }
+    minQueue[(minHead + minCount) % capacity] = (uint16_t)slot;
+    minCount++;
+    
+    while (maxCount > 0) {
+        int back = (maxHead + maxCount - 1) % capacity;
+        if (values[maxQueue[back]] > v) break;
+        maxCount--;
+    }
+    maxQueue[(maxHead + maxCount) % capacity] = (uint16_t)slot;
+    maxCount++;
+}
+
+// The oldest value is only queued if nothing newer has dominated it
+void SlidingExtrema::evict(int slot) {
+    if (minCount > 0 && minQueue[minHead] == slot) {
+        minHead = (minHead + 1) % capacity;
+        minCount--;
+    }
+    if (maxCount > 0 && maxQueue[maxHead] == slot) {
+        maxHead = (maxHead + 1) % capacity;
+        maxCount--;
+    }
+}
+
+bool SlidingExtrema::isEmpty() const {
+    return minCount == 0;
+}
+
+float SlidingExtrema::getMin() const {
+    return (minCount > 0) ? values[minQueue[minHead]] : 0.0f;
+}
+
+float SlidingExtrema::getMax() const {
+    return (maxCount > 0) ? values[maxQueue[maxHead]] : 0.0f;
+}
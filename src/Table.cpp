@@ -1,15 +1,64 @@
 #include "Table.hpp"
+#include "AssetBuffer.hpp"
+#include <stdio.h>
+#include <string.h>
+
+// Text of a numeric cell, as String(value) / String(value, decimals) would give
+static void formatNumber(char* buf, bool integer, int32_t i, float f, uint8_t decimals) {
+    if (integer) {
+        snprintf(buf, TABLE_CELL_TEXT, "%ld", (long)i);
+    } else {
+        snprintf(buf, TABLE_CELL_TEXT, "%.*f", (int)decimals, (double)f);
+    }
+}
+
+// Line segments limited to a clip rectangle (none when clip is nullptr)
+static void clippedHLine(LedScreen128_64* screen, int16_t lx, int16_t ly, int16_t length, const ScreenRect* clip) {
+    if (clip != nullptr) {
+        if (ly < clip->y || ly >= clip->y + clip->h) return;
+        int16_t x0 = max(lx, clip->x);
+        int16_t x1 = min((int16_t)(lx + length), (int16_t)(clip->x + clip->w));
+        if (x1 <= x0) return;
+        lx = x0;
+        length = x1 - x0;
+    }
+    screen->drawFastHLine(lx, ly, length, true);
+}
+
+static void clippedVLine(LedScreen128_64* screen, int16_t lx, int16_t ly, int16_t length, const ScreenRect* clip) {
+    if (clip != nullptr) {
+        if (lx < clip->x || lx >= clip->x + clip->w) return;
+        int16_t y0 = max(ly, clip->y);
+        int16_t y1 = min((int16_t)(ly + length), (int16_t)(clip->y + clip->h));
+        if (y1 <= y0) return;
+        ly = y0;
+        length = y1 - y0;
+    }
+    screen->drawFastVLine(lx, ly, length, true);
+}
 
 // Constructor
 Table::Table(int16_t x, int16_t y, int16_t width, int16_t height, int rows, int cols)
-    : GraphicsAsset(x, y, width, height, AssetType::TABLE), cells(nullptr), rows(rows), cols(cols),
+    : GraphicsAsset(x, y, width, height, AssetType::TABLE), cells(nullptr), cellText(nullptr), rows(rows), cols(cols),
       colWidths(nullptr), rowHeight(10), textSize(1), showHeaders(true),
       showGridLines(true), autoFitColumns(true) {
     
     // Allocate cell data
     if (rows > 0 && cols > 0) {
-        cells = new String[rows * cols];
-        colWidths = new int[cols];
+        cells = assetBufferNew<Cell>(rows * cols);
+        cellText = assetBufferNew<char>(rows * cols * TABLE_CELL_TEXT);
+        colWidths = assetBufferNew<int>(cols);
+        if (cells == nullptr || cellText == nullptr || colWidths == nullptr) {
+            assetBufferFree(cells);
+            assetBufferFree(cellText);
+            assetBufferFree(colWidths);
+            cells = nullptr;
+            cellText = nullptr;
+            colWidths = nullptr;
+            this->rows = 0;
+            this->cols = 0;
+            return;
+        }
         
         // Initialize column widths
         if (autoFitColumns) {
@@ -25,14 +74,12 @@ Table::Table(int16_t x, int16_t y, int16_t width, int16_t height, int rows, int
 
 // Destructor
 Table::~Table() {
-    if (cells != nullptr) {
-        delete[] cells;
-        cells = nullptr;
-    }
-    if (colWidths != nullptr) {
-        delete[] colWidths;
-        colWidths = nullptr;
-    }
+    assetBufferFree(cells);
+    cells = nullptr;
+    assetBufferFree(cellText);
+    cellText = nullptr;
+    assetBufferFree(colWidths);
+    colWidths = nullptr;
 }
 
 // Draw method implementation
@@ -40,10 +87,91 @@ void Table::draw(LedScreen128_64* screen) {
     if (!visible || screen == nullptr || rows == 0 || cols == 0) {
         return;
     }
+    drawTable(screen, nullptr);
+}
+
+// Partial repaint: the block of cells from the first to the last changed row
+// and column. Refused when text in that block could spill out of its cell.
+bool Table::getDamage(int16_t& dx, int16_t& dy, int16_t& dw, int16_t& dh) const {
+    if (rows == 0 || cols == 0) {
+        return false;
+    }
+    
+    int firstRow = rows, lastRow = -1, firstCol = cols, lastCol = -1;
+    for (int row = 0; row < rows; row++) {
+        for (int col = 0; col < cols; col++) {
+            if (cells[row * cols + col].dirty) {
+                firstRow = min(firstRow, row);
+                lastRow = max(lastRow, row);
+                firstCol = min(firstCol, col);
+                lastCol = max(lastCol, col);
+            }
+        }
+    }
+    if (lastRow < 0) {
+        return false;
+    }
+    
+    // Same row and column walk as drawTable()
+    int16_t top = 0, bottom = 0;
+    int16_t currentY = y + 1;
+    for (int row = 0; row <= lastRow && currentY < y + height; row++) {
+        int16_t currentRowHeight = getRowPixels(row);
+        if (currentY + currentRowHeight > y + height) break;
+        if (row >= firstRow) {
+            if (8 * textSize > currentRowHeight) return false;
+            if (row == firstRow) top = currentY;
+            bottom = currentY + currentRowHeight;
+        }
+        currentY += currentRowHeight;
+    }
     
+    int16_t left = 0, right = 0;
+    int16_t currentX = x + 1;
+    for (int col = 0; col <= lastCol && currentX < x + width; col++) {
+        int16_t cellWidth = colWidths[col];
+        if (currentX + cellWidth > x + width) {
+            cellWidth = x + width - currentX;
+        }
+        if (col >= firstCol) {
+            if ((cellWidth - 4) / (6 * textSize) <= 0) return false;
+            if (col == firstCol) left = currentX;
+            right = currentX + cellWidth;
+        }
+        currentX += cellWidth;
+    }
+    
+    dx = left;
+    dy = top;
+    dw = right - left;
+    dh = bottom - top;
+    return dw > 0 && dh > 0;
+}
+
+void Table::drawDamage(LedScreen128_64* screen) {
+    if (!visible || screen == nullptr || rows == 0 || cols == 0) {
+        return;
+    }
+    ScreenRect clip;
+    if (!getDamage(clip.x, clip.y, clip.w, clip.h)) {
+        drawTable(screen, nullptr);
+        return;
+    }
+    drawTable(screen, &clip);
+}
+
+// Draw the cells overlapping clip, and the lines inside it; everything when clip is nullptr
+void Table::drawTable(LedScreen128_64* screen, const ScreenRect* clip) {
     // Draw border if enabled
     if (border) {
-        screen->drawRect(x, y, width, height, true);
+        if (clip == nullptr) {
+            screen->drawRect(x, y, width, height, true);
+        } else {
+            clippedHLine(screen, x, y, width, clip);
+            clippedHLine(screen, x, y + height - 1, width, clip);
+            clippedVLine(screen, x, y, height, clip);
+            clippedVLine(screen, x + width - 1, y, height, clip);
+        }
     }
     
     // Recalculate column widths if auto-fit is enabled
@@ -57,12 +185,7 @@ void Table::draw(LedScreen128_64* screen) {
     // Draw each row
     for (int row = 0; row < rows && currentY < y + height; row++) {
         int16_t currentX = x + 1;
-        int16_t currentRowHeight = rowHeight;
-        
-        // Make header row slightly taller if enabled
-        if (showHeaders && row == 0) {
-            currentRowHeight = rowHeight + 2;
-        }
+        int16_t currentRowHeight = getRowPixels(row);
         
         // Don't draw if row extends beyond bounds
         if (currentY + currentRowHeight > y + height) {
@@ -79,11 +202,15 @@ void Table::draw(LedScreen128_64* screen) {
             }
             
             // Draw the cell
-            drawCell(screen, row, col, currentX, currentY, cellWidth, currentRowHeight);
+            if (clip == nullptr ||
+                (currentX < clip->x + clip->w && clip->x < currentX + cellWidth &&
+                 currentY < clip->y + clip->h && clip->y < currentY + currentRowHeight)) {
+                drawCell(screen, row, col, currentX, currentY, cellWidth, currentRowHeight);
+            }
             
             // Draw vertical grid line
             if (showGridLines && col < cols - 1) {
-                screen->drawFastVLine(currentX + cellWidth, currentY, currentRowHeight, true);
+                clippedVLine(screen, currentX + cellWidth, currentY, currentRowHeight, clip);
             }
             
             currentX += cellWidth;
@@ -91,60 +218,87 @@ void Table::draw(LedScreen128_64* screen) {
         
         // Draw horizontal grid line
         if (showGridLines && row < rows - 1) {
-            screen->drawFastHLine(x + 1, currentY + currentRowHeight, width - 2, true);
+            clippedHLine(screen, x + 1, currentY + currentRowHeight, width - 2, clip);
         }
         
         currentY += currentRowHeight;
     }
+    
+    for (int i = 0; i < rows * cols; i++) {
+        cells[i].dirty = false;
+    }
 }
 
 // Cell content management
 void Table::setCell(int row, int col, const char* text) {
     int index = getCellIndex(row, col);
     if (index >= 0) {
-        cells[index] = text;
+        storeText(index, text != nullptr ? text : "", text != nullptr ? strlen(text) : 0);
     }
 }
 
 void Table::setCell(int row, int col, const String& text) {
     int index = getCellIndex(row, col);
     if (index >= 0) {
-        cells[index] = text;
+        storeText(index, text.c_str(), text.length());
     }
 }
 
 void Table::setCell(int row, int col, int value) {
     int index = getCellIndex(row, col);
-    if (index >= 0) {
-        cells[index] = String(value);
-    }
+    if (index < 0) return;
+    Cell& cell = cells[index];
+    if (cell.kind == CELL_INT && cell.value.i == value) return;
+    cell.kind = CELL_INT;
+    cell.value.i = value;
+    cell.formatted = false;
+    touchCell(index);
 }
 
 void Table::setCell(int row, int col, float value, int decimals) {
     int index = getCellIndex(row, col);
-    if (index >= 0) {
-        cells[index] = String(value, decimals);
-    }
+    if (index < 0) return;
+    if (decimals < 0) decimals = 0;
+    if (decimals > 7) decimals = 7;
+    Cell& cell = cells[index];
+    if (cell.kind == CELL_FLOAT && cell.value.f == value && cell.decimals == decimals) return;
+    cell.kind = CELL_FLOAT;
+    cell.value.f = value;
+    cell.decimals = (uint8_t)decimals;
+    cell.formatted = false;
+    touchCell(index);
 }
 
 String Table::getCell(int row, int col) const {
     int index = getCellIndex(row, col);
-    if (index >= 0) {
-        return cells[index];
+    if (index < 0) {
+        return "";
     }
-    return "";
+    const Cell& cell = cells[index];
+    if ((cell.kind == CELL_INT || cell.kind == CELL_FLOAT) && !cell.formatted) {
+        char buf[TABLE_CELL_TEXT];
+        formatNumber(buf, cell.kind == CELL_INT, cell.value.i, cell.value.f, cell.decimals);
+        return String(buf);
+    }
+    return String(&cellText[index * TABLE_CELL_TEXT]);
 }
 
 void Table::clearCell(int row, int col) {
     int index = getCellIndex(row, col);
-    if (index >= 0) {
-        cells[index] = "";
+    if (index >= 0 && cells[index].kind != CELL_EMPTY) {
+        cells[index].kind = CELL_EMPTY;
+        cellText[index * TABLE_CELL_TEXT] = '\0';
+        touchCell(index);
     }
 }
 
 void Table::clearAllCells() {
     for (int i = 0; i < rows * cols; i++) {
-        cells[i] = "";
+        if (cells[i].kind != CELL_EMPTY) {
+            cells[i].kind = CELL_EMPTY;
+            cellText[i * TABLE_CELL_TEXT] = '\0';
+            touchCell(i);
+        }
     }
 }
 
@@ -163,13 +317,21 @@ bool Table::resize(int newRows, int newCols) {
     }
     
     // Allocate new arrays
-    String* newCells = new String[newRows * newCols];
-    int* newColWidths = new int[newCols];
+    Cell* newCells = assetBufferNew<Cell>(newRows * newCols);
+    char* newCellText = assetBufferNew<char>(newRows * newCols * TABLE_CELL_TEXT);
+    int* newColWidths = assetBufferNew<int>(newCols);
+    if (newCells == nullptr || newCellText == nullptr || newColWidths == nullptr) {
+        assetBufferFree(newCells);
+        assetBufferFree(newCellText);
+        assetBufferFree(newColWidths);
+        return false;
+    }
     
     // Copy existing data
     for (int r = 0; r < newRows && r < rows; r++) {
         for (int c = 0; c < newCols && c < cols; c++) {
             newCells[r * newCols + c] = cells[r * cols + c];
+            memcpy(&newCellText[(r * newCols + c) * TABLE_CELL_TEXT], &cellText[(r * cols + c) * TABLE_CELL_TEXT], TABLE_CELL_TEXT);
         }
     }
     
@@ -183,18 +345,22 @@ bool Table::resize(int newRows, int newCols) {
     }
     
     // Delete old arrays and assign new ones
-    delete[] cells;
-    delete[] colWidths;
+    assetBufferFree(cells);
+    assetBufferFree(cellText);
+    assetBufferFree(colWidths);
     cells = newCells;
+    cellText = newCellText;
     colWidths = newColWidths;
     rows = newRows;
     cols = newCols;
+    markDirty();
     
     return true;
 }
 
 // Column width management
 void Table::setColumnWidth(int col, int width) {
+    markDirty();
     if (col >= 0 && col < cols && width > 0) {
         colWidths[col] = width;
         autoFitColumns = false;
@@ -209,6 +375,7 @@ int Table::getColumnWidth(int col) const {
 }
 
 void Table::setAllColumnWidths(int width) {
+    markDirty();
     if (width > 0) {
         for (int i = 0; i < cols; i++) {
             colWidths[i] = width;
@@ -219,6 +386,7 @@ void Table::setAllColumnWidths(int width) {
 
 // Row height management
 void Table::setRowHeight(int height) {
+    markDirty();
     if (height > 0) {
         this->rowHeight = height;
     }
@@ -230,6 +398,7 @@ int Table::getRowHeight() const {
 
 // Display options
 void Table::setTextSize(uint8_t size) {
+    markDirty();
     if (size >= 1 && size <= 4) {
         this->textSize = size;
     }
@@ -240,6 +409,7 @@ uint8_t Table::getTextSize() const {
 }
 
 void Table::setShowHeaders(bool show) {
+    markDirty();
     this->showHeaders = show;
 }
 
@@ -248,6 +418,7 @@ bool Table::getShowHeaders() const {
 }
 
 void Table::setShowGridLines(bool show) {
+    markDirty();
     this->showGridLines = show;
 }
 
@@ -256,6 +427,7 @@ bool Table::getShowGridLines() const {
 }
 
 void Table::setAutoFitColumns(bool autoFit) {
+    markDirty();
     this->autoFitColumns = autoFit;
     if (autoFit) {
         calculateColumnWidths();
@@ -292,11 +464,51 @@ void Table::calculateColumnWidths() {
     }
 }
 
+int16_t Table::getRowPixels(int row) const {
+    // Header row is slightly taller if enabled
+    if (showHeaders && row == 0) {
+        return rowHeight + 2;
+    }
+    return rowHeight;
+}
+
+// Copy text into the cell's slot; unchanged text leaves the cell clean
+void Table::storeText(int index, const char* text, size_t length) {
+    Cell& cell = cells[index];
+    char* slot = &cellText[index * TABLE_CELL_TEXT];
+    if (length > TABLE_CELL_TEXT - 1) {
+        length = TABLE_CELL_TEXT - 1;
+    }
+    if (cell.kind == CELL_TEXT && strlen(slot) == length && memcmp(slot, text, length) == 0) {
+        return;
+    }
+    memcpy(slot, text, length);
+    slot[length] = '\0';
+    cell.kind = CELL_TEXT;
+    touchCell(index);
+}
+
+void Table::touchCell(int index) {
+    cells[index].dirty = true;
+    markPartiallyDirty();
+}
+
+// Text to draw, formatting a numeric cell first if its value changed
+const char* Table::getCellText(int index) {
+    Cell& cell = cells[index];
+    char* slot = &cellText[index * TABLE_CELL_TEXT];
+    if ((cell.kind == CELL_INT || cell.kind == CELL_FLOAT) && !cell.formatted) {
+        formatNumber(slot, cell.kind == CELL_INT, cell.value.i, cell.value.f, cell.decimals);
+        cell.formatted = true;
+    }
+    return slot;
+}
+
 void Table::drawCell(LedScreen128_64* screen, int row, int col, int16_t cellX, int16_t cellY, int16_t cellW, int16_t cellH) {
     int index = getCellIndex(row, col);
     if (index < 0) return;
     
-    String cellText = cells[index];
+    const char* text = getCellText(index);
     
     // Set text properties
     screen->setTextSize(textSize);
@@ -312,14 +524,14 @@ void Table::drawCell(LedScreen128_64* screen, int row, int col, int16_t cellX, i
     int maxChars = (cellW - 4) / charWidth;
     
     // Truncate text if necessary
-    String displayText = cellText;
-    if (displayText.length() > maxChars && maxChars > 0) {
-        displayText = displayText.substring(0, maxChars);
+    size_t length = strlen(text);
+    if (maxChars > 0 && length > (size_t)maxChars) {
+        length = maxChars;
     }
     
     // Draw text
     screen->setCursor(textX, textY);
-    screen->print(displayText.c_str());
+    screen->write(text, length);
     
     // Highlight header cells if enabled
     if (showHeaders && row == 0) {
@@ -3,7 +3,9 @@
 // Constructor
 TextBox::TextBox(int16_t x, int16_t y, int16_t width, int16_t height, const char* text)
     : GraphicsAsset(x, y, width, height, AssetType::TEXTBOX), text(text), textSize(1), 
-      alignment(TextAlign::LEFT), wordWrap(true), fillBackground(false), animationFrame(0) {
+      alignment(TextAlign::LEFT), wordWrap(true), fillBackground(false), animationFrame(0),
+      lineSpans(0), lineCount(0), layoutValid(false), layoutWidth(0), layoutTextSize(0),
+      layoutAlignment(TextAlign::LEFT), layoutWrap(false) {
 }
 
 // Destructor
@@ -26,102 +28,130 @@ void TextBox::draw(LedScreen128_64* screen) {
         screen->fillRect(x + 1, y + 1, width - 2, height - 2, false);
     }
     
-    // Calculate character dimensions (approximate)
-    int16_t charWidth = 6 * textSize;
     int16_t charHeight = 8 * textSize;
     int16_t padding = 2;
-    
-    // Calculate text bounds
-    int16_t textX = x + padding;
     int16_t textY = y + padding;
-    int16_t maxWidth = width - (2 * padding);
     
     // Set text properties
     screen->setTextSize(textSize);
     screen->setTextColor(true, fillBackground);
     screen->setTextWrap(false); // We handle wrapping manually
     
-    // Determine the text to display (for animation)
-    String displayString = text;
+    // Determine how much of the text to display (for animation)
+    uint16_t visibleChars = text.length();
     if (animate && animationFrame < text.length()) {
-        displayString = text.substring(0, animationFrame);
+        visibleChars = animationFrame;
         // Auto-advance animation on each draw
         animationFrame++;
+        markDirty();  // Next frame still has to be drawn in retained mode
     }
     
-    // Handle text alignment and rendering
-    if (wordWrap) {
-        // Word wrap logic
-        String remainingText = displayString;
-        int16_t currentY = textY;
-        
-        while (remainingText.length() > 0 && currentY + charHeight <= y + height - padding) {
-            int maxChars = maxWidth / charWidth;
-            String line;
-            
-            if (remainingText.length() <= maxChars) {
-                line = remainingText;
-                remainingText = "";
-            } else {
-                // Find last space before maxChars
-                int spacePos = remainingText.lastIndexOf(' ', maxChars);
-                if (spacePos > 0 && spacePos < maxChars) {
-                    line = remainingText.substring(0, spacePos);
-                    remainingText = remainingText.substring(spacePos + 1);
-                } else {
-                    // No space found, force break
-                    line = remainingText.substring(0, maxChars);
-                    remainingText = remainingText.substring(maxChars);
-                }
-            }
-            
-            // Calculate X position based on alignment
-            int16_t lineX = textX;
-            if (alignment == TextAlign::CENTER) {
-                int16_t lineWidth = line.length() * charWidth;
-                lineX = x + (width - lineWidth) / 2;
-            } else if (alignment == TextAlign::RIGHT) {
-                int16_t lineWidth = line.length() * charWidth;
-                lineX = x + width - lineWidth - padding;
-            }
-            
-            // Draw the line
-            screen->setCursor(lineX, currentY);
-            screen->print(line.c_str());
-            
-            currentY += charHeight;
+    // Print the cached line spans straight from the text buffer
+    updateLayout();
+    const char* chars = text.c_str();
+    int16_t currentY = textY;
+    for (uint8_t i = 0; i < lineSpans; i++) {
+        const LineSpan& line = lines[i];
+        if (line.offset >= visibleChars) {
+            break;
+        }
+        if (wordWrap && currentY + charHeight > y + height - padding) {
+            break;
         }
-    } else {
-        // No word wrap - single line with truncation
-        int maxChars = maxWidth / charWidth;
-        String displayText = displayString;
-        if (displayText.length() > maxChars) {
-            displayText = displayText.substring(0, maxChars);
+        uint16_t count = line.length;
+        if (line.offset + count > visibleChars) {
+            count = visibleChars - line.offset;
         }
-        
-        // Calculate X position based on alignment
-        int16_t lineX = textX;
+        screen->setCursor(x + line.xOffset, currentY);
+        screen->write(chars + line.offset, count);
+        currentY += charHeight;
+    }
+}
+
+// Layout helpers
+void TextBox::addLine(uint16_t offset, uint16_t length) const {
+    if (lineSpans < TEXTBOX_MAX_LINES) {
+        int16_t padding = 2;
+        int16_t lineWidth = length * 6 * textSize;
+        LineSpan& line = lines[lineSpans++];
+        line.offset = offset;
+        line.length = length;
         if (alignment == TextAlign::CENTER) {
-            int16_t lineWidth = displayText.length() * charWidth;
-            lineX = x + (width - lineWidth) / 2;
+            line.xOffset = (width - lineWidth) / 2;
         } else if (alignment == TextAlign::RIGHT) {
-            int16_t lineWidth = displayText.length() * charWidth;
-            lineX = x + width - lineWidth - padding;
+            line.xOffset = width - lineWidth - padding;
+        } else {
+            line.xOffset = padding;
+        }
+    }
+    lineCount++;
+}
+
+// Split the text into lines: break at the last space that fits, or force a
+// break at the box width when a word is too long
+void TextBox::updateLayout() const {
+    if (layoutValid && layoutWidth == width && layoutTextSize == textSize &&
+        layoutAlignment == alignment && layoutWrap == wordWrap) {
+        return;
+    }
+    layoutValid = true;
+    layoutWidth = width;
+    layoutTextSize = textSize;
+    layoutAlignment = alignment;
+    layoutWrap = wordWrap;
+    lineSpans = 0;
+    lineCount = 0;
+    
+    int16_t charWidth = 6 * textSize;
+    int16_t padding = 2;
+    int16_t maxWidth = width - (2 * padding);
+    int maxChars = maxWidth / charWidth;
+    uint16_t length = text.length();
+    if (length == 0 || maxChars <= 0) {
+        return;
+    }
+    
+    if (!wordWrap) {
+        // Single line, truncated to the box
+        addLine(0, length <= maxChars ? length : maxChars);
+        return;
+    }
+    
+    const char* chars = text.c_str();
+    uint16_t start = 0;
+    while (start < length) {
+        uint16_t remaining = length - start;
+        if (remaining <= maxChars) {
+            addLine(start, remaining);
+            break;
+        }
+        // Last space at or before maxChars
+        int spacePos = maxChars;
+        while (spacePos >= 0 && chars[start + spacePos] != ' ') {
+            spacePos--;
+        }
+        if (spacePos > 0 && spacePos < maxChars) {
+            addLine(start, spacePos);
+            start += spacePos + 1;
+        } else {
+            addLine(start, maxChars);
+            start += maxChars;
         }
-        
-        screen->setCursor(lineX, textY);
-        screen->print(displayText.c_str());
     }
 }
 
 // Text content
 void TextBox::setText(const char* text) {
+    markDirty();
     this->text = text;
+    layoutValid = false;
     animationFrame = 0;  // Reset animation when text changes
 }
 
 void TextBox::setText(const String& text) {
+    markDirty();
     this->text = text;
+    layoutValid = false;
     animationFrame = 0;  // Reset animation when text changes
 }
 
@@ -131,6 +161,7 @@ const String& TextBox::getText() const {
 
 // Text formatting
 void TextBox::setTextSize(uint8_t size) {
+    markDirty();
     if (size >= 1 && size <= 4) {
         this->textSize = size;
     }
@@ -141,6 +172,7 @@ uint8_t TextBox::getTextSize() const {
 }
 
 void TextBox::setAlignment(TextAlign align) {
+    markDirty();
     this->alignment = align;
 }
 
@@ -149,6 +181,7 @@ TextAlign TextBox::getAlignment() const {
 }
 
 void TextBox::setWordWrap(bool wrap) {
+    markDirty();
     this->wordWrap = wrap;
 }
 
@@ -157,6 +190,7 @@ bool TextBox::getWordWrap() const {
 }
 
 void TextBox::setFillBackground(bool fill) {
+    markDirty();
     this->fillBackground = fill;
 }
 
@@ -166,10 +200,12 @@ bool TextBox::getFillBackground() const {
 
 // Animation control
 void TextBox::resetAnimation() {
+    markDirty();
     animationFrame = 0;
 }
 
 void TextBox::advanceAnimation() {
+    markDirty();
     if (animationFrame < text.length()) {
         animationFrame++;
     }
@@ -184,31 +220,6 @@ int TextBox::calculateLines() const {
     if (!wordWrap || text.length() == 0) {
         return text.length() > 0 ? 1 : 0;
     }
-    
-    int16_t charWidth = 6 * textSize;
-    int16_t padding = 2;
-    int16_t maxWidth = width - (2 * padding);
-    int maxChars = maxWidth / charWidth;
-    
-    if (maxChars <= 0) return 0;
-    
-    int lines = 0;
-    String remainingText = text;
-    
-    while (remainingText.length() > 0) {
-        if (remainingText.length() <= maxChars) {
-            lines++;
-            break;
-        } else {
-            int spacePos = remainingText.lastIndexOf(' ', maxChars);
-            if (spacePos > 0 && spacePos < maxChars) {
-                remainingText = remainingText.substring(spacePos + 1);
-            } else {
-                remainingText = remainingText.substring(maxChars);
-            }
-            lines++;
-        }
-    }
-    
-    return lines;
+    updateLayout();
+    return lineCount;
 }
@@ -0,0 +1,158 @@
+#include "TinyFont.hpp"
+#include "FrameRaster.hpp"
+#include <string.h>
+
+// Larger scales do not fit the 32-bit column masks of the upright blitter
+#define TINY_FONT_BLIT_MAX_SCALE 6
+
+// Glyphs as column bytes, left to right; bit 0 is the top row
+static const uint8_t tinyGlyphs[][TINY_FONT_WIDTH] = {
+    {0x1F, 0x11, 0x1F},  // 0
+    {0x12, 0x1F, 0x10},  // 1
+    {0x1D, 0x15, 0x17},  // 2
+    {0x15, 0x15, 0x1F},  // 3
+    {0x07, 0x04, 0x1F},  // 4
+    {0x17, 0x15, 0x1D},  // 5
+    {0x1F, 0x15, 0x1D},  // 6
+    {0x01, 0x01, 0x1F},  // 7
+    {0x1F, 0x15, 0x1F},  // 8
+    {0x17, 0x15, 0x1F},  // 9
+    {0x04, 0x04, 0x04},  // -
+    {0x00, 0x10, 0x00},  // .
+    {0x1F, 0x11, 0x11},  // C
+    {0x01, 0x1F, 0x01},  // T
+    {0x1F, 0x04, 0x1F},  // H
+    {0x15, 0x08, 0x13}   // %
+};
+
+// ASCII -> glyph index, -1 where the font has no glyph
+static constexpr int8_t tinyGlyphIndex[128] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, 15, -1, -1, -1, -1, -1, -1, -1, 10, 11, -1,
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, 12, -1, -1, -1, -1, 14, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, 12, -1, -1, -1, -1, 14, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+static_assert(tinyGlyphIndex['0'] == 0 && tinyGlyphIndex['9'] == 9 && tinyGlyphIndex['%'] == 15,
+              "Glyph index table out of step with tinyGlyphs");
+
+// Repeat every row bit scale times
+static uint32_t scaleColumn(uint8_t column, uint8_t scale) {
+    uint32_t run = (1UL << scale) - 1;
+    uint32_t mask = 0;
+    for (uint8_t row = 0; row < TINY_FONT_HEIGHT; row++) {
+        if (column & (1 << row)) {
+            mask |= run << (row * scale);
+        }
+    }
+    return mask;
+}
+
+// OR a column mask (bit 0 at row y) into one framebuffer column
+static void orColumn(uint8_t* buffer, int16_t px, int16_t y, uint32_t mask) {
+    if (y < 0) {
+        if (y <= -32) {
+            return;
+        }
+        mask >>= -y;
+        y = 0;
+    }
+    uint64_t bits = (uint64_t)mask << (y & 7);
+    for (int16_t page = y >> 3; bits != 0 && page < SCREEN_PAGES; page++, bits >>= 8) {
+        buffer[page * SCREEN_WIDTH + px] |= (uint8_t)bits;
+    }
+}
+
+// Rotation 0: whole glyph columns per framebuffer write
+static void blitUpright(uint8_t* buffer, int16_t x, int16_t y, const char* text, uint8_t scale) {
+    int16_t advance = TINY_FONT_ADVANCE * scale;
+    for (int16_t cursorX = x; *text; text++, cursorX += advance) {
+        const uint8_t* glyph = TinyFont::glyphColumns(*text);
+        if (glyph == nullptr || cursorX >= SCREEN_WIDTH) {
+            continue;
+        }
+        for (uint8_t col = 0; col < TINY_FONT_WIDTH; col++) {
+            uint32_t mask = scale == 1 ? glyph[col] : scaleColumn(glyph[col], scale);
+            for (uint8_t sx = 0; sx < scale; sx++) {
+                int16_t px = cursorX + col * scale + sx;
+                if (px >= 0 && px < SCREEN_WIDTH) {
+                    orColumn(buffer, px, y, mask);
+                }
+            }
+        }
+    }
+}
+
+// Other rotations and large scales: one clipped block per lit glyph pixel
+template <uint8_t Rotation>
+static void blitRaster(uint8_t* buffer, int16_t x, int16_t y, const char* text, uint8_t scale) {
+    FrameRaster<Rotation> raster(buffer);
+    int16_t advance = TINY_FONT_ADVANCE * scale;
+    for (int16_t cursorX = x; *text; text++, cursorX += advance) {
+        const uint8_t* glyph = TinyFont::glyphColumns(*text);
+        if (glyph == nullptr) {
+            continue;
+        }
+        for (uint8_t col = 0; col < TINY_FONT_WIDTH; col++) {
+            for (uint8_t row = 0; row < TINY_FONT_HEIGHT; row++) {
+                if (glyph[col] & (1 << row)) {
+                    raster.fillRect(cursorX + col * scale, y + row * scale, scale, scale);
+                }
+            }
+        }
+    }
+}
+
+// Drawing
+void TinyFont::drawText(LedScreen128_64* screen, int16_t x, int16_t y, const char* text, uint8_t scale) {
+    if (screen == nullptr || text == nullptr || *text == '\0') {
+        return;
+    }
+    uint8_t* buffer = screen->getFramebuffer();
+    if (buffer == nullptr) {
+        return;
+    }
+    if (scale < 1) scale = 1;
+
+    switch (screen->getRotation()) {
+        case 1:
+            blitRaster<1>(buffer, x, y, text, scale);
+            break;
+        case 2:
+            blitRaster<2>(buffer, x, y, text, scale);
+            break;
+        case 3:
+            blitRaster<3>(buffer, x, y, text, scale);
+            break;
+        default:
+            if (scale <= TINY_FONT_BLIT_MAX_SCALE) {
+                blitUpright(buffer, x, y, text, scale);
+            } else {
+                blitRaster<0>(buffer, x, y, text, scale);
+            }
+            break;
+    }
+    screen->markDirty(x, y, textWidth(text, scale), TINY_FONT_HEIGHT * scale);
+}
+
+// Metrics
+int16_t TinyFont::textWidth(const char* text, uint8_t scale) {
+    if (scale < 1) scale = 1;
+    return text != nullptr ? (int16_t)(strlen(text) * TINY_FONT_ADVANCE * scale) : 0;
+}
+
+bool TinyFont::hasGlyph(char c) {
+    return glyphColumns(c) != nullptr;
+}
+
+const uint8_t* TinyFont::glyphColumns(char c) {
+    uint8_t code = (uint8_t)c;
+    if (code >= 128 || tinyGlyphIndex[code] < 0) {
+        return nullptr;
+    }
+    return tinyGlyphs[tinyGlyphIndex[code]];
+}
@@ -0,0 +1,137 @@
+#include "BinaryFrameCodec.hpp"
+#include <string.h>
+
+// Constructor
+BinaryFrameDecoder::BinaryFrameDecoder()
+    : state(State::SYNC), opcode(0), length(0), received(0), crc(0xFFFF), frame_crc(0),
+      frames_ok(0), frames_bad(0) {
+}
+
+// Advance the state machine by one byte
+FrameStatus BinaryFrameDecoder::feed(uint8_t byte) {
+    switch (state) {
+        case State::SYNC:
+            if (byte == BINARY_FRAME_SYNC) {
+                crc = 0xFFFF;
+                state = State::OPCODE;
+            }
+            return FrameStatus::INCOMPLETE;
+
+        case State::OPCODE:
+            opcode = byte;
+            crc = crc16(&byte, 1, crc);
+            state = State::LENGTH_LOW;
+            return FrameStatus::INCOMPLETE;
+
+        case State::LENGTH_LOW:
+            length = byte;
+            crc = crc16(&byte, 1, crc);
+            state = State::LENGTH_HIGH;
+            return FrameStatus::INCOMPLETE;
+
+        case State::LENGTH_HIGH:
+            length |= (uint16_t)byte << 8;
+            crc = crc16(&byte, 1, crc);
+            if (length > BINARY_FRAME_MAX_PAYLOAD) {
+                frames_bad++;
+                state = State::SYNC;
+                return FrameStatus::BAD_LENGTH;
+            }
+            received = 0;
+            state = length > 0 ? State::PAYLOAD : State::CRC_LOW;
+            return FrameStatus::INCOMPLETE;
+
+        case State::PAYLOAD:
+            payload[received++] = byte;
+            if (received == length) {
+                crc = crc16(payload, length, crc);
+                state = State::CRC_LOW;
+            }
+            return FrameStatus::INCOMPLETE;
+
+        case State::CRC_LOW:
+            frame_crc = byte;
+            state = State::CRC_HIGH;
+            return FrameStatus::INCOMPLETE;
+
+        case State::CRC_HIGH:
+            frame_crc |= (uint16_t)byte << 8;
+            state = State::SYNC;
+            if (frame_crc != crc) {
+                frames_bad++;
+                return FrameStatus::BAD_CRC;
+            }
+            frames_ok++;
+            return FrameStatus::READY;
+    }
+    return FrameStatus::INCOMPLETE;
+}
+
+void BinaryFrameDecoder::reset() {
+    state = State::SYNC;
+    length = 0;
+    received = 0;
+}
+
+// Getters
+uint8_t BinaryFrameDecoder::getOpcode() const {
+    return opcode;
+}
+
+const uint8_t* BinaryFrameDecoder::getPayload() const {
+    return payload;
+}
+
+uint16_t BinaryFrameDecoder::getLength() const {
+    return length;
+}
+
+uint32_t BinaryFrameDecoder::getFrameCount() const {
+    return frames_ok;
+}
+
+uint32_t BinaryFrameDecoder::getErrorCount() const {
+    return frames_bad;
+}
+
+// CRC-16/CCITT-FALSE, bitwise (frames are short and the UART is the bottleneck)
+uint16_t BinaryFrameDecoder::crc16(const uint8_t* data, size_t length, uint16_t crc) {
+    for (size_t i = 0; i < length; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// Encode header, payload and CRC in one go
+void BinaryFrameDecoder::writeFrame(Print* out, uint8_t opcode, const uint8_t* payload, uint16_t length) {
+    uint8_t header[BINARY_FRAME_HEADER_SIZE] = {
+        BINARY_FRAME_SYNC, opcode, (uint8_t)(length & 0xFF), (uint8_t)(length >> 8)
+    };
+    uint16_t crc = crc16(&header[1], BINARY_FRAME_HEADER_SIZE - 1);
+    crc = crc16(payload, length, crc);
+    uint8_t trailer[2] = { (uint8_t)(crc & 0xFF), (uint8_t)(crc >> 8) };
+
+    out->write(header, sizeof(header));
+    if (length > 0) {
+        out->write(payload, length);
+    }
+    out->write(trailer, sizeof(trailer));
+}
+
+// Field readers
+uint16_t readFrameU16(const uint8_t* data) {
+    return (uint16_t)data[0] | ((uint16_t)data[1] << 8);
+}
+
+int16_t readFrameI16(const uint8_t* data) {
+    return (int16_t)readFrameU16(data);
+}
+
+float readFrameFloat(const uint8_t* data) {
+    float value;
+    memcpy(&value, data, sizeof(value));  // ESP32 is little endian
+    return value;
+}
@@ -0,0 +1,65 @@
+#ifndef BINARY_FRAME_CODEC_HPP
+#define BINARY_FRAME_CODEC_HPP
+
+#include <Arduino.h>
+
+// Frame layout (multi-byte fields little endian):
+//   SYNC(0xA5) | opcode u8 | length u16 | payload[length] | crc u16
+// The CRC is CRC-16/CCITT-FALSE over opcode, length and payload.
+#define BINARY_FRAME_SYNC 0xA5
+#define BINARY_FRAME_HEADER_SIZE 4   // Sync, opcode, length
+#define BINARY_FRAME_OVERHEAD 6      // Header plus CRC
+#define BINARY_FRAME_MAX_PAYLOAD 2048  // Fits a full framebuffer or 500 float values
+
+// Result of feeding one byte to the decoder
+enum class FrameStatus : uint8_t {
+    INCOMPLETE = 0,  // Need more bytes
+    READY = 1,       // getOpcode()/getPayload() hold a verified frame
+    BAD_CRC = 2,     // Frame dropped, decoder is hunting for the next sync byte
+    BAD_LENGTH = 3   // Declared length exceeds BINARY_FRAME_MAX_PAYLOAD
+};
+
+// Byte-at-a-time decoder for length-prefixed, CRC-checked frames. The payload
+// is assembled in a fixed buffer, so decoding never allocates.
+class BinaryFrameDecoder {
+private:
+    enum class State : uint8_t { SYNC, OPCODE, LENGTH_LOW, LENGTH_HIGH, PAYLOAD, CRC_LOW, CRC_HIGH };
+
+    State state;
+    uint8_t opcode;
+    uint16_t length;
+    uint16_t received;
+    uint16_t crc;
+    uint16_t frame_crc;
+    uint8_t payload[BINARY_FRAME_MAX_PAYLOAD];
+
+    uint32_t frames_ok;
+    uint32_t frames_bad;
+
+public:
+    BinaryFrameDecoder();
+
+    FrameStatus feed(uint8_t byte);
+    void reset();
+
+    // Valid after feed() returned READY, until the next feed()
+    uint8_t getOpcode() const;
+    const uint8_t* getPayload() const;
+    uint16_t getLength() const;
+
+    uint32_t getFrameCount() const;  // Frames that passed the CRC
+    uint32_t getErrorCount() const;  // Frames dropped for CRC or length
+
+    // CRC-16/CCITT-FALSE (polynomial 0x1021), chainable through crc
+    static uint16_t crc16(const uint8_t* data, size_t length, uint16_t crc = 0xFFFF);
+
+    // Write one complete frame to the stream
+    static void writeFrame(Print* out, uint8_t opcode, const uint8_t* payload, uint16_t length);
+};
+
+// Little-endian field readers over a received payload
+uint16_t readFrameU16(const uint8_t* data);
+int16_t readFrameI16(const uint8_t* data);
+float readFrameFloat(const uint8_t* data);
+
+#endif // BINARY_FRAME_CODEC_HPP
@@ -1,14 +1,98 @@
 #include "SerialLedControl.hpp"
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+namespace {
+
+// constexpr strcmp, written as a single return so it also works as C++11
+constexpr int compareNames(const char* a, const char* b) {
+    return (*a != *b || *a == '\0') ? (*a - *b) : compareNames(a + 1, b + 1);
+}
+
+template <typename Entry, size_t N>
+constexpr bool isSortedTable(const Entry (&table)[N], size_t i = 1) {
+    return i >= N || (compareNames(table[i - 1].name, table[i].name) < 0 && isSortedTable(table, i + 1));
+}
+
+// Case-insensitive compare of the first n characters
+bool matchesIgnoreCase(const char* a, const char* b, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (tolower((unsigned char)a[i]) != tolower((unsigned char)b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+// Span helpers
+bool ArgSpan::empty() const {
+    return length == 0;
+}
+
+bool ArgSpan::equals(const char* word) const {
+    return strlen(word) == length && matchesIgnoreCase(data, word, length);
+}
+
+bool ArgSpan::startsWith(const char* prefix) const {
+    size_t prefix_length = strlen(prefix);
+    return prefix_length <= length && matchesIgnoreCase(data, prefix, prefix_length);
+}
+
+// Argument reader
+ArgReader::ArgReader(char* args) : cursor(args) {
+}
+
+void ArgReader::skipSpaces() {
+    while (*cursor == ' ') {
+        cursor++;
+    }
+}
+
+bool ArgReader::hasMore() {
+    skipSpaces();
+    return *cursor != '\0';
+}
+
+// Terminate the token in place and step past it
+ArgSpan ArgReader::nextWord() {
+    skipSpaces();
+    ArgSpan word = { cursor, 0 };
+    while (*cursor != '\0' && *cursor != ' ') {
+        cursor++;
+    }
+    word.length = cursor - word.data;
+    if (*cursor == ' ') {
+        *cursor++ = '\0';
+    }
+    return word;
+}
+
+int ArgReader::nextInt() {
+    return (int)strtol(nextWord().data, nullptr, 10);
+}
+
+float ArgReader::nextFloat() {
+    return strtof(nextWord().data, nullptr);
+}
+
+// The line was trimmed before dispatch, so the rest ends at the terminator
+ArgSpan ArgReader::rest() {
+    skipSpaces();
+    ArgSpan remaining = { cursor, (uint16_t)strlen(cursor) };
+    cursor += remaining.length;
+    return remaining;
+}
 
 // Constructor
 SerialLedControl::SerialLedControl(LedScreen128_64* ledScreen, Stream* serialPort)
-    : screen(ledScreen), serial(serialPort), echo_commands(true), assetCount(0) {
-    input_buffer.reserve(128);
-    
-    // Initialize assets array
-    for (int i = 0; i < MAX_GRAPHICS_ASSETS; i++) {
-        assets[i] = nullptr;
-    }
+    : screen(ledScreen), serial(serialPort), input_length(0), input_overflow(false),
+      echo_commands(true), batch_length(0), batch_count(0), batch_open(false), batch_overflow(false),
+      batch_running(false), batch_failed(0), batch_first_failure(0), ack_enabled(true),
+      binary_mode(false), arena(MAX_GRAPHICS_ASSETS, SERIAL_LED_ARENA_POOL_BYTES, ArenaMemory::PSRAM) {
+    input_buffer[0] = '\0';
 }
 
 // Initialize the serial control
@@ -26,32 +110,54 @@ void SerialLedControl::begin(unsigned long baudRate) {
 
 // Main run method - call this in loop()
 void SerialLedControl::run() {
+    // Buffers the console's assets allocate after creation (draw caches,
+    // bitmap data) come from its arena, without claiming it for other code
+    AssetArenaScope scope(arena);
     while (serial->available() > 0) {
-        char c = serial->read();
-        
-        if (c == '\n' || c == '\r') {
-            if (input_buffer.length() > 0) {
-                if (echo_commands) {
-                    serial->println();
-                }
+        if (binary_mode) {
+            runBinary();
+        } else {
+            handleTextByte(serial->read());
+        }
+    }
+}
+
+// Line editing for the text protocol
+void SerialLedControl::handleTextByte(char c) {
+    if (c == '\n' || c == '\r') {
+        if (input_length > 0 || input_overflow) {
+            if (echoing()) {
+                serial->println();
+            }
+            if (input_overflow) {
+                printError("Command too long");
+            } else {
+                input_buffer[input_length] = '\0';
                 processCommand(input_buffer);
-                input_buffer = "";
+            }
+            input_length = 0;
+            input_overflow = false;
+            if (!binary_mode) {
                 printPrompt();
             }
-        } else if (c == '\b' || c == 127) {
-            // Backspace
-            if (input_buffer.length() > 0) {
-                input_buffer.remove(input_buffer.length() - 1);
-                if (echo_commands) {
-                    serial->print("\b \b");
-                }
+        }
+    } else if (c == '\b' || c == 127) {
+        // Backspace
+        if (input_length > 0 && !input_overflow) {
+            input_length--;
+            if (echoing()) {
+                serial->print("\b \b");
             }
-        } else if (c >= 32 && c < 127) {
-            // Printable character
-            input_buffer += c;
-            if (echo_commands) {
+        }
+    } else if (c >= 32 && c < 127) {
+        // Printable character; one byte stays free for the terminator
+        if (input_length < SERIAL_LED_LINE_BUFFER - 1) {
+            input_buffer[input_length++] = c;
+            if (echoing()) {
                 serial->print(c);
             }
+        } else {
+            input_overflow = true;
         }
     }
 }
@@ -61,143 +167,207 @@ void SerialLedControl::setEcho(bool enable) {
     echo_commands = enable;
 }
 
+// Binary protocol mode
+void SerialLedControl::setBinaryMode(bool enable) {
+    binary_mode = enable;
+    frame_decoder.reset();
+    input_length = 0;
+    input_overflow = false;
+}
+
+bool SerialLedControl::isBinaryMode() const {
+    return binary_mode;
+}
+
 // Get screen reference
 LedScreen128_64* SerialLedControl::getScreen() {
     return screen;
 }
 
+// Command table, sorted by name so findCommand() can binary search it.
+// Aliases are separate entries pointing at the same handler.
+const SerialLedControl::CommandEntry* SerialLedControl::findCommand(const char* name) {
+    static constexpr CommandEntry commands[] = {
+        { "?",              &SerialLedControl::handleHelp },
+        { "abort",          &SerialLedControl::handleAbort },
+        { "ack",            &SerialLedControl::handleAck },
+        { "addpoint",       &SerialLedControl::handleAddPoint },
+        { "bar",            &SerialLedControl::handleProgressBar },
+        { "begin",          &SerialLedControl::handleBegin },
+        { "binary",         &SerialLedControl::handleBinaryMode },
+        { "bitmap",         &SerialLedControl::handleCreateBitmap },
+        { "bmp",            &SerialLedControl::handleCreateBitmap },
+        { "circ",           &SerialLedControl::handleCircle },
+        { "circle",         &SerialLedControl::handleCircle },
+        { "clear",          &SerialLedControl::handleClear },
+        { "cls",            &SerialLedControl::handleClear },
+        { "commit",         &SerialLedControl::handleCommit },
+        { "createbitmap",   &SerialLedControl::handleCreateBitmap },
+        { "createdataplot", &SerialLedControl::handleCreateDataPlot },
+        { "creategeometry", &SerialLedControl::handleCreateGeometry },
+        { "createtable",    &SerialLedControl::handleCreateTable },
+        { "createtextbox",  &SerialLedControl::handleCreateTextBox },
+        { "cursor",         &SerialLedControl::handleCursor },
+        { "dataplot",       &SerialLedControl::handleCreateDataPlot },
+        { "delete",         &SerialLedControl::handleDeleteAsset },
+        { "deleteall",      &SerialLedControl::handleDeleteAllAssets },
+        { "deleteasset",    &SerialLedControl::handleDeleteAsset },
+        { "dim",            &SerialLedControl::handleDim },
+        { "display",        &SerialLedControl::handleDisplay },
+        { "draw",           &SerialLedControl::handleDrawAsset },
+        { "drawall",        &SerialLedControl::handleDrawAllAssets },
+        { "drawallassets",  &SerialLedControl::handleDrawAllAssets },
+        { "drawasset",      &SerialLedControl::handleDrawAsset },
+        { "fcirc",          &SerialLedControl::handleFillCircle },
+        { "fillcircle",     &SerialLedControl::handleFillCircle },
+        { "fillrect",       &SerialLedControl::handleFillRect },
+        { "filltriangle",   &SerialLedControl::handleFillTriangle },
+        { "frect",          &SerialLedControl::handleFillRect },
+        { "ftri",           &SerialLedControl::handleFillTriangle },
+        { "geom",           &SerialLedControl::handleCreateGeometry },
+        { "geometry",       &SerialLedControl::handleCreateGeometry },
+        { "help",           &SerialLedControl::handleHelp },
+        { "invert",         &SerialLedControl::handleInvert },
+        { "line",           &SerialLedControl::handleLine },
+        { "list",           &SerialLedControl::handleListAssets },
+        { "listassets",     &SerialLedControl::handleListAssets },
+        { "ln",             &SerialLedControl::handleLine },
+        { "pixel",          &SerialLedControl::handlePixel },
+        { "pos",            &SerialLedControl::handleCursor },
+        { "print",          &SerialLedControl::handleText },
+        { "progress",       &SerialLedControl::handleProgressBar },
+        { "px",             &SerialLedControl::handlePixel },
+        { "rect",           &SerialLedControl::handleRect },
+        { "rectangle",      &SerialLedControl::handleRect },
+        { "rotate",         &SerialLedControl::handleRotation },
+        { "rotation",       &SerialLedControl::handleRotation },
+        { "scroll",         &SerialLedControl::handleScroll },
+        { "setanimate",     &SerialLedControl::handleSetAnimate },
+        { "setborder",      &SerialLedControl::handleSetAssetBorder },
+        { "setcell",        &SerialLedControl::handleSetCell },
+        { "setpos",         &SerialLedControl::handleSetAssetPos },
+        { "setsize",        &SerialLedControl::handleSetAssetSize },
+        { "settext",        &SerialLedControl::handleSetText },
+        { "settextsize",    &SerialLedControl::handleSetTextBoxSize },
+        { "setvisible",     &SerialLedControl::handleSetAssetVisible },
+        { "setz",           &SerialLedControl::handleSetZIndex },
+        { "setzindex",      &SerialLedControl::handleSetZIndex },
+        { "show",           &SerialLedControl::handleDisplay },
+        { "size",           &SerialLedControl::handleTextSize },
+        { "stats",          &SerialLedControl::handleStats },
+        { "table",          &SerialLedControl::handleCreateTable },
+        { "text",           &SerialLedControl::handleText },
+        { "textbox",        &SerialLedControl::handleCreateTextBox },
+        { "textsize",       &SerialLedControl::handleTextSize },
+        { "tri",            &SerialLedControl::handleTriangle },
+        { "triangle",       &SerialLedControl::handleTriangle },
+        { "update",         &SerialLedControl::handleDisplay },
+    };
+    static_assert(isSortedTable(commands), "Command table must be sorted by name without duplicates");
+
+    size_t low = 0;
+    size_t high = sizeof(commands) / sizeof(commands[0]);
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        int order = strcmp(name, commands[mid].name);
+        if (order == 0) {
+            return &commands[mid];
+        }
+        if (order < 0) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    return nullptr;
+}
+
 // Command parsing
-void SerialLedControl::processCommand(String command) {
-    command.trim();
+void SerialLedControl::processCommand(char* line) {
+    // Trim trailing spaces in place; leading ones are skipped by the reader
+    size_t length = strlen(line);
+    while (length > 0 && line[length - 1] == ' ') {
+        line[--length] = '\0';
+    }
     
-    if (command.length() == 0) {
+    ArgReader args(line);
+    if (!args.hasMore()) {
         return;
     }
     
-    // Split command and arguments
-    int space_index = command.indexOf(' ');
-    String cmd, args;
+    // Inside a batch everything except the batch commands themselves is queued
+    if (batch_open) {
+        const char* word = line;
+        while (*word == ' ') {
+            word++;
+        }
+        ArgSpan first = { word, (uint16_t)strcspn(word, " ") };
+        if (!first.equals("begin") && !first.equals("commit") && !first.equals("abort")) {
+            bool overflowed = batch_overflow;
+            if (!queueBatchLine(word) && !overflowed) {
+                printError("Batch buffer full, batch will be refused");
+            }
+            return;
+        }
+    }
     
-    if (space_index == -1) {
-        cmd = command;
-        args = "";
-    } else {
-        cmd = command.substring(0, space_index);
-        args = command.substring(space_index + 1);
-        args.trim();
-    }
-    
-    cmd.toLowerCase();
-    parseAndExecute(cmd, args);
-}
-
-void SerialLedControl::parseAndExecute(String cmd, String args) {
-    if (cmd == "help" || cmd == "?") {
-        handleHelp();
-    } else if (cmd == "clear" || cmd == "cls") {
-        handleClear();
-    } else if (cmd == "display" || cmd == "show" || cmd == "update") {
-        handleDisplay();
-    } else if (cmd == "text" || cmd == "print") {
-        handleText(args);
-    } else if (cmd == "textsize" || cmd == "size") {
-        handleTextSize(args);
-    } else if (cmd == "cursor" || cmd == "pos") {
-        handleCursor(args);
-    } else if (cmd == "pixel" || cmd == "px") {
-        handlePixel(args);
-    } else if (cmd == "line" || cmd == "ln") {
-        handleLine(args);
-    } else if (cmd == "rect" || cmd == "rectangle") {
-        handleRect(args);
-    } else if (cmd == "fillrect" || cmd == "frect") {
-        handleFillRect(args);
-    } else if (cmd == "circle" || cmd == "circ") {
-        handleCircle(args);
-    } else if (cmd == "fillcircle" || cmd == "fcirc") {
-        handleFillCircle(args);
-    } else if (cmd == "triangle" || cmd == "tri") {
-        handleTriangle(args);
-    } else if (cmd == "filltriangle" || cmd == "ftri") {
-        handleFillTriangle(args);
-    } else if (cmd == "progress" || cmd == "bar") {
-        handleProgressBar(args);
-    } else if (cmd == "invert") {
-        handleInvert(args);
-    } else if (cmd == "dim") {
-        handleDim(args);
-    } else if (cmd == "rotate" || cmd == "rotation") {
-        handleRotation(args);
-    } else if (cmd == "scroll") {
-        handleScroll(args);
-    } else if (cmd == "textbox" || cmd == "createtextbox") {
-        handleCreateTextBox(args);
-    } else if (cmd == "dataplot" || cmd == "createdataplot") {
-        handleCreateDataPlot(args);
-    } else if (cmd == "table" || cmd == "createtable") {
-        handleCreateTable(args);
-    } else if (cmd == "geometry" || cmd == "creategeometry" || cmd == "geom") {
-        handleCreateGeometry(args);
-    } else if (cmd == "bitmap" || cmd == "createbitmap" || cmd == "bmp") {
-        handleCreateBitmap(args);
-    } else if (cmd == "setcell") {
-        handleSetCell(args);
-    } else if (cmd == "addpoint") {
-        handleAddPoint(args);
-    } else if (cmd == "drawasset" || cmd == "draw") {
-        handleDrawAsset(args);
-    } else if (cmd == "drawallassets" || cmd == "drawall") {
-        handleDrawAllAssets();
-    } else if (cmd == "listassets" || cmd == "list") {
-        handleListAssets();
-    } else if (cmd == "deleteasset" || cmd == "delete") {
-        handleDeleteAsset(args);
-    } else if (cmd == "deleteall") {
-        handleDeleteAllAssets();
-    } else if (cmd == "setpos") {
-        handleSetAssetPos(args);
-    } else if (cmd == "setsize") {
-        handleSetAssetSize(args);
-    } else if (cmd == "setborder") {
-        handleSetAssetBorder(args);
-    } else if (cmd == "setvisible") {
-        handleSetAssetVisible(args);
-    } else if (cmd == "settext") {
-        handleSetText(args);
-    } else if (cmd == "setanimate") {
-        handleSetAnimate(args);
-    } else if (cmd == "setzindex" || cmd == "setz") {
-        handleSetZIndex(args);
-    } else if (cmd == "settextsize" || cmd == "setsize") {
-        handleSetTextBoxSize(args);
-    } else {
+    // Command names are matched lower case
+    ArgSpan cmd = args.nextWord();
+    char* name = const_cast<char*>(cmd.data);
+    for (uint16_t i = 0; i < cmd.length; i++) {
+        name[i] = tolower((unsigned char)name[i]);
+    }
+    
+    const CommandEntry* entry = findCommand(name);
+    if (entry == nullptr) {
         printError("Unknown command. Type 'help' for available commands.");
+        return;
     }
+    PROFILE_SCOPE(ProfileZone::COMMAND);
+    (this->*(entry->handler))(args);
+}
+
+// Append one line to the batch buffer
+bool SerialLedControl::queueBatchLine(const char* line) {
+    size_t length = strlen(line) + 1;
+    if (batch_overflow || batch_length + length > SERIAL_LED_BATCH_BUFFER) {
+        batch_overflow = true;
+        return false;
+    }
+    memcpy(&batch_buffer[batch_length], line, length);
+    batch_length += length;
+    batch_count++;
+    return true;
 }
 
 // Command handlers
-void SerialLedControl::handleClear() {
+void SerialLedControl::handleClear(ArgReader&) {
     screen->clearDisplay();
     printOk();
 }
 
-void SerialLedControl::handleDisplay() {
+void SerialLedControl::handleDisplay(ArgReader&) {
+    // A batch flushes once at commit
+    if (batch_running) {
+        return;
+    }
     screen->displayBuffer();
     printOk();
 }
 
-void SerialLedControl::handleText(String args) {
-    if (args.length() == 0) {
+void SerialLedControl::handleText(ArgReader& args) {
+    ArgSpan text = args.rest();
+    if (text.empty()) {
         printError("Usage: text <string>");
         return;
     }
     
-    screen->print(args.c_str());
+    screen->print(text.data);
     printOk();
 }
 
-void SerialLedControl::handleTextSize(String args) {
-    int size = parseIntArg(args);
+void SerialLedControl::handleTextSize(ArgReader& args) {
+    int size = args.nextInt();
     if (size < 1 || size > 4) {
         printError("Text size must be 1-4");
         return;
@@ -207,9 +377,9 @@ void SerialLedControl::handleTextSize(String args) {
     printOk();
 }
 
-void SerialLedControl::handleCursor(String args) {
-    int x = parseIntArg(args);
-    int y = parseIntArg(args);
+void SerialLedControl::handleCursor(ArgReader& args) {
+    int x = args.nextInt();
+    int y = args.nextInt();
     
     if (x < 0 || x >= 128 || y < 0 || y >= 64) {
         printError("Cursor position out of bounds (0-127, 0-63)");
@@ -220,9 +390,9 @@ void SerialLedControl::handleCursor(String args) {
     printOk();
 }
 
-void SerialLedControl::handlePixel(String args) {
-    int x = parseIntArg(args);
-    int y = parseIntArg(args);
+void SerialLedControl::handlePixel(ArgReader& args) {
+    int x = args.nextInt();
+    int y = args.nextInt();
     
     if (x < 0 || x >= 128 || y < 0 || y >= 64) {
         printError("Pixel position out of bounds");
@@ -233,84 +403,84 @@ void SerialLedControl::handlePixel(String args) {
     printOk();
 }
 
-void SerialLedControl::handleLine(String args) {
-    int x0 = parseIntArg(args);
-    int y0 = parseIntArg(args);
-    int x1 = parseIntArg(args);
-    int y1 = parseIntArg(args);
+void SerialLedControl::handleLine(ArgReader& args) {
+    int x0 = args.nextInt();
+    int y0 = args.nextInt();
+    int x1 = args.nextInt();
+    int y1 = args.nextInt();
     
     screen->drawLine(x0, y0, x1, y1, true);
     printOk();
 }
 
-void SerialLedControl::handleRect(String args) {
-    int x = parseIntArg(args);
-    int y = parseIntArg(args);
-    int w = parseIntArg(args);
-    int h = parseIntArg(args);
+void SerialLedControl::handleRect(ArgReader& args) {
+    int x = args.nextInt();
+    int y = args.nextInt();
+    int w = args.nextInt();
+    int h = args.nextInt();
     
     screen->drawRect(x, y, w, h, true);
     printOk();
 }
 
-void SerialLedControl::handleFillRect(String args) {
-    int x = parseIntArg(args);
-    int y = parseIntArg(args);
-    int w = parseIntArg(args);
-    int h = parseIntArg(args);
+void SerialLedControl::handleFillRect(ArgReader& args) {
+    int x = args.nextInt();
+    int y = args.nextInt();
+    int w = args.nextInt();
+    int h = args.nextInt();
     
     screen->fillRect(x, y, w, h, true);
     printOk();
 }
 
-void SerialLedControl::handleCircle(String args) {
-    int x = parseIntArg(args);
-    int y = parseIntArg(args);
-    int r = parseIntArg(args);
+void SerialLedControl::handleCircle(ArgReader& args) {
+    int x = args.nextInt();
+    int y = args.nextInt();
+    int r = args.nextInt();
     
     screen->drawCircle(x, y, r, true);
     printOk();
 }
 
-void SerialLedControl::handleFillCircle(String args) {
-    int x = parseIntArg(args);
-    int y = parseIntArg(args);
-    int r = parseIntArg(args);
+void SerialLedControl::handleFillCircle(ArgReader& args) {
+    int x = args.nextInt();
+    int y = args.nextInt();
+    int r = args.nextInt();
     
     screen->fillCircle(x, y, r, true);
     printOk();
 }
 
-void SerialLedControl::handleTriangle(String args) {
-    int x0 = parseIntArg(args);
-    int y0 = parseIntArg(args);
-    int x1 = parseIntArg(args);
-    int y1 = parseIntArg(args);
-    int x2 = parseIntArg(args);
-    int y2 = parseIntArg(args);
+void SerialLedControl::handleTriangle(ArgReader& args) {
+    int x0 = args.nextInt();
+    int y0 = args.nextInt();
+    int x1 = args.nextInt();
+    int y1 = args.nextInt();
+    int x2 = args.nextInt();
+    int y2 = args.nextInt();
     
     screen->drawTriangle(x0, y0, x1, y1, x2, y2, true);
     printOk();
 }
 
-void SerialLedControl::handleFillTriangle(String args) {
-    int x0 = parseIntArg(args);
-    int y0 = parseIntArg(args);
-    int x1 = parseIntArg(args);
-    int y1 = parseIntArg(args);
-    int x2 = parseIntArg(args);
-    int y2 = parseIntArg(args);
+void SerialLedControl::handleFillTriangle(ArgReader& args) {
+    int x0 = args.nextInt();
+    int y0 = args.nextInt();
+    int x1 = args.nextInt();
+    int y1 = args.nextInt();
+    int x2 = args.nextInt();
+    int y2 = args.nextInt();
     
     screen->fillTriangle(x0, y0, x1, y1, x2, y2, true);
     printOk();
 }
 
-void SerialLedControl::handleProgressBar(String args) {
-    int x = parseIntArg(args);
-    int y = parseIntArg(args);
-    int w = parseIntArg(args);
-    int h = parseIntArg(args);
-    int percent = parseIntArg(args);
+void SerialLedControl::handleProgressBar(ArgReader& args) {
+    int x = args.nextInt();
+    int y = args.nextInt();
+    int w = args.nextInt();
+    int h = args.nextInt();
+    int percent = args.nextInt();
     
     if (percent < 0 || percent > 100) {
         printError("Percentage must be 0-100");
@@ -321,22 +491,22 @@ void SerialLedControl::handleProgressBar(String args) {
     printOk();
 }
 
-void SerialLedControl::handleInvert(String args) {
-    args.toLowerCase();
-    bool invert = (args == "1" || args == "true" || args == "on" || args == "yes");
+void SerialLedControl::handleInvert(ArgReader& args) {
+    ArgSpan value = args.rest();
+    bool invert = (value.equals("1") || value.equals("true") || value.equals("on") || value.equals("yes"));
     screen->invertDisplay(invert);
     printOk();
 }
 
-void SerialLedControl::handleDim(String args) {
-    args.toLowerCase();
-    bool dim = (args == "1" || args == "true" || args == "on" || args == "yes");
+void SerialLedControl::handleDim(ArgReader& args) {
+    ArgSpan value = args.rest();
+    bool dim = (value.equals("1") || value.equals("true") || value.equals("on") || value.equals("yes"));
     screen->dim(dim);
     printOk();
 }
 
-void SerialLedControl::handleRotation(String args) {
-    int rotation = parseIntArg(args);
+void SerialLedControl::handleRotation(ArgReader& args) {
+    int rotation = args.nextInt();
     if (rotation < 0 || rotation > 3) {
         printError("Rotation must be 0-3");
         return;
@@ -346,19 +516,17 @@ void SerialLedControl::handleRotation(String args) {
     printOk();
 }
 
-void SerialLedControl::handleScroll(String args) {
-    args.toLowerCase();
+void SerialLedControl::handleScroll(ArgReader& args) {
+    ArgSpan direction = args.nextWord();
     
-    if (args.startsWith("stop")) {
+    if (direction.startsWith("stop")) {
         screen->stopScroll();
         printOk();
-    } else if (args.startsWith("right") || args.startsWith("left")) {
-        String remaining = args;
-        String direction = parseStringArg(remaining);
-        int start = parseIntArg(remaining);
-        int stop = parseIntArg(remaining);
+    } else if (direction.startsWith("right") || direction.startsWith("left")) {
+        int start = args.nextInt();
+        int stop = args.nextInt();
         
-        if (direction == "right") {
+        if (direction.equals("right")) {
             screen->startScrollRight(start, stop);
         } else {
             screen->startScrollLeft(start, stop);
@@ -369,7 +537,7 @@ void SerialLedControl::handleScroll(String args) {
     }
 }
 
-void SerialLedControl::handleHelp() {
+void SerialLedControl::handleHelp(ArgReader&) {
     serial->println("\n--- Available Commands ---");
     serial->println("Display Control:");
     serial->println("  clear              - Clear display buffer");
@@ -423,221 +591,331 @@ void SerialLedControl::handleHelp() {
     serial->println("  scroll left <start> <stop>        - Scroll left");
     serial->println("  scroll stop                       - Stop scrolling");
     serial->println();
+    serial->println("Batching:");
+    serial->println("  begin              - Queue the following commands");
+    serial->println("  commit             - Run the queue, draw assets and flush once");
+    serial->println("  abort              - Discard the queue");
+    serial->println("  ack [0|1]          - 0 drops OK replies and prompts (pipelining)");
+    serial->println();
     serial->println("Other:");
+    serial->println("  binary             - Switch to the binary frame protocol");
+    serial->println("  stats              - Timing, bus, queue and heap report");
+    serial->println("  stats reset|on|off - Clear or switch the profiler");
+    serial->println("  stats overlay <x> <y> - Create an on-screen readout asset");
     serial->println("  help               - Show this help");
     serial->println("\nNote: Most commands require 'display' to show changes");
     serial->println("Screen size: 128x64 pixels (x: 0-127, y: 0-63)");
     serial->println();
 }
 
-// Utility methods
-void SerialLedControl::printPrompt() {
-    serial->print("> ");
+void SerialLedControl::handleBinaryMode(ArgReader&) {
+    printOk();
+    setBinaryMode(true);
 }
 
-void SerialLedControl::printOk() {
-    serial->println("OK");
+// Profiler report and control
+void SerialLedControl::handleStats(ArgReader& args) {
+    Profiler& profiler = Profiler::getInstance();
+    ArgSpan action = args.nextWord();
+    
+    if (action.empty()) {
+        profiler.printReport(*serial);
+    } else if (action.equals("reset")) {
+        profiler.reset();
+        printOk();
+    } else if (action.equals("on") || action.equals("off")) {
+        profiler.setEnabled(action.equals("on"));
+        printOk();
+    } else if (action.equals("overlay")) {
+        int x = args.nextInt();
+        int y = args.nextInt();
+        AssetHandle handle = arena.create<ProfilerOverlay>(x, y);
+        if (handle == ASSET_HANDLE_INVALID) {
+            printError("Maximum number of assets reached");
+            return;
+        }
+        serial->print("Created ProfilerOverlay with ID: ");
+        serial->println(AssetArena::indexOf(handle));
+    } else {
+        printError("Usage: stats [reset|on|off|overlay <x> <y>]");
+    }
 }
 
-void SerialLedControl::printError(const char* message) {
-    serial->print("ERROR: ");
-    serial->println(message);
+// Batch handlers
+void SerialLedControl::handleBegin(ArgReader&) {
+    if (batch_open) {
+        printError("Batch already open");
+        return;
+    }
+    batch_open = true;
+    batch_overflow = false;
+    batch_length = 0;
+    batch_count = 0;
+    printOk();
 }
 
-int SerialLedControl::parseIntArg(String& args) {
-    args.trim();
-    int space_index = args.indexOf(' ');
-    String value_str;
+// Run the queued lines back to back, then draw and flush exactly once
+void SerialLedControl::handleCommit(ArgReader&) {
+    if (!batch_open) {
+        printError("No open batch");
+        return;
+    }
+    batch_open = false;
+    if (batch_overflow) {
+        batch_length = 0;
+        batch_count = 0;
+        printError("Batch overflowed, nothing executed");
+        return;
+    }
     
-    if (space_index == -1) {
-        value_str = args;
-        args = "";
-    } else {
-        value_str = args.substring(0, space_index);
-        args = args.substring(space_index + 1);
+    batch_running = true;
+    batch_failed = 0;
+    batch_first_failure = 0;
+    char* line = batch_buffer;
+    for (uint16_t i = 0; i < batch_count; i++) {
+        char* next = line + strlen(line) + 1;
+        uint16_t failed_before = batch_failed;
+        processCommand(line);
+        if (batch_failed != failed_before && batch_first_failure == 0) {
+            batch_first_failure = i + 1;
+        }
+        line = next;
     }
+    batch_running = false;
     
-    return value_str.toInt();
-}
-
-float SerialLedControl::parseFloatArg(String& args) {
-    args.trim();
-    int space_index = args.indexOf(' ');
-    String value_str;
+    screen->drawAssets();
+    screen->displayBuffer();
     
-    if (space_index == -1) {
-        value_str = args;
-        args = "";
+    if (batch_failed == 0) {
+        serial->print("OK ");
+        serial->println(batch_count);
     } else {
-        value_str = args.substring(0, space_index);
-        args = args.substring(space_index + 1);
+        serial->print("ERROR: ");
+        serial->print(batch_failed);
+        serial->print(" of ");
+        serial->print(batch_count);
+        serial->print(" commands failed, first at line ");
+        serial->println(batch_first_failure);
     }
-    
-    return value_str.toFloat();
+    batch_length = 0;
+    batch_count = 0;
 }
 
-String SerialLedControl::parseStringArg(String& args) {
-    args.trim();
-    int space_index = args.indexOf(' ');
-    String value_str;
-    
-    if (space_index == -1) {
-        value_str = args;
-        args = "";
-    } else {
-        value_str = args.substring(0, space_index);
-        args = args.substring(space_index + 1);
+void SerialLedControl::handleAbort(ArgReader&) {
+    if (!batch_open) {
+        printError("No open batch");
+        return;
     }
-    
-    return value_str;
+    batch_open = false;
+    batch_overflow = false;
+    batch_length = 0;
+    batch_count = 0;
+    printOk();
+}
+
+// Pipelined mode: no OK or prompt per command, so the host can stream
+void SerialLedControl::handleAck(ArgReader& args) {
+    ArgSpan value = args.rest();
+    ack_enabled = (value.empty() || value.equals("1") || value.equals("true") || value.equals("on") || value.equals("yes"));
+    printOk();
+}
+
+// Utility methods
+GraphicsAsset* SerialLedControl::findAsset(int id) const {
+    if (id < 0 || id >= arena.getCapacity()) {
+        return nullptr;
+    }
+    return arena.get(arena.handleAt(id));
+}
+
+// Pipelined mode silences the echo too, without touching the setEcho() choice
+bool SerialLedControl::echoing() const {
+    return echo_commands && ack_enabled;
+}
+
+void SerialLedControl::printPrompt() {
+    if (!ack_enabled || batch_open) {
+        return;
+    }
+    serial->print("> ");
+}
+
+void SerialLedControl::printOk() {
+    if (!ack_enabled || batch_running) {
+        return;
+    }
+    serial->println("OK");
+}
+
+void SerialLedControl::printError(const char* message) {
+    if (batch_running) {
+        // Reported once at commit
+        batch_failed++;
+        return;
+    }
+    serial->print("ERROR: ");
+    serial->println(message);
 }
 
 // Graphics asset command handlers
-void SerialLedControl::handleCreateTextBox(String args) {
-    if (assetCount >= MAX_GRAPHICS_ASSETS) {
+void SerialLedControl::handleCreateTextBox(ArgReader& args) {
+    if (arena.getCount() >= arena.getCapacity()) {
         printError("Maximum number of assets reached");
         return;
     }
     
-    int x = parseIntArg(args);
-    int y = parseIntArg(args);
-    int w = parseIntArg(args);
-    int h = parseIntArg(args);
+    int x = args.nextInt();
+    int y = args.nextInt();
+    int w = args.nextInt();
+    int h = args.nextInt();
     
     // Remaining args is the text
-    args.trim();
+    ArgSpan text = args.rest();
     
-    TextBox* textBox = new TextBox(x, y, w, h, args.c_str());
+    AssetHandle handle = arena.create<TextBox>(x, y, w, h, text.data);
+    if (handle == ASSET_HANDLE_INVALID) {
+        printError("Maximum number of assets reached");
+        return;
+    }
+    TextBox* textBox = arena.getAs<TextBox>(handle);
     textBox->setBorder(true);
-    assets[assetCount] = textBox;
     
     serial->print("Created TextBox with ID: ");
-    serial->println(assetCount);
-    assetCount++;
+    serial->println(AssetArena::indexOf(handle));
 }
 
-void SerialLedControl::handleCreateDataPlot(String args) {
-    if (assetCount >= MAX_GRAPHICS_ASSETS) {
+void SerialLedControl::handleCreateDataPlot(ArgReader& args) {
+    if (arena.getCount() >= arena.getCapacity()) {
         printError("Maximum number of assets reached");
         return;
     }
     
-    int x = parseIntArg(args);
-    int y = parseIntArg(args);
-    int w = parseIntArg(args);
-    int h = parseIntArg(args);
+    int x = args.nextInt();
+    int y = args.nextInt();
+    int w = args.nextInt();
+    int h = args.nextInt();
     
-    DataPlot* dataPlot = new DataPlot(x, y, w, h, 50);
+    AssetHandle handle = arena.create<DataPlot>(x, y, w, h, 50);
+    if (handle == ASSET_HANDLE_INVALID) {
+        printError("Maximum number of assets reached");
+        return;
+    }
+    DataPlot* dataPlot = arena.getAs<DataPlot>(handle);
     dataPlot->setBorder(true);
-    assets[assetCount] = dataPlot;
     
     serial->print("Created DataPlot with ID: ");
-    serial->println(assetCount);
-    assetCount++;
+    serial->println(AssetArena::indexOf(handle));
 }
 
-void SerialLedControl::handleCreateTable(String args) {
-    if (assetCount >= MAX_GRAPHICS_ASSETS) {
+void SerialLedControl::handleCreateTable(ArgReader& args) {
+    if (arena.getCount() >= arena.getCapacity()) {
         printError("Maximum number of assets reached");
         return;
     }
     
-    int x = parseIntArg(args);
-    int y = parseIntArg(args);
-    int w = parseIntArg(args);
-    int h = parseIntArg(args);
-    int rows = parseIntArg(args);
-    int cols = parseIntArg(args);
+    int x = args.nextInt();
+    int y = args.nextInt();
+    int w = args.nextInt();
+    int h = args.nextInt();
+    int rows = args.nextInt();
+    int cols = args.nextInt();
     
     if (rows <= 0 || cols <= 0) {
         printError("Rows and columns must be positive");
         return;
     }
     
-    Table* table = new Table(x, y, w, h, rows, cols);
+    AssetHandle handle = arena.create<Table>(x, y, w, h, rows, cols);
+    if (handle == ASSET_HANDLE_INVALID) {
+        printError("Maximum number of assets reached");
+        return;
+    }
+    Table* table = arena.getAs<Table>(handle);
     table->setBorder(true);
-    assets[assetCount] = table;
     
     serial->print("Created Table with ID: ");
-    serial->println(assetCount);
-    assetCount++;
+    serial->println(AssetArena::indexOf(handle));
 }
 
-void SerialLedControl::handleSetCell(String args) {
-    int id = parseIntArg(args);
+void SerialLedControl::handleSetCell(ArgReader& args) {
+    int id = args.nextInt();
     
-    if (id < 0 || id >= assetCount || assets[id] == nullptr) {
+    GraphicsAsset* asset = findAsset(id);
+    if (asset == nullptr) {
         printError("Invalid asset ID");
         return;
     }
     
     // Check if it's a Table
-    if (assets[id]->getAssetType() != AssetType::TABLE) {
+    if (asset->getAssetType() != AssetType::TABLE) {
         printError("Asset is not a Table");
         return;
     }
     
-    Table* table = static_cast<Table*>(assets[id]);
+    Table* table = static_cast<Table*>(asset);
     
-    int row = parseIntArg(args);
-    int col = parseIntArg(args);
+    int row = args.nextInt();
+    int col = args.nextInt();
     
     // Remaining args is the cell content
-    args.trim();
+    ArgSpan content = args.rest();
     
-    table->setCell(row, col, args.c_str());
+    table->setCell(row, col, content.data);
     printOk();
 }
 
-void SerialLedControl::handleAddPoint(String args) {
-    int id = parseIntArg(args);
+void SerialLedControl::handleAddPoint(ArgReader& args) {
+    int id = args.nextInt();
     
-    if (id < 0 || id >= assetCount || assets[id] == nullptr) {
+    GraphicsAsset* asset = findAsset(id);
+    if (asset == nullptr) {
         printError("Invalid asset ID");
         return;
     }
     
     // Check if it's a DataPlot
-    if (assets[id]->getAssetType() != AssetType::DATAPLOT) {
+    if (asset->getAssetType() != AssetType::DATAPLOT) {
         printError("Asset is not a DataPlot");
         return;
     }
     
-    DataPlot* dataPlot = static_cast<DataPlot*>(assets[id]);
+    DataPlot* dataPlot = static_cast<DataPlot*>(asset);
     
-    float x = parseFloatArg(args);
-    float y = parseFloatArg(args);
+    float x = args.nextFloat();
+    float y = args.nextFloat();
     
     dataPlot->addPoint(x, y);
     printOk();
 }
 
-void SerialLedControl::handleDrawAsset(String args) {
-    int id = parseIntArg(args);
+void SerialLedControl::handleDrawAsset(ArgReader& args) {
+    int id = args.nextInt();
     
-    if (id < 0 || id >= assetCount || assets[id] == nullptr) {
+    GraphicsAsset* asset = findAsset(id);
+    if (asset == nullptr) {
         printError("Invalid asset ID");
         return;
     }
     
-    assets[id]->draw(screen);
+    asset->draw(screen);
     printOk();
 }
 
-void SerialLedControl::handleListAssets() {
+void SerialLedControl::handleListAssets(ArgReader&) {
     serial->println("\n--- Graphics Assets ---");
     
-    if (assetCount == 0) {
+    if (arena.getCount() == 0) {
         serial->println("No assets created");
     } else {
-        for (int i = 0; i < assetCount; i++) {
-            if (assets[i] != nullptr) {
+        for (uint16_t i = 0; i < arena.getCapacity(); i++) {
+            GraphicsAsset* asset = findAsset(i);
+            if (asset != nullptr) {
                 serial->print("ID ");
                 serial->print(i);
                 serial->print(": ");
                 
                 // Determine type
-                switch (assets[i]->getAssetType()) {
+                switch (asset->getAssetType()) {
                     case AssetType::TEXTBOX:
                         serial->print("TextBox");
                         break;
@@ -656,185 +934,189 @@ void SerialLedControl::handleListAssets() {
                     case AssetType::BITMAP:
                         serial->print("Bitmap");
                         break;
+                    case AssetType::PROFILER_OVERLAY:
+                        serial->print("ProfilerOverlay");
+                        break;
                     default:
                         serial->print("GraphicsAsset");
                         break;
                 }
                 
                 serial->print(" at (");
-                serial->print(assets[i]->getX());
+                serial->print(asset->getX());
                 serial->print(",");
-                serial->print(assets[i]->getY());
+                serial->print(asset->getY());
                 serial->print(") size ");
-                serial->print(assets[i]->getWidth());
+                serial->print(asset->getWidth());
                 serial->print("x");
-                serial->print(assets[i]->getHeight());
+                serial->print(asset->getHeight());
                 serial->print(" z=");
-                serial->print(assets[i]->getZIndex());
+                serial->print(asset->getZIndex());
                 serial->print(" visible=");
-                serial->println(assets[i]->isVisible() ? "yes" : "no");
+                serial->println(asset->isVisible() ? "yes" : "no");
             }
         }
     }
     serial->println();
 }
 
-void SerialLedControl::handleDeleteAsset(String args) {
-    int id = parseIntArg(args);
+void SerialLedControl::handleDeleteAsset(ArgReader& args) {
+    int id = args.nextInt();
     
-    if (id < 0 || id >= assetCount || assets[id] == nullptr) {
+    if (!arena.destroy(arena.handleAt(id))) {
         printError("Invalid asset ID");
         return;
     }
-    
-    delete assets[id];
-    assets[id] = nullptr;
     printOk();
 }
 
-void SerialLedControl::handleDeleteAllAssets() {
-    for (int i = 0; i < assetCount; i++) {
-        if (assets[i] != nullptr) {
-            delete assets[i];
-            assets[i] = nullptr;
-        }
-    }
-    assetCount = 0;
+void SerialLedControl::handleDeleteAllAssets(ArgReader&) {
+    arena.destroyAll();
     printOk();
 }
 
-void SerialLedControl::handleSetAssetPos(String args) {
-    int id = parseIntArg(args);
+void SerialLedControl::handleSetAssetPos(ArgReader& args) {
+    int id = args.nextInt();
     
-    if (id < 0 || id >= assetCount || assets[id] == nullptr) {
+    GraphicsAsset* asset = findAsset(id);
+    if (asset == nullptr) {
         printError("Invalid asset ID");
         return;
     }
     
-    int x = parseIntArg(args);
-    int y = parseIntArg(args);
+    int x = args.nextInt();
+    int y = args.nextInt();
     
-    assets[id]->setPosition(x, y);
+    asset->setPosition(x, y);
     printOk();
 }
 
-void SerialLedControl::handleSetAssetSize(String args) {
-    int id = parseIntArg(args);
+void SerialLedControl::handleSetAssetSize(ArgReader& args) {
+    int id = args.nextInt();
     
-    if (id < 0 || id >= assetCount || assets[id] == nullptr) {
+    GraphicsAsset* asset = findAsset(id);
+    if (asset == nullptr) {
         printError("Invalid asset ID");
         return;
     }
     
-    int w = parseIntArg(args);
-    int h = parseIntArg(args);
+    int w = args.nextInt();
+    int h = args.nextInt();
     
-    assets[id]->setSize(w, h);
+    asset->setSize(w, h);
     printOk();
 }
 
-void SerialLedControl::handleSetAssetBorder(String args) {
-    int id = parseIntArg(args);
+void SerialLedControl::handleSetAssetBorder(ArgReader& args) {
+    int id = args.nextInt();
     
-    if (id < 0 || id >= assetCount || assets[id] == nullptr) {
+    GraphicsAsset* asset = findAsset(id);
+    if (asset == nullptr) {
         printError("Invalid asset ID");
         return;
     }
     
-    int border = parseIntArg(args);
-    assets[id]->setBorder(border != 0);
+    int border = args.nextInt();
+    asset->setBorder(border != 0);
     printOk();
 }
 
-void SerialLedControl::handleSetAssetVisible(String args) {
-    int id = parseIntArg(args);
+void SerialLedControl::handleSetAssetVisible(ArgReader& args) {
+    int id = args.nextInt();
     
-    if (id < 0 || id >= assetCount || assets[id] == nullptr) {
+    GraphicsAsset* asset = findAsset(id);
+    if (asset == nullptr) {
         printError("Invalid asset ID");
         return;
     }
     
-    int visible = parseIntArg(args);
-    assets[id]->setVisible(visible != 0);
+    int visible = args.nextInt();
+    asset->setVisible(visible != 0);
     printOk();
 }
 
-void SerialLedControl::handleSetText(String args) {
-    int id = parseIntArg(args);
+void SerialLedControl::handleSetText(ArgReader& args) {
+    int id = args.nextInt();
     
-    if (id < 0 || id >= assetCount || assets[id] == nullptr) {
+    GraphicsAsset* asset = findAsset(id);
+    if (asset == nullptr) {
         printError("Invalid asset ID");
         return;
     }
     
     // Check if it's a TextBox
-    if (assets[id]->getAssetType() != AssetType::TEXTBOX) {
+    if (asset->getAssetType() != AssetType::TEXTBOX) {
         printError("Asset is not a TextBox");
         return;
     }
     
-    TextBox* textBox = static_cast<TextBox*>(assets[id]);
+    TextBox* textBox = static_cast<TextBox*>(asset);
     
     // Remaining args is the new text
-    args.trim();
+    ArgSpan text = args.rest();
     
-    textBox->setText(args.c_str());
+    textBox->setText(text.data);
     printOk();
 }
 
-void SerialLedControl::handleSetAnimate(String args) {
-    int id = parseIntArg(args);
+void SerialLedControl::handleSetAnimate(ArgReader& args) {
+    int id = args.nextInt();
     
-    if (id < 0 || id >= assetCount || assets[id] == nullptr) {
+    GraphicsAsset* asset = findAsset(id);
+    if (asset == nullptr) {
         printError("Invalid asset ID");
         return;
     }
     
-    int animate = parseIntArg(args);
-    assets[id]->setAnimate(animate != 0);
+    int animate = args.nextInt();
+    asset->setAnimate(animate != 0);
     
     // Reset animation frame when enabling animation
     if (animate != 0) {
-        AssetType type = assets[id]->getAssetType();
+        AssetType type = asset->getAssetType();
         if (type == AssetType::TEXTBOX) {
-            static_cast<TextBox*>(assets[id])->resetAnimation();
+            static_cast<TextBox*>(asset)->resetAnimation();
         } else if (type == AssetType::FUNCTIONPLOT) {
-            static_cast<FunctionPlot*>(assets[id])->resetAnimation();
+            static_cast<FunctionPlot*>(asset)->resetAnimation();
         } else if (type == AssetType::DATAPLOT) {
-            static_cast<DataPlot*>(assets[id])->resetAnimation();
+            static_cast<DataPlot*>(asset)->resetAnimation();
         }
     }
     
     printOk();
 }
 
-void SerialLedControl::handleCreateGeometry(String args) {
-    if (assetCount >= MAX_GRAPHICS_ASSETS) {
+void SerialLedControl::handleCreateGeometry(ArgReader& args) {
+    if (arena.getCount() >= arena.getCapacity()) {
         printError("Maximum number of assets reached");
         return;
     }
     
-    int x = parseIntArg(args);
-    int y = parseIntArg(args);
-    int w = parseIntArg(args);
-    int h = parseIntArg(args);
-    String shapeStr = parseStringArg(args);
-    shapeStr.toLowerCase();
+    int x = args.nextInt();
+    int y = args.nextInt();
+    int w = args.nextInt();
+    int h = args.nextInt();
+    ArgSpan shape = args.nextWord();
     
     int filled = 0;
-    if (args.length() > 0) {
-        filled = parseIntArg(args);
+    if (args.hasMore()) {
+        filled = args.nextInt();
     }
     
-    Geometry* geom = new Geometry(x, y, w, h);
+    AssetHandle handle = arena.create<Geometry>(x, y, w, h);
+    if (handle == ASSET_HANDLE_INVALID) {
+        printError("Maximum number of assets reached");
+        return;
+    }
+    Geometry* geom = arena.getAs<Geometry>(handle);
     
-    if (shapeStr == "rect" || shapeStr == "rectangle") {
+    if (shape.equals("rect") || shape.equals("rectangle")) {
         geom->setAsRectangle(x, y, w, h, filled != 0);
-    } else if (shapeStr == "circle" || shapeStr == "circ") {
+    } else if (shape.equals("circle") || shape.equals("circ")) {
         geom->setAsCircle(x, y, w, filled != 0); // w is radius
-    } else if (shapeStr == "line") {
+    } else if (shape.equals("line")) {
         geom->setAsLine(x, y, w, h); // w and h are x1, y1
-    } else if (shapeStr == "rrect" || shapeStr == "roundrect") {
+    } else if (shape.equals("rrect") || shape.equals("roundrect")) {
         int radius = 5; // Default radius
         geom->setAsRoundedRectangle(x, y, w, h, radius, filled != 0);
     } else {
@@ -842,77 +1124,318 @@ void SerialLedControl::handleCreateGeometry(String args) {
         geom->setAsRectangle(x, y, w, h, filled != 0);
     }
     
-    assets[assetCount] = geom;
     
     serial->print("Created Geometry with ID: ");
-    serial->println(assetCount);
-    assetCount++;
+    serial->println(AssetArena::indexOf(handle));
 }
 
-void SerialLedControl::handleCreateBitmap(String args) {
-    if (assetCount >= MAX_GRAPHICS_ASSETS) {
+void SerialLedControl::handleCreateBitmap(ArgReader& args) {
+    if (arena.getCount() >= arena.getCapacity()) {
         printError("Maximum number of assets reached");
         return;
     }
     
-    int x = parseIntArg(args);
-    int y = parseIntArg(args);
-    int w = parseIntArg(args);
-    int h = parseIntArg(args);
+    int x = args.nextInt();
+    int y = args.nextInt();
+    int w = args.nextInt();
+    int h = args.nextInt();
     
-    Bitmap* bitmap = new Bitmap(x, y, w, h);
+    AssetHandle handle = arena.create<Bitmap>(x, y, w, h);
+    if (handle == ASSET_HANDLE_INVALID) {
+        printError("Maximum number of assets reached");
+        return;
+    }
+    Bitmap* bitmap = arena.getAs<Bitmap>(handle);
     
     // Create a default checkerboard pattern
     bitmap->createCheckerboard(4);
     bitmap->setBorder(true);
     
-    assets[assetCount] = bitmap;
     
     serial->print("Created Bitmap with ID: ");
-    serial->println(assetCount);
-    assetCount++;
+    serial->println(AssetArena::indexOf(handle));
 }
 
-void SerialLedControl::handleDrawAllAssets() {
+void SerialLedControl::handleDrawAllAssets(ArgReader&) {
+    // A batch draws the assets once at commit
+    if (batch_running) {
+        return;
+    }
     screen->drawAssets();
     printOk();
 }
 
-void SerialLedControl::handleSetZIndex(String args) {
-    int id = parseIntArg(args);
+void SerialLedControl::handleSetZIndex(ArgReader& args) {
+    int id = args.nextInt();
     
-    if (id < 0 || id >= assetCount || assets[id] == nullptr) {
+    GraphicsAsset* asset = findAsset(id);
+    if (asset == nullptr) {
         printError("Invalid asset ID");
         return;
     }
     
-    int z = parseIntArg(args);
-    assets[id]->setZIndex(z);
+    int z = args.nextInt();
+    asset->setZIndex(z);
     printOk();
 }
 
-void SerialLedControl::handleSetTextBoxSize(String args) {
-    int id = parseIntArg(args);
+void SerialLedControl::handleSetTextBoxSize(ArgReader& args) {
+    int id = args.nextInt();
     
-    if (id < 0 || id >= assetCount || assets[id] == nullptr) {
+    GraphicsAsset* asset = findAsset(id);
+    if (asset == nullptr) {
         printError("Invalid asset ID");
         return;
     }
     
     // Check if it's a TextBox
-    if (assets[id]->getAssetType() != AssetType::TEXTBOX) {
+    if (asset->getAssetType() != AssetType::TEXTBOX) {
         printError("Asset is not a TextBox");
         return;
     }
     
-    int size = parseIntArg(args);
+    int size = args.nextInt();
     if (size < 1 || size > 4) {
         printError("Text size must be 1-4 (1=6x8px, 2=12x16px, 3=18x24px, 4=24x32px)");
         return;
     }
     
-    TextBox* textBox = static_cast<TextBox*>(assets[id]);
+    TextBox* textBox = static_cast<TextBox*>(asset);
     textBox->setTextSize(size);
     printOk();
 }
 
+
+// Binary protocol: decode whatever has arrived, in chunks
+void SerialLedControl::runBinary() {
+    uint8_t chunk[64];
+    int available = serial->available();
+    size_t count = serial->readBytes(chunk, available < (int)sizeof(chunk) ? available : sizeof(chunk));
+    
+    for (size_t i = 0; i < count; i++) {
+        if (!binary_mode) {
+            // EXIT arrived mid-chunk; the rest belongs to the text protocol
+            handleTextByte(chunk[i]);
+            continue;
+        }
+        
+        FrameStatus status = frame_decoder.feed(chunk[i]);
+        if (status == FrameStatus::READY) {
+            processFrame(frame_decoder.getOpcode(), frame_decoder.getPayload(), frame_decoder.getLength());
+        } else if (status == FrameStatus::BAD_CRC) {
+            sendReply(SERIAL_LED_OP_NAK, SERIAL_LED_STATUS_BAD_CRC);
+        } else if (status == FrameStatus::BAD_LENGTH) {
+            sendReply(SERIAL_LED_OP_NAK, SERIAL_LED_STATUS_BAD_LENGTH);
+        }
+    }
+}
+
+// Dispatch one verified frame and answer it
+void SerialLedControl::processFrame(uint8_t opcode, const uint8_t* payload, uint16_t length) {
+    PROFILE_SCOPE(ProfileZone::COMMAND);
+    switch (opcode) {
+        case SERIAL_LED_OP_PING: {
+            uint8_t info[3] = { SERIAL_LED_BINARY_VERSION, (uint8_t)(BINARY_FRAME_MAX_PAYLOAD & 0xFF),
+                                (uint8_t)(BINARY_FRAME_MAX_PAYLOAD >> 8) };
+            sendReply(opcode, SERIAL_LED_STATUS_OK, info, sizeof(info));
+            break;
+        }
+        case SERIAL_LED_OP_EXIT:
+            sendReply(opcode, SERIAL_LED_STATUS_OK);
+            setBinaryMode(false);
+            printPrompt();
+            break;
+        case SERIAL_LED_OP_BLIT:
+            sendReply(opcode, handleBlitFrame(payload, length));
+            break;
+        case SERIAL_LED_OP_PLOT_DATA:
+            sendReply(opcode, handlePlotDataFrame(payload, length));
+            break;
+        case SERIAL_LED_OP_TABLE_ROW:
+            sendReply(opcode, handleTableRowFrame(payload, length));
+            break;
+        case SERIAL_LED_OP_DRAW_LIST:
+            sendReply(opcode, handleDrawListFrame(payload, length));
+            break;
+        default:
+            sendReply(opcode, SERIAL_LED_STATUS_UNKNOWN_OPCODE);
+            break;
+    }
+}
+
+void SerialLedControl::sendReply(uint8_t opcode, uint8_t status, const uint8_t* data, uint8_t data_length) {
+    uint8_t reply[8];
+    if (data_length > sizeof(reply) - 1) {
+        data_length = sizeof(reply) - 1;
+    }
+    reply[0] = status;
+    if (data_length > 0) {
+        memcpy(&reply[1], data, data_length);
+    }
+    BinaryFrameDecoder::writeFrame(serial, opcode | SERIAL_LED_OP_REPLY, reply, data_length + 1);
+}
+
+// Framebuffer window, copied straight into the SSD1306 buffer
+uint8_t SerialLedControl::handleBlitFrame(const uint8_t* payload, uint16_t length) {
+    if (length < 5) {
+        return SERIAL_LED_STATUS_BAD_PAYLOAD;
+    }
+    
+    uint8_t flags = payload[0];
+    uint8_t page_start = payload[1];
+    uint8_t page_count = payload[2];
+    uint8_t col_start = payload[3];
+    uint8_t col_count = payload[4];
+    if (length != 5 + page_count * col_count ||
+        !screen->writeFramebuffer(page_start, page_count, col_start, col_count, &payload[5])) {
+        return SERIAL_LED_STATUS_BAD_PAYLOAD;
+    }
+    
+    if (flags & SERIAL_LED_BLIT_DISPLAY) {
+        screen->displayBuffer();
+    }
+    return SERIAL_LED_STATUS_OK;
+}
+
+// Bulk DataPlot points
+uint8_t SerialLedControl::handlePlotDataFrame(const uint8_t* payload, uint16_t length) {
+    if (length < 4) {
+        return SERIAL_LED_STATUS_BAD_PAYLOAD;
+    }
+    
+    uint8_t id = payload[0];
+    uint8_t flags = payload[1];
+    uint16_t count = readFrameU16(&payload[2]);
+    GraphicsAsset* asset = findAsset(id);
+    if (asset == nullptr || asset->getAssetType() != AssetType::DATAPLOT) {
+        return SERIAL_LED_STATUS_BAD_ASSET;
+    }
+    
+    bool values_only = flags & SERIAL_LED_PLOT_VALUES;
+    size_t point_size = values_only ? sizeof(float) : 2 * sizeof(float);
+    if (length != 4 + count * point_size) {
+        return SERIAL_LED_STATUS_BAD_PAYLOAD;
+    }
+    
+    DataPlot* dataPlot = static_cast<DataPlot*>(asset);
+    if (flags & SERIAL_LED_PLOT_CLEAR) {
+        dataPlot->clearData();
+    }
+    
+    const uint8_t* point = &payload[4];
+    for (uint16_t i = 0; i < count; i++, point += point_size) {
+        if (values_only) {
+            dataPlot->addValue(readFrameFloat(point));
+        } else {
+            dataPlot->addPoint(readFrameFloat(point), readFrameFloat(point + sizeof(float)));
+        }
+    }
+    return SERIAL_LED_STATUS_OK;
+}
+
+// Consecutive cells of one Table row
+uint8_t SerialLedControl::handleTableRowFrame(const uint8_t* payload, uint16_t length) {
+    if (length < 3 || payload[length - 1] != '\0') {
+        return SERIAL_LED_STATUS_BAD_PAYLOAD;
+    }
+    
+    uint8_t id = payload[0];
+    GraphicsAsset* asset = findAsset(id);
+    if (asset == nullptr || asset->getAssetType() != AssetType::TABLE) {
+        return SERIAL_LED_STATUS_BAD_ASSET;
+    }
+    
+    Table* table = static_cast<Table*>(asset);
+    int row = payload[1];
+    int col = payload[2];
+    if (row >= table->getRows()) {
+        return SERIAL_LED_STATUS_BAD_PAYLOAD;
+    }
+    
+    // The payload ends in '\0', so every cell string is terminated
+    const char* cell = reinterpret_cast<const char*>(&payload[3]);
+    const char* end = reinterpret_cast<const char*>(&payload[length]);
+    while (cell < end && col < table->getCols()) {
+        table->setCell(row, col++, cell);
+        cell += strlen(cell) + 1;
+    }
+    return SERIAL_LED_STATUS_OK;
+}
+
+// Batched immediate-mode drawing; stops at the first malformed record
+uint8_t SerialLedControl::handleDrawListFrame(const uint8_t* payload, uint16_t length) {
+    // int16 argument count per record type, indexed by SERIAL_LED_DRAW_* (0 unused)
+    static const uint8_t arg_counts[] = { 0, 2, 4, 4, 4, 3, 3, 6, 6, 2, 0, 0, 0 };
+    
+    uint16_t pos = 0;
+    while (pos < length) {
+        uint8_t op = payload[pos] & ~SERIAL_LED_DRAW_BLACK;
+        bool white = !(payload[pos] & SERIAL_LED_DRAW_BLACK);
+        pos++;
+        
+        if (op == 0 || op >= sizeof(arg_counts)) {
+            return SERIAL_LED_STATUS_BAD_PAYLOAD;
+        }
+        if (pos + arg_counts[op] * 2 > length) {
+            return SERIAL_LED_STATUS_BAD_PAYLOAD;
+        }
+        int16_t a[6];
+        for (uint8_t i = 0; i < arg_counts[op]; i++, pos += 2) {
+            a[i] = readFrameI16(&payload[pos]);
+        }
+        
+        switch (op) {
+            case SERIAL_LED_DRAW_PIXEL:
+                screen->drawPixel(a[0], a[1], white);
+                break;
+            case SERIAL_LED_DRAW_LINE:
+                screen->drawLine(a[0], a[1], a[2], a[3], white);
+                break;
+            case SERIAL_LED_DRAW_RECT:
+                screen->drawRect(a[0], a[1], a[2], a[3], white);
+                break;
+            case SERIAL_LED_DRAW_FILL_RECT:
+                screen->fillRect(a[0], a[1], a[2], a[3], white);
+                break;
+            case SERIAL_LED_DRAW_CIRCLE:
+                screen->drawCircle(a[0], a[1], a[2], white);
+                break;
+            case SERIAL_LED_DRAW_FILL_CIRCLE:
+                screen->fillCircle(a[0], a[1], a[2], white);
+                break;
+            case SERIAL_LED_DRAW_TRIANGLE:
+                screen->drawTriangle(a[0], a[1], a[2], a[3], a[4], a[5], white);
+                break;
+            case SERIAL_LED_DRAW_FILL_TRIANGLE:
+                screen->fillTriangle(a[0], a[1], a[2], a[3], a[4], a[5], white);
+                break;
+            case SERIAL_LED_DRAW_TEXT: {
+                if (pos + 2 > length || pos + 2 + payload[pos + 1] > length) {
+                    return SERIAL_LED_STATUS_BAD_PAYLOAD;
+                }
+                uint8_t size = payload[pos];
+                uint8_t text_length = payload[pos + 1];
+                char text[256];
+                memcpy(text, &payload[pos + 2], text_length);
+                text[text_length] = '\0';
+                pos += 2 + text_length;
+                
+                screen->setTextSize(size >= 1 && size <= 4 ? size : 1);
+                screen->setTextColor(white);
+                screen->setCursor(a[0], a[1]);
+                screen->print(text);
+                break;
+            }
+            case SERIAL_LED_DRAW_CLEAR:
+                screen->clearDisplay();
+                break;
+            case SERIAL_LED_DRAW_DISPLAY:
+                screen->displayBuffer();
+                break;
+            case SERIAL_LED_DRAW_ASSETS:
+                screen->drawAssets();
+                break;
+        }
+    }
+    return SERIAL_LED_STATUS_OK;
+}
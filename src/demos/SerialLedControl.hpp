@@ -10,74 +10,192 @@
 #include "../../include/Table.hpp"
 #include "../../include/Geometry.hpp"
 #include "../../include/Bitmap.hpp"
+#include "../../include/AssetArena.hpp"
+#include "../../include/Profiler.hpp"
+#include "../../include/ProfilerOverlay.hpp"
+#include "BinaryFrameCodec.hpp"
 
-#define MAX_GRAPHICS_ASSETS 10
+#define MAX_GRAPHICS_ASSETS 128           // Arena slots; asset IDs are slot indices
+#define SERIAL_LED_ARENA_POOL_BYTES (32 * 1024)  // Plot data, bitmaps and table cells
+#define SERIAL_LED_LINE_BUFFER 128  // Longest accepted command line, including '\0'
+#define SERIAL_LED_BATCH_BUFFER 2048  // Queued command text between 'begin' and 'commit'
+
+// Binary mode ('binary' command). Every request frame is answered with a frame
+// carrying opcode | SERIAL_LED_OP_REPLY and a status byte as first payload byte.
+#define SERIAL_LED_BINARY_VERSION 1
+#define SERIAL_LED_OP_PING 0x01       // -> status, version, max payload u16
+#define SERIAL_LED_OP_EXIT 0x02       // Back to the text protocol
+#define SERIAL_LED_OP_BLIT 0x10       // flags, page, pages, col, cols, page-native data
+#define SERIAL_LED_OP_PLOT_DATA 0x20  // id, flags, count u16, float32 values or x/y pairs
+#define SERIAL_LED_OP_TABLE_ROW 0x30  // id, row, first col, NUL-terminated cell strings
+#define SERIAL_LED_OP_DRAW_LIST 0x40  // Sequence of draw records (SERIAL_LED_DRAW_*)
+#define SERIAL_LED_OP_REPLY 0x80
+#define SERIAL_LED_OP_NAK 0xFF        // Reply to a frame that failed CRC or length checks
+
+// Flags
+#define SERIAL_LED_BLIT_DISPLAY 0x01      // Flush the screen after the blit
+#define SERIAL_LED_PLOT_VALUES 0x01       // Payload holds Y values only (implicit X)
+#define SERIAL_LED_PLOT_CLEAR 0x02        // Clear the plot before adding
+
+// Draw list records: opcode byte (bit 7 set = draw black) + int16 arguments
+#define SERIAL_LED_DRAW_BLACK 0x80
+#define SERIAL_LED_DRAW_PIXEL 0x01          // x y
+#define SERIAL_LED_DRAW_LINE 0x02           // x0 y0 x1 y1
+#define SERIAL_LED_DRAW_RECT 0x03           // x y w h
+#define SERIAL_LED_DRAW_FILL_RECT 0x04      // x y w h
+#define SERIAL_LED_DRAW_CIRCLE 0x05         // x y r
+#define SERIAL_LED_DRAW_FILL_CIRCLE 0x06    // x y r
+#define SERIAL_LED_DRAW_TRIANGLE 0x07       // x0 y0 x1 y1 x2 y2
+#define SERIAL_LED_DRAW_FILL_TRIANGLE 0x08  // x0 y0 x1 y1 x2 y2
+#define SERIAL_LED_DRAW_TEXT 0x09           // x y, then u8 size, u8 length, characters
+#define SERIAL_LED_DRAW_CLEAR 0x0A
+#define SERIAL_LED_DRAW_DISPLAY 0x0B
+#define SERIAL_LED_DRAW_ASSETS 0x0C
+
+// Reply status codes
+#define SERIAL_LED_STATUS_OK 0
+#define SERIAL_LED_STATUS_BAD_CRC 1
+#define SERIAL_LED_STATUS_BAD_LENGTH 2
+#define SERIAL_LED_STATUS_UNKNOWN_OPCODE 3
+#define SERIAL_LED_STATUS_BAD_PAYLOAD 4
+#define SERIAL_LED_STATUS_BAD_ASSET 5
+
+// Non-owning view of one token inside the line buffer
+struct ArgSpan {
+    const char* data;
+    uint16_t length;
+
+    bool empty() const;
+    bool equals(const char* word) const;       // Case-insensitive
+    bool startsWith(const char* prefix) const; // Case-insensitive
+};
+
+// Cursor over the arguments of one command line. Tokens are split in place
+// (the separator after each token is overwritten with '\0'), so every span
+// handed out is also a null-terminated string and nothing is copied.
+class ArgReader {
+private:
+    char* cursor;
+
+    void skipSpaces();
+
+public:
+    explicit ArgReader(char* args);
+
+    bool hasMore();
+    ArgSpan nextWord();
+    int nextInt();      // 0 when missing or not a number, like String::toInt()
+    float nextFloat();  // 0.0 when missing or not a number
+    ArgSpan rest();     // Everything left, e.g. free text at the end of a command
+};
 
 class SerialLedControl {
 private:
     LedScreen128_64* screen;
     Stream* serial;  // Use Stream base class for compatibility
-    String input_buffer;
+    char input_buffer[SERIAL_LED_LINE_BUFFER];
+    uint16_t input_length;
+    bool input_overflow;  // Line exceeded the buffer; rejected on newline
     bool echo_commands;
     
-    // Graphics assets storage
-    GraphicsAsset* assets[MAX_GRAPHICS_ASSETS];
-    int assetCount;
+    // Batch state: lines between 'begin' and 'commit' are stored back to back
+    // as null-terminated strings and run in one go at commit
+    char batch_buffer[SERIAL_LED_BATCH_BUFFER];
+    uint16_t batch_length;
+    uint16_t batch_count;
+    bool batch_open;
+    bool batch_overflow;   // A line did not fit; commit is refused
+    bool batch_running;    // Suppresses per-command OK and deferred flushes
+    uint16_t batch_failed;
+    uint16_t batch_first_failure;  // 1-based line of the first error
+    bool ack_enabled;      // 'ack 0' drops OK replies and prompts (errors still print)
+    
+    // Binary protocol state
+    bool binary_mode;
+    BinaryFrameDecoder frame_decoder;
     
-    // Command parsing
-    void processCommand(String command);
-    void parseAndExecute(String cmd, String args);
+    // Graphics assets: IDs are arena slot indices, reused after delete
+    AssetArena arena;
+    
+    // Command dispatch: one entry per command name and alias, sorted by name
+    typedef void (SerialLedControl::*CommandHandler)(ArgReader& args);
+    struct CommandEntry {
+        const char* name;
+        CommandHandler handler;
+    };
+    static const CommandEntry* findCommand(const char* name);
+
+    // Command parsing (tokenizes the line buffer in place)
+    void handleTextByte(char c);
+    void processCommand(char* line);
+    bool queueBatchLine(const char* line);
+    
+    // Binary protocol
+    void runBinary();
+    void processFrame(uint8_t opcode, const uint8_t* payload, uint16_t length);
+    void sendReply(uint8_t opcode, uint8_t status, const uint8_t* data = nullptr, uint8_t data_length = 0);
+    uint8_t handleBlitFrame(const uint8_t* payload, uint16_t length);
+    uint8_t handlePlotDataFrame(const uint8_t* payload, uint16_t length);
+    uint8_t handleTableRowFrame(const uint8_t* payload, uint16_t length);
+    uint8_t handleDrawListFrame(const uint8_t* payload, uint16_t length);
     
     // Command handlers
-    void handleClear();
-    void handleDisplay();
-    void handleText(String args);
-    void handleTextSize(String args);
-    void handleCursor(String args);
-    void handlePixel(String args);
-    void handleLine(String args);
-    void handleRect(String args);
-    void handleFillRect(String args);
-    void handleCircle(String args);
-    void handleFillCircle(String args);
-    void handleTriangle(String args);
-    void handleFillTriangle(String args);
-    void handleProgressBar(String args);
-    void handleInvert(String args);
-    void handleDim(String args);
-    void handleRotation(String args);
-    void handleScroll(String args);
-    void handleHelp();
+    void handleClear(ArgReader& args);
+    void handleDisplay(ArgReader& args);
+    void handleText(ArgReader& args);
+    void handleTextSize(ArgReader& args);
+    void handleCursor(ArgReader& args);
+    void handlePixel(ArgReader& args);
+    void handleLine(ArgReader& args);
+    void handleRect(ArgReader& args);
+    void handleFillRect(ArgReader& args);
+    void handleCircle(ArgReader& args);
+    void handleFillCircle(ArgReader& args);
+    void handleTriangle(ArgReader& args);
+    void handleFillTriangle(ArgReader& args);
+    void handleProgressBar(ArgReader& args);
+    void handleInvert(ArgReader& args);
+    void handleDim(ArgReader& args);
+    void handleRotation(ArgReader& args);
+    void handleScroll(ArgReader& args);
+    void handleHelp(ArgReader& args);
+    void handleBinaryMode(ArgReader& args);
+    void handleStats(ArgReader& args);
+    
+    // Batch and acknowledgement handlers
+    void handleBegin(ArgReader& args);
+    void handleCommit(ArgReader& args);
+    void handleAbort(ArgReader& args);
+    void handleAck(ArgReader& args);
     
     // Graphics asset command handlers
-    void handleCreateTextBox(String args);
-    void handleCreateDataPlot(String args);
-    void handleCreateTable(String args);
-    void handleCreateGeometry(String args);
-    void handleCreateBitmap(String args);
-    void handleSetCell(String args);
-    void handleAddPoint(String args);
-    void handleDrawAsset(String args);
-    void handleDrawAllAssets();
-    void handleListAssets();
-    void handleDeleteAsset(String args);
-    void handleDeleteAllAssets();
-    void handleSetAssetPos(String args);
-    void handleSetAssetSize(String args);
-    void handleSetAssetBorder(String args);
-    void handleSetAssetVisible(String args);
-    void handleSetText(String args);
-    void handleSetAnimate(String args);
-    void handleSetZIndex(String args);
-    void handleSetTextBoxSize(String args);
+    void handleCreateTextBox(ArgReader& args);
+    void handleCreateDataPlot(ArgReader& args);
+    void handleCreateTable(ArgReader& args);
+    void handleCreateGeometry(ArgReader& args);
+    void handleCreateBitmap(ArgReader& args);
+    void handleSetCell(ArgReader& args);
+    void handleAddPoint(ArgReader& args);
+    void handleDrawAsset(ArgReader& args);
+    void handleDrawAllAssets(ArgReader& args);
+    void handleListAssets(ArgReader& args);
+    void handleDeleteAsset(ArgReader& args);
+    void handleDeleteAllAssets(ArgReader& args);
+    void handleSetAssetPos(ArgReader& args);
+    void handleSetAssetSize(ArgReader& args);
+    void handleSetAssetBorder(ArgReader& args);
+    void handleSetAssetVisible(ArgReader& args);
+    void handleSetText(ArgReader& args);
+    void handleSetAnimate(ArgReader& args);
+    void handleSetZIndex(ArgReader& args);
+    void handleSetTextBoxSize(ArgReader& args);
     
     // Utility methods
+    GraphicsAsset* findAsset(int id) const;
+    bool echoing() const;
     void printPrompt();
     void printOk();
     void printError(const char* message);
-    int parseIntArg(String& args);
-    float parseFloatArg(String& args);
-    String parseStringArg(String& args);
     
 public:
     // Constructor
@@ -92,6 +210,10 @@ public:
     // Enable/disable command echo
     void setEcho(bool enable);
     
+    // Binary protocol mode (also entered with the 'binary' command)
+    void setBinaryMode(bool enable);
+    bool isBinaryMode() const;
+    
     // Get screen reference
     LedScreen128_64* getScreen();
 };
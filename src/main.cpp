@@ -10,14 +10,23 @@
 //   - Real-time temperature and humidity display
 //   - Live plotting of sensor data over time
 //   - Serial command interface
-//   - 1-second polling interval
+//   - 4 Hz oversampling through a SensorPipeline, plotted as 1-second means
+//   - Adaptive sampling: slower, lower-precision reads while conditions are stable
+//   - 1-minute means logged to LittleFS; after a reboot the plots show the
+//     logged minutes and continue with live 1-minute means
+//   - Fast boot: devices begun together, non-critical work after the first reading
 
 #include <Arduino.h>
 #include <Wire.h>
+#include <LittleFS.h>
 #include "SHT45HumidityTempSensor.hpp"
 #include "DeviceRegistry.hpp"
+#include "BusScheduler.hpp"
 #include "LedScreen128_64.hpp"
 #include "DataPlot.hpp"
+#include "SensorPipeline.hpp"
+#include "SampleLog.hpp"
+#include "Profiler.hpp"
 
 // Pin definitions for ESP32S3
 #define I2C_SDA 5  // Default SDA for Seeed XIAO ESP32S3
@@ -31,23 +40,43 @@ LedScreen128_64* display;
 DataPlot* tempPlot;
 DataPlot* humidityPlot;
 
-// Reading interval
-const unsigned long READ_INTERVAL = 1000;  // 1 second
-unsigned long lastReadTime = 0;
+// Sampling: 4 raw readings per plotted point, median-filtered against spikes
+const unsigned long SAMPLE_INTERVAL = 250;
+#define CHANNEL_TEMPERATURE 0
+#define CHANNEL_HUMIDITY 1
+SensorPipeline* sensorPipeline;
+MedianStage tempMedian(3);
+MedianStage humidityMedian(3);
 
-// Data buffers for plotting
+// Adaptive schedule: 250 ms at high precision while readings move, backing
+// off to 8 s at low precision once they settle
+AdaptiveSamplingPolicy samplingPolicy(SAMPLE_INTERVAL, 8000);
+#define TEMP_ESCALATE_RATE 0.2f       // °C per second
+#define TEMP_STABLE_RATE 0.1f
+#define HUMIDITY_ESCALATE_RATE 1.0f   // %RH per second
+#define HUMIDITY_STABLE_RATE 0.5f
+
+// Light sleep between samples (pauses USB serial, so off by default)
+#define USE_LIGHT_SLEEP 0
+
+// Plot history length (the plots keep their own ring buffers)
 #define MAX_DATA_POINTS 50
-float tempData[MAX_DATA_POINTS];
-float humData[MAX_DATA_POINTS];
-int dataIndex = 0;
-int dataCount = 0;
+
+// Persistent history: one SampleLog sample per 1-minute mean
+SampleLog sampleLog(2);
 
 // Function declarations
 void handleCommand(String command);
+void updateDisplay(float tempC, float humidity);
+void showSensorError();
+void printReading();
+bool readSht45(float* values, void* context);
+void printSerialNumber(void* context);
+void printHelp(void* context);
+void openHistoryLog(void* context);
 
 void setup() {
     Serial.begin(115200);
-    delay(100);
     
     Serial.println("\n========================================");
     Serial.println("  SHT45 Sensor Demo with Live Display");
@@ -55,25 +84,32 @@ void setup() {
     
     // Initialize I2C with custom pins
     Wire.begin(I2C_SDA, I2C_SCL);
-    delay(100);
     
-    // Create and initialize display
+    // Hand the bus to the scheduler task so sensor reads preempt display flushes
+    if (!BusScheduler::getInstance().begin()) {
+        Serial.println("Bus scheduler not started, using direct I2C");
+    }
+    
+    // Create the devices and let the registry bring them up together: the
+    // first SHT45 conversion runs while the display is initialized
     display = new LedScreen128_64(0x3C);
-    Serial.print("Initializing display... ");
-    if (!display->begin()) {
-        Serial.println("FAILED!");
+    tempSensor = new SHT45HumidityTempSensor();
+    DeviceRegistry& registry = DeviceRegistry::getInstance();
+    registry.registerDevice(tempSensor);
+    registry.registerDevice(display);
+    registry.beginAll();
+    Serial.print("Devices started in ");
+    Serial.print(registry.getBootTime() / 1000.0f, 1);
+    Serial.println(registry.isResumedFromSleep() ? " ms (resumed from deep sleep)" : " ms");
+    
+    if (!registry.isDeviceReady(display)) {
+        Serial.println("Display init FAILED!");
         Serial.println("Check display connections and restart.");
         while (1) delay(10);
     }
-    Serial.println("SUCCESS!");
-    
-    // Create sensor instance
-    tempSensor = new SHT45HumidityTempSensor();
     
-    // Initialize sensor
-    Serial.print("Initializing SHT45 sensor... ");
-    if (!tempSensor->begin()) {
-        Serial.println("FAILED!");
+    if (!registry.isDeviceReady(tempSensor)) {
+        Serial.println("SHT45 init FAILED!");
         Serial.println("Check sensor connections and restart.");
         
         // Display error on screen
@@ -87,29 +123,20 @@ void setup() {
         
         while (1) delay(10);
     }
-    Serial.println("SUCCESS!");
     
-    // Set high precision mode for best accuracy
-    tempSensor->setPrecision(SHT4X_HIGH_PRECISION);
-    Serial.println("Precision mode: HIGH");
-    
-    // Read and display sensor serial number
-    uint32_t serial = tempSensor->getSerialNumber();
-    Serial.print("Sensor Serial Number: 0x");
-    Serial.println(serial, HEX);
-    
-    // Register with DeviceRegistry
-    DeviceRegistry& registry = DeviceRegistry::getInstance();
-    if (registry.registerDevice(tempSensor)) {
-        Serial.println("Sensor registered with DeviceRegistry");
-    }
-    if (registry.registerDevice(display)) {
-        Serial.println("Display registered with DeviceRegistry");
+    // Flush frames from a background task so drawing overlaps the I2C transfer
+    if (!display->startFlushTask(2)) {
+        Serial.println("Flush task not started, flushing inline");
     }
     
+    // Not needed for the first reading, so they wait until it has been shown
+    registry.deferTask(printSerialNumber);
+    registry.deferTask(openHistoryLog);
+    registry.deferTask(printHelp);
+    
     // Create data plots
     // Temperature plot on left side
-    tempPlot = new DataPlot(0, 18, 64, 46, MAX_DATA_POINTS);
+    tempPlot = new DataPlot(0, 18, 64, 46, MAX_DATA_POINTS, true);
     tempPlot->setAutoScale(true);
     tempPlot->setShowAxes(true);
     tempPlot->setShowGrid(true);
@@ -120,7 +147,7 @@ void setup() {
     tempPlot->setPlotStyle(PlotStyle::LINES);
     
     // Humidity plot on right side
-    humidityPlot = new DataPlot(64, 18, 64, 46, MAX_DATA_POINTS);
+    humidityPlot = new DataPlot(64, 18, 64, 46, MAX_DATA_POINTS, true);
     humidityPlot->setYRange(0, 100);  // Fixed scale for humidity
     humidityPlot->setAutoScale(false);
     humidityPlot->setShowAxes(true);
@@ -131,119 +158,115 @@ void setup() {
     humidityPlot->setAxisLabelSize(1);
     humidityPlot->setPlotStyle(PlotStyle::LINES);
     
-    // Initialize data arrays
-    for (int i = 0; i < MAX_DATA_POINTS; i++) {
-        tempData[i] = 0.0f;
-        humData[i] = 0.0f;
-    }
+    // Sampler task feeds the pipeline; both plots receive the 1 s means
+    sensorPipeline = new SensorPipeline(2, readSht45);
+    sensorPipeline->addStage(CHANNEL_TEMPERATURE, &tempMedian);
+    sensorPipeline->addStage(CHANNEL_HUMIDITY, &humidityMedian);
+    sensorPipeline->bindPlot(CHANNEL_TEMPERATURE, SensorTier::SECOND, tempPlot);
+    sensorPipeline->bindPlot(CHANNEL_HUMIDITY, SensorTier::SECOND, humidityPlot);
+    samplingPolicy.setChannelThresholds(CHANNEL_TEMPERATURE, TEMP_ESCALATE_RATE, TEMP_STABLE_RATE);
+    samplingPolicy.setChannelThresholds(CHANNEL_HUMIDITY, HUMIDITY_ESCALATE_RATE, HUMIDITY_STABLE_RATE);
+    sensorPipeline->setAdaptivePolicy(&samplingPolicy);
+    sensorPipeline->begin(SAMPLE_INTERVAL);
     
-    // Display welcome message
+    // Title and the reading taken during boot until the first mean replaces them
     display->clearDisplay();
     display->setTextSize(1);
     display->setTextColor(true);
     display->setCursor(10, 10);
     display->println("SHT45 Sensor");
     display->setCursor(5, 25);
-    display->println("Initializing...");
+    display->print(tempSensor->getTemperature(), 1);
+    display->print("C  ");
+    display->print(tempSensor->getHumidity(), 1);
+    display->print("%");
     display->displayBuffer();
-    delay(1000);
-    
-    Serial.println("\nReading sensor data every second...");
+}
+
+// Deferred boot task: the sensor serial number
+void printSerialNumber(void* context) {
+    (void)context;
+    sensorPipeline->suspendSampling();
+    uint32_t serial = tempSensor->getSerialNumber();
+    sensorPipeline->resumeSampling();
+    Serial.print("Sensor Serial Number: 0x");
+    Serial.println(serial, HEX);
+}
+
+// Deferred boot task: mount the history log. Logged minutes only belong in a
+// plot of minute means, so when there are any the plots switch to the minute
+// tier and carry on from the log.
+void openHistoryLog(void* context) {
+    (void)context;
+    if (LittleFS.begin(true) && sampleLog.begin(LittleFS)) {
+        if (sampleLog.loadPlot(tempPlot, CHANNEL_TEMPERATURE, MAX_DATA_POINTS * 60) > 0) {
+            sampleLog.loadPlot(humidityPlot, CHANNEL_HUMIDITY, MAX_DATA_POINTS * 60);
+            sensorPipeline->unbindPlots(SensorTier::SECOND);
+            sensorPipeline->bindPlot(CHANNEL_TEMPERATURE, SensorTier::MINUTE, tempPlot);
+            sensorPipeline->bindPlot(CHANNEL_HUMIDITY, SensorTier::MINUTE, humidityPlot);
+        }
+        Serial.print("History log: ");
+        Serial.print(sampleLog.getStoredBlocks());
+        Serial.println(" blocks");
+    } else {
+        Serial.println("History log not available");
+    }
+}
+
+// Deferred boot task: the command list
+void printHelp(void* context) {
+    (void)context;
+    Serial.println("\nSampling at 4 Hz, reporting 1-second means...");
     Serial.println("Available commands:");
     Serial.println("  READ - Read current temperature and humidity");
     Serial.println("  SERIAL - Display sensor serial number");
     Serial.println("  RESET - Soft reset the sensor");
     Serial.println("  CELSIUS - Display temperature in Celsius");
     Serial.println("  FAHRENHEIT - Display temperature in Fahrenheit");
+    Serial.println("  ADAPTIVE - Toggle adaptive sampling");
+    Serial.println("  HISTORY - Show the stored history");
+    Serial.println("  STATS - Show timing, bus, queue and heap statistics");
     Serial.println("  HELP - Display available commands");
     Serial.println();
 }
 
 void loop() {
-    // Periodic sensor reading (every 1 second)
-    if (millis() - lastReadTime >= READ_INTERVAL) {
-        lastReadTime = millis();
+    // Drain the pipeline (and sample here when no sampler task is running)
+    sensorPipeline->run();
+    
+    // One plot point per completed 1-second bucket
+    if (sensorPipeline->takeTierUpdate(SensorTier::SECOND)) {
+        float tempC = 0.0f;
+        float humidity = 0.0f;
+        sensorPipeline->getTierValue(CHANNEL_TEMPERATURE, SensorTier::SECOND, tempC);
+        sensorPipeline->getTierValue(CHANNEL_HUMIDITY, SensorTier::SECOND, humidity);
+        updateDisplay(tempC, humidity);
         
-        if (tempSensor->readSensor()) {
-            float tempC = tempSensor->getTemperature();
-            float humidity = tempSensor->getHumidity();
-            
-            // Store data in circular buffer
-            tempData[dataIndex] = tempC;
-            humData[dataIndex] = humidity;
-            dataIndex = (dataIndex + 1) % MAX_DATA_POINTS;
-            if (dataCount < MAX_DATA_POINTS) {
-                dataCount++;
-            }
-            
-            // Update plots with all data points
-            tempPlot->clearData();
-            humidityPlot->clearData();
-            
-            for (int i = 0; i < dataCount; i++) {
-                int idx = (dataIndex - dataCount + i + MAX_DATA_POINTS) % MAX_DATA_POINTS;
-                tempPlot->addPoint((float)i, tempData[idx]);
-                humidityPlot->addPoint((float)i, humData[idx]);
-            }
-            
-            // Update display
-            display->clearDisplay();
-            
-            // Draw labels and current values
-            display->setTextSize(1);
-            display->setTextColor(true);
-            display->setCursor(2, 1);
-            display->print("T:");
-            display->setCursor(14, 1);
-            display->print(tempC, 1);
-            display->print("C");
-            
-            display->setCursor(68, 1);
-            display->print("H:");
-            display->setCursor(80, 1);
-            display->print(humidity, 1);
-            display->print("%");
-            
-            // Draw separator line
-            display->drawFastHLine(0, 16, 128, true);
-            
-            // Draw plots
-            tempPlot->draw(display);
-            humidityPlot->draw(display);
-            
-            // Draw plot labels and coordinate values (index, value), compact to avoid overlaps
-            display->setTextSize(1);
-            int lastIndex = (dataIndex - 1 + MAX_DATA_POINTS) % MAX_DATA_POINTS;
-            float lastTemp = tempData[lastIndex];
-            float lastHum = humData[lastIndex];
-            char leftLabel[20];
-            char rightLabel[20];
-            // Format: "T idx valC" and "H idx val%"
-            snprintf(leftLabel, sizeof(leftLabel), "T %d %.1fC", dataCount - 1, lastTemp);
-            snprintf(rightLabel, sizeof(rightLabel), "H %d %.1f%%", dataCount - 1, lastHum);
-            display->setCursor(2, 10);
-            display->print(leftLabel);
-            display->setCursor(68, 10);
-            display->print(rightLabel);
-            
-            display->displayBuffer();
-            
-            // Serial output
-            Serial.print("Temperature: ");
-            Serial.print(tempC, 2);
-            Serial.print(" °C, Humidity: ");
-            Serial.print(humidity, 2);
-            Serial.println(" %RH");
-        } else {
-            Serial.println("ERROR: Failed to read sensor!");
-            
-            // Display error on screen
-            display->clearDisplay();
-            display->setTextSize(1);
-            display->setCursor(10, 28);
-            display->println("Sensor Error!");
-            display->displayBuffer();
-        }
+        // Boot work that was held back until the first reading
+        DeviceRegistry::getInstance().runDeferredTasks();
+        
+        // Serial output
+        Serial.print("Temperature: ");
+        Serial.print(tempC, 2);
+        Serial.print(" °C, Humidity: ");
+        Serial.print(humidity, 2);
+        Serial.println(" %RH");
+    }
+    
+    // Log the 1-minute means (the log batches them into flash blocks)
+    if (sensorPipeline->takeTierUpdate(SensorTier::MINUTE) && sampleLog.isOpen()) {
+        float means[2] = {0.0f, 0.0f};
+        sensorPipeline->getTierValue(CHANNEL_TEMPERATURE, SensorTier::MINUTE, means[CHANNEL_TEMPERATURE]);
+        sensorPipeline->getTierValue(CHANNEL_HUMIDITY, SensorTier::MINUTE, means[CHANNEL_HUMIDITY]);
+        sampleLog.append(means);
+    }
+    
+    // Report sampling failures once per failed read
+    static uint32_t reportedFailures = 0;
+    if (sensorPipeline->getFailedCount() != reportedFailures) {
+        reportedFailures = sensorPipeline->getFailedCount();
+        Serial.println("ERROR: Failed to read sensor!");
+        showSensorError();
     }
     
     // Handle serial commands from host
@@ -254,33 +277,125 @@ void loop() {
         
         handleCommand(command);
     }
+    
+#if USE_LIGHT_SLEEP
+    // Nothing to do until the next sample is due
+    sensorPipeline->sleepUntilNextSample();
+#endif
+}
+
+// Pipeline source: one blocking SHT45 measurement (runs on the sampler task)
+bool readSht45(float* values, void* context) {
+    (void)context;
+    
+    // Conversion time follows the adaptive effort level
+    sht4x_precision_t precision = SHT4X_HIGH_PRECISION;
+    if (samplingPolicy.getEffort() == SamplingEffort::BALANCED) {
+        precision = SHT4X_MED_PRECISION;
+    } else if (samplingPolicy.getEffort() == SamplingEffort::ECONOMY) {
+        precision = SHT4X_LOW_PRECISION;
+    }
+    if (tempSensor->getPrecision() != precision) {
+        tempSensor->setPrecision(precision);
+    }
+    
+    if (!tempSensor->readSensor()) {
+        return false;
+    }
+    values[CHANNEL_TEMPERATURE] = tempSensor->getTemperature();
+    values[CHANNEL_HUMIDITY] = tempSensor->getHumidity();
+    return true;
+}
+
+void updateDisplay(float tempC, float humidity) {
+    // The pipeline has already appended these means to the bound plots
+    int dataCount = tempPlot->getDataSize();
+    
+    // Update display
+    display->clearDisplay();
+    
+    // Draw labels and current values
+    display->setTextSize(1);
+    display->setTextColor(true);
+    display->setCursor(2, 1);
+    display->print("T:");
+    display->setCursor(14, 1);
+    display->print(tempC, 1);
+    display->print("C");
+    
+    display->setCursor(68, 1);
+    display->print("H:");
+    display->setCursor(80, 1);
+    display->print(humidity, 1);
+    display->print("%");
+    
+    // Draw separator line
+    display->drawFastHLine(0, 16, 128, true);
+    
+    // Draw plots
+    tempPlot->draw(display);
+    humidityPlot->draw(display);
+    
+    // Draw plot labels and coordinate values (index, value), compact to avoid overlaps
+    display->setTextSize(1);
+    char leftLabel[20];
+    char rightLabel[20];
+    // Format: "T idx valC" and "H idx val%"
+    snprintf(leftLabel, sizeof(leftLabel), "T %d %.1fC", dataCount - 1, tempC);
+    snprintf(rightLabel, sizeof(rightLabel), "H %d %.1f%%", dataCount - 1, humidity);
+    display->setCursor(2, 10);
+    display->print(leftLabel);
+    display->setCursor(68, 10);
+    display->print(rightLabel);
+    
+    display->displayBuffer();
+}
+
+void showSensorError() {
+    // Display error on screen
+    display->clearDisplay();
+    display->setTextSize(1);
+    display->setCursor(10, 28);
+    display->println("Sensor Error!");
+    display->displayBuffer();
+}
+
+void printReading() {
+    // Newest filtered sample (at most one sample interval old)
+    float tempC = sensorPipeline->getLatest(CHANNEL_TEMPERATURE);
+    Serial.print("Temperature: ");
+    Serial.print(tempC, 2);
+    Serial.print(" °C (");
+    Serial.print(tempC * 9.0f / 5.0f + 32.0f, 2);
+    Serial.print(" °F), Humidity: ");
+    Serial.print(sensorPipeline->getLatest(CHANNEL_HUMIDITY), 2);
+    Serial.println(" %RH");
 }
 
 void handleCommand(String command) {
     if (command == "READ") {
-        // Read and display current values
-        if (tempSensor->readSensor()) {
-            Serial.print("Temperature: ");
-            Serial.print(tempSensor->getTemperature(), 2);
-            Serial.print(" °C (");
-            Serial.print(tempSensor->getTemperatureFahrenheit(), 2);
-            Serial.print(" °F), Humidity: ");
-            Serial.print(tempSensor->getHumidity(), 2);
-            Serial.println(" %RH");
+        if (sensorPipeline->hasData()) {
+            printReading();
         } else {
-            Serial.println("ERROR: Sensor read failed");
+            Serial.println("ERROR: No sensor data yet");
         }
     }
     else if (command == "SERIAL") {
-        // Display sensor serial number
+        // Display sensor serial number (sampler kept off the sensor meanwhile)
+        sensorPipeline->suspendSampling();
         uint32_t serial = tempSensor->getSerialNumber();
+        sensorPipeline->resumeSampling();
         Serial.print("Sensor Serial: 0x");
         Serial.println(serial, HEX);
     }
     else if (command == "RESET") {
         // Perform soft reset
         Serial.print("Resetting sensor... ");
-        if (tempSensor->softReset()) {
+        sensorPipeline->suspendSampling();
+        bool ok = tempSensor->softReset();
+        sensorPipeline->resumeSampling();
+        if (ok) {
+            sensorPipeline->resetStages();
             Serial.println("SUCCESS");
         } else {
             Serial.println("FAILED");
@@ -288,34 +403,57 @@ void handleCommand(String command) {
     }
     else if (command == "CELSIUS") {
         // Display temperature in Celsius
-        if (tempSensor->isDataValid()) {
+        if (sensorPipeline->hasData()) {
             Serial.print("Temperature: ");
-            Serial.print(tempSensor->getTemperature(), 2);
+            Serial.print(sensorPipeline->getLatest(CHANNEL_TEMPERATURE), 2);
             Serial.println(" °C");
         } else {
-            Serial.println("No valid data. Reading sensor...");
-            if (tempSensor->readSensor()) {
-                Serial.print("Temperature: ");
-                Serial.print(tempSensor->getTemperature(), 2);
-                Serial.println(" °C");
-            }
+            Serial.println("No valid data yet");
         }
     }
     else if (command == "FAHRENHEIT") {
         // Display temperature in Fahrenheit
-        if (tempSensor->isDataValid()) {
+        if (sensorPipeline->hasData()) {
             Serial.print("Temperature: ");
-            Serial.print(tempSensor->getTemperatureFahrenheit(), 2);
+            Serial.print(sensorPipeline->getLatest(CHANNEL_TEMPERATURE) * 9.0f / 5.0f + 32.0f, 2);
             Serial.println(" °F");
         } else {
-            Serial.println("No valid data. Reading sensor...");
-            if (tempSensor->readSensor()) {
-                Serial.print("Temperature: ");
-                Serial.print(tempSensor->getTemperatureFahrenheit(), 2);
-                Serial.println(" °F");
-            }
+            Serial.println("No valid data yet");
         }
     }
+    else if (command == "ADAPTIVE") {
+        samplingPolicy.setEnabled(!samplingPolicy.isEnabled());
+        Serial.print("Adaptive sampling: ");
+        Serial.println(samplingPolicy.isEnabled() ? "ON" : "OFF");
+        Serial.print("Sample period: ");
+        Serial.print(sensorPipeline->getSamplePeriod());
+        Serial.println(" ms");
+    }
+    else if (command == "HISTORY") {
+        uint32_t oldest = 0, newest = 0;
+        if (!sampleLog.getTimeSpan(oldest, newest)) {
+            Serial.println("No history stored");
+            return;
+        }
+        Serial.print("History: ");
+        Serial.print((newest - oldest) / 3600.0f, 1);
+        Serial.print(" h in ");
+        Serial.print(sampleLog.getStoredBlocks());
+        Serial.print(" of ");
+        Serial.print(sampleLog.getBlockCapacity());
+        Serial.println(" blocks");
+        float low, high;
+        if (sampleLog.getExtrema(newest >= 86400 ? newest - 86400 : 0, newest, CHANNEL_TEMPERATURE, low, high)) {
+            Serial.print("Last 24 h temperature: ");
+            Serial.print(low, 2);
+            Serial.print(" to ");
+            Serial.print(high, 2);
+            Serial.println(" °C");
+        }
+    }
+    else if (command == "STATS") {
+        Profiler::getInstance().printReport(Serial);
+    }
     else if (command == "HELP") {
         Serial.println("\nAvailable commands:");
         Serial.println("  READ - Read current temperature and humidity");
@@ -323,6 +461,9 @@ void handleCommand(String command) {
         Serial.println("  RESET - Soft reset the sensor");
         Serial.println("  CELSIUS - Display temperature in Celsius");
         Serial.println("  FAHRENHEIT - Display temperature in Fahrenheit");
+        Serial.println("  ADAPTIVE - Toggle adaptive sampling");
+        Serial.println("  HISTORY - Show the stored history");
+        Serial.println("  STATS - Show timing, bus, queue and heap statistics");
         Serial.println("  HELP - Display this help message");
     }
     else {
@@ -0,0 +1,26 @@
+#ifndef MOCK_DEVICE_HPP
+#define MOCK_DEVICE_HPP
+
+#include "Device.hpp"
+
+// Device that starts without probing the bus and counts the work the
+// registry hands it
+class MockDevice : public Device {
+private:
+    uint8_t begin_calls;
+
+public:
+    MockDevice(uint8_t address, TwoWire* wire = &Wire) : Device(address, wire), begin_calls(0) {
+        // Skip the frequency negotiation in Device::begin()
+        setKnownBusFrequency(400000);
+    }
+
+    bool begin() override {
+        begin_calls++;
+        return Device::begin();
+    }
+
+    uint8_t getBeginCalls() const { return begin_calls; }
+};
+
+#endif // MOCK_DEVICE_HPP
@@ -0,0 +1,226 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <vector>
+#include "../../src/demos/BinaryFrameCodec.hpp"
+
+// BinaryFrameDecoder over byte streams built with writeFrame(): every frame
+// that reaches READY is recorded, so each test checks exactly which frames
+// came through and which were dropped.
+
+struct DecodedFrame {
+    uint8_t opcode;
+    std::vector<uint8_t> payload;
+};
+
+// Print that collects what writeFrame() sends
+class ByteSink : public Print {
+public:
+    std::vector<uint8_t> bytes;
+
+    size_t write(uint8_t c) override {
+        bytes.push_back(c);
+        return 1;
+    }
+    using Print::write;
+};
+
+static BinaryFrameDecoder decoder;
+static ByteSink stream;
+static std::vector<DecodedFrame> frames;
+static uint32_t bad_crc;
+static uint32_t bad_length;
+
+void setUp(void) {
+    decoder = BinaryFrameDecoder();
+    stream.bytes.clear();
+    frames.clear();
+    bad_crc = 0;
+    bad_length = 0;
+}
+
+void tearDown(void) {
+    // Not needed
+}
+
+// Payload of frame n: its length is chosen by the caller, the bytes never
+// contain the sync byte so only the framing decides where frames start
+static std::vector<uint8_t> payloadFor(uint8_t n, uint16_t length) {
+    std::vector<uint8_t> payload(length);
+    for (uint16_t i = 0; i < length; i++) {
+        uint8_t value = (uint8_t)(n * 31 + i * 7);
+        payload[i] = value == BINARY_FRAME_SYNC ? 0 : value;
+    }
+    return payload;
+}
+
+static void writeFrame(uint8_t opcode, uint16_t length) {
+    std::vector<uint8_t> payload = payloadFor(opcode, length);
+    BinaryFrameDecoder::writeFrame(&stream, opcode, payload.data(), length);
+}
+
+static void writeNoise(const uint8_t* bytes, size_t count) {
+    stream.bytes.insert(stream.bytes.end(), bytes, bytes + count);
+}
+
+static void feedAll(void) {
+    for (uint8_t byte : stream.bytes) {
+        switch (decoder.feed(byte)) {
+            case FrameStatus::READY: {
+                DecodedFrame frame;
+                frame.opcode = decoder.getOpcode();
+                frame.payload.assign(decoder.getPayload(), decoder.getPayload() + decoder.getLength());
+                frames.push_back(frame);
+                break;
+            }
+            case FrameStatus::BAD_CRC:
+                bad_crc++;
+                break;
+            case FrameStatus::BAD_LENGTH:
+                bad_length++;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static void expectFrame(size_t index, uint8_t opcode, uint16_t length) {
+    TEST_ASSERT_TRUE(index < frames.size());
+    TEST_ASSERT_EQUAL(opcode, frames[index].opcode);
+    TEST_ASSERT_EQUAL(length, frames[index].payload.size());
+    std::vector<uint8_t> payload = payloadFor(opcode, length);
+    if (length > 0) {
+        TEST_ASSERT_EQUAL_MEMORY(payload.data(), frames[index].payload.data(), length);
+    }
+}
+
+void test_crc16_check_value(void) {
+    // The CRC-16/CCITT-FALSE check value, and chaining over a split input
+    const uint8_t text[] = "123456789";
+    TEST_ASSERT_EQUAL(0x29B1, BinaryFrameDecoder::crc16(text, 9));
+    TEST_ASSERT_EQUAL(0x29B1, BinaryFrameDecoder::crc16(text + 4, 5, BinaryFrameDecoder::crc16(text, 4)));
+}
+
+void test_valid_frames(void) {
+    writeFrame(1, 0);
+    writeFrame(2, 1);
+    writeFrame(3, 300);
+    writeFrame(4, BINARY_FRAME_MAX_PAYLOAD);
+    writeFrame(5, 4);
+    feedAll();
+
+    TEST_ASSERT_EQUAL(5, frames.size());
+    expectFrame(0, 1, 0);
+    expectFrame(1, 2, 1);
+    expectFrame(2, 3, 300);
+    expectFrame(3, 4, BINARY_FRAME_MAX_PAYLOAD);
+    expectFrame(4, 5, 4);
+    TEST_ASSERT_EQUAL(5, decoder.getFrameCount());
+    TEST_ASSERT_EQUAL(0, decoder.getErrorCount());
+}
+
+void test_corrupted_crc(void) {
+    writeFrame(1, 8);
+
+    // A flipped payload byte, then a flipped CRC byte
+    size_t start = stream.bytes.size();
+    writeFrame(2, 8);
+    stream.bytes[start + BINARY_FRAME_HEADER_SIZE + 3] ^= 0x01;
+    start = stream.bytes.size();
+    writeFrame(3, 8);
+    stream.bytes[start + BINARY_FRAME_HEADER_SIZE + 8 + 1] ^= 0x80;
+
+    writeFrame(4, 8);
+    feedAll();
+
+    TEST_ASSERT_EQUAL(2, frames.size());
+    expectFrame(0, 1, 8);
+    expectFrame(1, 4, 8);
+    TEST_ASSERT_EQUAL(2, bad_crc);
+    TEST_ASSERT_EQUAL(0, bad_length);
+    TEST_ASSERT_EQUAL(2, decoder.getFrameCount());
+    TEST_ASSERT_EQUAL(2, decoder.getErrorCount());
+}
+
+void test_oversize_length(void) {
+    writeFrame(1, 6);
+
+    // Refused as soon as the length is known; the body that follows is noise
+    // to the decoder until the next sync byte
+    size_t start = stream.bytes.size();
+    writeFrame(2, BINARY_FRAME_MAX_PAYLOAD + 1);
+    TEST_ASSERT_EQUAL(start + BINARY_FRAME_OVERHEAD + BINARY_FRAME_MAX_PAYLOAD + 1, stream.bytes.size());
+    for (size_t i = start + BINARY_FRAME_HEADER_SIZE; i < stream.bytes.size(); i++) {
+        TEST_ASSERT_TRUE(stream.bytes[i] != BINARY_FRAME_SYNC);
+    }
+    const uint8_t header[] = { BINARY_FRAME_SYNC, 3, 0xFF, 0xFF };
+    writeNoise(header, sizeof(header));
+
+    writeFrame(4, 6);
+    feedAll();
+
+    TEST_ASSERT_EQUAL(2, frames.size());
+    expectFrame(0, 1, 6);
+    expectFrame(1, 4, 6);
+    TEST_ASSERT_EQUAL(2, bad_length);
+    TEST_ASSERT_EQUAL(0, bad_crc);
+    TEST_ASSERT_EQUAL(2, decoder.getErrorCount());
+}
+
+void test_noise_between_frames(void) {
+    // Line noise without a sync byte is skipped while hunting
+    const uint8_t noise[] = { 0x00, 0xFF, 0x5A, 0x13, 0x37, 0xA4, 0xA6 };
+    writeNoise(noise, sizeof(noise));
+    writeFrame(1, 5);
+    writeNoise(noise, sizeof(noise));
+    writeNoise(noise, 3);
+    writeFrame(2, 0);
+    writeFrame(3, 12);
+    writeNoise(noise, 1);
+
+    // A stray sync byte starts a frame that fails its CRC, and consumes the
+    // bytes it claims; the decoder hunts again right after it
+    const uint8_t stray[] = { BINARY_FRAME_SYNC, 0x10, 0x02, 0x00, 0x11, 0x22, 0x33, 0x44 };
+    writeNoise(stray, sizeof(stray));
+    writeFrame(4, 3);
+    writeNoise(noise, sizeof(noise));
+    feedAll();
+
+    TEST_ASSERT_EQUAL(4, frames.size());
+    expectFrame(0, 1, 5);
+    expectFrame(1, 2, 0);
+    expectFrame(2, 3, 12);
+    expectFrame(3, 4, 3);
+    TEST_ASSERT_EQUAL(1, bad_crc);
+    TEST_ASSERT_EQUAL(0, bad_length);
+}
+
+void test_reset_drops_partial_frame(void) {
+    writeFrame(1, 20);
+    stream.bytes.resize(stream.bytes.size() - 5);
+    feedAll();
+    TEST_ASSERT_EQUAL(0, frames.size());
+
+    decoder.reset();
+    stream.bytes.clear();
+    writeFrame(2, 20);
+    feedAll();
+    TEST_ASSERT_EQUAL(1, frames.size());
+    expectFrame(0, 2, 20);
+    TEST_ASSERT_EQUAL(0, decoder.getErrorCount());
+}
+
+void setup() {
+    UNITY_BEGIN();
+    RUN_TEST(test_crc16_check_value);
+    RUN_TEST(test_valid_frames);
+    RUN_TEST(test_corrupted_crc);
+    RUN_TEST(test_oversize_length);
+    RUN_TEST(test_noise_between_frames);
+    RUN_TEST(test_reset_drops_partial_frame);
+    UNITY_END();
+}
+
+void loop() {
+    // Tests run once from setup()
+}
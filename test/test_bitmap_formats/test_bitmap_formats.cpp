@@ -0,0 +1,229 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <Wire.h>
+#include <Adafruit_SSD1306.h>
+#include "Bitmap.hpp"
+
+// The page layouts of Bitmap: rowMajorToPageNative() and encodeRle() must
+// round-trip row-major images, and blitting either page format must match
+// drawBitmap() on the row-major original, at any rotation and offset.
+
+#define BITMAP_TEST_IMAGES 200
+#define BITMAP_TEST_MAX_SIZE 72
+#define BITMAP_TEST_PAGES_SIZE (BITMAP_TEST_MAX_SIZE * ((BITMAP_TEST_MAX_SIZE + 7) / 8))
+#define BITMAP_TEST_ROWS_SIZE (BITMAP_TEST_MAX_SIZE * ((BITMAP_TEST_MAX_SIZE + 7) / 8))
+// Worst case: one control byte per BITMAP_RLE_MAX_PACKET literal bytes
+#define BITMAP_TEST_RLE_SIZE (BITMAP_TEST_PAGES_SIZE + BITMAP_TEST_PAGES_SIZE / BITMAP_RLE_MAX_PACKET + 1)
+
+static Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
+static uint8_t raster_buffer[SCREEN_WIDTH * SCREEN_PAGES] __attribute__((aligned(4)));
+static uint8_t initial_buffer[SCREEN_WIDTH * SCREEN_PAGES];
+static uint8_t rows[BITMAP_TEST_ROWS_SIZE];
+static uint8_t pages[BITMAP_TEST_PAGES_SIZE];
+static uint8_t encoded[BITMAP_TEST_RLE_SIZE];
+static uint8_t decoded[BITMAP_TEST_PAGES_SIZE];
+
+void setUp(void) {
+    // Not needed
+}
+
+void tearDown(void) {
+    // Not needed
+}
+
+// Random row-major image with solid stretches so RLE sees runs as well as
+// literals; the padding bits past the width stay clear
+static void randomImage(int16_t w, int16_t h) {
+    int16_t byteWidth = (w + 7) / 8;
+    uint8_t fill = 0;
+    for (int16_t row = 0; row < h; row++) {
+        if (random(4) == 0) {
+            fill = random(2) != 0 ? 0xFF : 0x00;
+        }
+        bool solid = random(3) != 0;
+        for (int16_t b = 0; b < byteWidth; b++) {
+            uint8_t value = solid ? fill : (uint8_t)random(256);
+            if (b == byteWidth - 1 && (w & 7) != 0) {
+                value &= (uint8_t)(0xFF << (8 - (w & 7)));
+            }
+            rows[row * byteWidth + b] = value;
+        }
+    }
+}
+
+static bool rowPixel(const uint8_t* data, int16_t w, int16_t x, int16_t y) {
+    return (data[y * ((w + 7) / 8) + (x >> 3)] & (0x80 >> (x & 7))) != 0;
+}
+
+static bool pagePixel(const uint8_t* data, int16_t w, int16_t x, int16_t y) {
+    return (data[(y >> 3) * w + x] & (1 << (y & 7))) != 0;
+}
+
+// Inverse of rowMajorToPageNative(), one pixel at a time
+static void pageNativeToRowMajor(const uint8_t* data, int16_t w, int16_t h, uint8_t* out) {
+    int16_t byteWidth = (w + 7) / 8;
+    memset(out, 0, (size_t)byteWidth * h);
+    for (int16_t y = 0; y < h; y++) {
+        for (int16_t x = 0; x < w; x++) {
+            if (pagePixel(data, w, x, y)) {
+                out[y * byteWidth + (x >> 3)] |= 0x80 >> (x & 7);
+            }
+        }
+    }
+}
+
+void test_begin_allocates_buffer(void) {
+    TEST_ASSERT_TRUE(display.begin(SSD1306_SWITCHCAPVCC, 0x3C));
+    TEST_ASSERT_NOT_NULL(display.getBuffer());
+}
+
+void test_page_native_round_trip(void) {
+    static uint8_t back[BITMAP_TEST_ROWS_SIZE];
+    randomSeed(2000);
+    for (uint32_t n = 0; n < BITMAP_TEST_IMAGES; n++) {
+        int16_t w = (int16_t)random(1, BITMAP_TEST_MAX_SIZE + 1);
+        int16_t h = (int16_t)random(1, BITMAP_TEST_MAX_SIZE + 1);
+        randomImage(w, h);
+
+        // The padding bits of the last page are cleared, not left over
+        memset(pages, 0xA5, sizeof(pages));
+        Bitmap::rowMajorToPageNative(rows, w, h, pages);
+        for (int16_t y = 0; y < h; y++) {
+            for (int16_t x = 0; x < w; x++) {
+                TEST_ASSERT_EQUAL(rowPixel(rows, w, x, y), pagePixel(pages, w, x, y));
+            }
+        }
+        for (int16_t y = h; y < ((h + 7) & ~7); y++) {
+            for (int16_t x = 0; x < w; x++) {
+                TEST_ASSERT_FALSE(pagePixel(pages, w, x, y));
+            }
+        }
+
+        pageNativeToRowMajor(pages, w, h, back);
+        TEST_ASSERT_EQUAL_MEMORY(rows, back, (size_t)((w + 7) / 8) * h);
+    }
+}
+
+static void check_rle(const uint8_t* data, size_t length) {
+    size_t size = Bitmap::encodeRle(data, length);
+    TEST_ASSERT_TRUE(size <= BITMAP_TEST_RLE_SIZE);
+    // Too small a buffer is refused without overrunning it
+    if (size > 0) {
+        memset(encoded, 0xEE, sizeof(encoded));
+        TEST_ASSERT_EQUAL(0, Bitmap::encodeRle(data, length, encoded, size - 1));
+        TEST_ASSERT_EQUAL(0xEE, encoded[size - 1]);
+    }
+    TEST_ASSERT_EQUAL(size, Bitmap::encodeRle(data, length, encoded, size));
+
+    BitmapRleReader reader(encoded);
+    for (size_t i = 0; i < length; i++) {
+        decoded[i] = reader.next();
+    }
+    TEST_ASSERT_EQUAL_MEMORY(data, decoded, length);
+}
+
+void test_rle_round_trip(void) {
+    randomSeed(2001);
+    for (uint32_t n = 0; n < BITMAP_TEST_IMAGES; n++) {
+        int16_t w = (int16_t)random(1, BITMAP_TEST_MAX_SIZE + 1);
+        int16_t h = (int16_t)random(1, BITMAP_TEST_MAX_SIZE + 1);
+        randomImage(w, h);
+        Bitmap::rowMajorToPageNative(rows, w, h, pages);
+        check_rle(pages, Bitmap::pageNativeSize(w, h));
+    }
+
+    // Packet limits: runs and literal stretches longer than one packet, and
+    // runs of two that stay literal
+    size_t length = BITMAP_TEST_PAGES_SIZE;
+    memset(pages, 0x3C, length);
+    check_rle(pages, length);
+    TEST_ASSERT_EQUAL(2 * ((length + BITMAP_RLE_MAX_PACKET - 1) / BITMAP_RLE_MAX_PACKET),
+                      Bitmap::encodeRle(pages, length));
+    for (size_t i = 0; i < length; i++) {
+        pages[i] = (uint8_t)i;
+    }
+    check_rle(pages, length);
+    for (size_t i = 0; i < length; i++) {
+        pages[i] = (uint8_t)(i / 2);
+    }
+    check_rle(pages, length);
+    TEST_ASSERT_EQUAL(length + (length + BITMAP_RLE_MAX_PACKET - 1) / BITMAP_RLE_MAX_PACKET,
+                      Bitmap::encodeRle(pages, length));
+    check_rle(pages, 1);
+    check_rle(pages, 2);
+    TEST_ASSERT_EQUAL(0, Bitmap::encodeRle(pages, 0));
+}
+
+// Blit the page-native and RLE copies of the current image with FrameRaster
+// and draw the row-major original with drawBitmap(), from the same contents
+template <uint8_t Rotation>
+static void check_blit(int16_t x, int16_t y, int16_t w, int16_t h, bool white) {
+    Bitmap::rowMajorToPageNative(rows, w, h, pages);
+    size_t size = Bitmap::encodeRle(pages, Bitmap::pageNativeSize(w, h), encoded, sizeof(encoded));
+    TEST_ASSERT_TRUE(size > 0);
+
+    uint8_t* gfx_buffer = display.getBuffer();
+    for (size_t i = 0; i < sizeof(raster_buffer); i++) {
+        initial_buffer[i] = (uint8_t)random(256);
+    }
+    memcpy(gfx_buffer, initial_buffer, sizeof(initial_buffer));
+    display.drawBitmap(x, y, rows, w, h, white ? SSD1306_WHITE : SSD1306_BLACK);
+
+    char message[64];
+    snprintf(message, sizeof(message), "rotation %u at %d,%d size %dx%d", Rotation, x, y, w, h);
+    FrameRaster<Rotation> raster(raster_buffer);
+    memcpy(raster_buffer, initial_buffer, sizeof(initial_buffer));
+    raster.pageBitmap(x, y, pages, w, h, white);
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(gfx_buffer, raster_buffer, sizeof(raster_buffer), message);
+
+    memcpy(raster_buffer, initial_buffer, sizeof(initial_buffer));
+    BitmapRleReader reader(encoded);
+    raster.pageBitmapFrom(x, y, reader, w, h, white);
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(gfx_buffer, raster_buffer, sizeof(raster_buffer), message);
+}
+
+template <uint8_t Rotation>
+static void check_rotation(void) {
+    display.setRotation(Rotation);
+    randomSeed(2100 + Rotation);
+
+    // Aligned, unaligned y (above the top edge too), and clipped at the right
+    // and bottom edges of the rotated screen
+    int16_t right = Rotation & 1 ? SCREEN_HEIGHT : SCREEN_WIDTH;
+    int16_t bottom = Rotation & 1 ? SCREEN_WIDTH : SCREEN_HEIGHT;
+    static const int16_t sizes[][2] = { { 8, 8 }, { 13, 21 }, { 40, 5 }, { 72, 70 } };
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        int16_t w = sizes[s][0], h = sizes[s][1];
+        randomImage(w, h);
+        const int16_t positions[][2] = {
+            { 0, 0 }, { 3, 8 }, { 5, 3 }, { 17, 13 }, { -6, -5 }, { 2, -11 },
+            { (int16_t)(right - w / 2), 9 }, { 4, (int16_t)(bottom - h / 2 - 3) },
+            { (int16_t)(right - 3), (int16_t)(bottom - 5) }
+        };
+        for (size_t p = 0; p < sizeof(positions) / sizeof(positions[0]); p++) {
+            check_blit<Rotation>(positions[p][0], positions[p][1], w, h, true);
+            check_blit<Rotation>(positions[p][0], positions[p][1], w, h, false);
+        }
+    }
+}
+
+void test_blit_rotation_0(void) { check_rotation<0>(); }
+void test_blit_rotation_1(void) { check_rotation<1>(); }
+void test_blit_rotation_2(void) { check_rotation<2>(); }
+void test_blit_rotation_3(void) { check_rotation<3>(); }
+
+void setup() {
+    UNITY_BEGIN();
+    RUN_TEST(test_begin_allocates_buffer);
+    RUN_TEST(test_page_native_round_trip);
+    RUN_TEST(test_rle_round_trip);
+    RUN_TEST(test_blit_rotation_0);
+    RUN_TEST(test_blit_rotation_1);
+    RUN_TEST(test_blit_rotation_2);
+    RUN_TEST(test_blit_rotation_3);
+    UNITY_END();
+}
+
+void loop() {
+    // Tests run once from setup()
+}
@@ -1,5 +1,6 @@
 #include <Arduino.h>
 #include <unity.h>
+#include <MockCounters.h>
 #include "DeviceRegistry.hpp"
 #include "mocks/MockDevice.hpp"
 
@@ -37,9 +38,108 @@ void test_register_unregister_devices(void) {
     TEST_ASSERT_EQUAL(0, registry.getDeviceCount());
 }
 
+void test_address_lookup_and_duplicates(void) {
+    DeviceRegistry& registry = DeviceRegistry::getInstance();
+
+    // Ensure registry is empty to start
+    while (registry.getDeviceCount() > 0) {
+        registry.unregisterDevice(registry.getDevice(0));
+    }
+
+    MockDevice d1(0x12);
+    MockDevice duplicate(0x12);
+    Device other_bus(0x12, &Wire1);
+
+    TEST_ASSERT_TRUE(registry.registerDevice(&d1));
+    TEST_ASSERT_FALSE(registry.registerDevice(&duplicate));
+    TEST_ASSERT_TRUE(registry.registerDevice(&other_bus));
+    TEST_ASSERT_EQUAL(2, registry.getDeviceCount());
+
+    TEST_ASSERT_EQUAL_PTR(&d1, registry.getDeviceByAddress(0x12));
+    TEST_ASSERT_EQUAL_PTR(&d1, registry.getDeviceByAddress(0x12, &Wire));
+    TEST_ASSERT_EQUAL_PTR(&other_bus, registry.getDeviceByAddress(0x12, &Wire1));
+    TEST_ASSERT_NULL(registry.getDeviceByAddress(0x13));
+
+    // Address becomes free again once unregistered
+    TEST_ASSERT_TRUE(registry.unregisterDevice(&d1));
+    TEST_ASSERT_EQUAL_PTR(&other_bus, registry.getDeviceByAddress(0x12));
+    TEST_ASSERT_TRUE(registry.registerDevice(&duplicate));
+
+    TEST_ASSERT_TRUE(registry.unregisterDevice(&duplicate));
+    TEST_ASSERT_TRUE(registry.unregisterDevice(&other_bus));
+    TEST_ASSERT_EQUAL(0, registry.getDeviceCount());
+}
+
+static int deferred_sum = 0;
+
+static void addToSum(void* context) {
+    deferred_sum += *static_cast<int*>(context);
+}
+
+void test_deferred_tasks(void) {
+    DeviceRegistry& registry = DeviceRegistry::getInstance();
+    registry.runDeferredTasks();
+    deferred_sum = 0;
+
+    int one = 1;
+    int ten = 10;
+    TEST_ASSERT_TRUE(registry.deferTask(addToSum, &one));
+    TEST_ASSERT_TRUE(registry.deferTask(addToSum, &ten));
+    TEST_ASSERT_FALSE(registry.deferTask(nullptr));
+    TEST_ASSERT_EQUAL(2, registry.getDeferredTaskCount());
+    TEST_ASSERT_EQUAL(0, deferred_sum);
+
+    // Tasks run once, then the list is empty
+    TEST_ASSERT_EQUAL(2, registry.runDeferredTasks());
+    TEST_ASSERT_EQUAL(11, deferred_sum);
+    TEST_ASSERT_EQUAL(0, registry.getDeferredTaskCount());
+    TEST_ASSERT_EQUAL(0, registry.runDeferredTasks());
+
+    for (int i = 0; i < DEVICE_REGISTRY_MAX_DEFERRED; i++) {
+        TEST_ASSERT_TRUE(registry.deferTask(addToSum, &one));
+    }
+    TEST_ASSERT_FALSE(registry.deferTask(addToSum, &one));
+    registry.runDeferredTasks();
+}
+
+void test_begin_all_probes_once(void) {
+    DeviceRegistry& registry = DeviceRegistry::getInstance();
+    while (registry.getDeviceCount() > 0) {
+        registry.unregisterDevice(registry.getDevice(0));
+    }
+
+    // Cold boot: both devices have to be negotiated at Standard-mode
+    MockDevice present(0x20);
+    MockDevice missing(0x21);
+    present.setKnownBusFrequency(0);
+    missing.setKnownBusFrequency(0);
+    setMockDevicePresent(0x21, false);
+    TEST_ASSERT_TRUE(registry.registerDevice(&present));
+    TEST_ASSERT_TRUE(registry.registerDevice(&missing));
+
+    resetMockCounters();
+    TEST_ASSERT_EQUAL(1, registry.beginAll());
+    TEST_ASSERT_TRUE(registry.isDeviceReady(&present));
+    TEST_ASSERT_FALSE(registry.isDeviceReady(&missing));
+    TEST_ASSERT_EQUAL(1, present.getBeginCalls());
+    TEST_ASSERT_EQUAL(0, missing.getBeginCalls());
+
+    // One negotiation for the device that answers, one probe for the other;
+    // begin() adopts the negotiated rate without probing again
+    TEST_ASSERT_EQUAL(BUS_CLOCK_PROBE_COUNT + 1, mock_counters.i2c_transactions);
+    TEST_ASSERT_EQUAL(I2C_STANDARD_CLOCK, present.getMaxBusFrequency());
+
+    setMockDevicePresent(0x21, true);
+    TEST_ASSERT_TRUE(registry.unregisterDevice(&present));
+    TEST_ASSERT_TRUE(registry.unregisterDevice(&missing));
+}
+
 void setup() {
     UNITY_BEGIN();
     RUN_TEST(test_register_unregister_devices);
+    RUN_TEST(test_address_lookup_and_duplicates);
+    RUN_TEST(test_deferred_tasks);
+    RUN_TEST(test_begin_all_probes_once);
     UNITY_END();
 }
 
@@ -0,0 +1,130 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <Wire.h>
+#include <Adafruit_SSD1306.h>
+#include "FrameRaster.hpp"
+
+// Every FrameRaster primitive against Adafruit_SSD1306 drawing the same
+// shape into its own buffer. Needs no panel: begin() only allocates the
+// buffer when nothing acknowledges on the bus.
+
+#define RASTER_TEST_SHAPES 2000
+#define RASTER_TEST_KINDS 13
+
+static Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
+static uint8_t raster_buffer[SCREEN_WIDTH * SCREEN_PAGES] __attribute__((aligned(4)));
+static uint8_t bitmap_data[64 * 8];
+
+void setUp(void) {
+    // Not needed
+}
+
+void tearDown(void) {
+    // Not needed
+}
+
+static int16_t coord(bool on_screen) {
+    return on_screen ? (int16_t)random(0, 64) : (int16_t)random(-40, 170);
+}
+
+// Draw shape n with both renderers, starting from the same random contents
+template <uint8_t Rotation>
+static void draw_shape(FrameRaster<Rotation>& raster, uint32_t n) {
+    uint8_t* gfx_buffer = display.getBuffer();
+    for (size_t i = 0; i < sizeof(raster_buffer); i++) {
+        gfx_buffer[i] = raster_buffer[i] = (uint8_t)random(256);
+    }
+
+    bool on_screen = (n % 3) == 0;
+    int16_t x0 = coord(on_screen), y0 = coord(on_screen);
+    int16_t x1 = coord(on_screen), y1 = coord(on_screen);
+    int16_t x2 = coord(on_screen), y2 = coord(on_screen);
+    int16_t w = (int16_t)random(-4, 140), h = (int16_t)random(-4, 140);
+    int16_t r = (int16_t)random(0, 40);
+    bool white = random(2) != 0;
+    uint16_t color = white ? SSD1306_WHITE : SSD1306_BLACK;
+
+    switch (n % RASTER_TEST_KINDS) {
+        case 0: raster.pixel(x0, y0, white); display.drawPixel(x0, y0, color); break;
+        case 1: raster.fillRect(x0, y0, w, h, white); display.fillRect(x0, y0, w, h, color); break;
+        case 2: raster.hline(x0, y0, w, white); display.drawFastHLine(x0, y0, w, color); break;
+        case 3: raster.vline(x0, y0, h, white); display.drawFastVLine(x0, y0, h, color); break;
+        case 4: raster.drawRect(x0, y0, w, h, white); display.drawRect(x0, y0, w, h, color); break;
+        case 5: raster.line(x0, y0, x1, y1, white); display.drawLine(x0, y0, x1, y1, color); break;
+        case 6: raster.drawCircle(x0, y0, r, white); display.drawCircle(x0, y0, r, color); break;
+        case 7: raster.fillCircle(x0, y0, r, white); display.fillCircle(x0, y0, r, color); break;
+        case 8: raster.drawRoundRect(x0, y0, w, h, r, white); display.drawRoundRect(x0, y0, w, h, r, color); break;
+        case 9: raster.fillRoundRect(x0, y0, w, h, r, white); display.fillRoundRect(x0, y0, w, h, r, color); break;
+        case 10:
+            raster.fillTriangle(x0, y0, x1, y1, x2, y2, white);
+            display.fillTriangle(x0, y0, x1, y1, x2, y2, color);
+            break;
+        case 11: {
+            for (size_t i = 0; i < sizeof(bitmap_data); i++) {
+                bitmap_data[i] = (uint8_t)random(256);
+            }
+            int16_t bw = (int16_t)random(1, 64), bh = (int16_t)random(1, 64);
+            raster.bitmap(x0, y0, bitmap_data, bw, bh, white);
+            display.drawBitmap(x0, y0, bitmap_data, bw, bh, color);
+            break;
+        }
+        default: {
+            // Page-native layout, against one drawPixel() per set bit
+            for (size_t i = 0; i < sizeof(bitmap_data); i++) {
+                bitmap_data[i] = (uint8_t)random(256);
+            }
+            int16_t bw = (int16_t)random(1, 64), bh = (int16_t)random(1, 64);
+            if (on_screen) {
+                y0 &= ~7;
+            }
+            raster.pageBitmap(x0, y0, bitmap_data, bw, bh, white);
+            for (int16_t j = 0; j < bh; j++) {
+                for (int16_t i = 0; i < bw; i++) {
+                    if (bitmap_data[(j >> 3) * bw + i] & (1 << (j & 7))) {
+                        display.drawPixel(x0 + i, y0 + j, color);
+                    }
+                }
+            }
+            break;
+        }
+    }
+}
+
+template <uint8_t Rotation>
+static void check_rotation(void) {
+    display.setRotation(Rotation);
+    FrameRaster<Rotation> raster(raster_buffer);
+    randomSeed(1000 + Rotation);
+    for (uint32_t n = 0; n < RASTER_TEST_SHAPES; n++) {
+        draw_shape(raster, n);
+        if (memcmp(raster_buffer, display.getBuffer(), sizeof(raster_buffer)) != 0) {
+            char message[48];
+            snprintf(message, sizeof(message), "shape %lu (kind %lu) differs", (unsigned long)n, (unsigned long)(n % RASTER_TEST_KINDS));
+            TEST_FAIL_MESSAGE(message);
+        }
+    }
+}
+
+void test_begin_allocates_buffer(void) {
+    TEST_ASSERT_TRUE(display.begin(SSD1306_SWITCHCAPVCC, 0x3C));
+    TEST_ASSERT_NOT_NULL(display.getBuffer());
+}
+
+void test_rotation_0(void) { check_rotation<0>(); }
+void test_rotation_1(void) { check_rotation<1>(); }
+void test_rotation_2(void) { check_rotation<2>(); }
+void test_rotation_3(void) { check_rotation<3>(); }
+
+void setup() {
+    UNITY_BEGIN();
+    RUN_TEST(test_begin_allocates_buffer);
+    RUN_TEST(test_rotation_0);
+    RUN_TEST(test_rotation_1);
+    RUN_TEST(test_rotation_2);
+    RUN_TEST(test_rotation_3);
+    UNITY_END();
+}
+
+void loop() {
+    // No continuous loop needed for unit tests
+}
@@ -0,0 +1,419 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <MockCounters.h>
+#include <chrono>
+#include "LedScreen128_64.hpp"
+#include "DataPlot.hpp"
+#include "FunctionPlot.hpp"
+#include "TextBox.hpp"
+#include "Table.hpp"
+#include "Geometry.hpp"
+#include "DeviceRegistry.hpp"
+#include "../../src/demos/SerialLedControl.hpp"
+#include "../mocks/MockDevice.hpp"
+
+// Hot-path benchmarks on the native mocks. Every benchmark prints one line
+//
+//   BENCH {"name":"...","iterations":N,"ns_per_op":T,"allocs_per_op":A,
+//          "i2c_bytes_per_op":B,"pixels_per_op":P}
+//
+// to stdout and to bench_output.txt (BENCH_OUTPUT overrides the path).
+// Bus bytes, pixel writes and allocations do not depend on the host, so
+// they are held to the budgets below. Time is only compared when
+// BENCH_BASELINE names the output of an earlier run: a benchmark fails when
+// it is slower than BENCH_TOLERANCE (default 1.25) times its baseline.
+
+#define BENCH_DEFAULT_OUTPUT "bench_output.txt"
+#define BENCH_DEFAULT_TOLERANCE 1.25
+#define BENCH_BATCHES 5  // Time is the fastest batch; counters cover all of them
+
+// Per-operation ceilings; a negative value leaves that counter unchecked.
+// Budgets are the measured counts plus about 5%: lower them when an
+// optimization lands, raise them only with a reason in the commit.
+struct BenchBudget {
+    double allocs;
+    double i2c_bytes;
+    double pixels;
+};
+
+// Per-operation figures of one benchmark run
+struct BenchResult {
+    double ns;
+    double allocs;
+    double i2c_bytes;
+    double pixels;
+};
+
+static LedScreen128_64 screen;
+static FILE* bench_output = nullptr;
+static double bench_tolerance = BENCH_DEFAULT_TOLERANCE;
+
+void setUp(void) {
+    // Not needed
+}
+
+void tearDown(void) {
+    // Not needed
+}
+
+// ns_per_op of a benchmark in the baseline file, or 0 if it has none
+static double baselineTime(const char* name) {
+    const char* path = getenv("BENCH_BASELINE");
+    FILE* file = path != nullptr ? fopen(path, "r") : nullptr;
+    if (file == nullptr) {
+        return 0.0;
+    }
+
+    char key[96];
+    snprintf(key, sizeof(key), "\"name\":\"%s\"", name);
+    char line[512];
+    double result = 0.0;
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        const char* field = strstr(line, "\"ns_per_op\":");
+        if (strstr(line, key) != nullptr && field != nullptr) {
+            result = atof(field + strlen("\"ns_per_op\":"));
+        }
+    }
+    fclose(file);
+    return result;
+}
+
+static void checkBudget(const char* name, const char* counter, double value, double budget) {
+    if (budget < 0.0) {
+        return;
+    }
+    char message[160];
+    snprintf(message, sizeof(message), "%s: %.2f %s per op, budget %.2f", name, value, counter, budget);
+    TEST_ASSERT_TRUE_MESSAGE(value <= budget, message);
+}
+
+// Run op once to warm caches, then calls times in BENCH_BATCHES batches
+// under the counters. Results are per operation; one call of op may perform
+// several (ops_per_call).
+template <typename Op>
+static BenchResult bench(const char* name, uint32_t calls, const BenchBudget& budget, Op op,
+                  uint32_t ops_per_call = 1) {
+    op();
+
+    uint32_t batch_calls = (calls + BENCH_BATCHES - 1) / BENCH_BATCHES;
+    double best_ns = 0.0;
+    resetMockCounters();
+    for (int batch = 0; batch < BENCH_BATCHES; batch++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < batch_calls; i++) {
+            op();
+        }
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        double batch_ns = std::chrono::duration<double, std::nano>(end - start).count();
+        if (batch == 0 || batch_ns < best_ns) {
+            best_ns = batch_ns;
+        }
+    }
+    MockCounters counters = mock_counters;
+
+    uint32_t iterations = batch_calls * BENCH_BATCHES * ops_per_call;
+    double ns = best_ns / ((double)batch_calls * ops_per_call);
+    double allocs = (double)counters.allocations / iterations;
+    double bytes = (double)counters.i2c_bytes_written / iterations;
+    double pixels = (double)counters.pixel_writes / iterations;
+
+    char line[384];
+    snprintf(line, sizeof(line),
+             "{\"name\":\"%s\",\"iterations\":%lu,\"ns_per_op\":%.1f,\"allocs_per_op\":%.2f,"
+             "\"i2c_bytes_per_op\":%.1f,\"pixels_per_op\":%.1f}",
+             name, (unsigned long)iterations, ns, allocs, bytes, pixels);
+    printf("BENCH %s\n", line);
+    if (bench_output != nullptr) {
+        fprintf(bench_output, "%s\n", line);
+        fflush(bench_output);
+    }
+
+    checkBudget(name, "allocations", allocs, budget.allocs);
+    checkBudget(name, "I2C bytes", bytes, budget.i2c_bytes);
+    checkBudget(name, "pixel writes", pixels, budget.pixels);
+
+    double baseline = baselineTime(name);
+    if (baseline > 0.0) {
+        char message[160];
+        snprintf(message, sizeof(message), "%s: %.1f ns per op, baseline %.1f ns", name, ns, baseline);
+        TEST_ASSERT_TRUE_MESSAGE(ns <= baseline * bench_tolerance, message);
+    }
+    return { ns, allocs, bytes, pixels };
+}
+
+static float wave(float x) {
+    return sinf(x) * 0.8f + sinf(x * 3.1f) * 0.2f;
+}
+
+static void fillPlot(DataPlot& plot, int count) {
+    for (int i = 0; i < count; i++) {
+        plot.addValue(20.0f + 5.0f * wave(i * 0.05f));
+    }
+}
+
+// DataPlot::draw() with a full buffer at several capacities
+void test_dataplot_draw(void) {
+    static const struct {
+        int capacity;
+        double pixels;
+    } cases[] = { { 16, 850 }, { 64, 915 }, { 256, 1080 }, { 1024, 1560 } };
+    for (const auto& entry : cases) {
+        int capacity = entry.capacity;
+        DataPlot plot(0, 0, 128, 64, capacity, true);
+        plot.setShowAxisLabels(true);
+        fillPlot(plot, capacity);
+
+        char name[32];
+        snprintf(name, sizeof(name), "dataplot_draw_%d", capacity);
+        bench(name, 2000, { 0, 0, entry.pixels }, [&]() {
+            plot.draw(&screen);
+        });
+    }
+}
+
+// FunctionPlot::draw() sampling one function per column
+void test_functionplot_draw(void) {
+    FunctionPlot plot(0, 0, 128, 64, wave);
+    plot.setXRange(-6.0f, 6.0f);
+    plot.setShowGrid(true);
+    plot.setShowAxisLabels(true);
+
+    bench("functionplot_draw", 2000, { 0, 0, 1600 }, [&]() {
+        plot.draw(&screen);
+    });
+}
+
+// TextBox word wrapping: the text changes every draw, so the layout is redone
+void test_textbox_wrap(void) {
+    static const char* const texts[] = {
+        "The quick brown fox jumps over the lazy dog while the display keeps refreshing",
+        "Humidity 45.2 %RH, temperature 21.5 C, dew point 9.3 C, sensor ok, bus ok"
+    };
+    TextBox box(0, 0, 128, 64, texts[0]);
+    box.setWordWrap(true);
+
+    uint32_t frame = 0;
+    bench("textbox_wrap", 5000, { 0, 0, 1500 }, [&]() {
+        box.setText(texts[frame++ & 1]);
+        box.draw(&screen);
+    });
+}
+
+// Table::draw() of a 4x4 table with grid lines
+void test_table_draw(void) {
+    Table table(0, 0, 128, 64, 4, 4);
+    table.setShowGridLines(true);
+    for (int row = 0; row < 4; row++) {
+        for (int col = 0; col < 4; col++) {
+            table.setCell(row, col, row * 10 + col);
+        }
+    }
+
+    bench("table_draw", 5000, { 0, 0, 1280 }, [&]() {
+        table.draw(&screen);
+    });
+}
+
+// A 20-asset scene: clear, drawAssets() and flush, with two plots moving
+// every frame. Runs in immediate and in retained mode.
+void test_draw_assets_20(void) {
+    DataPlot* plots[4];
+    GraphicsAsset* assets[20];
+    size_t count = 0;
+
+    for (int i = 0; i < 4; i++) {
+        plots[i] = new DataPlot((i % 2) * 64, (i / 2) * 32, 64, 32, 64, true);
+        fillPlot(*plots[i], 64);
+        assets[count++] = plots[i];
+    }
+    assets[count++] = new FunctionPlot(0, 0, 64, 32, wave);
+    assets[count++] = new FunctionPlot(64, 32, 64, 32, sinf);
+    for (int i = 0; i < 4; i++) {
+        assets[count++] = new TextBox(i * 32, 56, 32, 8, "21.5C");
+    }
+    for (int i = 0; i < 2; i++) {
+        Table* table = new Table(i * 64, 0, 64, 24, 2, 2);
+        table->setCell(0, 0, "T");
+        table->setCell(1, 1, 21.5f, 1);
+        assets[count++] = table;
+    }
+    for (int i = 0; i < 8; i++) {
+        GeometryShape shape = (i % 2) ? GeometryShape::CIRCLE : GeometryShape::RECTANGLE;
+        assets[count++] = new Geometry(i * 16, 40, 12, 12, shape);
+    }
+    TEST_ASSERT_EQUAL(20, count);
+
+    screen.clearAssets();
+    for (size_t i = 0; i < count; i++) {
+        TEST_ASSERT_TRUE(screen.addAsset(assets[i]));
+    }
+
+    int step = 0;
+    auto frame = [&]() {
+        plots[0]->addValue(20.0f + 5.0f * wave(step * 0.05f));
+        plots[3]->addValue(45.0f + 3.0f * wave(step * 0.11f));
+        step++;
+        if (!screen.getRetainedMode()) {
+            screen.clearDisplay();
+        }
+        screen.drawAssets();
+        screen.displayBuffer();
+    };
+    // Both modes replay the same frames
+    auto restart = [&]() {
+        for (int i = 0; i < 4; i++) {
+            plots[i]->clearData();
+            fillPlot(*plots[i], 64);
+        }
+        step = 0;
+    };
+
+    restart();
+    screen.setRetainedMode(false);
+    BenchResult immediate = bench("draw_assets_20", 500, { 0, 240, 2100 }, frame);
+
+    // Retained mode exists to do less work than repainting everything
+    restart();
+    screen.setRetainedMode(true);
+    BenchResult retained = bench("draw_assets_20_retained", 500, { 0, 240, 1260 }, frame);
+    char message[160];
+    snprintf(message, sizeof(message), "retained: %.1f pixels, %.1f I2C bytes, %.1f ns per op; immediate: %.1f, %.1f, %.1f",
+             retained.pixels, retained.i2c_bytes, retained.ns, immediate.pixels, immediate.i2c_bytes, immediate.ns);
+    TEST_ASSERT_TRUE_MESSAGE(retained.pixels <= immediate.pixels, message);
+    TEST_ASSERT_TRUE_MESSAGE(retained.i2c_bytes <= immediate.i2c_bytes, message);
+    TEST_ASSERT_TRUE_MESSAGE(retained.ns <= immediate.ns, message);
+    screen.setRetainedMode(false);
+
+    screen.clearAssets();
+    for (size_t i = 0; i < count; i++) {
+        delete assets[i];
+    }
+}
+
+// One changed pixel flushes as a single data byte behind the control byte
+void test_flush_sends_dirty_bytes(void) {
+    screen.clearDisplay();
+    screen.displayBuffer();
+    screen.drawPixel(3, 9);
+    screen.displayBuffer();
+
+    const uint8_t expected[] = { 0x40, 0x02 };
+    TEST_ASSERT_EQUAL(sizeof(expected), Wire.getLastTransmissionLength());
+    TEST_ASSERT_EQUAL_MEMORY(expected, Wire.getLastTransmission(), sizeof(expected));
+    screen.clearDisplay();
+    screen.displayBuffer();
+}
+
+// Replays a command script from memory and discards the replies
+class ScriptStream : public Stream {
+private:
+    const char* script;
+    size_t position;
+
+public:
+    explicit ScriptStream(const char* text) : script(text), position(0) {}
+
+    void load(const char* text) { script = text; position = 0; }
+    int available() override { return script[position] != '\0' ? 1 : 0; }
+    int read() override { return script[position] != '\0' ? (uint8_t)script[position++] : -1; }
+    size_t write(uint8_t) override { return 1; }
+    using Print::write;
+};
+
+#define BENCH_SCRIPT_COMMANDS 8
+
+// SerialLedControl text protocol: parse and run a mix of drawing and asset
+// commands; one operation is one command line
+void test_serial_command_parse(void) {
+    static const char setup_script[] =
+        "ack 0\n"
+        "textbox 0 0 60 10 hello\n"
+        "table 0 16 60 30 3 3\n"
+        "dataplot 64 0 64 32\n";
+    static const char script[] =
+        "setpos 0 4 4\n"
+        "settext 0 temperature 21.5\n"
+        "setcell 1 1 1 42\n"
+        "addpoint 2 1.5 2.5\n"
+        "line 0 0 127 63\n"
+        "rect 10 10 20 10\n"
+        "pixel 5 5\n"
+        "setvisible 1 1\n";
+
+    ScriptStream stream(setup_script);
+    SerialLedControl parser(&screen, &stream);
+    parser.setEcho(false);
+    parser.run();
+
+    // The console's arena is active only while it handles commands
+    TEST_ASSERT_NULL(AssetArena::getActive());
+
+    bench("serial_command_parse", 4000, { 0, 0, 25 }, [&]() {
+        stream.load(script);
+        parser.run();
+    }, BENCH_SCRIPT_COMMANDS);
+}
+
+// DeviceRegistry action queue round trips through a registered device
+void test_registry_queue(void) {
+    DeviceRegistry& registry = DeviceRegistry::getInstance();
+    registry.clearAllActions();
+    while (registry.getDeviceCount() > 0) {
+        registry.unregisterDevice(registry.getDevice(0));
+    }
+
+    MockDevice device(0x20);
+    TEST_ASSERT_TRUE(device.begin());
+    TEST_ASSERT_TRUE(registry.registerDevice(&device));
+
+    static const uint8_t payload[8] = { 0x10, 1, 2, 3, 4, 5, 6, 7 };
+    bench("registry_queue_single", 20000, { 0, 8, 0 }, [&]() {
+        device.addActionToQueue(1, payload, sizeof(payload));
+        registry.performNextAction();
+    });
+
+    bench("registry_queue_burst", 2000, { 0, 8, 0 }, [&]() {
+        for (int i = 0; i < ACTION_QUEUE_CAPACITY; i++) {
+            device.addActionToQueue(1, payload, sizeof(payload));
+        }
+        registry.performPendingActions(1000000UL);
+    }, ACTION_QUEUE_CAPACITY);
+
+    bench("registry_lookup", 200000, { 0, 0, 0 }, [&]() {
+        if (registry.getDeviceByAddress(0x20, &Wire) != &device) {
+            TEST_FAIL_MESSAGE("lookup failed");
+        }
+    });
+
+    registry.clearAllActions();
+    TEST_ASSERT_TRUE(registry.unregisterDevice(&device));
+}
+
+void setup() {
+    const char* path = getenv("BENCH_OUTPUT");
+    bench_output = fopen(path != nullptr ? path : BENCH_DEFAULT_OUTPUT, "w");
+    const char* tolerance = getenv("BENCH_TOLERANCE");
+    if (tolerance != nullptr && atof(tolerance) > 0.0) {
+        bench_tolerance = atof(tolerance);
+    }
+    screen.begin();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_dataplot_draw);
+    RUN_TEST(test_functionplot_draw);
+    RUN_TEST(test_textbox_wrap);
+    RUN_TEST(test_table_draw);
+    RUN_TEST(test_draw_assets_20);
+    RUN_TEST(test_flush_sends_dirty_bytes);
+    RUN_TEST(test_serial_command_parse);
+    RUN_TEST(test_registry_queue);
+    UNITY_END();
+
+    if (bench_output != nullptr) {
+        fclose(bench_output);
+    }
+}
+
+void loop() {
+    // Benchmarks run once from setup()
+}
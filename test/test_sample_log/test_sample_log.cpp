@@ -0,0 +1,229 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <FS.h>
+#include <MockCounters.h>
+#include <vector>
+#include "SampleLog.hpp"
+
+// SampleLog on the in-memory fs::FS of the native mocks. A small ring
+// (LOG_TEST_BLOCKS blocks) wraps after a few hundred samples; the range
+// tests use a ring large enough to keep everything they append.
+
+#define LOG_TEST_BLOCKS 8
+#define LOG_TEST_LARGE_BLOCKS 64
+#define LOG_TEST_PATH "/test.log"
+
+struct LoggedSample {
+    uint32_t time_s;
+    float values[2];
+};
+
+static std::vector<LoggedSample> visited;
+
+void setUp(void) {
+    visited.clear();
+}
+
+void tearDown(void) {
+    // Not needed
+}
+
+static void collect(uint32_t time_s, const float* values, void* context) {
+    (void)context;
+    LoggedSample sample = { time_s, { values[0], values[1] } };
+    visited.push_back(sample);
+}
+
+// Deterministic values that are exact multiples of the default resolution
+static void sampleValues(uint32_t time_s, float* values) {
+    values[0] = (float)((int)(time_s * 37 % 200) - 100) * 0.05f;
+    values[1] = (float)(time_s % 97) * 0.5f;
+}
+
+static void appendRange(SampleLog& log, uint32_t from_s, uint32_t to_s, uint32_t step_s) {
+    float values[2];
+    for (uint32_t t = from_s; t <= to_s; t += step_s) {
+        sampleValues(t, values);
+        TEST_ASSERT_TRUE(log.append(values, t));
+    }
+}
+
+static void expectSamples(uint32_t from_s, uint32_t to_s, uint32_t step_s) {
+    TEST_ASSERT_EQUAL((to_s - from_s) / step_s + 1, visited.size());
+    float values[2];
+    for (size_t i = 0; i < visited.size(); i++) {
+        uint32_t t = from_s + (uint32_t)i * step_s;
+        sampleValues(t, values);
+        TEST_ASSERT_EQUAL(t, visited[i].time_s);
+        TEST_ASSERT_FLOAT_WITHIN(0.001f, values[0], visited[i].values[0]);
+        TEST_ASSERT_FLOAT_WITHIN(0.001f, values[1], visited[i].values[1]);
+    }
+}
+
+void test_wraparound(void) {
+    fs::FS filesystem;
+    SampleLog log(2, LOG_TEST_BLOCKS);
+    log.setCommitInterval(0xFFFFFFFFUL);
+    TEST_ASSERT_TRUE(log.begin(filesystem, LOG_TEST_PATH));
+    TEST_ASSERT_EQUAL(0, log.getStoredBlocks());
+
+    // Several laps of the ring: only the newest LOG_TEST_BLOCKS blocks remain
+    appendRange(log, 1000, 4999, 1);
+    TEST_ASSERT_EQUAL(LOG_TEST_BLOCKS, log.getStoredBlocks());
+    TEST_ASSERT_EQUAL(4000, log.getSampleCount());
+
+    uint32_t oldest = 0, newest = 0;
+    TEST_ASSERT_TRUE(log.getTimeSpan(oldest, newest));
+    TEST_ASSERT_EQUAL(4999, newest);
+    TEST_ASSERT_TRUE(oldest > 1000);
+
+    // Everything still stored comes back in order, nothing older
+    TEST_ASSERT_EQUAL(newest - oldest + 1, log.query(0, 0xFFFFFFFFUL, collect));
+    expectSamples(oldest, newest, 1);
+    visited.clear();
+    TEST_ASSERT_EQUAL(0, log.query(1000, oldest - 1, collect));
+    log.end();
+}
+
+void test_resume_after_begin(void) {
+    fs::FS filesystem;
+    uint32_t oldest = 0, newest = 0;
+    {
+        SampleLog log(2, LOG_TEST_BLOCKS);
+        TEST_ASSERT_TRUE(log.begin(filesystem, LOG_TEST_PATH));
+        appendRange(log, 100, 1300, 2);
+        TEST_ASSERT_TRUE(log.getTimeSpan(oldest, newest));
+        log.end();
+    }
+
+    SampleLog log(2, LOG_TEST_BLOCKS);
+    resetMockCounters();
+    TEST_ASSERT_TRUE(log.begin(filesystem, LOG_TEST_PATH));
+
+    // The index comes from the headers; only the newest block is read whole
+    size_t header = 24 + 6 * 2;
+    TEST_ASSERT_TRUE(mock_counters.fs_bytes_read <= LOG_TEST_BLOCKS * header + SAMPLE_LOG_BLOCK_SIZE);
+
+    uint32_t resumed_oldest = 0, resumed_newest = 0;
+    TEST_ASSERT_TRUE(log.getTimeSpan(resumed_oldest, resumed_newest));
+    TEST_ASSERT_EQUAL(oldest, resumed_oldest);
+    TEST_ASSERT_EQUAL(newest, resumed_newest);
+    TEST_ASSERT_EQUAL(LOG_TEST_BLOCKS, log.getStoredBlocks());
+    TEST_ASSERT_TRUE(log.now() > newest);
+
+    // Appending continues in the newest block, after the stored samples
+    appendRange(log, newest + 2, newest + 40, 2);
+    TEST_ASSERT_TRUE(log.getTimeSpan(resumed_oldest, resumed_newest));
+    log.query(resumed_oldest, resumed_newest, collect);
+    expectSamples(resumed_oldest, newest + 40, 2);
+    log.end();
+}
+
+void test_torn_newest_block(void) {
+    fs::FS filesystem;
+    uint32_t newest = 0, oldest = 0;
+    {
+        SampleLog log(2, LOG_TEST_BLOCKS);
+        TEST_ASSERT_TRUE(log.begin(filesystem, LOG_TEST_PATH));
+        appendRange(log, 0, 199, 1);
+        TEST_ASSERT_TRUE(log.getTimeSpan(oldest, newest));
+        log.end();
+    }
+    SampleLog probe(2, LOG_TEST_BLOCKS);
+    TEST_ASSERT_TRUE(probe.begin(filesystem, LOG_TEST_PATH));
+    uint16_t blocks = probe.getStoredBlocks();
+    probe.end();
+    TEST_ASSERT_TRUE(blocks > 1);
+
+    // Flip a payload byte of the newest block: its header still looks fine
+    fs::File file = filesystem.open(LOG_TEST_PATH, "r+");
+    uint8_t byte = 0;
+    size_t offset = (blocks - 1) * SAMPLE_LOG_BLOCK_SIZE + 24 + 6 * 2;
+    TEST_ASSERT_TRUE(file.seek(offset));
+    TEST_ASSERT_EQUAL(1, file.read(&byte, 1));
+    byte ^= 0x55;
+    TEST_ASSERT_TRUE(file.seek(offset));
+    TEST_ASSERT_EQUAL(1, file.write(&byte, 1));
+    file.close();
+
+    SampleLog log(2, LOG_TEST_BLOCKS);
+    TEST_ASSERT_TRUE(log.begin(filesystem, LOG_TEST_PATH));
+    TEST_ASSERT_EQUAL(blocks - 1, log.getStoredBlocks());
+    uint32_t resumed_oldest = 0, resumed_newest = 0;
+    TEST_ASSERT_TRUE(log.getTimeSpan(resumed_oldest, resumed_newest));
+    TEST_ASSERT_EQUAL(0, resumed_oldest);
+    TEST_ASSERT_TRUE(resumed_newest < newest);
+    log.query(0, newest, collect);
+    expectSamples(0, resumed_newest, 1);
+    log.end();
+}
+
+void test_query_bounds(void) {
+    fs::FS filesystem;
+    SampleLog log(2, LOG_TEST_LARGE_BLOCKS);
+    TEST_ASSERT_TRUE(log.begin(filesystem, LOG_TEST_PATH));
+    appendRange(log, 500, 899, 1);
+    log.commit();
+
+    // Inclusive at both ends, across block boundaries
+    TEST_ASSERT_EQUAL(251, log.query(600, 850, collect));
+    expectSamples(600, 850, 1);
+
+    visited.clear();
+    TEST_ASSERT_EQUAL(1, log.query(899, 899, collect));
+    TEST_ASSERT_EQUAL(899, visited[0].time_s);
+
+    visited.clear();
+    TEST_ASSERT_EQUAL(400, log.query(0, 10000, collect));
+    TEST_ASSERT_EQUAL(0, log.query(900, 10000, collect));
+    TEST_ASSERT_EQUAL(0, log.query(0, 499, collect));
+    TEST_ASSERT_EQUAL(0, log.query(700, 600, collect));
+    log.end();
+}
+
+void test_extrema(void) {
+    fs::FS filesystem;
+    SampleLog log(2, LOG_TEST_LARGE_BLOCKS);
+    TEST_ASSERT_TRUE(log.begin(filesystem, LOG_TEST_PATH));
+    appendRange(log, 0, 499, 1);
+    log.commit();
+    TEST_ASSERT_TRUE(log.getStoredBlocks() > 3);
+
+    // Edge blocks decoded, inner blocks from their headers: both must agree
+    // with a scan of the samples
+    static const uint32_t ranges[][2] = { { 0, 499 }, { 3, 4 }, { 17, 401 }, { 100, 100 }, { 250, 499 } };
+    for (size_t r = 0; r < sizeof(ranges) / sizeof(ranges[0]); r++) {
+        for (uint8_t channel = 0; channel < 2; channel++) {
+            float expected_min = 1e9f, expected_max = -1e9f;
+            float values[2];
+            for (uint32_t t = ranges[r][0]; t <= ranges[r][1]; t++) {
+                sampleValues(t, values);
+                expected_min = min(expected_min, values[channel]);
+                expected_max = max(expected_max, values[channel]);
+            }
+            float low = 0.0f, high = 0.0f;
+            TEST_ASSERT_TRUE(log.getExtrema(ranges[r][0], ranges[r][1], channel, low, high));
+            TEST_ASSERT_FLOAT_WITHIN(0.001f, expected_min, low);
+            TEST_ASSERT_FLOAT_WITHIN(0.001f, expected_max, high);
+        }
+    }
+
+    float low = 0.0f, high = 0.0f;
+    TEST_ASSERT_FALSE(log.getExtrema(500, 600, 0, low, high));
+    TEST_ASSERT_FALSE(log.getExtrema(0, 499, 2, low, high));
+    log.end();
+}
+
+void setup() {
+    UNITY_BEGIN();
+    RUN_TEST(test_wraparound);
+    RUN_TEST(test_resume_after_begin);
+    RUN_TEST(test_torn_newest_block);
+    RUN_TEST(test_query_bounds);
+    RUN_TEST(test_extrema);
+    UNITY_END();
+}
+
+void loop() {
+    // Tests run once from setup()
+}